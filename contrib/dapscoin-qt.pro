@@ -25,14 +25,12 @@ DEPENDPATH += . \
               src/qt/forms \
               src/qt/locale \
               src/qt/test \
-              src/secp256k1/include \
-              src/secp256k1/src \
+              src/secp256k1-mw/include \
               src/test/data \
               src/leveldb/doc/bench \
               src/leveldb/helpers/memenv \
               src/leveldb/include/leveldb \
-              src/leveldb/port/win \
-              src/secp256k1/src/java
+              src/leveldb/port/win
 INCLUDEPATH += . \
                src \
                src/config \
@@ -46,13 +44,11 @@ INCLUDEPATH += . \
                src/qt \
                src/qt/forms \
                src/compat \
-               src/secp256k1/include \
+               src/secp256k1-mw/include \
                src/leveldb/helpers/memenv \
                src/test/data \
                src/test \
-               src/qt/test \
-               src/secp256k1/src \
-               src/secp256k1/src/java
+               src/qt/test
 
 # Input
 HEADERS += src/activemasternode.h \
@@ -80,7 +76,7 @@ HEADERS += src/activemasternode.h \
            src/dapscoin-config.h \
            src/db.h \
            src/eccryptoverify.h \
-           src/ecwrapper.h \
+           src/ecutil.h \
            src/hash.h \
            src/init.h \
            src/swifttx.h \
@@ -95,6 +91,7 @@ HEADERS += src/activemasternode.h \
            src/masternode-sync.h \
            src/masternode.h \
            src/masternodeconfig.h \
+           src/masternodedb.h \
            src/masternodeman.h \
            src/merkleblock.h \
            src/miner.h \
@@ -208,6 +205,7 @@ HEADERS += src/activemasternode.h \
            src/qt/transactiondesc.h \
            src/qt/transactiondescdialog.h \
            src/qt/transactionfilterproxy.h \
+           src/qt/transactionhistorymodel.h \
            src/qt/transactionrecord.h \
            src/qt/transactiontablemodel.h \
            src/qt/transactionview.h \
@@ -270,41 +268,6 @@ HEADERS += src/activemasternode.h \
            src/qt/test/paymentrequestdata.h \
            src/qt/test/paymentservertests.h \
            src/qt/test/uritests.h \
-           src/secp256k1/include/secp256k1.h \
-           src/secp256k1/src/ecdsa.h \
-           src/secp256k1/src/ecdsa_impl.h \
-           src/secp256k1/src/eckey.h \
-           src/secp256k1/src/eckey_impl.h \
-           src/secp256k1/src/ecmult.h \
-           src/secp256k1/src/ecmult_gen.h \
-           src/secp256k1/src/ecmult_gen_impl.h \
-           src/secp256k1/src/ecmult_impl.h \
-           src/secp256k1/src/field.h \
-           src/secp256k1/src/field_10x26.h \
-           src/secp256k1/src/field_10x26_impl.h \
-           src/secp256k1/src/field_5x52.h \
-           src/secp256k1/src/field_5x52_asm_impl.h \
-           src/secp256k1/src/field_5x52_impl.h \
-           src/secp256k1/src/field_5x52_int128_impl.h \
-           src/secp256k1/src/field_gmp.h \
-           src/secp256k1/src/field_gmp_impl.h \
-           src/secp256k1/src/field_impl.h \
-           src/secp256k1/src/group.h \
-           src/secp256k1/src/group_impl.h \
-           src/secp256k1/src/libsecp256k1-config.h \
-           src/secp256k1/src/num.h \
-           src/secp256k1/src/num_gmp.h \
-           src/secp256k1/src/num_gmp_impl.h \
-           src/secp256k1/src/num_impl.h \
-           src/secp256k1/src/scalar.h \
-           src/secp256k1/src/scalar_4x64.h \
-           src/secp256k1/src/scalar_4x64_impl.h \
-           src/secp256k1/src/scalar_8x32.h \
-           src/secp256k1/src/scalar_8x32_impl.h \
-           src/secp256k1/src/scalar_impl.h \
-           src/secp256k1/src/testrand.h \
-           src/secp256k1/src/testrand_impl.h \
-           src/secp256k1/src/util.h \
            src/test/data/alertTests.raw.h \
            src/test/data/base58_encode_decode.json.h \
            src/test/data/base58_keys_invalid.json.h \
@@ -332,14 +295,12 @@ HEADERS += src/activemasternode.h \
            src/leveldb/include/leveldb/table_builder.h \
            src/leveldb/include/leveldb/write_batch.h \
            src/leveldb/port/win/stdint.h \
-           src/secp256k1/src/java/org_bitcoin_NativeSecp256k1.h \
            src/crypto/aes_helper.c \
            src/qt/bitcoinamountfield.moc \
            src/qt/dapscoin.moc \
            src/qt/intro.moc \
            src/qt/overviewpage.moc \
-           src/qt/rpcconsole.moc \
-           src/secp256k1/src/secp256k1.c
+           src/qt/rpcconsole.moc
 FORMS += src/qt/forms/addressbookpage.ui \
          src/qt/forms/askpassphrasedialog.ui \
          src/qt/forms/coincontroldialog.ui \
@@ -385,7 +346,7 @@ SOURCES += src/activemasternode.cpp \
            src/dapscoin.cpp \
            src/db.cpp \
            src/eccryptoverify.cpp \
-           src/ecwrapper.cpp \
+           src/ecutil.cpp \
            src/editaddressdialog.cpp \
            src/hash.cpp \
            src/init.cpp \
@@ -400,6 +361,7 @@ SOURCES += src/activemasternode.cpp \
            src/masternode-sync.cpp \
            src/masternode.cpp \
            src/masternodeconfig.cpp \
+           src/masternodedb.cpp \
            src/masternodeman.cpp \
            src/merkleblock.cpp \
            src/miner.cpp \
@@ -509,6 +471,7 @@ SOURCES += src/activemasternode.cpp \
            src/qt/transactiondesc.cpp \
            src/qt/transactiondescdialog.cpp \
            src/qt/transactionfilterproxy.cpp \
+           src/qt/transactionhistorymodel.cpp \
            src/qt/transactionrecord.cpp \
            src/qt/transactiontablemodel.cpp \
            src/qt/transactionview.cpp \
@@ -641,16 +604,10 @@ SOURCES += src/activemasternode.cpp \
            src/qt/test/paymentservertests.cpp \
            src/qt/test/test_main.cpp \
            src/qt/test/uritests.cpp \
-           src/secp256k1/src/bench_inv.c \
-           src/secp256k1/src/bench_sign.c \
-           src/secp256k1/src/bench_verify.c \
-           src/secp256k1/src/secp256k1.c \
-           src/secp256k1/src/tests.c \
            src/leveldb/doc/bench/db_bench_sqlite3.cc \
            src/leveldb/doc/bench/db_bench_tree_db.cc \
            src/leveldb/helpers/memenv/memenv.cc \
-           src/leveldb/helpers/memenv/memenv_test.cc \
-           src/secp256k1/src/java/org_bitcoin_NativeSecp256k1.c
+           src/leveldb/helpers/memenv/memenv_test.cc
 RESOURCES += src/qt/dapscoin.qrc src/qt/dapscoin_locale.qrc
 
 TRANSLATIONS += src/qt/locale/dapscoin_bg.ts \
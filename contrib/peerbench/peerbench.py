@@ -0,0 +1,197 @@
+#!/usr/bin/env python3
+#
+# peerbench.py: Measure the per-peer overhead of the socket handler by
+# holding thousands of loopback P2P connections open against a dapscoind.
+#
+# Copyright (c) 2018-2019 The DAPS Project developers
+# Distributed under the MIT software license, see the accompanying
+# file COPYING or http://www.opensource.org/licenses/mit-license.php.
+#
+
+import argparse
+import hashlib
+import os
+import random
+import resource
+import selectors
+import socket
+import statistics
+import struct
+import time
+
+NETWORKS = {
+    'main': (bytes([0xa4, 0xb7, 0x79, 0x84]), 53572),
+    'testnet': (bytes([0xa5, 0xb8, 0x7a, 0x85]), 53574),
+    'regtest': (bytes([0xa1, 0xcf, 0x7e, 0xac]), 51476),
+}
+PROTOCOL_VERSION = 70913
+HEADER_SIZE = 24
+
+
+def checksum(payload):
+    return hashlib.sha256(hashlib.sha256(payload).digest()).digest()[:4]
+
+
+def message(magic, command, payload=b''):
+    return (magic + command.encode('ascii').ljust(12, b'\0') +
+            struct.pack('<I', len(payload)) + checksum(payload) + payload)
+
+
+def net_addr(host, port):
+    ip = b'\0' * 10 + b'\xff\xff' + socket.inet_aton(host)
+    return struct.pack('<Q', 1) + ip + struct.pack('>H', port)
+
+
+def version_payload(host, port):
+    subver = b'/peerbench:0.1/'
+    return (struct.pack('<iQq', PROTOCOL_VERSION, 1, int(time.time())) +
+            net_addr(host, port) + net_addr('127.0.0.1', 0) +
+            struct.pack('<Q', random.getrandbits(64)) +
+            bytes([len(subver)]) + subver + struct.pack('<i', 0))
+
+
+class Peer(object):
+    def __init__(self, sock):
+        self.sock = sock
+        self.recvbuf = b''
+        self.sendbuf = b''
+        self.ready = False
+        self.closed = False
+        self.ping_nonce = None
+        self.ping_sent = 0.0
+
+
+class Bench(object):
+    def __init__(self, args):
+        self.args = args
+        self.magic, default_port = NETWORKS[args.network]
+        self.port = args.port or default_port
+        self.sel = selectors.DefaultSelector()
+        self.peers = []
+        self.latencies = []
+        self.dropped = 0
+
+    def connect(self, count):
+        while len(self.peers) < count:
+            sock = socket.socket(socket.AF_INET, socket.SOCK_STREAM)
+            sock.setblocking(False)
+            sock.connect_ex((self.args.host, self.port))
+            peer = Peer(sock)
+            self.sel.register(sock, selectors.EVENT_READ, peer)
+            self.send(peer, message(self.magic, 'version', version_payload(self.args.host, self.port)))
+            self.peers.append(peer)
+            if len(self.peers) % 500 == 0:
+                # Let the node keep up with the accept queue
+                self.poll(0.2)
+
+    def send(self, peer, data):
+        # Only wait for writability while something is queued
+        if not peer.sendbuf:
+            self.sel.modify(peer.sock, selectors.EVENT_READ | selectors.EVENT_WRITE, peer)
+        peer.sendbuf += data
+
+    def close(self, peer):
+        peer.closed = True
+        self.sel.unregister(peer.sock)
+        peer.sock.close()
+        self.peers.remove(peer)
+        self.dropped += 1
+
+    def handle(self, peer, command, payload):
+        if command == 'version':
+            self.send(peer, message(self.magic, 'verack'))
+        elif command == 'verack':
+            peer.ready = True
+        elif command == 'ping':
+            self.send(peer, message(self.magic, 'pong', payload))
+        elif command == 'pong' and peer.ping_nonce is not None and payload[:8] == peer.ping_nonce:
+            self.latencies.append(time.time() - peer.ping_sent)
+            peer.ping_nonce = None
+
+    def service(self, peer, mask):
+        try:
+            if mask & selectors.EVENT_READ:
+                data = peer.sock.recv(65536)
+                if not data:
+                    return self.close(peer)
+                peer.recvbuf += data
+                while len(peer.recvbuf) >= HEADER_SIZE:
+                    command = peer.recvbuf[4:16].rstrip(b'\0').decode('ascii', 'replace')
+                    length = struct.unpack('<I', peer.recvbuf[16:20])[0]
+                    if len(peer.recvbuf) < HEADER_SIZE + length:
+                        break
+                    self.handle(peer, command, peer.recvbuf[HEADER_SIZE:HEADER_SIZE + length])
+                    peer.recvbuf = peer.recvbuf[HEADER_SIZE + length:]
+            if mask & selectors.EVENT_WRITE and peer.sendbuf:
+                sent = peer.sock.send(peer.sendbuf)
+                peer.sendbuf = peer.sendbuf[sent:]
+                if not peer.sendbuf:
+                    self.sel.modify(peer.sock, selectors.EVENT_READ, peer)
+        except (BlockingIOError, InterruptedError):
+            pass
+        except OSError:
+            self.close(peer)
+
+    def poll(self, duration):
+        end = time.time() + duration
+        while time.time() < end:
+            for key, mask in self.sel.select(timeout=0.05):
+                if not key.data.closed:
+                    self.service(key.data, mask)
+
+    def ping_all(self):
+        for peer in self.peers:
+            if peer.ready and peer.ping_nonce is None:
+                peer.ping_nonce = struct.pack('<Q', random.getrandbits(64))
+                peer.ping_sent = time.time()
+                self.send(peer, message(self.magic, 'ping', peer.ping_nonce))
+
+
+def cpu_seconds(pid):
+    with open('/proc/%d/stat' % pid) as f:
+        fields = f.read().rsplit(')', 1)[1].split()
+    return (int(fields[11]) + int(fields[12])) / float(os.sysconf('SC_CLK_TCK'))
+
+
+def main():
+    parser = argparse.ArgumentParser(description='Open many loopback peers to a dapscoind and measure per-peer overhead.')
+    parser.add_argument('--network', choices=sorted(NETWORKS), default='regtest')
+    parser.add_argument('--host', default='127.0.0.1')
+    parser.add_argument('--port', type=int, default=0, help='P2P port (default: the network default)')
+    parser.add_argument('--pid', type=int, required=True, help='pid of the dapscoind to sample CPU time of')
+    parser.add_argument('--peers', default='100,500,1000,2000,4000', help='comma separated peer counts to step through')
+    parser.add_argument('--duration', type=float, default=30, help='seconds to measure at every step')
+    parser.add_argument('--ping-interval', type=float, default=5, help='seconds between pings on every peer')
+    args = parser.parse_args()
+
+    steps = [int(n) for n in args.peers.split(',')]
+    soft, hard = resource.getrlimit(resource.RLIMIT_NOFILE)
+    resource.setrlimit(resource.RLIMIT_NOFILE, (min(hard, max(steps) + 64), hard))
+
+    bench = Bench(args)
+    print('%8s %8s %10s %14s %10s %10s' % ('peers', 'ready', 'cpu %', 'us/peer/s', 'ping p50', 'ping p99'))
+    for count in steps:
+        bench.connect(count)
+        bench.poll(2)
+        bench.latencies = []
+        cpu_start, wall_start = cpu_seconds(args.pid), time.time()
+        next_ping = 0
+        while time.time() - wall_start < args.duration:
+            if time.time() >= next_ping:
+                bench.ping_all()
+                next_ping = time.time() + args.ping_interval
+            bench.poll(0.5)
+        cpu = cpu_seconds(args.pid) - cpu_start
+        wall = time.time() - wall_start
+        ready = sum(1 for peer in bench.peers if peer.ready)
+        latencies = sorted(bench.latencies) or [0.0]
+        p99 = latencies[min(len(latencies) - 1, int(len(latencies) * 0.99))]
+        print('%8d %8d %10.1f %14.1f %9.1fms %9.1fms' % (
+            len(bench.peers), ready, 100.0 * cpu / wall, 1e6 * cpu / wall / max(ready, 1),
+            1000 * statistics.median(latencies), 1000 * p99))
+    if bench.dropped:
+        print('%d connections were closed by the node, check -maxconnections and the file descriptor limit' % bench.dropped)
+
+
+if __name__ == '__main__':
+    main()
@@ -15,6 +15,8 @@ zmqSubSocket.setsockopt(zmq.SUBSCRIBE, b"hashtxlock")
 zmqSubSocket.setsockopt(zmq.SUBSCRIBE, b"rawblock")
 zmqSubSocket.setsockopt(zmq.SUBSCRIBE, b"rawtx")
 zmqSubSocket.setsockopt(zmq.SUBSCRIBE, b"rawtxlock")
+zmqSubSocket.setsockopt(zmq.SUBSCRIBE, b"keyimage")
+zmqSubSocket.setsockopt(zmq.SUBSCRIBE, b"walletoutput")
 zmqSubSocket.connect("tcp://127.0.0.1:%i" % port)
 
 try:
@@ -46,6 +48,14 @@ try:
         elif topic == "rawtxlock":
             print('- RAW TX LOCK ('+sequence+') -')
             print(binascii.hexlify(body).decode("utf-8"))
+        elif topic == "keyimage":
+            print('- KEY IMAGE ('+sequence+') -')
+            height = struct.unpack('<I', body[65:69])[0]
+            print(binascii.hexlify(body[:33]).decode("utf-8") + ' ' + binascii.hexlify(body[33:65]).decode("utf-8") + ' ' + str(height))
+        elif topic == "walletoutput":
+            print('- WALLET OUTPUT ('+sequence+') -')
+            n, amount = struct.unpack('<Iq', body[32:44])
+            print(binascii.hexlify(body[:32]).decode("utf-8") + ':' + str(n) + ' ' + str(amount) + ' ' + body[44:].decode("utf-8"))
 
 except KeyboardInterrupt:
     zmqContext.destroy()
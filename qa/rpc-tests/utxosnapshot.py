@@ -0,0 +1,69 @@
+#!/usr/bin/env python2
+# Copyright (c) 2018-2019 The DAPS Project developers
+# Distributed under the MIT software license, see the accompanying
+# file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#
+# Test dumptxoutset and -loadtxoutset, including the background replay of the snapshot's blocks
+#
+from test_framework import BitcoinTestFramework
+from util import *
+import os.path
+import time
+
+class UtxoSnapshotTest(BitcoinTestFramework):
+
+    def setup_chain(self):
+        print("Initializing test directory "+self.options.tmpdir)
+        initialize_chain_clean(self.options.tmpdir, 2)
+
+    def setup_network(self):
+        self.nodes = []
+        self.is_network_split = False
+        self.nodes.append(start_node(0, self.options.tmpdir))
+
+    def wait_for_replay(self, n_node, timeout):
+        log = log_filename(self.options.tmpdir, n_node, "debug.log")
+        while timeout > 0:
+            if "Replayed the blocks of the UTXO snapshot" in open(log).read():
+                return
+            time.sleep(1)
+            timeout -= 1
+        raise AssertionError("The blocks of the UTXO snapshot were not replayed")
+
+    def run_test(self):
+        self.nodes[0].generate(25)
+        snapshot = self.nodes[0].dumptxoutset("utxo.dat")
+        assert_equal(snapshot["height"], 25)
+        assert_equal(snapshot["bestblockhash"], self.nodes[0].getbestblockhash())
+        assert_raises(JSONRPCException, self.nodes[0].dumptxoutset, "utxo.dat")
+
+        # A new node continues from the snapshot's tip with the same coins
+        self.nodes.append(start_node(1, self.options.tmpdir, ["-loadtxoutset="+snapshot["path"]]))
+        assert_equal(self.nodes[1].getblockcount(), 25)
+        assert_equal(self.nodes[1].getbestblockhash(), snapshot["bestblockhash"])
+        info0 = self.nodes[0].gettxoutsetinfo()
+        info1 = self.nodes[1].gettxoutsetinfo()
+        for key in ["bestblock", "transactions", "txouts", "bytes_serialized", "muhash", "total_amount"]:
+            assert_equal(info1[key], info0[key])
+        assert(self.nodes[1].getsupplyinfo()["consistent"])
+
+        # The blocks below the tip are replayed in the background and match the snapshot
+        self.wait_for_replay(1, 60)
+        assert_equal(self.nodes[1].getblockcount(), 25)
+
+        # The node follows the chain from the snapshot on
+        connect_nodes_bi(self.nodes, 0, 1)
+        self.nodes[0].generate(5)
+        sync_blocks(self.nodes)
+        assert_equal(self.nodes[1].getbestblockhash(), self.nodes[0].getbestblockhash())
+
+        # A verified snapshot is not replayed again after a restart
+        stop_node(self.nodes[1], 1)
+        self.nodes[1] = start_node(1, self.options.tmpdir, ["-loadtxoutset="+snapshot["path"]])
+        assert_equal(self.nodes[1].getblockcount(), 30)
+        assert(not os.path.exists(os.path.join(self.options.tmpdir, "node1", "regtest", "snapshotcheck")))
+        print "Success"
+
+if __name__ == '__main__':
+    UtxoSnapshotTest().main()
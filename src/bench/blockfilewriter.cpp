@@ -0,0 +1,89 @@
+// Copyright (c) 2018-2019 The DAPS Project developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include "bench.h"
+
+#include "blockfilewriter.h"
+#include "chainparams.h"
+#include "main.h"
+#include "util.h"
+
+#include <assert.h>
+#include <vector>
+
+#include <boost/filesystem.hpp>
+
+// Record sizes in the range of a RingCT block and its undo data during a reindex
+static const unsigned int BLOCK_RECORD_SIZE = 32 * 1024;
+static const unsigned int UNDO_RECORD_SIZE = 4 * 1024;
+// Blocks connected between two FlushBlockFile calls
+static const int BLOCKS_PER_FLUSH = 100;
+
+static void SetupBlocksDir()
+{
+    static bool fSetup = false;
+    if (!fSetup) {
+        SelectParams(CBaseChainParams::REGTEST);
+        boost::filesystem::path path = GetTempPath() / strprintf("bench_dapscoin_%lu", (unsigned long)GetTime());
+        boost::filesystem::create_directories(path);
+        mapArgs["-datadir"] = path.string();
+        fSetup = true;
+    }
+    boost::filesystem::remove_all(GetDataDir() / "blocks");
+}
+
+/**
+ * Connect BLOCKS_PER_FLUSH blocks the way ConnectBlock writes them, then flush
+ * like FlushBlockFile: drain the writer and fsync the current files.
+ */
+static void WriteBlockFiles(benchmark::State& state, bool fQueued)
+{
+    SetupBlocksDir();
+    CBlockFileWriter writer;
+    if (fQueued)
+        writer.Start(DEFAULT_BLOCK_WRITE_QUEUE << 20);
+
+    CDiskBlockPos posBlock(0, 0);
+    CDiskBlockPos posUndo(0, 0);
+    while (state.KeepRunning()) {
+        for (int i = 0; i < BLOCKS_PER_FLUSH; i++) {
+            if (posBlock.nPos + BLOCK_RECORD_SIZE > MAX_BLOCKFILE_SIZE) {
+                posBlock = CDiskBlockPos(posBlock.nFile + 1, 0);
+                posUndo = CDiskBlockPos(posUndo.nFile + 1, 0);
+            }
+            std::vector<char> vchBlock(BLOCK_RECORD_SIZE, 'b');
+            std::vector<char> vchUndo(UNDO_RECORD_SIZE, 'u');
+            assert(writer.Write(CBlockFileWriter::BLOCK_FILE, posBlock, vchBlock));
+            assert(writer.Write(CBlockFileWriter::UNDO_FILE, posUndo, vchUndo));
+            posBlock.nPos += BLOCK_RECORD_SIZE;
+            posUndo.nPos += UNDO_RECORD_SIZE;
+        }
+
+        assert(writer.Flush());
+        FILE* file = OpenBlockFile(CDiskBlockPos(posBlock.nFile, 0));
+        assert(file);
+        FileCommit(file);
+        fclose(file);
+        file = OpenUndoFile(CDiskBlockPos(posUndo.nFile, 0));
+        assert(file);
+        FileCommit(file);
+        fclose(file);
+    }
+
+    writer.Stop();
+    boost::filesystem::remove_all(GetDataDir() / "blocks");
+}
+
+static void BlockFileWriteSync(benchmark::State& state)
+{
+    WriteBlockFiles(state, false);
+}
+
+static void BlockFileWriteQueued(benchmark::State& state)
+{
+    WriteBlockFiles(state, true);
+}
+
+BENCHMARK(BlockFileWriteSync);
+BENCHMARK(BlockFileWriteQueued);
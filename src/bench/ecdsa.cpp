@@ -0,0 +1,122 @@
+// Copyright (c) 2018-2019 The DAPS Project developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include "bench.h"
+
+#include "hash.h"
+#include "key.h"
+#include "pubkey.h"
+#include "uint256.h"
+#include "utilstrencodings.h"
+
+#include <assert.h>
+#include <vector>
+
+#include <openssl/ecdsa.h>
+#include <openssl/obj_mac.h>
+
+// Signatures over the same number of keys as the comparison run that retired the OpenSSL path
+static const int NUM_KEYS = 300;
+
+struct SignedHashes {
+    std::vector<CPubKey> vPubKeys;
+    std::vector<uint256> vHashes;
+    std::vector<std::vector<unsigned char> > vSigs;
+    std::vector<std::vector<unsigned char> > vCompactSigs;
+
+    SignedHashes()
+    {
+        for (int i = 0; i < NUM_KEYS; i++) {
+            CKey key;
+            key.MakeNewKey(true);
+            uint256 hash = Hash(BEGIN(i), END(i));
+            std::vector<unsigned char> vchSig, vchCompactSig;
+            key.Sign(hash, vchSig);
+            key.SignCompact(hash, vchCompactSig);
+            vPubKeys.push_back(key.GetPubKey());
+            vHashes.push_back(hash);
+            vSigs.push_back(vchSig);
+            vCompactSigs.push_back(vchCompactSig);
+        }
+    }
+};
+
+static const SignedHashes& GetSignedHashes()
+{
+    static SignedHashes signedHashes;
+    return signedHashes;
+}
+
+/** The verification CPubKey::Verify did through OpenSSL before all EC operations moved to secp256k1-mw */
+static bool VerifyOpenSSL(const CPubKey& pubkey, const uint256& hash, const std::vector<unsigned char>& vchSig)
+{
+    EC_KEY* pkey = EC_KEY_new_by_curve_name(NID_secp256k1);
+    const unsigned char* pbegin = pubkey.begin();
+    bool ret = false;
+    if (pkey && o2i_ECPublicKey(&pkey, &pbegin, pubkey.size())) {
+        // Newer OpenSSL versions reject non-canonical DER, the old path re-serialized first
+        ECDSA_SIG* norm_sig = ECDSA_SIG_new();
+        const unsigned char* sigptr = &vchSig[0];
+        unsigned char* norm_der = NULL;
+        if (d2i_ECDSA_SIG(&norm_sig, &sigptr, vchSig.size())) {
+            int derlen = i2d_ECDSA_SIG(norm_sig, &norm_der);
+            if (derlen > 0)
+                ret = ECDSA_verify(0, (const unsigned char*)&hash, sizeof(hash), norm_der, derlen, pkey) == 1;
+            OPENSSL_free(norm_der);
+        }
+        ECDSA_SIG_free(norm_sig);
+    }
+    EC_KEY_free(pkey);
+    return ret;
+}
+
+static void ECDSASign(benchmark::State& state)
+{
+    std::vector<CKey> vKeys(NUM_KEYS);
+    for (int i = 0; i < NUM_KEYS; i++)
+        vKeys[i].MakeNewKey(true);
+    uint256 hash = Hash(BEGIN(NUM_KEYS), END(NUM_KEYS));
+    std::vector<unsigned char> vchSig;
+    int i = 0;
+    while (state.KeepRunning()) {
+        vKeys[i].Sign(hash, vchSig);
+        i = (i + 1) % NUM_KEYS;
+    }
+}
+
+static void ECDSAVerify(benchmark::State& state)
+{
+    const SignedHashes& data = GetSignedHashes();
+    int i = 0;
+    while (state.KeepRunning()) {
+        assert(data.vPubKeys[i].Verify(data.vHashes[i], data.vSigs[i]));
+        i = (i + 1) % NUM_KEYS;
+    }
+}
+
+static void ECDSAVerifyOpenSSL(benchmark::State& state)
+{
+    const SignedHashes& data = GetSignedHashes();
+    int i = 0;
+    while (state.KeepRunning()) {
+        assert(VerifyOpenSSL(data.vPubKeys[i], data.vHashes[i], data.vSigs[i]));
+        i = (i + 1) % NUM_KEYS;
+    }
+}
+
+static void ECDSARecoverCompact(benchmark::State& state)
+{
+    const SignedHashes& data = GetSignedHashes();
+    int i = 0;
+    while (state.KeepRunning()) {
+        CPubKey pubkey;
+        assert(pubkey.RecoverCompact(data.vHashes[i], data.vCompactSigs[i]));
+        i = (i + 1) % NUM_KEYS;
+    }
+}
+
+BENCHMARK(ECDSASign);
+BENCHMARK(ECDSAVerify);
+BENCHMARK(ECDSAVerifyOpenSSL);
+BENCHMARK(ECDSARecoverCompact);
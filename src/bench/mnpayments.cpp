@@ -0,0 +1,74 @@
+// Copyright (c) 2018-2019 The DAPS Project developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include "bench.h"
+
+#include "masternode-payments.h"
+#include "random.h"
+
+#include <assert.h>
+#include <vector>
+
+// A network of this size pays each masternode about once per NUM_MASTERNODES blocks
+static const int NUM_MASTERNODES = 5000;
+static const int NUM_BLOCKS = NUM_MASTERNODES * 5 / 4;
+
+struct SyntheticPayments {
+    CMasternodePayments payments;
+    std::vector<std::vector<unsigned char> > vPayees;
+
+    SyntheticPayments()
+    {
+        seed_insecure_rand(true);
+        for (int i = 0; i < NUM_MASTERNODES; i++) {
+            std::string str = strprintf("masternode-%d", i);
+            vPayees.push_back(std::vector<unsigned char>(str.begin(), str.end()));
+        }
+        // One to three votes for the winner of each block, a stray vote for someone else now and then
+        for (int nHeight = 1; nHeight <= NUM_BLOCKS; nHeight++) {
+            const std::vector<unsigned char>& winner = vPayees[insecure_rand() % NUM_MASTERNODES];
+            int nVotes = 1 + insecure_rand() % 3;
+            for (int i = 0; i < nVotes; i++)
+                payments.AddPayeeVote(nHeight, winner);
+            if (insecure_rand() % 4 == 0)
+                payments.AddPayeeVote(nHeight, vPayees[insecure_rand() % NUM_MASTERNODES]);
+        }
+    }
+};
+
+static SyntheticPayments& GetSyntheticPayments()
+{
+    static SyntheticPayments data;
+    return data;
+}
+
+// What GetLastPaid did before the paid index: walk the window from the newest block down
+static void MasternodeLastPaidScan(benchmark::State& state)
+{
+    SyntheticPayments& data = GetSyntheticPayments();
+    int i = 0;
+    while (state.KeepRunning()) {
+        int nLastPaid = 0;
+        for (int nHeight = NUM_BLOCKS; nHeight >= NUM_BLOCKS / 2 && !nLastPaid; nHeight--) {
+            if (data.payments.mapMasternodeBlocks.count(nHeight) && data.payments.mapMasternodeBlocks[nHeight].HasPayeeWithVotes(data.vPayees[i], MNPAYMENTS_PAID_VOTES))
+                nLastPaid = nHeight;
+        }
+        assert(nLastPaid >= 0);
+        i = (i + 1) % NUM_MASTERNODES;
+    }
+}
+
+static void MasternodeLastPaidIndex(benchmark::State& state)
+{
+    SyntheticPayments& data = GetSyntheticPayments();
+    int i = 0;
+    while (state.KeepRunning()) {
+        int nLastPaid = data.payments.GetLastPaidHeight(data.vPayees[i], NUM_BLOCKS / 2, NUM_BLOCKS);
+        assert(nLastPaid >= 0);
+        i = (i + 1) % NUM_MASTERNODES;
+    }
+}
+
+BENCHMARK(MasternodeLastPaidScan);
+BENCHMARK(MasternodeLastPaidIndex);
@@ -0,0 +1,217 @@
+// Copyright (c) 2018-2019 The DAPS Project developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include "blockfilewriter.h"
+
+#include "main.h"
+#include "util.h"
+#include "utiltime.h"
+
+#include <algorithm>
+
+#include <boost/bind.hpp>
+#include <boost/foreach.hpp>
+
+CBlockFileWriter blockFileWriter;
+
+namespace
+{
+struct CompareByFile {
+    template <typename T>
+    bool operator()(const T& a, const T& b) const
+    {
+        if (a->type != b->type)
+            return a->type < b->type;
+        return a->pos.nFile < b->pos.nFile;
+    }
+};
+}
+
+CBlockFileWriter::CBlockFileWriter() : pthread(NULL), fStop(false), fBusy(false), fError(false), nMaxQueueBytes(0), nQueuedBytes(0)
+{
+}
+
+CBlockFileWriter::~CBlockFileWriter()
+{
+    Stop();
+}
+
+void CBlockFileWriter::Start(size_t nMaxQueueBytesIn)
+{
+    boost::unique_lock<boost::mutex> lock(mutex);
+    if (pthread)
+        return;
+    fStop = false;
+    nMaxQueueBytes = nMaxQueueBytesIn;
+    pthread = new boost::thread(boost::bind(&CBlockFileWriter::ThreadWriter, this));
+}
+
+void CBlockFileWriter::Stop()
+{
+    Flush();
+    boost::thread* pthreadStop = NULL;
+    {
+        boost::unique_lock<boost::mutex> lock(mutex);
+        fStop = true;
+        std::swap(pthreadStop, pthread);
+        condWork.notify_all();
+        condDone.notify_all();
+    }
+    if (pthreadStop) {
+        pthreadStop->join();
+        delete pthreadStop;
+    }
+}
+
+bool CBlockFileWriter::WriteRecord(FILE* file, const CPendingWrite& write)
+{
+    if (fseek(file, write.pos.nPos, SEEK_SET))
+        return error("%s : unable to seek to position %u", __func__, write.pos.nPos);
+    if (!write.vch.empty() && fwrite(&write.vch[0], 1, write.vch.size(), file) != write.vch.size())
+        return error("%s : write of %u bytes failed", __func__, write.vch.size());
+    return true;
+}
+
+FILE* CBlockFileWriter::GetFile(const FileKey& key)
+{
+    std::map<FileKey, FILE*>::iterator it = mapFiles.find(key);
+    if (it != mapFiles.end())
+        return it->second;
+    CDiskBlockPos pos(key.second, 0);
+    FILE* file = key.first == BLOCK_FILE ? OpenBlockFile(pos) : OpenUndoFile(pos);
+    if (file)
+        mapFiles[key] = file;
+    return file;
+}
+
+bool CBlockFileWriter::Write(FileType type, const CDiskBlockPos& pos, std::vector<char>& vch)
+{
+    boost::shared_ptr<CPendingWrite> write(new CPendingWrite());
+    write->type = type;
+    write->pos = pos;
+    write->vch.swap(vch);
+
+    boost::unique_lock<boost::mutex> lock(mutex);
+    if (!pthread) {
+        // No writer thread: behave like the historical synchronous write
+        FILE* file = type == BLOCK_FILE ? OpenBlockFile(pos) : OpenUndoFile(pos);
+        if (!file)
+            return error("%s : unable to open file %d", __func__, pos.nFile);
+        bool fOk = WriteRecord(file, *write);
+        fclose(file);
+        return fOk;
+    }
+
+    // Bound the amount of serialized data waiting on the disk
+    while (!fStop && !fError && !queue.empty() && nQueuedBytes + write->vch.size() > nMaxQueueBytes)
+        condDone.wait(lock);
+    if (fError)
+        return error("%s : an earlier block file write failed", __func__);
+
+    nQueuedBytes += write->vch.size();
+    mapPending[std::make_pair((int)type, pos.nFile)][pos.nPos] = write;
+    queue.push_back(write);
+    condWork.notify_one();
+    return true;
+}
+
+bool CBlockFileWriter::ReadPending(FileType type, const CDiskBlockPos& pos, CDataStream& ss)
+{
+    boost::unique_lock<boost::mutex> lock(mutex);
+    std::map<FileKey, PendingMap>::const_iterator mi = mapPending.find(std::make_pair((int)type, pos.nFile));
+    if (mi == mapPending.end())
+        return false;
+    PendingMap::const_iterator it = mi->second.upper_bound(pos.nPos);
+    if (it == mi->second.begin())
+        return false;
+    --it;
+    const CPendingWrite& write = *it->second;
+    if (pos.nPos >= write.pos.nPos + write.vch.size())
+        return false;
+    ss.write(&write.vch[pos.nPos - write.pos.nPos], write.vch.size() - (pos.nPos - write.pos.nPos));
+    return true;
+}
+
+bool CBlockFileWriter::Flush()
+{
+    boost::unique_lock<boost::mutex> lock(mutex);
+    while (pthread && (!queue.empty() || fBusy))
+        condDone.wait(lock);
+
+    // The writer is idle and cannot pick up new work while we hold the lock
+    BOOST_FOREACH (const FileKey& key, setDirty) {
+        FILE* file = GetFile(key);
+        if (file)
+            FileCommit(file);
+    }
+    setDirty.clear();
+    for (std::map<FileKey, FILE*>::iterator it = mapFiles.begin(); it != mapFiles.end(); ++it)
+        fclose(it->second);
+    mapFiles.clear();
+    return !fError;
+}
+
+void CBlockFileWriter::ThreadWriter()
+{
+    RenameThread("dapscoin-blkwriter");
+
+    std::vector<boost::shared_ptr<CPendingWrite> > vBatch;
+    while (true) {
+        {
+            boost::unique_lock<boost::mutex> lock(mutex);
+            while (!fStop && queue.empty())
+                condWork.wait(lock);
+            if (queue.empty())
+                return;
+            vBatch.assign(queue.begin(), queue.end());
+            queue.clear();
+            fBusy = true;
+        }
+
+        // Group by file, keeping the queue order within each file
+        int64_t nTimeStart = GetTimeMicros();
+        std::stable_sort(vBatch.begin(), vBatch.end(), CompareByFile());
+        bool fOk = true;
+        size_t nBytes = 0;
+        FILE* file = NULL;
+        for (size_t i = 0; i < vBatch.size(); i++) {
+            const CPendingWrite& write = *vBatch[i];
+            if (i == 0 || CompareByFile()(vBatch[i - 1], vBatch[i])) {
+                if (file)
+                    fflush(file);
+                file = GetFile(std::make_pair((int)write.type, write.pos.nFile));
+            }
+            if (!file || !WriteRecord(file, write)) {
+                LogPrintf("%s : failed to write %s data to file %d\n", __func__,
+                    write.type == BLOCK_FILE ? "block" : "undo", write.pos.nFile);
+                fOk = false;
+            }
+            nBytes += write.vch.size();
+        }
+        if (file)
+            fflush(file);
+        LogPrint("bench", "    - Block file writer: %u records, %.2fKiB in %.2fms\n", vBatch.size(),
+            nBytes / 1024.0, 0.001 * (GetTimeMicros() - nTimeStart));
+
+        {
+            boost::unique_lock<boost::mutex> lock(mutex);
+            BOOST_FOREACH (const boost::shared_ptr<CPendingWrite>& write, vBatch) {
+                FileKey key = std::make_pair((int)write->type, write->pos.nFile);
+                std::map<FileKey, PendingMap>::iterator mi = mapPending.find(key);
+                if (mi != mapPending.end()) {
+                    mi->second.erase(write->pos.nPos);
+                    if (mi->second.empty())
+                        mapPending.erase(mi);
+                }
+                setDirty.insert(key);
+                nQueuedBytes -= write->vch.size();
+            }
+            if (!fOk)
+                fError = true;
+            fBusy = false;
+            condDone.notify_all();
+        }
+        vBatch.clear();
+    }
+}
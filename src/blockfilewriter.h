@@ -0,0 +1,110 @@
+// Copyright (c) 2018-2019 The DAPS Project developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#ifndef BITCOIN_BLOCKFILEWRITER_H
+#define BITCOIN_BLOCKFILEWRITER_H
+
+#include "chain.h"
+#include "streams.h"
+
+#include <deque>
+#include <map>
+#include <set>
+#include <stdio.h>
+#include <vector>
+
+#include <boost/shared_ptr.hpp>
+#include <boost/thread/condition_variable.hpp>
+#include <boost/thread/mutex.hpp>
+#include <boost/thread/thread.hpp>
+
+/** Default for -blockwritequeue, the maximum amount of queued block/undo data in megabytes */
+static const unsigned int DEFAULT_BLOCK_WRITE_QUEUE = 32;
+
+/**
+ * Background writer for the blk?????.dat and rev?????.dat files.
+ *
+ * The validation thread still reserves space with FindBlockPos/FindUndoPos,
+ * but instead of writing under cs_main it serializes the record and queues
+ * it here. The writer thread takes everything queued so far, groups it per
+ * file so each file is opened and flushed once per batch, and writes it out.
+ *
+ * Records stay readable from memory until they reached the OS, so readers
+ * going through ReadPending never see a hole. Flush() waits for the queue
+ * to drain and fsyncs every file written since the previous call; it must
+ * run before the block index is written, which keeps the on-disk ordering
+ * guarantees of FlushStateToDisk unchanged.
+ *
+ * When the thread is not running (unit tests, -blockwritequeue=0) every
+ * Write is performed synchronously, exactly as before.
+ */
+class CBlockFileWriter
+{
+public:
+    enum FileType {
+        BLOCK_FILE = 0,
+        UNDO_FILE = 1
+    };
+
+    CBlockFileWriter();
+    ~CBlockFileWriter();
+
+    //! Start the writer thread, queueing at most nMaxQueueBytes before Write blocks
+    void Start(size_t nMaxQueueBytes);
+    //! Write out everything queued and stop the writer thread
+    void Stop();
+
+    /**
+     * Write a serialized record at pos (the start of its message header).
+     * The contents of vch are taken over. Returns false if this or any earlier
+     * background write failed.
+     */
+    bool Write(FileType type, const CDiskBlockPos& pos, std::vector<char>& vch);
+
+    /**
+     * If pos falls inside a record that is still queued, append the bytes from
+     * pos up to the end of that record to ss and return true.
+     */
+    bool ReadPending(FileType type, const CDiskBlockPos& pos, CDataStream& ss);
+
+    //! Wait for all queued records to be written and fsync the files they touched
+    bool Flush();
+
+private:
+    struct CPendingWrite {
+        FileType type;
+        CDiskBlockPos pos;
+        std::vector<char> vch;
+    };
+    typedef std::pair<int, int> FileKey;
+    typedef std::map<unsigned int, boost::shared_ptr<CPendingWrite> > PendingMap;
+
+    boost::mutex mutex;
+    //! Writer thread waits on this for work
+    boost::condition_variable condWork;
+    //! Producers wait on this for queue space and for batches to complete
+    boost::condition_variable condDone;
+
+    boost::thread* pthread;
+    bool fStop;
+    bool fBusy;
+    bool fError;
+    size_t nMaxQueueBytes;
+    size_t nQueuedBytes;
+
+    std::deque<boost::shared_ptr<CPendingWrite> > queue;
+    std::map<FileKey, PendingMap> mapPending;
+    //! Open handles, only touched by the writer thread or while it is idle
+    std::map<FileKey, FILE*> mapFiles;
+    //! Files written since the last Flush
+    std::set<FileKey> setDirty;
+
+    void ThreadWriter();
+    FILE* GetFile(const FileKey& key);
+    static bool WriteRecord(FILE* file, const CPendingWrite& write);
+};
+
+extern CBlockFileWriter blockFileWriter;
+
+#endif // BITCOIN_BLOCKFILEWRITER_H
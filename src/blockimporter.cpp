@@ -0,0 +1,383 @@
+// Copyright (c) 2018-2019 The DAPS Project developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include "blockimporter.h"
+
+#include "chainparams.h"
+#include "clientversion.h"
+#include "crypto/common.h"
+#include "main.h"
+#include "protocol.h"
+#include "streams.h"
+#include "sync.h"
+#include "util.h"
+#include "utiltime.h"
+
+#include <algorithm>
+#include <deque>
+
+#include <boost/bind.hpp>
+#include <boost/filesystem/operations.hpp>
+#include <boost/interprocess/file_mapping.hpp>
+#include <boost/interprocess/mapped_region.hpp>
+#include <boost/shared_ptr.hpp>
+#include <boost/thread/condition_variable.hpp>
+#include <boost/thread/mutex.hpp>
+#include <boost/thread/thread.hpp>
+
+static CCriticalSection cs_importProgress;
+static bool fImportProgress = false;
+static CImportProgress importProgress;
+
+void StartImportProgress(int nFiles)
+{
+    LOCK(cs_importProgress);
+    fImportProgress = true;
+    importProgress = CImportProgress();
+    importProgress.nFiles = nFiles;
+}
+
+void StopImportProgress()
+{
+    LOCK(cs_importProgress);
+    fImportProgress = false;
+}
+
+bool GetImportProgress(CImportProgress& progress)
+{
+    LOCK(cs_importProgress);
+    progress = importProgress;
+    return fImportProgress;
+}
+
+static void StartImportFile(const std::string& strFile, uint64_t nFileSize)
+{
+    LOCK(cs_importProgress);
+    importProgress.strFile = strFile;
+    importProgress.nFilePos = 0;
+    importProgress.nFileSize = nFileSize;
+}
+
+static void UpdateImportFile(uint64_t nFilePos)
+{
+    LOCK(cs_importProgress);
+    importProgress.nFilePos = nFilePos;
+}
+
+static void FinishImportFile()
+{
+    LOCK(cs_importProgress);
+    importProgress.strFile.clear();
+    importProgress.nFilePos = importProgress.nFileSize = 0;
+    importProgress.nFilesDone++;
+}
+
+namespace
+{
+/** A block record found in the mapped file */
+struct CImportedBlock
+{
+    //! Position of the message start in front of the record
+    uint64_t nMagicPos;
+    uint64_t nBlockPos;
+    //! Size from the record header, cut off at the end of the file
+    unsigned int nSize;
+    //! Set under CImportPipeline::mutex once a thread is done with the block
+    bool fDone;
+    //! Whether the block deserialized, nEnd is then where it ended
+    bool fParsed;
+    uint64_t nEnd;
+    //! Whether CheckBlockContextFree passed, all but the coinstake proof
+    bool fContextFree;
+    //! Set by the connecting thread once the coinstake proof went into a batch
+    bool fProofBatched;
+    CBlock block;
+
+    CImportedBlock() : nMagicPos(0), nBlockPos(0), nSize(0), fDone(false), fParsed(false), nEnd(0), fContextFree(false), fProofBatched(false) {}
+};
+
+class CImportPipeline
+{
+public:
+    CImportPipeline(const unsigned char* pbeginIn, uint64_t nFileSizeIn);
+    ~CImportPipeline();
+
+    //! Start the reader and nThreads checking threads and connect the blocks on the calling thread, false on a system error
+    bool Run(int nThreads, CDiskBlockPos* dbp, int& nLoaded);
+
+private:
+    const unsigned char* pbegin;
+    uint64_t nFileSize;
+
+    boost::mutex mutex;
+    boost::condition_variable condReader;
+    boost::condition_variable condWorker;
+    boost::condition_variable condConnector;
+    boost::thread_group threads;
+    bool fStop;
+    bool fReaderDone;
+    //! Records found and not connected yet, in file order
+    std::deque<boost::shared_ptr<CImportedBlock> > queueFound;
+    //! Records no thread has taken yet
+    std::deque<boost::shared_ptr<CImportedBlock> > queueUnchecked;
+    uint64_t nQueuedSize;
+
+    //! First record header from nPos with its message start before nLimit, as LoadExternalBlockFile finds it
+    bool FindRecord(uint64_t nPos, uint64_t nLimit, CImportedBlock& rec) const;
+    bool Parse(CImportedBlock& rec) const;
+    //! Connect the blocks a sequential scan from nPos finds before nLimit
+    bool ScanSequential(uint64_t& nPos, uint64_t nLimit, CDiskBlockPos* dbp, int& nLoaded);
+    //! Verify the coinstake proof of rec and of the checked blocks queued behind it in one batch
+    void BatchStakeProofs(const boost::shared_ptr<CImportedBlock>& rec);
+
+    void ThreadReader();
+    void ThreadWorker();
+};
+
+CImportPipeline::CImportPipeline(const unsigned char* pbeginIn, uint64_t nFileSizeIn) : pbegin(pbeginIn), nFileSize(nFileSizeIn), fStop(false), fReaderDone(false), nQueuedSize(0) {}
+
+CImportPipeline::~CImportPipeline()
+{
+    {
+        boost::unique_lock<boost::mutex> lock(mutex);
+        fStop = true;
+    }
+    condReader.notify_all();
+    condWorker.notify_all();
+    threads.join_all();
+}
+
+bool CImportPipeline::FindRecord(uint64_t nPos, uint64_t nLimit, CImportedBlock& rec) const
+{
+    const unsigned char* pchMessageStart = (const unsigned char*)Params().MessageStart();
+    while (nPos < nLimit) {
+        const unsigned char* pch = (const unsigned char*)memchr(pbegin + nPos, pchMessageStart[0], nLimit - nPos);
+        if (!pch)
+            return false;
+        uint64_t nMagicPos = pch - pbegin;
+        // no valid block header found; don't complain
+        if (nMagicPos + MESSAGE_START_SIZE + sizeof(uint32_t) > nFileSize)
+            return false;
+        nPos = nMagicPos + 1;
+        if (memcmp(pch, pchMessageStart, MESSAGE_START_SIZE))
+            continue;
+        unsigned int nSize = ReadLE32(pch + MESSAGE_START_SIZE);
+        if (nSize < 80 || nSize > MAX_BLOCK_SIZE_CURRENT)
+            continue;
+        rec.nMagicPos = nMagicPos;
+        rec.nBlockPos = nMagicPos + MESSAGE_START_SIZE + sizeof(uint32_t);
+        rec.nSize = std::min((uint64_t)nSize, nFileSize - rec.nBlockPos);
+        return true;
+    }
+    return false;
+}
+
+bool CImportPipeline::Parse(CImportedBlock& rec) const
+{
+    try {
+        CDataStream ss((const char*)pbegin + rec.nBlockPos, (const char*)pbegin + rec.nBlockPos + rec.nSize, SER_DISK, CLIENT_VERSION);
+        ss >> rec.block;
+        rec.nEnd = rec.nBlockPos + rec.nSize - ss.size();
+        return true;
+    } catch (std::exception& e) {
+        LogPrintf("%s : Deserialize or I/O error - %s\n", __func__, e.what());
+    }
+    return false;
+}
+
+bool CImportPipeline::ScanSequential(uint64_t& nPos, uint64_t nLimit, CDiskBlockPos* dbp, int& nLoaded)
+{
+    CImportedBlock rec;
+    while (FindRecord(nPos, nLimit, rec)) {
+        if (!Parse(rec)) {
+            nPos = rec.nMagicPos + 1;
+            continue;
+        }
+        nPos = rec.nEnd;
+        if (dbp)
+            dbp->nPos = rec.nBlockPos;
+        if (!ProcessImportedBlock(rec.block, dbp, nLoaded))
+            return false;
+    }
+    return true;
+}
+
+void CImportPipeline::BatchStakeProofs(const boost::shared_ptr<CImportedBlock>& rec)
+{
+    std::vector<boost::shared_ptr<CImportedBlock> > vBlocks(1, rec);
+    {
+        boost::unique_lock<boost::mutex> lock(mutex);
+        for (size_t i = 0; i < queueFound.size() && vBlocks.size() < MAX_IMPORT_PROOF_BATCH && queueFound[i]->fDone; i++) {
+            const CImportedBlock& next = *queueFound[i];
+            if (next.fContextFree && !next.fProofBatched && next.block.IsProofOfStake())
+                vBlocks.push_back(queueFound[i]);
+        }
+    }
+
+    // The staked outputs are older than the blocks being connected, so they are indexed by now. Proofs that
+    // do not verify in the batch, or whose output is missing, are left to CheckBlock rather than retried here.
+    std::vector<const CTransaction*> vCoinstakes;
+    for (size_t i = 0; i < vBlocks.size(); i++) {
+        vBlocks[i]->fProofBatched = true;
+        vCoinstakes.push_back(&vBlocks[i]->block.vtx[1]);
+    }
+    VerifyShnorrKeyImageTxs(vCoinstakes);
+}
+
+bool CImportPipeline::Run(int nThreads, CDiskBlockPos* dbp, int& nLoaded)
+{
+    threads.create_thread(boost::bind(&CImportPipeline::ThreadReader, this));
+    for (int i = 0; i < nThreads; i++)
+        threads.create_thread(boost::bind(&CImportPipeline::ThreadWorker, this));
+
+    // Where LoadExternalBlockFile would look for the next block header
+    uint64_t nPos = 0;
+    while (true) {
+        boost::shared_ptr<CImportedBlock> rec;
+        {
+            boost::unique_lock<boost::mutex> lock(mutex);
+            while (queueFound.empty() ? !fReaderDone : !queueFound.front()->fDone)
+                condConnector.wait(lock);
+            if (queueFound.empty())
+                break;
+            rec = queueFound.front();
+            queueFound.pop_front();
+            nQueuedSize -= rec->nSize;
+        }
+        condReader.notify_one();
+        boost::this_thread::interruption_point();
+
+        // The reader skips the rest of a record that does not deserialize and the unused end of one that does
+        if (!ScanSequential(nPos, rec->nMagicPos, dbp, nLoaded))
+            return false;
+        if (rec->nMagicPos < nPos)
+            continue;
+        if (!rec->fParsed) {
+            nPos = rec->nMagicPos + 1;
+            continue;
+        }
+        nPos = rec->nEnd;
+        if (dbp)
+            dbp->nPos = rec->nBlockPos;
+        if (rec->fContextFree && rec->block.IsProofOfStake()) {
+            if (!rec->fProofBatched)
+                BatchStakeProofs(rec);
+            // Found in the proof cache after a successful batch; otherwise CheckBlock runs all checks again
+            rec->block.fChecked = VerifyShnorrKeyImageTx(rec->block.vtx[1]);
+        } else if (rec->fContextFree) {
+            rec->block.fChecked = true;
+        }
+        if (!ProcessImportedBlock(rec->block, dbp, nLoaded))
+            return false;
+        UpdateImportFile(nPos);
+    }
+    return ScanSequential(nPos, nFileSize, dbp, nLoaded);
+}
+
+void CImportPipeline::ThreadReader()
+{
+    RenameThread("dapscoin-impread");
+
+    uint64_t nPos = 0;
+    boost::shared_ptr<CImportedBlock> rec(new CImportedBlock());
+    while (FindRecord(nPos, nFileSize, *rec)) {
+        nPos = rec->nBlockPos + rec->nSize;
+        {
+            boost::unique_lock<boost::mutex> lock(mutex);
+            while (!fStop && nQueuedSize >= MAX_IMPORT_QUEUE_SIZE)
+                condReader.wait(lock);
+            if (fStop)
+                return;
+            queueFound.push_back(rec);
+            queueUnchecked.push_back(rec);
+            nQueuedSize += rec->nSize;
+        }
+        condWorker.notify_one();
+        rec.reset(new CImportedBlock());
+    }
+
+    {
+        boost::unique_lock<boost::mutex> lock(mutex);
+        fReaderDone = true;
+    }
+    condWorker.notify_all();
+    condConnector.notify_one();
+}
+
+void CImportPipeline::ThreadWorker()
+{
+    RenameThread("dapscoin-impchk");
+
+    while (true) {
+        std::vector<boost::shared_ptr<CImportedBlock> > vBlocks;
+        {
+            boost::unique_lock<boost::mutex> lock(mutex);
+            while (!fStop && !fReaderDone && queueUnchecked.empty())
+                condWorker.wait(lock);
+            if (fStop || queueUnchecked.empty())
+                break;
+            while (!queueUnchecked.empty() && vBlocks.size() < MAX_IMPORT_BLOCK_BATCH) {
+                vBlocks.push_back(queueUnchecked.front());
+                queueUnchecked.pop_front();
+            }
+        }
+
+        // The connector does not touch the blocks until fDone is set. The coinstake
+        // proofs need the transaction index, the connector verifies them later.
+        for (size_t i = 0; i < vBlocks.size(); i++) {
+            CImportedBlock& rec = *vBlocks[i];
+            rec.fParsed = Parse(rec);
+            // A failure is reported when CheckBlock runs again in ProcessNewBlock
+            CValidationState state;
+            rec.fContextFree = rec.fParsed && CheckBlockContextFree(rec.block, state, true, false);
+        }
+
+        {
+            boost::unique_lock<boost::mutex> lock(mutex);
+            for (size_t i = 0; i < vBlocks.size(); i++)
+                vBlocks[i]->fDone = true;
+        }
+        condConnector.notify_one();
+    }
+}
+} // namespace
+
+bool ImportBlockFile(const boost::filesystem::path& path, int nThreads, CDiskBlockPos* dbp)
+{
+    int64_t nStart = GetTimeMillis();
+    boost::interprocess::file_mapping mapping;
+    boost::interprocess::mapped_region region;
+    if (nThreads > 0) {
+        try {
+            boost::interprocess::file_mapping(path.string().c_str(), boost::interprocess::read_only).swap(mapping);
+            boost::interprocess::mapped_region(mapping, boost::interprocess::read_only).swap(region);
+        } catch (const boost::interprocess::interprocess_exception& e) {
+            LogPrintf("%s: cannot map %s, importing it sequentially - %s\n", __func__, path.string(), e.what());
+            nThreads = 0;
+        }
+    }
+
+    if (nThreads <= 0) {
+        FILE* file = fopen(path.string().c_str(), "rb");
+        if (!file)
+            return error("%s: cannot open %s", __func__, path.string());
+        StartImportFile(path.filename().string(), boost::filesystem::file_size(path));
+        bool fLoaded = LoadExternalBlockFile(file, dbp);
+        FinishImportFile();
+        return fLoaded;
+    }
+
+    StartImportFile(path.filename().string(), region.get_size());
+    int nLoaded = 0;
+    try {
+        CImportPipeline pipeline((const unsigned char*)region.get_address(), region.get_size());
+        pipeline.Run(nThreads, dbp, nLoaded);
+    } catch (std::runtime_error& e) {
+        AbortNode(std::string("System error: ") + e.what());
+    }
+    FinishImportFile();
+    if (nLoaded > 0)
+        LogPrintf("Loaded %i blocks from external file in %dms\n", nLoaded, GetTimeMillis() - nStart);
+    return nLoaded > 0;
+}
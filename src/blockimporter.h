@@ -0,0 +1,69 @@
+// Copyright (c) 2018-2019 The DAPS Project developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#ifndef BITCOIN_BLOCKIMPORTER_H
+#define BITCOIN_BLOCKIMPORTER_H
+
+#include <stdint.h>
+#include <string>
+
+#include <boost/filesystem/path.hpp>
+
+struct CDiskBlockPos;
+
+/** Default for -importthreads, the number of threads deserializing and checking blocks during -reindex and -loadblock */
+static const int DEFAULT_IMPORT_THREADS = 4;
+/** Maximum number of block import threads */
+static const int MAX_IMPORT_THREADS = 16;
+/** Serialized bytes of blocks found ahead of the block being connected */
+static const uint64_t MAX_IMPORT_QUEUE_SIZE = 64 * 1000 * 1000;
+/** Blocks one import thread takes at once */
+static const unsigned int MAX_IMPORT_BLOCK_BATCH = 16;
+/** Coinstake key image proofs the connecting thread verifies in one batch, from the blocks next in line */
+static const unsigned int MAX_IMPORT_PROOF_BATCH = 64;
+
+/** How far -reindex, bootstrap.dat or -loadblock got, reported by getblockchaininfo */
+struct CImportProgress
+{
+    //! File being imported, empty between files
+    std::string strFile;
+    int nFilesDone;
+    //! Files to import in total
+    int nFiles;
+    //! Bytes of the current file handed to validation
+    uint64_t nFilePos;
+    uint64_t nFileSize;
+
+    CImportProgress() : nFilesDone(0), nFiles(0), nFilePos(0), nFileSize(0) {}
+};
+
+/** Start reporting the progress of an import of nFiles files */
+void StartImportProgress(int nFiles);
+/** Stop reporting import progress */
+void StopImportProgress();
+/** Progress of the running import, false if there is none */
+bool GetImportProgress(CImportProgress& progress);
+
+/**
+ * Import the blocks in the file at path, dbp gives the position of a blk
+ * file being reindexed and is NULL for external files.
+ *
+ * LoadExternalBlockFile reads, deserializes and checks one block after the
+ * other on the import thread, so a reindex keeps a single core busy. Here
+ * the file is memory mapped: a reader thread finds the block records, nThreads
+ * threads deserialize them and run CheckBlockContextFree without the coinstake
+ * key image proofs, and the calling thread hands the blocks to ProcessNewBlock
+ * in file order. A proof needs the staked output from the transaction index,
+ * which a reindex only builds as blocks are connected, so the calling thread
+ * verifies the proofs of the blocks next in line in one batch, just behind the
+ * tip where their staked outputs are indexed. Where a record does not
+ * deserialize the calling thread scans on from the byte after its header, as
+ * LoadExternalBlockFile does, so the same blocks are imported.
+ *
+ * Falls back to LoadExternalBlockFile if nThreads is 0 or the file cannot be
+ * mapped. Returns whether any block was loaded.
+ */
+bool ImportBlockFile(const boost::filesystem::path& path, int nThreads, CDiskBlockPos* dbp = NULL);
+
+#endif // BITCOIN_BLOCKIMPORTER_H
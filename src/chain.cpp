@@ -7,6 +7,34 @@
 
 using namespace std;
 
+CBlockIndexArena blockIndexArena;
+
+/**
+ * CBlockIndexArena implementation
+ */
+void* CBlockIndexArena::Allocate(size_t nSize)
+{
+    nSize = (nSize + ALIGNMENT - 1) & ~(ALIGNMENT - 1);
+    assert(nSize <= CHUNK_SIZE);
+    if (nChunkUsed + nSize > CHUNK_SIZE) {
+        vChunks.push_back(new char[CHUNK_SIZE]);
+        nChunkUsed = 0;
+    }
+    void* p = vChunks.back() + nChunkUsed;
+    nChunkUsed += nSize;
+    nAllocated += nSize;
+    return p;
+}
+
+void CBlockIndexArena::Clear()
+{
+    BOOST_FOREACH (char* pchunk, vChunks)
+        delete[] pchunk;
+    vChunks.clear();
+    nChunkUsed = CHUNK_SIZE;
+    nAllocated = 0;
+}
+
 /**
  * CChain implementation
  */
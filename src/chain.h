@@ -14,6 +14,7 @@
 #include "uint256.h"
 #include "util.h"
 
+#include <new>
 #include <vector>
 
 #include <boost/foreach.hpp>
@@ -100,6 +101,65 @@ enum BlockStatus {
     BLOCK_FAILED_MASK = BLOCK_FAILED_VALID | BLOCK_FAILED_CHILD,
 };
 
+/**
+ * Chunked bump allocator for objects that live as long as mapBlockIndex.
+ * Block index entries are never freed individually, so instead of one heap
+ * allocation (plus malloc bookkeeping) per entry they are carved out of large
+ * chunks which are released together. Destructors are not run, so only
+ * trivially destructible types may be allocated here. Callers hold cs_main.
+ */
+class CBlockIndexArena
+{
+public:
+    CBlockIndexArena() : nChunkUsed(CHUNK_SIZE), nAllocated(0) {}
+    ~CBlockIndexArena() { Clear(); }
+
+    template <typename T>
+    T* New()
+    {
+        return new (Allocate(sizeof(T))) T();
+    }
+
+    template <typename T, typename A>
+    T* New(const A& arg)
+    {
+        return new (Allocate(sizeof(T))) T(arg);
+    }
+
+    //! Release every chunk; all objects handed out become invalid
+    void Clear();
+
+    //! Bytes handed out so far
+    size_t GetAllocated() const { return nAllocated; }
+    //! Bytes reserved from the system
+    size_t GetReserved() const { return vChunks.size() * CHUNK_SIZE; }
+
+private:
+    static const size_t CHUNK_SIZE = 1 << 20;
+    static const size_t ALIGNMENT = 16;
+
+    std::vector<char*> vChunks;
+    size_t nChunkUsed;
+    size_t nAllocated;
+
+    CBlockIndexArena(const CBlockIndexArena&);
+    CBlockIndexArena& operator=(const CBlockIndexArena&);
+
+    void* Allocate(size_t nSize);
+};
+
+extern CBlockIndexArena blockIndexArena;
+
+/**
+ * PoA header fields. Only proof-of-audit blocks carry them, so they are kept
+ * out of line instead of costing every CBlockIndex three hashes.
+ */
+struct CBlockIndexPoAHeader {
+    uint256 hashPoAMerkleRoot;
+    uint256 minedHash;
+    uint256 hashPrevPoABlock;
+};
+
 /** The block chain is a tree shaped structure starting with the
  * genesis block at the root, with each block potentially having multiple
  * candidates to be the next block. A blockindex may have multiple pprev pointing
@@ -176,14 +236,25 @@ public:
     unsigned int nNonce;
     uint256 nAccumulatorCheckpoint;
 
-    //! PoA block header
-    uint256 hashPoAMerkleRoot;
-    uint256 minedHash;
-    uint256 hashPrevPoABlock;
+    //! PoA block header, NULL unless this is a PoA block (owned by blockIndexArena)
+    CBlockIndexPoAHeader* pPoAHeader;
 
     //! (memory only) Sequential id assigned to distinguish order in which blocks are received.
     uint32_t nSequenceId;
-    
+
+    uint256 GetPoAMerkleRoot() const { return pPoAHeader ? pPoAHeader->hashPoAMerkleRoot : uint256(); }
+    uint256 GetMinedHash() const { return pPoAHeader ? pPoAHeader->minedHash : uint256(); }
+    uint256 GetPrevPoABlockHash() const { return pPoAHeader ? pPoAHeader->hashPrevPoABlock : uint256(); }
+
+    void SetPoAHeader(const uint256& hashPoAMerkleRootIn, const uint256& minedHashIn, const uint256& hashPrevPoABlockIn)
+    {
+        if (!pPoAHeader)
+            pPoAHeader = blockIndexArena.New<CBlockIndexPoAHeader>();
+        pPoAHeader->hashPoAMerkleRoot = hashPoAMerkleRootIn;
+        pPoAHeader->minedHash = minedHashIn;
+        pPoAHeader->hashPrevPoABlock = hashPrevPoABlockIn;
+    }
+
     void SetNull()
     {
         phashBlock = NULL;
@@ -214,9 +285,7 @@ public:
         nNonce = 0;
         nAccumulatorCheckpoint = 0;
 
-        hashPoAMerkleRoot = uint256();
-        minedHash = uint256();
-        hashPrevPoABlock = uint256();
+        pPoAHeader = NULL;
     }
 
     CBlockIndex()
@@ -247,9 +316,7 @@ public:
 
         if (block.IsProofOfAudit()) {
             SetProofOfAudit();
-            hashPrevPoABlock = block.hashPrevPoABlock;
-            minedHash = block.minedHash;
-            hashPoAMerkleRoot = block.hashPoAMerkleRoot;
+            SetPoAHeader(block.hashPoAMerkleRoot, block.minedHash, block.hashPrevPoABlock);
             prevoutStake.SetNull();
             nStakeTime = 0;
         } else if (block.IsProofOfStake()) {
@@ -288,10 +355,10 @@ public:
         CBlockHeader block;
         block.nVersion = nVersion;
         if (IsProofOfAudit()) {
-            block.hashPoAMerkleRoot = hashPoAMerkleRoot;
-            block.minedHash = minedHash;
-            block.hashPrevPoABlock = hashPrevPoABlock;
-        }  
+            block.hashPoAMerkleRoot = GetPoAMerkleRoot();
+            block.minedHash = GetMinedHash();
+            block.hashPrevPoABlock = GetPrevPoABlockHash();
+        }
         if (pprev)
             block.hashPrevBlock = pprev->GetBlockHash();
         block.hashMerkleRoot = hashMerkleRoot;
@@ -434,6 +501,11 @@ public:
     uint256 hashPrev;
     uint256 hashNext;
 
+    //! PoA block header, stored inline in the on-disk record
+    uint256 hashPoAMerkleRoot;
+    uint256 minedHash;
+    uint256 hashPrevPoABlock;
+
     CDiskBlockIndex()
     {
         hashPrev = uint256();
@@ -444,9 +516,9 @@ public:
     {
         hashPrev = (pprev ? pprev->GetBlockHash() : uint256(0));
         if (IsProofOfAudit()) {
-			hashPoAMerkleRoot = pindex->hashPoAMerkleRoot;
-			minedHash = pindex->minedHash;
-			hashPrevPoABlock = pindex->hashPrevPoABlock;
+            hashPoAMerkleRoot = pindex->GetPoAMerkleRoot();
+            minedHash = pindex->GetMinedHash();
+            hashPrevPoABlock = pindex->GetPrevPoABlockHash();
         }
     }
 
@@ -82,6 +82,10 @@ static const Checkpoints::CCheckpointData dataTestnet = {
     0,
     0};
 
+// Published UTXO snapshots: (height, hash printed by dumptxoutset)
+static const MapSnapshots mapSnapshots;
+static const MapSnapshots mapSnapshotsTestnet;
+
 static Checkpoints::MapCheckpoints mapCheckpointsRegtest =
     boost::assign::map_list_of(0, uint256("0x519fc91c13da2eb1301e87ebb7db993f15b57fb1fd7f3e172411bf4262c2efdb"));
 static const Checkpoints::CCheckpointData dataRegtest = {
@@ -231,6 +235,11 @@ public:
     {
         return data;
     }
+
+    const MapSnapshots& Snapshots() const
+    {
+        return mapSnapshots;
+    }
 };
 static CMainParams mainParams;
 
@@ -341,6 +350,11 @@ public:
     {
         return dataTestnet;
     }
+
+    const MapSnapshots& Snapshots() const
+    {
+        return mapSnapshotsTestnet;
+    }
 };
 static CTestNetParams testNetParams;
 
@@ -15,9 +15,11 @@
 #include "protocol.h"
 #include "uint256.h"
 
+#include <map>
 #include <vector>
 
 typedef unsigned char MessageStartChars[MESSAGE_START_SIZE];
+typedef std::map<int, uint256> MapSnapshots;
 
 struct CDNSSeedData {
     std::string name, host;
@@ -89,6 +91,8 @@ public:
     const std::vector<unsigned char>& Base58Prefix(Base58Type type) const { return base58Prefixes[type]; }
     const std::vector<CAddress>& FixedSeeds() const { return vFixedSeeds; }
     virtual const Checkpoints::CCheckpointData& Checkpoints() const = 0;
+    /** Hashes of the dumptxoutset snapshots -loadtxoutset accepts, by height; regtest takes any snapshot */
+    virtual const MapSnapshots& Snapshots() const = 0;
     int PoolMaxTransactions() const { return nPoolMaxTransactions; }
     std::string ObfuscationPoolDummyAddress() const { return strObfuscationPoolDummyAddress; }
     int64_t StartMasternodePayments() const { return nStartMasternodePayments; }
@@ -64,8 +64,10 @@ bool CCoins::Spend(int nPos)
 bool CCoinsView::GetCoins(const uint256& txid, CCoins& coins) const { return false; }
 bool CCoinsView::HaveCoins(const uint256& txid) const { return false; }
 uint256 CCoinsView::GetBestBlock() const { return uint256(0); }
-bool CCoinsView::BatchWrite(CCoinsMap& mapCoins, const uint256& hashBlock) { return false; }
+bool CCoinsView::BatchWrite(CCoinsMap& mapCoins, const uint256& hashBlock, const CUtxoStats& statsDelta) { return false; }
 bool CCoinsView::GetStats(CCoinsStats& stats) const { return false; }
+bool CCoinsView::ForEachCoins(const boost::function<bool(const uint256&, const CCoins&)>& fn) const { return false; }
+CCoinsViewCursor* CCoinsView::Cursor() const { return NULL; }
 
 
 CCoinsViewBacked::CCoinsViewBacked(CCoinsView* viewIn) : base(viewIn) {}
@@ -73,8 +75,10 @@ bool CCoinsViewBacked::GetCoins(const uint256& txid, CCoins& coins) const { retu
 bool CCoinsViewBacked::HaveCoins(const uint256& txid) const { return base->HaveCoins(txid); }
 uint256 CCoinsViewBacked::GetBestBlock() const { return base->GetBestBlock(); }
 void CCoinsViewBacked::SetBackend(CCoinsView& viewIn) { base = &viewIn; }
-bool CCoinsViewBacked::BatchWrite(CCoinsMap& mapCoins, const uint256& hashBlock) { return base->BatchWrite(mapCoins, hashBlock); }
+bool CCoinsViewBacked::BatchWrite(CCoinsMap& mapCoins, const uint256& hashBlock, const CUtxoStats& statsDelta) { return base->BatchWrite(mapCoins, hashBlock, statsDelta); }
 bool CCoinsViewBacked::GetStats(CCoinsStats& stats) const { return base->GetStats(stats); }
+bool CCoinsViewBacked::ForEachCoins(const boost::function<bool(const uint256&, const CCoins&)>& fn) const { return base->ForEachCoins(fn); }
+CCoinsViewCursor* CCoinsViewBacked::Cursor() const { return base->Cursor(); }
 
 CCoinsKeyHasher::CCoinsKeyHasher() : salt(GetRandHash()) {}
 
@@ -164,7 +168,7 @@ void CCoinsViewCache::SetBestBlock(const uint256& hashBlockIn)
     hashBlock = hashBlockIn;
 }
 
-bool CCoinsViewCache::BatchWrite(CCoinsMap& mapCoins, const uint256& hashBlockIn)
+bool CCoinsViewCache::BatchWrite(CCoinsMap& mapCoins, const uint256& hashBlockIn, const CUtxoStats& statsDeltaIn)
 {
     assert(!hasModifier);
     for (CCoinsMap::iterator it = mapCoins.begin(); it != mapCoins.end();) {
@@ -198,13 +202,29 @@ bool CCoinsViewCache::BatchWrite(CCoinsMap& mapCoins, const uint256& hashBlockIn
         mapCoins.erase(itOld);
     }
     hashBlock = hashBlockIn;
+    statsDelta += statsDeltaIn;
     return true;
 }
 
+bool CCoinsViewCache::GetStats(CCoinsStats& stats) const
+{
+    if (!base->GetStats(stats))
+        return false;
+    stats.hashBlock = GetBestBlock();
+    stats.utxo += statsDelta;
+    return true;
+}
+
+void CCoinsViewCache::AddStatsDelta(const CUtxoStats& delta)
+{
+    statsDelta += delta;
+}
+
 bool CCoinsViewCache::Flush()
 {
-    bool fOk = base->BatchWrite(cacheCoins, hashBlock);
+    bool fOk = base->BatchWrite(cacheCoins, hashBlock, statsDelta);
     cacheCoins.clear();
+    statsDelta.SetNull();
     return fOk;
 }
 
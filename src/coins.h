@@ -11,11 +11,13 @@
 #include "serialize.h"
 #include "uint256.h"
 #include "undo.h"
+#include "utxostats.h"
 
 #include <assert.h>
 #include <stdint.h>
 
 #include <boost/foreach.hpp>
+#include <boost/function.hpp>
 #include <boost/unordered_map.hpp>
 
 extern bool GetTransaction(const uint256& hash, CTransaction& tx, uint256& hashBlock, bool fAllowSlow);
@@ -323,16 +325,31 @@ typedef boost::unordered_map<uint256, CCoinsCacheEntry, CCoinsKeyHasher> CCoinsM
 struct CCoinsStats {
     int nHeight;
     uint256 hashBlock;
-    uint64_t nTransactions;
-    uint64_t nTransactionOutputs;
-    uint64_t nSerializedSize;
-    uint256 hashSerialized;
-    CAmount nTotalAmount;
+    CUtxoStats utxo;
 
-    CCoinsStats() : nHeight(0), hashBlock(0), nTransactions(0), nTransactionOutputs(0), nSerializedSize(0), hashSerialized(0), nTotalAmount(0) {}
+    CCoinsStats() : nHeight(0), hashBlock(0) {}
 };
 
 
+/** Walks the coins of a view as they were when the cursor was created, returned by CCoinsView::Cursor */
+class CCoinsViewCursor
+{
+public:
+    CCoinsViewCursor(const uint256& hashBlockIn) : hashBlock(hashBlockIn) {}
+    virtual ~CCoinsViewCursor() {}
+
+    virtual bool GetKey(uint256& txid) const = 0;
+    virtual bool GetValue(CCoins& coins) const = 0;
+    virtual bool Valid() const = 0;
+    virtual void Next() = 0;
+
+    //! Best block of the coins the cursor walks
+    const uint256& GetBestBlock() const { return hashBlock; }
+
+private:
+    uint256 hashBlock;
+};
+
 /** Abstract view on the open txout dataset. */
 class CCoinsView
 {
@@ -347,13 +364,20 @@ public:
     //! Retrieve the block hash whose state this CCoinsView currently represents
     virtual uint256 GetBestBlock() const;
 
-    //! Do a bulk modification (multiple CCoins changes + BestBlock change).
-    //! The passed mapCoins can be modified.
-    virtual bool BatchWrite(CCoinsMap& mapCoins, const uint256& hashBlock);
+    //! Do a bulk modification (multiple CCoins changes + BestBlock change + the
+    //! changes to the UTXO statistics they make). The passed mapCoins can be modified.
+    virtual bool BatchWrite(CCoinsMap& mapCoins, const uint256& hashBlock, const CUtxoStats& statsDelta);
 
-    //! Calculate statistics about the unspent transaction output set
+    //! Statistics about the unspent transaction output set as of the best block, nHeight is left to the caller
     virtual bool GetStats(CCoinsStats& stats) const;
 
+    //! Call fn for every txid and its coins as of the call; false if the view cannot be walked or fn returned false
+    virtual bool ForEachCoins(const boost::function<bool(const uint256&, const CCoins&)>& fn) const;
+
+    //! Cursor over the coins as of the call, which can be walked after the locks held to create it are released;
+    //! NULL if the view cannot be walked. Changes still in caches above the database are not included
+    virtual CCoinsViewCursor* Cursor() const;
+
     //! As we use CCoinsViews polymorphically, have a virtual destructor
     virtual ~CCoinsView() {}
 };
@@ -371,8 +395,10 @@ public:
     bool HaveCoins(const uint256& txid) const;
     uint256 GetBestBlock() const;
     void SetBackend(CCoinsView& viewIn);
-    bool BatchWrite(CCoinsMap& mapCoins, const uint256& hashBlock);
+    bool BatchWrite(CCoinsMap& mapCoins, const uint256& hashBlock, const CUtxoStats& statsDelta);
     bool GetStats(CCoinsStats& stats) const;
+    bool ForEachCoins(const boost::function<bool(const uint256&, const CCoins&)>& fn) const;
+    CCoinsViewCursor* Cursor() const;
 };
 
 class CCoinsViewCache;
@@ -423,6 +449,9 @@ protected:
     mutable uint256 hashBlock;
     mutable CCoinsMap cacheCoins;
 
+    //! Changes to the UTXO statistics not yet handed to the base
+    CUtxoStats statsDelta;
+
 public:
     CCoinsViewCache(CCoinsView* baseIn);
     ~CCoinsViewCache();
@@ -432,7 +461,11 @@ public:
     bool HaveCoins(const uint256& txid) const;
     uint256 GetBestBlock() const;
     void SetBestBlock(const uint256& hashBlock);
-    bool BatchWrite(CCoinsMap& mapCoins, const uint256& hashBlock);
+    bool BatchWrite(CCoinsMap& mapCoins, const uint256& hashBlock, const CUtxoStats& statsDelta);
+    bool GetStats(CCoinsStats& stats) const;
+
+    //! Record the changes a connected or disconnected block made to the UTXO statistics
+    void AddStatsDelta(const CUtxoStats& delta);
 
     /**
      * Return a pointer to CCoins in the cache, or NULL if not found. This is
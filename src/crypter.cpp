@@ -208,6 +208,7 @@ bool CCryptoKeyStore::Lock()
     {
         LOCK(cs_KeyStore);
         vMasterKey.clear();
+        mapDecryptedKeys.clear();
     }
 
     NotifyStatusChanged(this);
@@ -291,6 +292,7 @@ bool CCryptoKeyStore::AddKeyPubKey(const CKey& key, const CPubKey& pubkey)
 
         if (!AddCryptedKey(pubkey, vchCryptedSecret))
             return false;
+        mapDecryptedKeys[pubkey.GetID()] = key;
     }
     return true;
 }
@@ -315,6 +317,14 @@ bool CCryptoKeyStore::GetKey(const CKeyID& address, CKey& keyOut) const
         if (!IsCrypted())
             return CBasicKeyStore::GetKey(address, keyOut);
 
+        if (vMasterKey.empty())
+            return false;
+        DecryptedKeyMap::const_iterator di = mapDecryptedKeys.find(address);
+        if (di != mapDecryptedKeys.end()) {
+            keyOut = di->second;
+            return true;
+        }
+
         CryptedKeyMap::const_iterator mi = mapCryptedKeys.find(address);
         if (mi != mapCryptedKeys.end()) {
             const CPubKey& vchPubKey = (*mi).second.first;
@@ -325,6 +335,7 @@ bool CCryptoKeyStore::GetKey(const CKeyID& address, CKey& keyOut) const
             if (vchSecret.size() != 32)
                 return false;
             keyOut.Set(vchSecret.begin(), vchSecret.end(), vchPubKey.IsCompressed());
+            mapDecryptedKeys[address] = keyOut;
             return true;
         }
     }
@@ -126,6 +126,11 @@ private:
 
     CKeyingMaterial vMasterKey;
 
+    //! Keys decrypted since the last Unlock, so GetKey runs AES once per key and session.
+    //! The map nodes come from locked pages and are wiped when freed, Lock() clears the map.
+    typedef std::map<CKeyID, CKey, std::less<CKeyID>, secure_allocator<std::pair<const CKeyID, CKey> > > DecryptedKeyMap;
+    mutable DecryptedKeyMap mapDecryptedKeys;
+
     //! if fUseCrypto is true, mapKeys must be empty
     //! if fUseCrypto is false, vMasterKey must be empty
     bool fUseCrypto;
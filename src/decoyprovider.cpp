@@ -0,0 +1,241 @@
+// Copyright (c) 2018-2019 The DAPS Project developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include "decoyprovider.h"
+
+#include "chainparams.h"
+#include "main.h"
+#include "random.h"
+#include "util.h"
+
+#include <limits>
+#include <math.h>
+
+#include <boost/thread.hpp>
+
+CDecoyProvider decoyProvider;
+
+namespace
+{
+/**
+ * Spend age distribution: log(age in seconds) ~ Gamma(shape, 1 / rate), as
+ * fitted to observed spends by Moser et al. and used by Monero.
+ */
+const double SPEND_AGE_GAMMA_SHAPE = 19.28;
+const double SPEND_AGE_GAMMA_RATE = 1.61;
+//! Samples drawn per requested ring member before giving up
+const int MAX_SAMPLES_PER_DECOY = 100;
+}
+
+CDecoyProvider::CDecoyProvider() : nWindow(0), nTipHeight(-1), fReady(false)
+{
+    for (int i = 0; i < OUTPUT_TYPES; i++)
+        nOutputs[i] = 0;
+}
+
+void CDecoyProvider::SetWindow(int nWindowIn)
+{
+    LOCK2(cs_main, cs);
+    nWindow = std::max(nWindowIn, 0);
+    nTipHeight = chainActive.Height();
+    rng.seed(GetRand(std::numeric_limits<uint64_t>::max()));
+    Prune();
+}
+
+void CDecoyProvider::AddBlock(const CBlock& block, const CBlockIndex* pindex)
+{
+    AssertLockHeld(cs);
+    std::map<int, CBucket>::iterator it = mapBuckets.find(pindex->nHeight);
+    if (it != mapBuckets.end())
+        EraseBucket(it);
+
+    CBucket& bucket = mapBuckets[pindex->nHeight];
+    bucket.hashBlock = pindex->GetBlockHash();
+    for (size_t i = 0; i < block.vtx.size(); i++) {
+        const CTransaction& tx = block.vtx[i];
+        OutputType type = OUTPUT_REGULAR;
+        if (tx.IsCoinBase() || tx.IsCoinAudit())
+            type = OUTPUT_COINBASE;
+        else if (tx.IsCoinStake())
+            type = OUTPUT_COINSTAKE;
+
+        for (size_t n = 0; n < tx.vout.size(); n++) {
+            if (tx.vout[n].IsNull() || tx.vout[n].IsEmpty())
+                continue;
+            bucket.vOutputs[type].push_back(COutPoint(tx.GetHash(), n));
+        }
+
+        // The stake input of a coinstake is publicly spent, never use it as a decoy
+        if (tx.IsCoinStake() && !tx.vin.empty()) {
+            setRevealed.insert(tx.vin[0].prevout);
+            mapRevealedByHeight.insert(std::make_pair(pindex->nHeight, tx.vin[0].prevout));
+        }
+    }
+    for (int i = 0; i < OUTPUT_TYPES; i++)
+        nOutputs[i] += bucket.vOutputs[i].size();
+}
+
+void CDecoyProvider::EraseBucket(std::map<int, CBucket>::iterator it)
+{
+    AssertLockHeld(cs);
+    for (int i = 0; i < OUTPUT_TYPES; i++)
+        nOutputs[i] -= it->second.vOutputs[i].size();
+    std::pair<std::multimap<int, COutPoint>::iterator, std::multimap<int, COutPoint>::iterator> range = mapRevealedByHeight.equal_range(it->first);
+    for (std::multimap<int, COutPoint>::iterator ri = range.first; ri != range.second; ++ri)
+        setRevealed.erase(ri->second);
+    mapRevealedByHeight.erase(range.first, range.second);
+    mapBuckets.erase(it);
+}
+
+void CDecoyProvider::Prune()
+{
+    AssertLockHeld(cs);
+    while (!mapBuckets.empty() && mapBuckets.begin()->first <= nTipHeight - nWindow)
+        EraseBucket(mapBuckets.begin());
+    if (nWindow == 0) {
+        while (!mapBuckets.empty())
+            EraseBucket(mapBuckets.begin());
+    }
+}
+
+void CDecoyProvider::BlockConnected(const CBlock& block, const CBlockIndex* pindex)
+{
+    AssertLockHeld(cs_main);
+    LOCK(cs);
+    if (nWindow == 0)
+        return;
+    nTipHeight = pindex->nHeight;
+    AddBlock(block, pindex);
+    Prune();
+}
+
+void CDecoyProvider::BlockDisconnected(const CBlockIndex* pindex)
+{
+    AssertLockHeld(cs_main);
+    LOCK(cs);
+    if (nWindow == 0)
+        return;
+    std::map<int, CBucket>::iterator it = mapBuckets.find(pindex->nHeight);
+    if (it != mapBuckets.end())
+        EraseBucket(it);
+    nTipHeight = pindex->nHeight - 1;
+}
+
+void CDecoyProvider::Backfill()
+{
+    int nHeight;
+    {
+        LOCK(cs_main);
+        nHeight = chainActive.Height();
+    }
+    int nWindowNow;
+    {
+        LOCK(cs);
+        nWindowNow = nWindow;
+    }
+
+    int64_t nStart = GetTimeMillis();
+    for (int i = nHeight; i >= 0 && i > nHeight - nWindowNow; i--) {
+        boost::this_thread::interruption_point();
+        CBlockIndex* pindex;
+        {
+            LOCK(cs_main);
+            pindex = chainActive[i];
+        }
+        if (!pindex)
+            continue;
+        {
+            LOCK(cs);
+            std::map<int, CBucket>::const_iterator it = mapBuckets.find(i);
+            if (it != mapBuckets.end() && it->second.hashBlock == pindex->GetBlockHash())
+                continue;
+        }
+
+        // Read without holding cs_main, then make sure the block is still active
+        CBlock block;
+        if (!ReadBlockFromDisk(block, pindex))
+            continue;
+        LOCK2(cs_main, cs);
+        if (chainActive.Contains(pindex) && pindex->nHeight > nTipHeight - nWindow)
+            AddBlock(block, pindex);
+    }
+
+    // No block may have connected since startup, so take the tip from the chain itself
+    LOCK2(cs_main, cs);
+    nTipHeight = chainActive.Height();
+    Prune();
+    fReady = true;
+    LogPrintf("%s: indexed %u regular, %u coinbase and %u coinstake outputs in %dms\n", __func__,
+        nOutputs[OUTPUT_REGULAR], nOutputs[OUTPUT_COINBASE], nOutputs[OUTPUT_COINSTAKE], GetTimeMillis() - nStart);
+}
+
+bool CDecoyProvider::IsEnabled()
+{
+    LOCK(cs);
+    return nWindow > 0;
+}
+
+bool CDecoyProvider::IsReady()
+{
+    LOCK(cs);
+    return fReady && nWindow > 0;
+}
+
+size_t CDecoyProvider::GetOutputCount(OutputType type)
+{
+    LOCK(cs);
+    return nOutputs[type];
+}
+
+bool CDecoyProvider::SelectDecoys(const COutPoint& prevout, bool fCoinbaseOnly, size_t nCount, int nMinDepth, std::vector<COutPoint>& vDecoys)
+{
+    LOCK(cs);
+    if (!fReady || nWindow == 0 || mapBuckets.empty())
+        return false;
+
+    const int nMaturity = Params().COINBASE_MATURITY();
+    const int nSpendHeight = nTipHeight + 1;
+    const double nSpacing = std::max<int64_t>(Params().TargetSpacing(), 1);
+    std::gamma_distribution<double> gamma(SPEND_AGE_GAMMA_SHAPE, 1.0 / SPEND_AGE_GAMMA_RATE);
+
+    std::set<COutPoint> setUsed(vDecoys.begin(), vDecoys.end());
+    setUsed.insert(prevout);
+    const int nMinAge = fCoinbaseOnly ? std::max(nMinDepth, nMaturity) : nMinDepth;
+
+    for (int nSamples = 0; vDecoys.size() < nCount && nSamples < (int)nCount * MAX_SAMPLES_PER_DECOY; nSamples++) {
+        // Depth of the picked block, counted like confirmations
+        int nDepth = nMinAge + (int)(exp(gamma(rng)) / nSpacing);
+        std::map<int, CBucket>::const_iterator it = mapBuckets.find(nSpendHeight - nDepth);
+        if (it == mapBuckets.end())
+            continue;
+        const CBucket& bucket = it->second;
+
+        // Immature coinbase/coinstake outputs cannot be ring members yet
+        bool fMature = nDepth >= nMaturity;
+        const std::vector<COutPoint>* vCandidates[OUTPUT_TYPES];
+        int nTypes = 0;
+        if (!fCoinbaseOnly)
+            vCandidates[nTypes++] = &bucket.vOutputs[OUTPUT_REGULAR];
+        if (fMature) {
+            vCandidates[nTypes++] = &bucket.vOutputs[OUTPUT_COINBASE];
+            vCandidates[nTypes++] = &bucket.vOutputs[OUTPUT_COINSTAKE];
+        }
+        size_t nCandidates = 0;
+        for (int t = 0; t < nTypes; t++)
+            nCandidates += vCandidates[t]->size();
+        if (nCandidates == 0)
+            continue;
+
+        size_t nPick = std::uniform_int_distribution<size_t>(0, nCandidates - 1)(rng);
+        int t = 0;
+        while (nPick >= vCandidates[t]->size())
+            nPick -= vCandidates[t++]->size();
+        const COutPoint& outpoint = (*vCandidates[t])[nPick];
+        if (setRevealed.count(outpoint) || !setUsed.insert(outpoint).second)
+            continue;
+        vDecoys.push_back(outpoint);
+    }
+
+    return vDecoys.size() >= nCount;
+}
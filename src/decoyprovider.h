@@ -0,0 +1,94 @@
+// Copyright (c) 2018-2019 The DAPS Project developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#ifndef BITCOIN_DECOYPROVIDER_H
+#define BITCOIN_DECOYPROVIDER_H
+
+#include "primitives/transaction.h"
+#include "sync.h"
+#include "uint256.h"
+
+#include <map>
+#include <random>
+#include <set>
+#include <vector>
+
+class CBlock;
+class CBlockIndex;
+
+/** Default for -decoywindow, the number of most recent blocks indexed for ring member selection */
+static const int DEFAULT_DECOY_WINDOW = 100000;
+
+/**
+ * Index of the outputs of the most recent blocks of the active chain, bucketed
+ * by height and output type, from which ring members are drawn.
+ *
+ * Ages are sampled from a gamma distribution over log(seconds), so decoys are
+ * spread like real spends are: mostly recent, with a long tail. Each sample
+ * costs a map lookup and a vector index instead of block reads.
+ *
+ * The tip is kept current from ConnectTip/DisconnectTip; older blocks are
+ * loaded once by Backfill on a background thread.
+ */
+class CDecoyProvider
+{
+public:
+    enum OutputType {
+        OUTPUT_REGULAR = 0,
+        OUTPUT_COINBASE,
+        OUTPUT_COINSTAKE,
+        OUTPUT_TYPES
+    };
+
+    CDecoyProvider();
+
+    //! Index the last nWindow blocks; 0 disables the provider
+    void SetWindow(int nWindow);
+
+    //! Called with cs_main held when a block is connected to / disconnected from the active chain
+    void BlockConnected(const CBlock& block, const CBlockIndex* pindex);
+    void BlockDisconnected(const CBlockIndex* pindex);
+
+    //! Load the window below the current tip; runs on its own thread
+    void Backfill();
+
+    bool IsEnabled();
+    //! True once the whole window is indexed
+    bool IsReady();
+
+    /**
+     * Append ring members for an input spending prevout to vDecoys until it
+     * holds nCount entries. Coinbase and coinstake outputs are only used once
+     * they are mature; with fCoinbaseOnly no regular outputs are used. Outputs
+     * already in vDecoys and prevout itself are never picked.
+     */
+    bool SelectDecoys(const COutPoint& prevout, bool fCoinbaseOnly, size_t nCount, int nMinDepth, std::vector<COutPoint>& vDecoys);
+
+    size_t GetOutputCount(OutputType type);
+
+private:
+    struct CBucket {
+        uint256 hashBlock;
+        std::vector<COutPoint> vOutputs[OUTPUT_TYPES];
+    };
+
+    CCriticalSection cs;
+    int nWindow;
+    int nTipHeight;
+    bool fReady;
+    std::map<int, CBucket> mapBuckets;
+    size_t nOutputs[OUTPUT_TYPES];
+    //! Stake inputs, which coinstakes reveal as spent, and the height they were revealed at
+    std::set<COutPoint> setRevealed;
+    std::multimap<int, COutPoint> mapRevealedByHeight;
+    std::mt19937_64 rng;
+
+    void AddBlock(const CBlock& block, const CBlockIndex* pindex);
+    void EraseBucket(std::map<int, CBucket>::iterator it);
+    void Prune();
+};
+
+extern CDecoyProvider decoyProvider;
+
+#endif // BITCOIN_DECOYPROVIDER_H
@@ -0,0 +1,100 @@
+// Copyright (c) 2018-2019 The DAPS Project developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include "ecutil.h"
+
+#include <string.h>
+
+#include <openssl/crypto.h> // for OPENSSL_cleanse()
+
+//! anonymous namespace
+namespace
+{
+class CSecp256k1Context
+{
+public:
+    secp256k1_context2* ctx;
+
+    CSecp256k1Context()
+    {
+        ctx = secp256k1_context_create2(SECP256K1_CONTEXT_SIGN | SECP256K1_CONTEXT_VERIFY);
+    }
+    ~CSecp256k1Context()
+    {
+        secp256k1_context_destroy(ctx);
+    }
+};
+
+bool ParsePubKey(secp256k1_pubkey2& pubkey, const unsigned char* input, int inputlen)
+{
+    if (inputlen != 33 && inputlen != 65)
+        return false;
+    return secp256k1_ec_pubkey_parse2(GetContext(), &pubkey, input, inputlen);
+}
+
+void SerializePubKey(unsigned char* output, int outputlen, const secp256k1_pubkey2& pubkey)
+{
+    size_t len = outputlen;
+    secp256k1_ec_pubkey_serialize2(GetContext(), output, &len, &pubkey, outputlen == 33 ? SECP256K1_EC_COMPRESSED : SECP256K1_EC_UNCOMPRESSED);
+}
+
+} // anon namespace
+
+secp256k1_context2* GetContext()
+{
+    // Built on first use, which may come from another static initializer
+    static CSecp256k1Context instance;
+    return instance.ctx;
+}
+
+bool ECPubKeyCreate(unsigned char* pubkey, int* pubkeylen, const unsigned char* seckey, bool fCompressed)
+{
+    secp256k1_pubkey2 pub;
+    if (!secp256k1_ec_pubkey_create2(GetContext(), &pub, seckey))
+        return false;
+    *pubkeylen = fCompressed ? 33 : 65;
+    SerializePubKey(pubkey, *pubkeylen, pub);
+    return true;
+}
+
+bool ECPubKeyTweakAdd(unsigned char* pubkey, int pubkeylen, const unsigned char* tweak)
+{
+    secp256k1_pubkey2 pub;
+    if (!ParsePubKey(pub, pubkey, pubkeylen) || !secp256k1_ec_pubkey_tweak_add2(GetContext(), &pub, tweak))
+        return false;
+    SerializePubKey(pubkey, pubkeylen, pub);
+    return true;
+}
+
+bool ECPubKeyTweakMul(unsigned char* pubkey, int pubkeylen, const unsigned char* tweak)
+{
+    secp256k1_pubkey2 pub;
+    if (!ParsePubKey(pub, pubkey, pubkeylen) || !secp256k1_ec_pubkey_tweak_mul2(GetContext(), &pub, tweak))
+        return false;
+    SerializePubKey(pubkey, pubkeylen, pub);
+    return true;
+}
+
+bool ECPrivKeyTweakAdd(unsigned char* seckey, const unsigned char* tweak)
+{
+    // The library clears the key when the tweak fails
+    unsigned char result[32];
+    memcpy(result, seckey, 32);
+    bool ret = secp256k1_ec_privkey_tweak_add2(GetContext(), result, tweak);
+    if (ret)
+        memcpy(seckey, result, 32);
+    OPENSSL_cleanse(result, sizeof(result));
+    return ret;
+}
+
+bool ECPrivKeyTweakMul(unsigned char* seckey, const unsigned char* tweak)
+{
+    unsigned char result[32];
+    memcpy(result, seckey, 32);
+    bool ret = secp256k1_ec_privkey_tweak_mul2(GetContext(), result, tweak);
+    if (ret)
+        memcpy(seckey, result, 32);
+    OPENSSL_cleanse(result, sizeof(result));
+    return ret;
+}
@@ -0,0 +1,30 @@
+// Copyright (c) 2018-2019 The DAPS Project developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#ifndef BITCOIN_ECUTIL_H
+#define BITCOIN_ECUTIL_H
+
+#include "secp256k1_2.h"
+
+/**
+ * The secp256k1-mw context behind every EC operation of the node: ECDSA,
+ * key derivation, ring signatures, ECDH, commitments and bulletproofs.
+ * It is built once, with the static generator tables, and only read
+ * afterwards, so it can be shared by all threads.
+ */
+secp256k1_context2* GetContext();
+
+/**
+ * Operations on serialized keys, with the semantics of the libsecp256k1 API
+ * the wallet and the ring signature code were written against. Public keys
+ * are 33 or 65 bytes and keep their length. A secret key is left untouched
+ * when false is returned.
+ */
+bool ECPubKeyCreate(unsigned char* pubkey, int* pubkeylen, const unsigned char* seckey, bool fCompressed);
+bool ECPubKeyTweakAdd(unsigned char* pubkey, int pubkeylen, const unsigned char* tweak);
+bool ECPubKeyTweakMul(unsigned char* pubkey, int pubkeylen, const unsigned char* tweak);
+bool ECPrivKeyTweakAdd(unsigned char* seckey, const unsigned char* tweak);
+bool ECPrivKeyTweakMul(unsigned char* seckey, const unsigned char* tweak);
+
+#endif // BITCOIN_ECUTIL_H
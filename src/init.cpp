@@ -15,7 +15,10 @@
 #include "activemasternode.h"
 #include "addrman.h"
 #include "amount.h"
+#include "blockimporter.h"
+#include "blockfilewriter.h"
 #include "checkpoints.h"
+#include "decoyprovider.h"
 #include "compat/sanity.h"
 #include "httpserver.h"
 #include "httprpc.h"
@@ -24,17 +27,22 @@
 #include "masternode-budget.h"
 #include "masternode-payments.h"
 #include "masternodeconfig.h"
+#include "masternodedb.h"
 #include "masternodeman.h"
 #include "miner.h"
+#include "msgprecheck.h"
 #include "net.h"
+#include "proofcache.h"
 #include "rpcserver.h"
 #include "script/standard.h"
 #include "scheduler.h"
 #include "txdb.h"
+#include "txprevalidator.h"
 #include "torcontrol.h"
 #include "ui_interface.h"
 #include "util.h"
 #include "utilmoneystr.h"
+#include "utxosnapshot.h"
 #include "validationinterface.h"
 #ifdef ENABLE_WALLET
 #include "db.h"
@@ -160,6 +168,7 @@ public:
 
 static CCoinsViewDB* pcoinsdbview = NULL;
 static CCoinsViewErrorCatcher* pcoinscatcher = NULL;
+static boost::thread* pthreadLoadMasternodeState = NULL;
 
 void Interrupt(boost::thread_group& threadGroup)
 {
@@ -197,10 +206,18 @@ void PrepareShutdown()
         bitdb.Flush(false);
     GenerateDapscoins(false, NULL, 0);
 #endif
+    txPreValidator.Stop();
+    messagePreChecker.Stop();
     StopNode();
+    // The loader still reads through pmnstatedb, let it finish before the dumps and the delete
+    if (pthreadLoadMasternodeState && pthreadLoadMasternodeState->joinable())
+        pthreadLoadMasternodeState->join();
+    pthreadLoadMasternodeState = NULL;
     DumpMasternodes();
     DumpBudgets();
     DumpMasternodePayments();
+    delete pmnstatedb;
+    pmnstatedb = NULL;
     UnregisterNodeSignals(GetNodeSignals());
 
     if (fFeeEstimatesInitialized) {
@@ -230,6 +247,7 @@ void PrepareShutdown()
         delete pblocktree;
         pblocktree = NULL;
     }
+    blockFileWriter.Stop();
 #ifdef ENABLE_WALLET
     if (pwalletMain)
         bitdb.Flush(true);
@@ -347,6 +365,7 @@ std::string HelpMessage(HelpMessageMode mode)
     strUsage += HelpMessageOpt("-alerts", strprintf(_("Receive and display P2P network alerts (default: %u)"), DEFAULT_ALERTS));
     strUsage += HelpMessageOpt("-blocknotify=<cmd>", _("Execute command when the best block changes (%s in cmd is replaced by block hash)"));
     strUsage += HelpMessageOpt("-checkblocks=<n>", strprintf(_("How many blocks to check at startup (default: %u, 0 = all)"), 500));
+    strUsage += HelpMessageOpt("-blockwritequeue=<n>", strprintf(_("Queue at most <n> megabytes of block and undo data for the background block file writer (0 = write synchronously, default: %u)"), DEFAULT_BLOCK_WRITE_QUEUE));
     strUsage += HelpMessageOpt("-conf=<file>", strprintf(_("Specify configuration file (default: %s)"), "dapscoin.conf"));
     if (mode == HMM_BITCOIND) {
 #if !defined(WIN32)
@@ -355,10 +374,14 @@ std::string HelpMessage(HelpMessageMode mode)
     }
     strUsage += HelpMessageOpt("-datadir=<dir>", _("Specify data directory"));
     strUsage += HelpMessageOpt("-dbcache=<n>", strprintf(_("Set database cache size in megabytes (%d to %d, default: %d)"), nMinDbCache, nMaxDbCache, nDefaultDbCache));
+    strUsage += HelpMessageOpt("-importthreads=<n>", strprintf(_("Set the number of threads deserializing and checking blocks during -reindex and -loadblock (0 to %d, 0 = on the import thread, default: %d)"), MAX_IMPORT_THREADS, DEFAULT_IMPORT_THREADS));
     strUsage += HelpMessageOpt("-loadblock=<file>", _("Imports blocks from external blk000??.dat file") + " " + _("on startup"));
+    strUsage += HelpMessageOpt("-loadtxoutset=<file>", _("Start an empty data directory from a UTXO snapshot written by dumptxoutset, the blocks below it are replayed in the background. Only snapshots whose hash is known to the client are accepted, which is none outside regtest so far"));
     strUsage += HelpMessageOpt("-maxreorg=<n>", strprintf(_("Set the Maximum reorg depth (default: %u)"), Params(CBaseChainParams::MAIN).MaxReorganizationDepth()));
     strUsage += HelpMessageOpt("-maxorphantx=<n>", strprintf(_("Keep at most <n> unconnectable transactions in memory (default: %u)"), DEFAULT_MAX_ORPHAN_TRANSACTIONS));
+    strUsage += HelpMessageOpt("-msgcheckthreads=<n>", strprintf(_("Set the number of threads deserializing and checking received blocks, transactions and masternode messages (0 to %d, 0 = on the message thread, default: %d)"), MAX_MSGCHECK_THREADS, DEFAULT_MSGCHECK_THREADS));
     strUsage += HelpMessageOpt("-par=<n>", strprintf(_("Set the number of script verification threads (%u to %d, 0 = auto, <0 = leave that many cores free, default: %d)"), -(int)boost::thread::hardware_concurrency(), MAX_SCRIPTCHECK_THREADS, DEFAULT_SCRIPTCHECK_THREADS));
+    strUsage += HelpMessageOpt("-txprevalidationthreads=<n>", strprintf(_("Set the number of threads verifying relayed transaction proofs outside the main lock (0 to %d, 0 = verify on the message thread, default: %d)"), MAX_TXPREVALIDATION_THREADS, DEFAULT_TXPREVALIDATION_THREADS));
 #ifndef WIN32
     strUsage += HelpMessageOpt("-pid=<file>", strprintf(_("Specify pid file (default: %s)"), "dapscoind.pid"));
 #endif
@@ -386,6 +409,9 @@ std::string HelpMessage(HelpMessageMode mode)
     strUsage += HelpMessageOpt("-listen", _("Accept connections from outside (default: 1 if no -proxy or -connect)"));
     strUsage += HelpMessageOpt("-listenonion", strprintf(_("Automatically create Tor hidden service (default: %d)"), DEFAULT_LISTEN_ONION));
     strUsage += HelpMessageOpt("-maxconnections=<n>", strprintf(_("Maintain at most <n> connections to peers (default: %u)"), 125));
+#ifdef HAVE_SYS_EPOLL_H
+    strUsage += HelpMessageOpt("-socketevents=<mode>", strprintf(_("Wait for socket events with <mode>, epoll or select; select limits connections to FD_SETSIZE (default: %s)"), DEFAULT_SOCKETEVENTS));
+#endif
     strUsage += HelpMessageOpt("-maxreceivebuffer=<n>", strprintf(_("Maximum per-connection receive buffer, <n>*1000 bytes (default: %u)"), 5000));
     strUsage += HelpMessageOpt("-maxsendbuffer=<n>", strprintf(_("Maximum per-connection send buffer, <n>*1000 bytes (default: %u)"), 1000));
     strUsage += HelpMessageOpt("-onion=<ip:port>", strprintf(_("Use separate SOCKS5 proxy to reach peers via Tor hidden services (default: %s)"), "-proxy"));
@@ -414,6 +440,7 @@ std::string HelpMessage(HelpMessageMode mode)
 #ifdef ENABLE_WALLET
     strUsage += HelpMessageGroup(_("Wallet options:"));
     strUsage += HelpMessageOpt("-createwalletbackups=<n>", _("Number of automatic wallet backups (default: 10)"));
+    strUsage += HelpMessageOpt("-decoywindow=<n>", strprintf(_("Index the outputs of the last <n> blocks for ring member selection (0 = disable, default: %u)"), DEFAULT_DECOY_WINDOW));
     strUsage += HelpMessageOpt("-disablewallet", _("Do not load the wallet and disable wallet RPC calls"));
     strUsage += HelpMessageOpt("-keypool=<n>", strprintf(_("Set key pool size to <n> (default: %u)"), 100));
     if (GetBoolArg("-help-debug", false))
@@ -430,6 +457,7 @@ std::string HelpMessage(HelpMessageMode mode)
         FormatMoney(maxTxFee)));
     strUsage += HelpMessageOpt("-upgradewallet", _("Upgrade wallet to latest format") + " " + _("on startup"));
     strUsage += HelpMessageOpt("-wallet=<file>", _("Specify wallet file (within data directory)") + " " + strprintf(_("(default: %s)"), "wallet.dat"));
+    strUsage += HelpMessageOpt("-walletarchivedepth=<n>", strprintf(_("Move transactions whose outputs are all spent and at least <n> blocks deep out of memory (0 to keep all, default: %u)"), DEFAULT_WALLET_ARCHIVE_DEPTH));
     strUsage += HelpMessageOpt("-walletnotify=<cmd>", _("Execute command when a wallet transaction changes (%s in cmd is replaced by TxID)"));
     if (mode == HMM_BITCOIN_QT)
         strUsage += HelpMessageOpt("-windowtitle=<name>", _("Wallet window title"));
@@ -445,6 +473,10 @@ std::string HelpMessage(HelpMessageMode mode)
     strUsage += HelpMessageOpt("-zmqpubrawblock=<address>", _("Enable publish raw block in <address>"));
     strUsage += HelpMessageOpt("-zmqpubrawtx=<address>", _("Enable publish raw transaction in <address>"));
     strUsage += HelpMessageOpt("-zmqpubrawtxlock=<address>", _("Enable publish raw transaction (locked via SwiftX) in <address>"));
+    strUsage += HelpMessageOpt("-zmqpubkeyimage=<address>", _("Enable publish key images spent in connected blocks in <address>"));
+#ifdef ENABLE_WALLET
+    strUsage += HelpMessageOpt("-zmqpubwalletoutput=<address>", _("Enable publish outputs received by the wallet in <address>"));
+#endif
 #endif
 
     strUsage += HelpMessageGroup(_("Debugging/Testing options:"));
@@ -476,9 +508,12 @@ std::string HelpMessage(HelpMessageMode mode)
     strUsage += HelpMessageOpt("-logips", strprintf(_("Include IP addresses in debug output (default: %u)"), 0));
     strUsage += HelpMessageOpt("-logtimestamps", strprintf(_("Prepend debug output with timestamp (default: %u)"), 1));
     if (GetBoolArg("-help-debug", false)) {
+        strUsage += HelpMessageOpt("-lockstats", strprintf(_("Record wait and hold times of every lock call site, see getlockstats (default: %u)"), 0));
+        strUsage += HelpMessageOpt("-lockstatsinterval=<n>", strprintf(_("With -lockstats, log the most contended lock sites every <n> seconds (0 = never, default: %u)"), DEFAULT_LOCKSTATS_INTERVAL));
         strUsage += HelpMessageOpt("-limitfreerelay=<n>", strprintf(_("Continuously rate-limit free transactions to <n>*1000 bytes per minute (default:%u)"), 15));
         strUsage += HelpMessageOpt("-relaypriority", strprintf(_("Require high priority for relaying free or low-fee transactions (default:%u)"), 1));
         strUsage += HelpMessageOpt("-maxsigcachesize=<n>", strprintf(_("Limit size of signature cache to <n> entries (default: %u)"), 50000));
+        strUsage += HelpMessageOpt("-maxproofcachesize=<n>", strprintf(_("Limit size of the ring signature and bulletproof cache to <n> entries (default: %u)"), DEFAULT_MAX_PROOF_CACHE_SIZE));
     }
     strUsage += HelpMessageOpt("-minrelaytxfee=<amt>", strprintf(_("Fees (in DAPS/Kb) smaller than this are considered zero fee for relaying (default: %s)"), FormatMoney(::minRelayTxFee.GetFeePerK())));
     strUsage += HelpMessageOpt("-printtoconsole", strprintf(_("Send trace/debug info to console instead of debug.log file (default: %u)"), 0));
@@ -586,19 +621,29 @@ void ThreadImport(std::vector<boost::filesystem::path> vImportFiles)
 {
     RenameThread("dapscoin-loadblk");
 
+    int nImportThreads = std::max(0, std::min((int)GetArg("-importthreads", DEFAULT_IMPORT_THREADS), MAX_IMPORT_THREADS));
+
+    // Count the files up front for the progress in getblockchaininfo
+    int nBlockFiles = 0;
+    if (fReindex) {
+        while (boost::filesystem::exists(GetBlockPosFilename(CDiskBlockPos(nBlockFiles, 0), "blk")))
+            nBlockFiles++;
+    }
+    filesystem::path pathBootstrap = GetDataDir() / "bootstrap.dat";
+    bool fBootstrap = filesystem::exists(pathBootstrap);
+    StartImportProgress(nBlockFiles + (fBootstrap ? 1 : 0) + vImportFiles.size());
+
     // -reindex
     if (fReindex) {
         CImportingNow imp;
         int nFile = 0;
         while (true) {
             CDiskBlockPos pos(nFile, 0);
-            if (!boost::filesystem::exists(GetBlockPosFilename(pos, "blk")))
+            filesystem::path pathBlockFile = GetBlockPosFilename(pos, "blk");
+            if (!boost::filesystem::exists(pathBlockFile))
                 break; // No block files left to reindex
-            FILE* file = OpenBlockFile(pos, true);
-            if (!file)
-                break; // This error is logged in OpenBlockFile
             LogPrintf("Reindexing block file blk%05u.dat...\n", (unsigned int)nFile);
-            LoadExternalBlockFile(file, &pos);
+            ImportBlockFile(pathBlockFile, nImportThreads, &pos);
             nFile++;
         }
         pblocktree->WriteReindexing(false);
@@ -609,31 +654,21 @@ void ThreadImport(std::vector<boost::filesystem::path> vImportFiles)
     }
 
     // hardcoded $DATADIR/bootstrap.dat
-    filesystem::path pathBootstrap = GetDataDir() / "bootstrap.dat";
-    if (filesystem::exists(pathBootstrap)) {
-        FILE* file = fopen(pathBootstrap.string().c_str(), "rb");
-        if (file) {
-            CImportingNow imp;
-            filesystem::path pathBootstrapOld = GetDataDir() / "bootstrap.dat.old";
-            LogPrintf("Importing bootstrap.dat...\n");
-            LoadExternalBlockFile(file);
-            RenameOver(pathBootstrap, pathBootstrapOld);
-        } else {
-            LogPrintf("Warning: Could not open bootstrap file %s\n", pathBootstrap.string());
-        }
+    if (fBootstrap) {
+        CImportingNow imp;
+        filesystem::path pathBootstrapOld = GetDataDir() / "bootstrap.dat.old";
+        LogPrintf("Importing bootstrap.dat...\n");
+        ImportBlockFile(pathBootstrap, nImportThreads);
+        RenameOver(pathBootstrap, pathBootstrapOld);
     }
 
     // -loadblock=
     BOOST_FOREACH (boost::filesystem::path& path, vImportFiles) {
-        FILE* file = fopen(path.string().c_str(), "rb");
-        if (file) {
-            CImportingNow imp;
-            LogPrintf("Importing blocks file %s...\n", path.string());
-            LoadExternalBlockFile(file);
-        } else {
-            LogPrintf("Warning: Could not open blocks file %s\n", path.string());
-        }
+        CImportingNow imp;
+        LogPrintf("Importing blocks file %s...\n", path.string());
+        ImportBlockFile(path, nImportThreads);
     }
+    StopImportProgress();
 
     if (GetBoolArg("-stopafterblockimport", false)) {
         LogPrintf("Stopping after block import\n");
@@ -641,6 +676,49 @@ void ThreadImport(std::vector<boost::filesystem::path> vImportFiles)
     }
 }
 
+/**
+ * Load the budgets and masternode payment votes after startup. Neither is
+ * needed before the masternode list is synced from the network, so the node
+ * starts answering without waiting for them; anything received meanwhile is
+ * kept over the stored copy.
+ */
+void ThreadLoadMasternodeState()
+{
+    if (!pmnstatedb->Read(budget))
+        LogPrintf("Skipped unreadable budget records, they are dropped on the next dump\n");
+
+    if (boost::filesystem::exists(GetDataDir() / "budget.dat")) {
+        CBudgetDB budgetdb;
+        CBudgetDB::ReadResult readResult = budgetdb.Read(budget);
+        if (readResult == CBudgetDB::Ok || readResult == CBudgetDB::IncorrectFormat) {
+            if (readResult == CBudgetDB::IncorrectFormat)
+                LogPrintf("Error reading budget.dat: magic is ok but data has invalid format, will try to recreate\n");
+            DumpBudgets();
+            boost::filesystem::remove(GetDataDir() / "budget.dat");
+        } else
+            LogPrintf("Error reading budget.dat: file format is unknown or invalid, please fix it manually\n");
+    }
+
+    //flag our cached items so we send them to our peers
+    budget.ResetSync();
+    budget.ClearSeen();
+
+    if (!pmnstatedb->Read(masternodePayments))
+        LogPrintf("Skipped unreadable masternode payment records, they are dropped on the next dump\n");
+
+    if (boost::filesystem::exists(GetDataDir() / "mnpayments.dat")) {
+        CMasternodePaymentDB mnpayments;
+        CMasternodePaymentDB::ReadResult readResult = mnpayments.Read(masternodePayments);
+        if (readResult == CMasternodePaymentDB::Ok || readResult == CMasternodePaymentDB::IncorrectFormat) {
+            if (readResult == CMasternodePaymentDB::IncorrectFormat)
+                LogPrintf("Error reading mnpayments.dat: magic is ok but data has invalid format, will try to recreate\n");
+            DumpMasternodePayments();
+            boost::filesystem::remove(GetDataDir() / "mnpayments.dat");
+        } else
+            LogPrintf("Error reading mnpayments.dat: file format is unknown or invalid, please fix it manually\n");
+    }
+}
+
 /** Sanity checks
  *  Ensure that DAPS is running in a usable environment with all
  *  necessary library support.
@@ -810,10 +888,21 @@ bool AppInit2(boost::thread_group& threadGroup, CScheduler& scheduler, bool isDa
         }
     }
 
+    std::string strSocketEvents = GetArg("-socketevents", DEFAULT_SOCKETEVENTS);
+    if (strSocketEvents == "select")
+        nSocketEventsMode = SOCKETEVENTS_SELECT;
+#ifdef HAVE_SYS_EPOLL_H
+    else if (strSocketEvents == "epoll")
+        nSocketEventsMode = SOCKETEVENTS_EPOLL;
+#endif
+    else
+        return InitError(strprintf(_("Unsupported -socketevents mode: '%s'"), strSocketEvents));
+
     // Make sure enough file descriptors are available
     int nBind = std::max((int)mapArgs.count("-bind") + (int)mapArgs.count("-whitebind"), 1);
+    int nMaxSockets = nSocketEventsMode == SOCKETEVENTS_SELECT ? (int)FD_SETSIZE : MAX_EPOLL_CONNECTIONS;
     nMaxConnections = GetArg("-maxconnections", 125);
-    nMaxConnections = std::max(std::min(nMaxConnections, (int)(FD_SETSIZE - nBind - MIN_CORE_FILEDESCRIPTORS)), 0);
+    nMaxConnections = std::max(std::min(nMaxConnections, nMaxSockets - nBind - MIN_CORE_FILEDESCRIPTORS), 0);
     int nFD = RaiseFileDescriptorLimit(nMaxConnections + MIN_CORE_FILEDESCRIPTORS);
     if (nFD < MIN_CORE_FILEDESCRIPTORS)
         return InitError(_("Not enough file descriptors available."));
@@ -845,6 +934,7 @@ bool AppInit2(boost::thread_group& threadGroup, CScheduler& scheduler, bool isDa
     mempool.setSanityCheck(GetBoolArg("-checkmempool", Params().DefaultConsistencyChecks()));
     fCheckBlockIndex = GetBoolArg("-checkblockindex", Params().DefaultConsistencyChecks());
     Checkpoints::fEnabled = GetBoolArg("-checkpoints", true);
+    fLockStats = GetBoolArg("-lockstats", false);
 
     // -par=0 means autodetect, but nScriptCheckThreads==0 means no concurrency
     nScriptCheckThreads = GetArg("-par", DEFAULT_SCRIPTCHECK_THREADS);
@@ -983,10 +1073,19 @@ bool AppInit2(boost::thread_group& threadGroup, CScheduler& scheduler, bool isDa
             threadGroup.create_thread(&ThreadScriptCheck);
     }
 
+    int64_t nBlockWriteQueue = GetArg("-blockwritequeue", DEFAULT_BLOCK_WRITE_QUEUE);
+    if (nBlockWriteQueue > 0) {
+        LogPrintf("Using a %dMiB queue for block file writes\n", nBlockWriteQueue);
+        blockFileWriter.Start(nBlockWriteQueue << 20);
+    }
+
     // Start the lightweight task scheduler thread
     CScheduler::Function serviceLoop = boost::bind(&CScheduler::serviceQueue, &scheduler);
     threadGroup.create_thread(boost::bind(&TraceThread<CScheduler::Function>, "scheduler", serviceLoop));
 
+    if (fLockStats && GetArg("-lockstatsinterval", DEFAULT_LOCKSTATS_INTERVAL) > 0)
+        scheduler.scheduleEvery(boost::bind(&LogLockStats, LOCKSTATS_LOG_SITES), GetArg("-lockstatsinterval", DEFAULT_LOCKSTATS_INTERVAL));
+
     /* Start the RPC server already.  It will be started in "warmup" mode
      * and not really process calls already (but it will signify connections
      * that the server is there and will be ready later).  Warmup mode will
@@ -1265,6 +1364,8 @@ bool AppInit2(boost::thread_group& threadGroup, CScheduler& scheduler, bool isDa
     // ********************************************************* Step 7: load block chain
 
     fReindex = GetBoolArg("-reindex", false);
+    decoyProvider.SetWindow(GetArg("-decoywindow", DEFAULT_DECOY_WINDOW));
+    proofCache.Setup(std::max<int64_t>(GetArg("-maxproofcachesize", DEFAULT_MAX_PROOF_CACHE_SIZE), 0));
 
     // Upgrading to 0.8; hard-link the old blknnnn.dat files into /blocks/
     filesystem::path blocksDir = GetDataDir() / "blocks";
@@ -1332,6 +1433,16 @@ bool AppInit2(boost::thread_group& threadGroup, CScheduler& scheduler, bool isDa
                 // End loop if shutdown was requested
                 if (ShutdownRequested()) break;
 
+                // Fill empty databases from a UTXO snapshot
+                if (!fReindex && mapArgs.count("-loadtxoutset")) {
+                    uiInterface.InitMessage(_("Loading UTXO snapshot..."));
+                    string strSnapshotError;
+                    if (!LoadTxOutSnapshot(GetArg("-loadtxoutset", ""), strSnapshotError)) {
+                        if (ShutdownRequested()) break;
+                        return InitError(strSnapshotError);
+                    }
+                }
+
                 uiInterface.InitMessage(_("Loading block index..."));
                 string strBlockIndexError = "";
                 if (!LoadBlockIndex(strBlockIndexError)) {
@@ -1366,6 +1477,17 @@ bool AppInit2(boost::thread_group& threadGroup, CScheduler& scheduler, bool isDa
                     RecalculateDAPSSupply(1);
                 }
 
+                // Coin databases written before the UTXO statistics were kept get them once, from every block
+                if (!pcoinsdbview->HaveStats()) {
+                    uiInterface.InitMessage(_("Rebuilding UTXO statistics..."));
+                    LOCK(cs_main);
+                    if (!pcoinsdbview->RebuildStats()) {
+                        if (ShutdownRequested()) break;
+                        strLoadError = _("Error rebuilding the UTXO statistics");
+                        break;
+                    }
+                }
+
                 uiInterface.InitMessage(_("Verifying blocks..."));
 
                 // Flag sent to validation code to let it know it can skip certain checks
@@ -1513,6 +1635,10 @@ bool AppInit2(boost::thread_group& threadGroup, CScheduler& scheduler, bool isDa
         LogPrintf(" wallet      %15dms\n", GetTimeMillis() - nStart);
 
         RegisterValidationInterface(pwalletMain);
+#if ENABLE_ZMQ
+        if (pzmqNotificationInterface)
+            pzmqNotificationInterface->RegisterWallet(pwalletMain);
+#endif
     	int height = -1;
         CBlockIndex* pindexRescan = chainActive.Tip();
         if (GetBoolArg("-rescan", false)) {
@@ -1546,10 +1672,15 @@ bool AppInit2(boost::thread_group& threadGroup, CScheduler& scheduler, bool isDa
             if (GetBoolArg("-zapwallettxes", false) && GetArg("-zapwallettxes", "1") != "2") {
                 BOOST_FOREACH (const CWalletTx& wtxOld, vWtx) {
                     uint256 hash = wtxOld.GetHash();
+                    LOCK(pwalletMain->cs_wallet);
+                    if (pwalletMain->mapWalletArchive.count(hash))
+                        pwalletMain->RestoreArchivedTx(hash);
                     std::map<uint256, CWalletTx>::iterator mi = pwalletMain->mapWallet.find(hash);
                     if (mi != pwalletMain->mapWallet.end()) {
                         const CWalletTx* copyFrom = &wtxOld;
                         CWalletTx* copyTo = &mi->second;
+                        // The history index is keyed by the times restored here
+                        pwalletMain->RemoveFromHistory(hash);
                         copyTo->mapValue = copyFrom->mapValue;
                         copyTo->vOrderForm = copyFrom->vOrderForm;
                         copyTo->nTimeReceived = copyFrom->nTimeReceived;
@@ -1557,11 +1688,17 @@ bool AppInit2(boost::thread_group& threadGroup, CScheduler& scheduler, bool isDa
                         copyTo->fFromMe = copyFrom->fFromMe;
                         copyTo->strFromAccount = copyFrom->strFromAccount;
                         copyTo->nOrderPos = copyFrom->nOrderPos;
+                        pwalletMain->AddToHistory(hash);
                         copyTo->WriteToDisk();
                     }
                 }
             }
         }
+        {
+            // Also moves the settled transactions of wallets written before the archive existed
+            LOCK2(cs_main, pwalletMain->cs_wallet);
+            pwalletMain->ArchiveSettledTransactions();
+        }
         fVerifyingBlocks = false;
 
     }  // (!fDisableWallet)
@@ -1590,56 +1727,38 @@ bool AppInit2(boost::thread_group& threadGroup, CScheduler& scheduler, bool isDa
             MilliSleep(10);
     }
 
-    // ********************************************************* Step 10: setup ObfuScation
-
-    uiInterface.InitMessage(_("Loading masternode cache..."));
+    // Check the blocks below a loaded UTXO snapshot
+    threadGroup.create_thread(&ThreadVerifySnapshot);
 
-    CMasternodeDB mndb;
-    CMasternodeDB::ReadResult readResult = mndb.Read(mnodeman);
-    if (readResult == CMasternodeDB::FileError)
-        LogPrintf("Missing masternode cache file - mncache.dat, will try to recreate\n");
-    else if (readResult != CMasternodeDB::Ok) {
-        LogPrintf("Error reading mncache.dat: ");
-        if (readResult == CMasternodeDB::IncorrectFormat)
-            LogPrintf("magic is ok but data has invalid format, will try to recreate\n");
-        else
-            LogPrintf("file format is unknown or invalid, please fix it manually\n");
+    // Load the ring member index below the tip; new blocks are added as they connect
+    if (decoyProvider.IsEnabled()) {
+        boost::function<void()> backfill = boost::bind(&CDecoyProvider::Backfill, &decoyProvider);
+        threadGroup.create_thread(boost::bind(&TraceThread<boost::function<void()> >, "decoyindex", backfill));
     }
 
-    uiInterface.InitMessage(_("Loading budget cache..."));
+    // ********************************************************* Step 10: setup ObfuScation
 
-    CBudgetDB budgetdb;
-    CBudgetDB::ReadResult readResult2 = budgetdb.Read(budget);
+    uiInterface.InitMessage(_("Loading masternode cache..."));
 
-    if (readResult2 == CBudgetDB::FileError)
-        LogPrintf("Missing budget cache - budget.dat, will try to recreate\n");
-    else if (readResult2 != CBudgetDB::Ok) {
-        LogPrintf("Error reading budget.dat: ");
-        if (readResult2 == CBudgetDB::IncorrectFormat)
-            LogPrintf("magic is ok but data has invalid format, will try to recreate\n");
-        else
-            LogPrintf("file format is unknown or invalid, please fix it manually\n");
+    pmnstatedb = new CMasternodeStateDB(MASTERNODE_STATE_DB_CACHE);
+    if (!pmnstatedb->Read(mnodeman))
+        LogPrintf("Skipped unreadable masternode list records, they are dropped on the next dump\n");
+
+    // Import the flat file of earlier versions once, the state database is kept up to date from then on
+    if (boost::filesystem::exists(GetDataDir() / "mncache.dat")) {
+        CMasternodeDB mndb;
+        CMasternodeDB::ReadResult readResult = mndb.Read(mnodeman);
+        if (readResult == CMasternodeDB::Ok || readResult == CMasternodeDB::IncorrectFormat) {
+            if (readResult == CMasternodeDB::IncorrectFormat)
+                LogPrintf("Error reading mncache.dat: magic is ok but data has invalid format, will try to recreate\n");
+            DumpMasternodes();
+            boost::filesystem::remove(GetDataDir() / "mncache.dat");
+        } else
+            LogPrintf("Error reading mncache.dat: file format is unknown or invalid, please fix it manually\n");
     }
 
-    //flag our cached items so we send them to our peers
-    budget.ResetSync();
-    budget.ClearSeen();
-
-
-    uiInterface.InitMessage(_("Loading masternode payment cache..."));
-
-    CMasternodePaymentDB mnpayments;
-    CMasternodePaymentDB::ReadResult readResult3 = mnpayments.Read(masternodePayments);
-
-    if (readResult3 == CMasternodePaymentDB::FileError)
-        LogPrintf("Missing masternode payment cache - mnpayments.dat, will try to recreate\n");
-    else if (readResult3 != CMasternodePaymentDB::Ok) {
-        LogPrintf("Error reading mnpayments.dat: ");
-        if (readResult3 == CMasternodePaymentDB::IncorrectFormat)
-            LogPrintf("magic is ok but data has invalid format, will try to recreate\n");
-        else
-            LogPrintf("file format is unknown or invalid, please fix it manually\n");
-    }
+    // Readers see the loaded list before the masternode thread publishes its first batch
+    mnodeman.PublishListChanges();
 
     fMasterNode = GetBoolArg("-masternode", false);
 
@@ -1747,6 +1866,9 @@ bool AppInit2(boost::thread_group& threadGroup, CScheduler& scheduler, bool isDa
 
     RandAddSeedPerfmon();
 
+    // Load budgets and payment votes in the background once nothing above can fail anymore
+    pthreadLoadMasternodeState = threadGroup.create_thread(boost::bind(&TraceThread<void (*)()>, "mnload", &ThreadLoadMasternodeState));
+
     //// debug print
     LogPrintf("mapBlockIndex.size() = %u\n", mapBlockIndex.size());
     LogPrintf("chainActive.Height() = %d\n", chainActive.Height());
@@ -1759,6 +1881,8 @@ bool AppInit2(boost::thread_group& threadGroup, CScheduler& scheduler, bool isDa
     if (GetBoolArg("-listenonion", DEFAULT_LISTEN_ONION))
         StartTorControl(threadGroup);
 
+    txPreValidator.Start(GetArg("-txprevalidationthreads", DEFAULT_TXPREVALIDATION_THREADS));
+    messagePreChecker.Start(GetArg("-msgcheckthreads", DEFAULT_MSGCHECK_THREADS));
     StartNode(threadGroup, scheduler);
 
 #ifdef ENABLE_WALLET
@@ -6,35 +6,39 @@
 
 #include "crypto/hmac_sha512.h"
 #include "crypto/rfc6979_hmac_sha256.h"
-#include "eccryptoverify.h"
+#include "ecutil.h"
 #include "pubkey.h"
 #include "random.h"
 
-#include "ecwrapper.h"
-#include <secp256k1.h>
+#include "secp256k1-mw/contrib/lax_der_privatekey_parsing.h"
+#include "secp256k1_recovery.h"
 
 //! anonymous namespace
 namespace
 {
-class CSecp256k1Init
+/**
+ * Nonce generation of the signing code before the switch to secp256k1-mw:
+ * the attempt-th output of an HMAC-SHA256 DRBG seeded with key and hash,
+ * plus the test case. Keeps signatures of the same key and hash unchanged.
+ */
+int nonce_function_dapscoin(unsigned char* nonce32, const unsigned char* msg32, const unsigned char* key32, const unsigned char* algo16, void* data, unsigned int attempt)
 {
-public:
-    CSecp256k1Init()
-    {
-        secp256k1_start(SECP256K1_START_SIGN | SECP256K1_START_VERIFY);
-    }
-    ~CSecp256k1Init()
-    {
-        secp256k1_stop();
-    }
-};
-static CSecp256k1Init instance_of_csecp256k1;
+    RFC6979_HMAC_SHA256 prng(key32, 32, msg32, 32);
+    uint256 nonce;
+    for (unsigned int i = 0; i <= attempt; i++)
+        prng.Generate((unsigned char*)&nonce, 32);
+    if (data)
+        nonce += *(const uint32_t*)data;
+    memcpy(nonce32, &nonce, 32);
+    nonce = 0;
+    return 1;
+}
 
 } // anon namespace
 
 bool CKey::Check(const unsigned char* vch)
 {
-    return eccrypto::Check(vch);
+    return secp256k1_ec_seckey_verify2(GetContext(), vch);
 }
 
 void CKey::MakeNewKey(bool fCompressedIn)
@@ -48,7 +52,7 @@ void CKey::MakeNewKey(bool fCompressedIn)
 
 bool CKey::SetPrivKey(const CPrivKey& privkey, bool fCompressedIn)
 {
-    if (!secp256k1_ec_privkey_import((unsigned char*)begin(), &privkey[0], privkey.size()))
+    if (privkey.empty() || !ec_privkey_import_der(GetContext(), (unsigned char*)begin(), &privkey[0], privkey.size()))
         return false;
     fCompressed = fCompressedIn;
     fValid = true;
@@ -67,10 +71,11 @@ CPrivKey CKey::GetPrivKey() const
 {
     assert(fValid);
     CPrivKey privkey;
-    int privkeylen, ret;
+    int ret;
+    size_t privkeylen;
     privkey.resize(279);
     privkeylen = 279;
-    ret = secp256k1_ec_privkey_export(begin(), (unsigned char*)&privkey[0], &privkeylen, fCompressed);
+    ret = ec_privkey_export_der(GetContext(), (unsigned char*)&privkey[0], &privkeylen, begin(), fCompressed);
     assert(ret);
     privkey.resize(privkeylen);
     return privkey;
@@ -79,11 +84,13 @@ CPrivKey CKey::GetPrivKey() const
 CPubKey CKey::GetPubKey() const
 {
     assert(fValid);
+    secp256k1_pubkey2 pubkey;
+    size_t clen = 65;
     CPubKey result;
-    int clen = 65;
-    int ret = secp256k1_ec_pubkey_create((unsigned char*)result.begin(), &clen, begin(), fCompressed);
-    assert((int)result.size() == clen);
+    int ret = secp256k1_ec_pubkey_create2(GetContext(), &pubkey, begin());
     assert(ret);
+    secp256k1_ec_pubkey_serialize2(GetContext(), (unsigned char*)result.begin(), &clen, &pubkey, fCompressed ? SECP256K1_EC_COMPRESSED : SECP256K1_EC_UNCOMPRESSED);
+    assert(result.size() == clen);
     assert(result.IsValid());
     return result;
 }
@@ -93,19 +100,13 @@ bool CKey::Sign(const uint256& hash, std::vector<unsigned char>& vchSig, uint32_
     if (!fValid)
         return false;
     vchSig.resize(72);
-    RFC6979_HMAC_SHA256 prng(begin(), 32, (unsigned char*)&hash, 32);
-    do {
-        uint256 nonce;
-        prng.Generate((unsigned char*)&nonce, 32);
-        nonce += test_case;
-        int nSigLen = 72;
-        int ret = secp256k1_ecdsa_sign((const unsigned char*)&hash, 32, (unsigned char*)&vchSig[0], &nSigLen, begin(), (unsigned char*)&nonce);
-        nonce = 0;
-        if (ret) {
-            vchSig.resize(nSigLen);
-            return true;
-        }
-    } while (true);
+    size_t nSigLen = 72;
+    secp256k1_ecdsa_sign2ature2 sig;
+    int ret = secp256k1_ecdsa_sign2(GetContext(), &sig, (const unsigned char*)&hash, begin(), nonce_function_dapscoin, &test_case);
+    assert(ret);
+    secp256k1_ecdsa_sign2ature2_serialize_der(GetContext(), (unsigned char*)&vchSig[0], &nSigLen, &sig);
+    vchSig.resize(nSigLen);
+    return true;
 }
 
 bool CKey::VerifyPubKey(const CPubKey& pubkey) const
@@ -129,15 +130,10 @@ bool CKey::SignCompact(const uint256& hash, std::vector<unsigned char>& vchSig)
         return false;
     vchSig.resize(65);
     int rec = -1;
-    RFC6979_HMAC_SHA256 prng(begin(), 32, (unsigned char*)&hash, 32);
-    do {
-        uint256 nonce;
-        prng.Generate((unsigned char*)&nonce, 32);
-        int ret = secp256k1_ecdsa_sign_compact((const unsigned char*)&hash, 32, &vchSig[1], begin(), (unsigned char*)&nonce, &rec);
-        nonce = 0;
-        if (ret)
-            break;
-    } while (true);
+    secp256k1_ecdsa_recoverable_signature sig;
+    int ret = secp256k1_ecdsa_sign2_recoverable(GetContext(), &sig, (const unsigned char*)&hash, begin(), nonce_function_dapscoin, NULL);
+    assert(ret);
+    secp256k1_ecdsa_recoverable_signature_serialize_compact(GetContext(), (unsigned char*)&vchSig[1], &rec, &sig);
     assert(rec != -1);
     vchSig[0] = 27 + rec + (fCompressed ? 4 : 0);
     return true;
@@ -145,7 +141,7 @@ bool CKey::SignCompact(const uint256& hash, std::vector<unsigned char>& vchSig)
 
 bool CKey::Load(CPrivKey& privkey, CPubKey& vchPubKey, bool fSkipCheck = false)
 {
-    if (!secp256k1_ec_privkey_import((unsigned char*)begin(), &privkey[0], privkey.size()))
+    if (privkey.empty() || !ec_privkey_import_der(GetContext(), (unsigned char*)begin(), &privkey[0], privkey.size()))
         return false;
     fCompressed = vchPubKey.IsCompressed();
     fValid = true;
@@ -172,7 +168,7 @@ bool CKey::Derive(CKey& keyChild, unsigned char ccChild[32], unsigned int nChild
     }
     memcpy(ccChild, out + 32, 32);
     memcpy((unsigned char*)keyChild.begin(), begin(), 32);
-    bool ret = secp256k1_ec_privkey_tweak_add((unsigned char*)keyChild.begin(), out);
+    bool ret = ECPrivKeyTweakAdd((unsigned char*)keyChild.begin(), out);
     UnlockObject(out);
     keyChild.fCompressed = true;
     keyChild.fValid = ret;
@@ -238,11 +234,6 @@ void CExtKey::Decode(const unsigned char code[74])
 
 bool ECC_InitSanityCheck()
 {
-#if !defined(USE_SECP256K1)
-    if (!CECKey::SanityCheck()) {
-        return false;
-    }
-#endif
     CKey key;
     key.MakeNewKey(true);
     CPubKey pubkey = key.GetPubKey();
@@ -10,19 +10,24 @@
 
 #include "addrman.h"
 #include "alert.h"
+#include "blockfilewriter.h"
 #include "chainparams.h"
 #include "checkpoints.h"
 #include "checkqueue.h"
+#include "decoyprovider.h"
 #include "init.h"
 #include "kernel.h"
 #include "masternode-budget.h"
 #include "masternode-payments.h"
 #include "masternodeman.h"
 #include "merkleblock.h"
+#include "msgprecheck.h"
 #include "net.h"
 #include "obfuscation.h"
 #include "poa.h"
 #include "pow.h"
+#include "proofcache.h"
+#include "txprevalidator.h"
 #include "swifttx.h"
 #include "txdb.h"
 #include "txmempool.h"
@@ -247,43 +252,45 @@ void SyncWithWallets(const CTransaction& tx, const CBlock* pblock)
     g_signals.SyncTransaction(tx, pblock);
 }
 
-CAmount GetValueIn(CCoinsViewCache view, const CTransaction& tx)
+/** Value of the inputs of a coinstake, hidden amounts decoded with the keys the coinstake carries */
+static CAmount GetCoinStakeValueIn(const CTransaction& tx)
 {
-    if (tx.IsCoinBase())
-        return 0;
-
     CAmount nResult = 0;
-
-    if (tx.IsCoinStake()) {
-        for (unsigned int i = 0; i < tx.vin.size(); i++) {
-            CAmount nValueIn; // = txPrev.vout[prevout.n].nValue;
-            uint256 hashBlock;
-            CTransaction txPrev;
-            GetTransaction(tx.vin[i].prevout.hash, txPrev, hashBlock, true);
-            const CTxOut& out = txPrev.vout[tx.vin[i].prevout.n];
-            if (out.nValue > 0) {
-                nResult += out.nValue;
-            } else {
-                uint256 val = out.maskValue.amount;
-                uint256 mask = out.maskValue.mask;
-                CKey decodedMask;
-                CPubKey sharedSec;
-                sharedSec.Set(tx.vin[i].encryptionKey.begin(), tx.vin[i].encryptionKey.begin() + 33);
-                ECDHInfo::Decode(mask.begin(), val.begin(), sharedSec, decodedMask, nValueIn);
-                //Verify commitment
-                std::vector<unsigned char> commitment;
-                CWallet::CreateCommitment(decodedMask.begin(), nValueIn, commitment);
-                if (commitment != out.commitment) {
-                    throw runtime_error("Commitment for coinstake not correct");
-                }
-                nResult += nValueIn;
+    for (unsigned int i = 0; i < tx.vin.size(); i++) {
+        CAmount nValueIn; // = txPrev.vout[prevout.n].nValue;
+        uint256 hashBlock;
+        CTransaction txPrev;
+        GetTransaction(tx.vin[i].prevout.hash, txPrev, hashBlock, true);
+        const CTxOut& out = txPrev.vout[tx.vin[i].prevout.n];
+        if (out.nValue > 0) {
+            nResult += out.nValue;
+        } else {
+            uint256 val = out.maskValue.amount;
+            uint256 mask = out.maskValue.mask;
+            CKey decodedMask;
+            CPubKey sharedSec;
+            sharedSec.Set(tx.vin[i].encryptionKey.begin(), tx.vin[i].encryptionKey.begin() + 33);
+            ECDHInfo::Decode(mask.begin(), val.begin(), sharedSec, decodedMask, nValueIn);
+            //Verify commitment
+            std::vector<unsigned char> commitment;
+            CWallet::CreateCommitment(decodedMask.begin(), nValueIn, commitment);
+            if (commitment != out.commitment) {
+                throw runtime_error("Commitment for coinstake not correct");
             }
+            nResult += nValueIn;
         }
     }
 
     return nResult;
 }
 
+CAmount GetValueIn(CCoinsViewCache view, const CTransaction& tx)
+{
+    if (tx.IsCoinStake())
+        return GetCoinStakeValueIn(tx);
+    return 0;
+}
+
 //! Return priority of tx at height nHeight
 double GetPriority(const CTransaction& tx, int nHeight)
 {
@@ -346,39 +353,34 @@ bool IsKeyImageSpend1(const std::string& kiHex, const uint256& againsHash)
     return false;
 }
 
-bool CheckKeyImageSpendInMainChain(const std::string& kiHex, int& confirmations)
+CBlockIndex* FindKeyImageSpendBlock(const std::string& kiHex)
 {
-    confirmations = 0;
-    if (kiHex.empty()) return false;
+    if (kiHex.empty()) return NULL;
     std::vector<uint256> bhs;
     if (!pblocktree->ReadKeyImages(kiHex, bhs)) {
         //not spent yet because not found in database
-        return false;
-    }
-    if (bhs.empty()) {
-        return false;
+        return NULL;
     }
-    for (int i = 0; i < bhs.size(); i++) {
-        uint256 bh = bhs[i];
+    for (size_t i = 0; i < bhs.size(); i++) {
         //check if bh is in main chain
-        // Find the block it claims to be in
-        BlockMap::iterator mi = mapBlockIndex.find(bh);
+        BlockMap::iterator mi = mapBlockIndex.find(bhs[i]);
         if (mi == mapBlockIndex.end())
             continue;
         CBlockIndex* pindex = (*mi).second;
-        if (pindex && chainActive.Contains(pindex)) {
-            confirmations = 1 + chainActive.Height() - pindex->nHeight;
-            return true;
-        }
+        if (pindex && chainActive.Contains(pindex))
+            return pindex;
     }
-    return false;
+    return NULL;
 }
 
-secp256k1_context2* GetContext()
+bool CheckKeyImageSpendInMainChain(const std::string& kiHex, int& confirmations)
 {
-    static secp256k1_context2* both;
-    if (!both) both = secp256k1_context_create2(SECP256K1_CONTEXT_SIGN | SECP256K1_CONTEXT_VERIFY);
-    return both;
+    confirmations = 0;
+    CBlockIndex* pindex = FindKeyImageSpendBlock(kiHex);
+    if (!pindex)
+        return false;
+    confirmations = 1 + chainActive.Height() - pindex->nHeight;
+    return true;
 }
 
 secp256k1_scratch_space2* GetScratch()
@@ -399,16 +401,112 @@ void DestroyContext()
 {
     secp256k1_bulletproof_generators_destroy(GetContext(), GetGenerator());
     secp256k1_scratch_space_destroy(GetScratch());
-    secp256k1_context_destroy(GetContext());
+}
+
+bool CResolvedRing::Resolve(const CTransaction& tx)
+{
+    if (fResolved && hashTx == tx.GetHash())
+        return fValid;
+    hashTx = tx.GetHash();
+    fResolved = true;
+    fValid = false;
+    vInputs.assign(tx.vin.size(), std::vector<CMember>());
+
+    // Callers need not hold cs_main, see PreValidateTransaction: members are read through
+    // the txindex and the mempool lock only, cs_main is taken once for the block index
+    for (size_t i = 0; i < tx.vin.size(); i++) {
+        std::vector<COutPoint> decoysForIn;
+        decoysForIn.push_back(tx.vin[i].prevout);
+        decoysForIn.insert(decoysForIn.end(), tx.vin[i].decoys.begin(), tx.vin[i].decoys.end());
+        vInputs[i].resize(decoysForIn.size());
+        for (size_t j = 0; j < decoysForIn.size(); j++) {
+            CMember& member = vInputs[i][j];
+            member.outpoint = decoysForIn[j];
+            CTransaction txPrev;
+            if (!LookupTransaction(member.outpoint.hash, txPrev, member.hashBlock)) {
+                LogPrintf("failed to find transaction %s\n", member.outpoint.hash.GetHex());
+                return false;
+            }
+            if (member.outpoint.n >= txPrev.vout.size())
+                return false;
+            const CTxOut& out = txPrev.vout[member.outpoint.n];
+            member.fCoinBase = txPrev.IsCoinStake() || txPrev.IsCoinAudit() || txPrev.IsCoinBase();
+            member.fHavePubKey = ExtractPubKey(out.scriptPubKey, member.pubKey);
+            member.commitment = out.commitment;
+        }
+    }
+
+    {
+        LOCK(cs_main);
+        for (size_t i = 0; i < vInputs.size(); i++) {
+            for (size_t j = 0; j < vInputs[i].size(); j++) {
+                CMember& member = vInputs[i][j];
+                BlockMap::iterator mi = mapBlockIndex.find(member.hashBlock);
+                member.pindex = mi == mapBlockIndex.end() ? NULL : mi->second;
+                if (!member.pindex)
+                    return false;
+            }
+        }
+    }
+    fValid = true;
+    return true;
+}
+
+bool CResolvedRing::IsMature(int nSpendHeight) const
+{
+    for (size_t i = 0; i < vInputs.size(); i++) {
+        for (size_t j = 0; j < vInputs[i].size(); j++) {
+            const CMember& member = vInputs[i][j];
+            if (member.fCoinBase && nSpendHeight - member.pindex->nHeight < Params().COINBASE_MATURITY())
+                return false;
+        }
+    }
+    return true;
+}
+
+bool CResolvedRing::IsInActiveChain() const
+{
+    LOCK(cs_main);
+    const CBlockIndex* tip = chainActive.Tip();
+    for (size_t i = 0; i < vInputs.size(); i++) {
+        for (size_t j = 0; j < vInputs[i].size(); j++) {
+            //verify that tip and hashBlock must be in the same fork
+            const CMember& member = vInputs[i][j];
+            if (tip->GetAncestor(member.pindex->nHeight) != member.pindex) {
+                LogPrintf("Decoy for transactions %s not in the same chain with block %s\n", member.outpoint.hash.GetHex(), tip->GetBlockHash().GetHex());
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+void CResolvedRing::AddToHash(CHashWriter& hasher) const
+{
+    for (size_t i = 0; i < vInputs.size(); i++) {
+        for (size_t j = 0; j < vInputs[i].size(); j++) {
+            const CMember& member = vInputs[i][j];
+            hasher << member.hashBlock << member.fHavePubKey << member.pubKey << member.commitment;
+        }
+    }
 }
 
 bool VerifyBulletProofAggregate(const CTransaction& tx)
+{
+    return VerifyBulletProofAggregate(tx, GetScratch());
+}
+
+bool VerifyBulletProofAggregate(const CTransaction& tx, secp256k1_scratch_space2* scratch)
 {
     if (IsInitialBlockDownload()) return true;
     size_t len = tx.bulletproofs.size();
     if (tx.vout.size() >= 5) return false;
 
     if (len == 0) return false;
+    // The proof only covers data inside the transaction, its hash is enough
+    uint256 cacheKey = proofCache.KeyWriter(CProofCache::BULLETPROOF, tx.GetHash()).GetHash();
+    if (proofCache.Contains(cacheKey))
+        return true;
     const size_t MAX_VOUT = 5;
     secp256k1_pedersen_commitment commitments[MAX_VOUT];
     size_t i = 0;
@@ -416,10 +514,13 @@ bool VerifyBulletProofAggregate(const CTransaction& tx)
         if (!secp256k1_pedersen_commitment_parse(GetContext(), &commitments[i], &(tx.vout[i].commitment[0])))
             throw runtime_error("Failed to parse pedersen commitment");
     }
-    return secp256k1_bulletproof_rangeproof_verify(GetContext(), GetScratch(), GetGenerator(), &(tx.bulletproofs[0]), len, NULL, commitments, tx.vout.size(), 64, &secp256k1_generator_const_h, NULL, 0);
+    if (!secp256k1_bulletproof_rangeproof_verify(GetContext(), scratch, GetGenerator(), &(tx.bulletproofs[0]), len, NULL, commitments, tx.vout.size(), 64, &secp256k1_generator_const_h, NULL, 0))
+        return false;
+    proofCache.Insert(cacheKey);
+    return true;
 }
 
-bool VerifyRingSignatureWithTxFee(const CTransaction& tx, CBlockIndex* pindex)
+bool VerifyRingSignatureWithTxFee(const CTransaction& tx, CBlockIndex* pindex, CResolvedRing* pring)
 {
     if (tx.nTxFee < 0) return false;
     if (IsInitialBlockDownload()) return true;
@@ -463,46 +564,30 @@ bool VerifyRingSignatureWithTxFee(const CTransaction& tx, CBlockIndex* pindex)
         memcpy(allKeyImages[j], tx.vin[j].keyImage.begin(), 33);
     }
 
+    CResolvedRing ringLocal;
+    CResolvedRing& ring = pring ? *pring : ringLocal;
+    if (!ring.Resolve(tx) || !ring.IsInActiveChain())
+        return false;
+
+    //the cache key covers what every ring member resolved to
+    CHashWriter cacheKeyWriter = proofCache.KeyWriter(CProofCache::RING_SIGNATURE, tx.GetHash());
+    ring.AddToHash(cacheKeyWriter);
+
     //extract all public keys
     for (size_t i = 0; i < tx.vin.size(); i++) {
-        std::vector<COutPoint> decoysForIn;
-        decoysForIn.push_back(tx.vin[i].prevout);
-        for (size_t j = 0; j < tx.vin[i].decoys.size(); j++) {
-            decoysForIn.push_back(tx.vin[i].decoys[j]);
-        }
         for (size_t j = 0; j < tx.vin[0].decoys.size() + 1; j++) {
-            CTransaction txPrev;
-            uint256 hashBlock;
-            if (!GetTransaction(decoysForIn[j].hash, txPrev, hashBlock)) {
-                LogPrintf("failed to find transaction %s\n", decoysForIn[j].hash.GetHex());
-                return false;
-            }
-            CBlockIndex* tip = chainActive.Tip();
-            if (!pindex) tip = pindex;
-
-            uint256 hashTip = tip->GetBlockHash();
-            //verify that tip and hashBlock must be in the same fork
-            CBlockIndex* atTheblock = mapBlockIndex[hashBlock];
-            if (!atTheblock) {
-                LogPrintf("Decoy for transactions %s not in the same chain with block %s\n", decoysForIn[j].hash.GetHex(), tip->GetBlockHash().GetHex());
-                return false;
-            } else {
-                CBlockIndex* ancestor = tip->GetAncestor(atTheblock->nHeight);
-                if (ancestor != atTheblock) {
-                    LogPrintf("Decoy for transactions %s not in the same chain with block %s\n", decoysForIn[j].hash.GetHex(), tip->GetBlockHash().GetHex());
-                    return false;
-                }
-            }
-
-            CPubKey extractedPub;
-            if (!ExtractPubKey(txPrev.vout[decoysForIn[j].n].scriptPubKey, extractedPub)) {
+            const CResolvedRing::CMember& member = ring.vInputs[i][j];
+            if (!member.fHavePubKey) {
                 LogPrintf("failed to extract pubkey\n");
                 return false;
             }
-            memcpy(allInPubKeys[i][j], extractedPub.begin(), 33);
-            memcpy(allInCommitments[i][j], &(txPrev.vout[decoysForIn[j].n].commitment[0]), 33);
+            memcpy(allInPubKeys[i][j], member.pubKey.begin(), 33);
+            memcpy(allInCommitments[i][j], &(member.commitment[0]), 33);
         }
     }
+    uint256 cacheKey = cacheKeyWriter.GetHash();
+    if (proofCache.Contains(cacheKey))
+        return true;
     memcpy(allKeyImages[tx.vin.size()], tx.ntxFeeKeyImage.begin(), 33);
 
     for (size_t i = 0; i < tx.vin[0].decoys.size() + 1; i++) {
@@ -578,12 +663,12 @@ bool VerifyRingSignatureWithTxFee(const CTransaction& tx, CBlockIndex* pindex)
             //compute LIJ, RIJ
             unsigned char P[33];
             memcpy(P, allInPubKeys[i][j], 33);
-            if (!secp256k1_ec_pubkey_tweak_mul(P, 33, C)) {
+            if (!ECPubKeyTweakMul(P, 33, C)) {
                 LogPrintf("failed to mul pubkey\n");
                 return false;
             }
 
-            if (!secp256k1_ec_pubkey_tweak_add(P, 33, SIJ[i][j])) {
+            if (!ECPubKeyTweakAdd(P, 33, SIJ[i][j])) {
                 LogPrintf("failed to add pubkey\n");
                 return false;
             }
@@ -598,7 +683,7 @@ bool VerifyRingSignatureWithTxFee(const CTransaction& tx, CBlockIndex* pindex)
 
             unsigned char ci[33];
             memcpy(ci, allKeyImages[i], 33);
-            if (!secp256k1_ec_pubkey_tweak_mul(ci, 33, C)) {
+            if (!ECPubKeyTweakMul(ci, 33, C)) {
                 LogPrintf("failed to mul tweak\n");
                 return false;
             }
@@ -639,7 +724,10 @@ bool VerifyRingSignatureWithTxFee(const CTransaction& tx, CBlockIndex* pindex)
         memcpy(C, temppi1.begin(), 32);
     }
     //LogPrintf("Verifying\n");
-    return HexStr(tx.c.begin(), tx.c.end()) == HexStr(C, C + 32);
+    if (HexStr(tx.c.begin(), tx.c.end()) != HexStr(C, C + 32))
+        return false;
+    proofCache.Insert(cacheKey);
+    return true;
 }
 
 bool IsKeyImageSpend2(const std::string& kiHex, const uint256& bh)
@@ -664,12 +752,19 @@ bool IsKeyImageSpend2(const std::string& kiHex, const uint256& bh)
 }
 
 bool ReVerifyPoSBlock(CBlockIndex* pindex)
+{
+    LOCK(cs_main);
+    if (!pindex) return false;
+    CBlock block;
+    if (!ReadBlockFromDisk(block, pindex)) return false;
+    return ReVerifyPoSBlock(pindex, block);
+}
+
+bool ReVerifyPoSBlock(CBlockIndex* pindex, const CBlock& block)
 {
     LOCK(cs_main);
     {
         if (!pindex) return false;
-        CBlock block;
-        if (!ReadBlockFromDisk(block, pindex)) return false;
         if (!pindex->IsProofOfStake()) return false;
         CAmount nFees = 0;
         CAmount nValueIn = 0;
@@ -678,7 +773,8 @@ bool ReVerifyPoSBlock(CBlockIndex* pindex)
             const CTransaction& tx = block.vtx[i];
             if (!tx.IsCoinStake()) {
                 if (!tx.IsCoinAudit()) {
-                    if (!VerifyRingSignatureWithTxFee(tx, pindex))
+                    CResolvedRing ring;
+                    if (!VerifyRingSignatureWithTxFee(tx, pindex, &ring))
                         return false;
                     if (!VerifyBulletProofAggregate(tx))
                         return false;
@@ -688,6 +784,10 @@ bool ReVerifyPoSBlock(CBlockIndex* pindex)
         }
 
         const CTransaction coinstake = block.vtx[1];
+        if (!VerifyShnorrKeyImageTx(coinstake)) {
+            LogPrintf("ReVerifyPoSBlock() : Failed to verify shnorr signature of the coinstake");
+            return false;
+        }
         CCoinsViewCache view(pcoinsTip);
         nValueIn = GetValueIn(view, coinstake);
         nValueOut = coinstake.GetValueOut();
@@ -748,6 +848,27 @@ bool ReVerifyPoSBlock(CBlockIndex* pindex)
     }
 }
 
+void ReadAuditedPoSBlocks(const CBlock& block, std::map<uint256, CBlock>& mapBlocks)
+{
+    LOCK(cs_main);
+    std::vector<const CTransaction*> vCoinstakes;
+    for (size_t i = 0; i < block.posBlocksAudited.size(); i++) {
+        const uint256& hash = block.posBlocksAudited[i].hash;
+        BlockMap::iterator mi = mapBlockIndex.find(hash);
+        if (mi == mapBlockIndex.end() || !mi->second || !mi->second->IsProofOfStake() || mapBlocks.count(hash))
+            continue;
+        CBlock& audited = mapBlocks[hash];
+        if (!ReadBlockFromDisk(audited, mi->second)) {
+            mapBlocks.erase(hash);
+            continue;
+        }
+        if (audited.vtx.size() > 1)
+            vCoinstakes.push_back(&audited.vtx[1]);
+    }
+    // Fills the proof cache for ReVerifyPoSBlock, which reports the failures
+    VerifyShnorrKeyImageTxs(vCoinstakes);
+}
+
 uint256 GetTxSignatureHash(const CTransaction& tx)
 {
     CTransactionSignature cts(tx);
@@ -1403,7 +1524,7 @@ unsigned int GetLegacySigOpCount(const CTransaction& tx)
     return nSigOps;
 }
 
-int GetInputAge(CTxIn& vin)
+int GetInputAge(const CTxIn& vin)
 {
     CCoinsView viewDummy;
     CCoinsViewCache view(&viewDummy);
@@ -1524,19 +1645,30 @@ bool IsSerialInBlockchain(const CBigNum& bnSerial, int& nHeightTx)
     return inChain;
 }
 
+static uint256 GetKeyImageProofCacheKey(const CTxIn& txin, const uint256& ctsHash)
+{
+    // The prevout fixes the output key the proof is checked against
+    CHashWriter ss = proofCache.KeyWriter(CProofCache::KEY_IMAGE_PROOF, txin.prevout.hash);
+    ss << txin.prevout.n << txin.keyImage << txin.R << txin.s << ctsHash;
+    return ss.GetHash();
+}
+
 bool VerifyShnorrKeyImageTxIn(const CTxIn& txin, uint256 ctsHash)
 {
+    uint256 cacheKey = GetKeyImageProofCacheKey(txin, ctsHash);
+    if (proofCache.Contains(cacheKey))
+        return true;
     COutPoint prevout = txin.prevout;
     CTransaction prev;
     uint256 bh;
-    if (!GetTransaction(prevout.hash, prev, bh, true)) {
+    if (!LookupTransaction(prevout.hash, prev, bh) || prevout.n >= prev.vout.size()) {
         return false;
     }
     uint256 s(txin.s);
     unsigned char S[33];
     CPubKey P;
     ExtractPubKey(prev.vout[prevout.n].scriptPubKey, P);
-    PointHashingSuccessively(P, s.begin(), S);
+    if (!PointHashingSuccessively(P, s.begin(), S)) return false;
     CPubKey R(txin.R.begin(), txin.R.end());
 
     //compute H(R)I = eI
@@ -1546,7 +1678,7 @@ bool VerifyShnorrKeyImageTxIn(const CTxIn& txin, uint256 ctsHash)
     uint256 e = Hash(buff, buff + 65);
     unsigned char eI[33];
     memcpy(eI, txin.keyImage.begin(), 33);
-    if (!secp256k1_ec_pubkey_tweak_mul(eI, 33, e.begin())) return false;
+    if (!ECPubKeyTweakMul(eI, 33, e.begin())) return false;
 
     secp256k1_pedersen_commitment R_commitment;
     secp256k1_pedersen_serialized_pubkey_to_commitment(R.begin(), 33, &R_commitment);
@@ -1568,9 +1700,89 @@ bool VerifyShnorrKeyImageTxIn(const CTxIn& txin, uint256 ctsHash)
 
     for (int i = 0; i < 33; i++)
         if (S[i] != recomputed[i]) return false;
+    proofCache.Insert(cacheKey);
     return true;
 }
 
+/** A key image proof of VerifyShnorrKeyImageTxIn in the form the batch verifier takes */
+struct CKeyImageProof {
+    uint256 cacheKey;
+    secp256k1_pubkey2 hashed;
+    uint256 s;
+    secp256k1_pubkey2 R;
+    uint256 e;
+    secp256k1_pubkey2 keyImage;
+};
+
+//! Whether the proof of txin could be put in batch form, anything unusual is left to VerifyShnorrKeyImageTxIn
+static bool GetKeyImageProof(const CTxIn& txin, const uint256& ctsHash, CKeyImageProof& proof)
+{
+    if (txin.s.size() != 32 || txin.R.size() != 33 || txin.keyImage.size() != 33)
+        return false;
+    CTransaction prev;
+    uint256 bh;
+    if (!LookupTransaction(txin.prevout.hash, prev, bh) || txin.prevout.n >= prev.vout.size())
+        return false;
+    CPubKey P;
+    unsigned char H[33];
+    if (!ExtractPubKey(prev.vout[txin.prevout.n].scriptPubKey, P) || !PointHashing(P, H))
+        return false;
+
+    unsigned char buff[33 + 32];
+    memcpy(buff, &txin.R[0], 33);
+    memcpy(buff + 33, ctsHash.begin(), 32);
+    proof.e = Hash(buff, buff + 65);
+    proof.s = uint256(txin.s);
+    proof.cacheKey = GetKeyImageProofCacheKey(txin, ctsHash);
+    return secp256k1_ec_pubkey_parse2(GetContext(), &proof.hashed, H, 33) &&
+           secp256k1_ec_pubkey_parse2(GetContext(), &proof.R, &txin.R[0], 33) &&
+           secp256k1_ec_pubkey_parse2(GetContext(), &proof.keyImage, txin.keyImage.begin(), 33);
+}
+
+bool VerifyShnorrKeyImageTxs(const std::vector<const CTransaction*>& vtx)
+{
+    int64_t nTimeStart = GetTimeMicros();
+    bool fAllBatched = true;
+    std::vector<CKeyImageProof> vProofs;
+    vProofs.reserve(vtx.size());
+    for (size_t i = 0; i < vtx.size(); i++) {
+        if (!vtx[i]->IsCoinStake())
+            continue;
+        const CTxIn& txin = vtx[i]->vin[0];
+        uint256 ctsHash = GetTxInSignatureHash(txin);
+        if (proofCache.Contains(GetKeyImageProofCacheKey(txin, ctsHash)))
+            continue;
+        vProofs.push_back(CKeyImageProof());
+        if (!GetKeyImageProof(txin, ctsHash, vProofs.back())) {
+            vProofs.pop_back();
+            fAllBatched = false;
+        }
+    }
+    if (vProofs.empty())
+        return fAllBatched;
+
+    std::vector<const secp256k1_pubkey2*> vHashed, vR, vKeyImage;
+    std::vector<const unsigned char*> vS, vE;
+    for (size_t i = 0; i < vProofs.size(); i++) {
+        vHashed.push_back(&vProofs[i].hashed);
+        vS.push_back(vProofs[i].s.begin());
+        vR.push_back(&vProofs[i].R);
+        vE.push_back(vProofs[i].e.begin());
+        vKeyImage.push_back(&vProofs[i].keyImage);
+    }
+    // A scratch space of its own, this runs on the message pre-check threads as well
+    secp256k1_scratch_space2* scratch = secp256k1_scratch_space_create(GetContext(), 16 * 1024 * 1024);
+    bool fValid = secp256k1_keyimage_schnorr_verify_batch(GetContext(), scratch, &vHashed[0], &vS[0], &vR[0], &vE[0], &vKeyImage[0], vProofs.size());
+    secp256k1_scratch_space_destroy(scratch);
+    LogPrint("bench", "    - Verify %u key image proofs in one batch: %.2fms\n", vProofs.size(), (GetTimeMicros() - nTimeStart) * 0.001);
+    if (!fValid)
+        return false;
+
+    for (size_t i = 0; i < vProofs.size(); i++)
+        proofCache.Insert(vProofs[i].cacheKey);
+    return fAllBatched;
+}
+
 bool VerifyShnorrKeyImageTx(const CTransaction& tx)
 {
     //check if a transaction is staking or spending collateral
@@ -1677,59 +1889,24 @@ CAmount GetMinRelayFee(const CTransaction& tx, unsigned int nBytes, bool fAllowF
     return nMinFee;
 }
 
-bool CheckHaveInputs(const CCoinsViewCache& view, const CTransaction& tx)
+bool CheckHaveInputs(const CCoinsViewCache& view, const CTransaction& tx, CResolvedRing* pring)
 {
     CBlockIndex* pindexPrev = mapBlockIndex.find(view.GetBestBlock())->second;
+    return CheckHaveInputs(pindexPrev, tx, pring);
+}
+
+bool CheckHaveInputs(const CBlockIndex* pindexPrev, const CTransaction& tx, CResolvedRing* pring)
+{
     int nSpendHeight = pindexPrev->nHeight + 1;
     if (!tx.IsCoinBase()) {
-        for (unsigned int i = 0; i < tx.vin.size(); i++) {
-            //check output and decoys
-            std::vector<COutPoint> alldecoys = tx.vin[i].decoys;
-
-            alldecoys.push_back(tx.vin[i].prevout);
-            for (size_t j = 0; j < alldecoys.size(); j++) {
-                CTransaction prev;
-                uint256 bh;
-                if (!GetTransaction(alldecoys[j].hash, prev, bh, true)) {
-                    return false;
-                }
-
-                //TODO-NOTE: 07/06/2019 Remove this condition as colateral will be cheated as a normal tx
-                //UTXO with 1M DAPS can only be consumed in a transaction with that single UTXO
-                /*if (decoysSize > 1 && prev.vout[alldecoys[j].n].nValue == 1000000 * COIN) {
-					return false;
-				}
-
-				if (prev.vout[alldecoys[j].n].nValue == 1000000 * COIN) {
-					if (!VerifyKeyImages(tx)) {
-						LogPrintf("Failed to verify correctness of key image of collateralization spend\n");
-						return false;
-					}
-				}*/
-
-                if (mapBlockIndex.count(bh) < 1) return false;
-                if (prev.IsCoinStake() || prev.IsCoinAudit() || prev.IsCoinBase()) {
-                    if (nSpendHeight - mapBlockIndex[bh]->nHeight < Params().COINBASE_MATURITY()) return false;
-                }
-
-                CBlockIndex* tip = chainActive.Tip();
-                if (!pindexPrev) tip = pindexPrev;
+        //check output and decoys
+        CResolvedRing ringLocal;
+        CResolvedRing& ring = pring ? *pring : ringLocal;
+        if (!ring.Resolve(tx) || !ring.IsMature(nSpendHeight) || !ring.IsInActiveChain())
+            return false;
 
-                uint256 hashTip = tip->GetBlockHash();
-                //verify that tip and hashBlock must be in the same fork
-                CBlockIndex* atTheblock = mapBlockIndex[bh];
-                if (!atTheblock) {
-                    LogPrintf("Decoy for transactions %s not in the same chain with block %s\n", alldecoys[j].hash.GetHex(), tip->GetBlockHash().GetHex());
-                    return false;
-                } else {
-                    CBlockIndex* ancestor = tip->GetAncestor(atTheblock->nHeight);
-                    if (ancestor != atTheblock) {
-                        LogPrintf("Decoy for transactions %s not in the same chain with block %s\n", alldecoys[j].hash.GetHex(), tip->GetBlockHash().GetHex());
-                        return false;
-                    }
-                }
-            }
-            if (!tx.IsCoinStake()) {
+        if (!tx.IsCoinStake()) {
+            for (unsigned int i = 0; i < tx.vin.size(); i++) {
                 if (tx.vin[i].decoys.size() != tx.vin[0].decoys.size()) {
                     LogPrintf("Transaction does not have the same ring size for inputs\n");
                     return false;
@@ -1748,6 +1925,44 @@ bool CheckHaveInputs(const CCoinsViewCache& view, const CTransaction& tx)
 }
 
 
+bool PreValidateTransaction(const CTransaction& tx, CValidationState& state, secp256k1_scratch_space2* scratch)
+{
+    // Everything AcceptToMemoryPool turns down before looking at the proofs is left to it
+    if (tx.nTxFee <= BASE_FEE || tx.IsCoinBase() || tx.IsCoinStake() || tx.IsCoinAudit())
+        return true;
+    if (!CheckTransaction(tx, false, true, state))
+        return state.DoS(100, error("PreValidateTransaction : CheckTransaction failed"), REJECT_INVALID, "bad-tx");
+    string reason;
+    if (Params().RequireStandard() && !IsStandardTx(tx, reason))
+        return true;
+    if (mempool.exists(tx.GetHash()))
+        return true;
+
+    CBlockIndex* pindexTip;
+    {
+        LOCK(cs_main);
+        pindexTip = chainActive.Tip();
+    }
+    CResolvedRing ring;
+    if (!pindexTip || !CheckHaveInputs(pindexTip, tx, &ring))
+        return true;
+
+    int64_t nTimeStart = GetTimeMicros();
+    if (!VerifyRingSignatureWithTxFee(tx, pindexTip, &ring)) {
+        // A ring member may have been reorganized away meanwhile, let AcceptToMemoryPool judge that
+        LOCK(cs_main);
+        if (chainActive.Tip() != pindexTip)
+            return true;
+        return state.DoS(100, error("PreValidateTransaction : Ring Signature check for transaction %s failed", tx.GetHash().ToString()),
+            REJECT_INVALID, "bad-ring-signature");
+    }
+    if (!VerifyBulletProofAggregate(tx, scratch))
+        return state.DoS(100, error("PreValidateTransaction : Bulletproof check for transaction %s failed", tx.GetHash().ToString()),
+            REJECT_INVALID, "bad-bulletproof");
+    LogPrint("bench", "    - Pre-validate %s: %.2fms\n", tx.GetHash().ToString(), 0.001 * (GetTimeMicros() - nTimeStart));
+    return true;
+}
+
 bool AcceptToMemoryPool(CTxMemPool& pool, CValidationState& state, const CTransaction& tx, bool fLimitFree, bool* pfMissingInputs, bool fRejectInsaneFee, bool ignoreFees)
 {
     AssertLockHeld(cs_main);
@@ -1784,6 +1999,7 @@ bool AcceptToMemoryPool(CTxMemPool& pool, CValidationState& state, const CTransa
         CCoinsView dummy;
         CCoinsViewCache view(&dummy);
         CAmount nValueIn = 0;
+        CResolvedRing ring;
         {
             LOCK(pool.cs);
             CCoinsViewMemPool viewMemPool(pcoinsTip, pool);
@@ -1795,7 +2011,7 @@ bool AcceptToMemoryPool(CTxMemPool& pool, CValidationState& state, const CTransa
             }
 
             // are the actual inputs available?
-            if (!CheckHaveInputs(view, tx)) {
+            if (!CheckHaveInputs(view, tx, &ring)) {
                 //check input spents
 
                 return state.Invalid(error("AcceptToMemoryPool : inputs already spent"),
@@ -1804,7 +2020,7 @@ bool AcceptToMemoryPool(CTxMemPool& pool, CValidationState& state, const CTransa
 
             if (!tx.IsCoinStake() && !tx.IsCoinBase() && !tx.IsCoinAudit()) {
                 if (!tx.IsCoinAudit()) {
-                    if (!VerifyRingSignatureWithTxFee(tx, chainActive.Tip()))
+                    if (!VerifyRingSignatureWithTxFee(tx, chainActive.Tip(), &ring))
                         return state.DoS(100, error("AcceptToMemoryPool() : Ring Signature check for transaction %s failed", tx.GetHash().ToString()),
                             REJECT_INVALID, "bad-ring-signature");
                     if (!VerifyBulletProofAggregate(tx))
@@ -1891,7 +2107,7 @@ bool AcceptToMemoryPool(CTxMemPool& pool, CValidationState& state, const CTransa
         // Check against previous transactions
         // This is done last to help prevent CPU exhaustion denial-of-service attacks.
 
-        if (!CheckInputs(tx, state, view, true, STANDARD_SCRIPT_VERIFY_FLAGS, true)) {
+        if (!CheckInputs(tx, state, view, true, STANDARD_SCRIPT_VERIFY_FLAGS, true, NULL, &ring)) {
             return error("AcceptToMemoryPool: : ConnectInputs failed %s", hash.ToString());
         }
         // Check again against just the consensus-critical mandatory script
@@ -1903,7 +2119,7 @@ bool AcceptToMemoryPool(CTxMemPool& pool, CValidationState& state, const CTransa
         // There is a similar check in CreateNewBlock() to prevent creating
         // invalid blocks, however allowing such transactions into the mempool
         // can be exploited as a DoS attack.
-        if (!CheckInputs(tx, state, view, true, MANDATORY_SCRIPT_VERIFY_FLAGS, true)) {
+        if (!CheckInputs(tx, state, view, true, MANDATORY_SCRIPT_VERIFY_FLAGS, true, NULL, &ring)) {
             return error(
                 "AcceptToMemoryPool: : BUG! PLEASE REPORT THIS! ConnectInputs failed against MANDATORY but not STANDARD flags %s",
                 hash.ToString());
@@ -2119,6 +2335,51 @@ bool AcceptableInputs(CTxMemPool& pool, CValidationState& state, const CTransact
     return true;
 }
 
+/** Read the transaction at a txindex position, possibly still queued for the block file writer */
+static bool ReadTransactionFromDisk(const CDiskTxPos& postx, const uint256& hash, CTransaction& txOut, uint256& hashBlock)
+{
+    CBlockHeader header;
+    CDataStream ssPending(SER_DISK, CLIENT_VERSION);
+    if (blockFileWriter.ReadPending(CBlockFileWriter::BLOCK_FILE, postx, ssPending)) {
+        try {
+            ssPending >> header;
+            ssPending.ignore(postx.nTxOffset);
+            ssPending >> txOut;
+        } catch (std::exception& e) {
+            return error("%s : Deserialize error - %s", __func__, e.what());
+        }
+    } else {
+        CAutoFile file(OpenBlockFile(postx, true), SER_DISK, CLIENT_VERSION);
+        if (file.IsNull())
+            return error("%s: OpenBlockFile failed", __func__);
+        try {
+            file >> header;
+            fseek(file.Get(), postx.nTxOffset, SEEK_CUR);
+            file >> txOut;
+        } catch (std::exception& e) {
+            return error("%s : Deserialize or I/O error - %s", __func__, e.what());
+        }
+    }
+    hashBlock = header.GetHash();
+    if (txOut.GetHash() != hash)
+        return error("%s : txid mismatch, %s, %s", __func__, txOut.GetHash().GetHex(), hash.GetHex());
+    return true;
+}
+
+bool LookupTransaction(const uint256& hash, CTransaction& txOut, uint256& hashBlock)
+{
+    // The coins database behind the slow path is only safe to walk under cs_main
+    if (!fTxIndex)
+        return GetTransaction(hash, txOut, hashBlock, true);
+
+    if (mempool.lookup(hash, txOut))
+        return true;
+    CDiskTxPos postx;
+    if (!pblocktree->ReadTxIndex(hash, postx))
+        return false;
+    return ReadTransactionFromDisk(postx, hash, txOut, hashBlock);
+}
+
 /** Return transaction in tx, and if it was found inside a block, its hash is placed in hashBlock */
 bool GetTransaction(const uint256& hash, CTransaction& txOut, uint256& hashBlock, bool fAllowSlow)
 {
@@ -2133,23 +2394,8 @@ bool GetTransaction(const uint256& hash, CTransaction& txOut, uint256& hashBlock
 
         if (fTxIndex) {
             CDiskTxPos postx;
-            if (pblocktree->ReadTxIndex(hash, postx)) {
-                CAutoFile file(OpenBlockFile(postx, true), SER_DISK, CLIENT_VERSION);
-                if (file.IsNull())
-                    return error("%s: OpenBlockFile failed", __func__);
-                CBlockHeader header;
-                try {
-                    file >> header;
-                    fseek(file.Get(), postx.nTxOffset, SEEK_CUR);
-                    file >> txOut;
-                } catch (std::exception& e) {
-                    return error("%s : Deserialize or I/O error - %s", __func__, e.what());
-                }
-                hashBlock = header.GetHash();
-                if (txOut.GetHash() != hash)
-                    return error("%s : txid mismatch, %s, %s", __func__, txOut.GetHash().GetHex(), hash.GetHex());
-                return true;
-            }
+            if (pblocktree->ReadTxIndex(hash, postx))
+                return ReadTransactionFromDisk(postx, hash, txOut, hashBlock);
 
             // transaction not found in the index, nothing more can be done
             return false;
@@ -2193,21 +2439,21 @@ bool GetTransaction(const uint256& hash, CTransaction& txOut, uint256& hashBlock
 
 bool WriteBlockToDisk(CBlock& block, CDiskBlockPos& pos)
 {
-    // Open history file to append
-    CAutoFile fileout(OpenBlockFile(pos), SER_DISK, CLIENT_VERSION);
-    if (fileout.IsNull())
-        return error("WriteBlockToDisk : OpenBlockFile failed");
+    CDataStream ss(SER_DISK, CLIENT_VERSION);
 
     // Write index header
-    unsigned int nSize = fileout.GetSerializeSize(block);
-    fileout << FLATDATA(Params().MessageStart()) << nSize;
+    unsigned int nSize = ss.GetSerializeSize(block);
+    ss << FLATDATA(Params().MessageStart()) << nSize;
 
     // Write block
-    long fileOutPos = ftell(fileout.Get());
-    if (fileOutPos < 0)
-        return error("WriteBlockToDisk : ftell failed");
-    pos.nPos = (unsigned int)fileOutPos;
-    fileout << block;
+    CDiskBlockPos posRecord = pos;
+    pos.nPos += ss.size();
+    ss << block;
+
+    // Hand the record to the block file writer
+    std::vector<char> vch(ss.begin(), ss.end());
+    if (!blockFileWriter.Write(CBlockFileWriter::BLOCK_FILE, posRecord, vch))
+        return error("WriteBlockToDisk : write to block file failed");
 
     return true;
 }
@@ -2216,16 +2462,25 @@ bool ReadBlockFromDisk(CBlock& block, const CDiskBlockPos& pos)
 {
     block.SetNull();
 
-    // Open history file to read
-    CAutoFile filein(OpenBlockFile(pos, true), SER_DISK, CLIENT_VERSION);
-    if (filein.IsNull())
-        return error("ReadBlockFromDisk : OpenBlockFile failed");
+    // Read block, possibly still queued for the block file writer
+    CDataStream ssPending(SER_DISK, CLIENT_VERSION);
+    if (blockFileWriter.ReadPending(CBlockFileWriter::BLOCK_FILE, pos, ssPending)) {
+        try {
+            ssPending >> block;
+        } catch (std::exception& e) {
+            return error("%s : Deserialize error - %s", __func__, e.what());
+        }
+    } else {
+        // Open history file to read
+        CAutoFile filein(OpenBlockFile(pos, true), SER_DISK, CLIENT_VERSION);
+        if (filein.IsNull())
+            return error("ReadBlockFromDisk : OpenBlockFile failed");
 
-    // Read block
-    try {
-        filein >> block;
-    } catch (std::exception& e) {
-        return error("%s : Deserialize or I/O error - %s", __func__, e.what());
+        try {
+            filein >> block;
+        } catch (std::exception& e) {
+            return error("%s : Deserialize or I/O error - %s", __func__, e.what());
+        }
     }
 
     // Check the header
@@ -2249,6 +2504,39 @@ bool ReadBlockFromDisk(CBlock& block, const CBlockIndex* pindex)
     return true;
 }
 
+bool ReadRawBlockFromDisk(std::vector<unsigned char>& vchBlock, const CDiskBlockPos& pos)
+{
+    // Block possibly still queued for the block file writer, the record ends with the block
+    CDataStream ssPending(SER_DISK, CLIENT_VERSION);
+    if (blockFileWriter.ReadPending(CBlockFileWriter::BLOCK_FILE, pos, ssPending)) {
+        vchBlock.assign(ssPending.begin(), ssPending.end());
+        return true;
+    }
+
+    // The index header written by WriteBlockToDisk precedes the block
+    if (pos.nPos < MESSAGE_START_SIZE + sizeof(unsigned int))
+        return error("ReadRawBlockFromDisk : no index header before file %d pos %u", pos.nFile, pos.nPos);
+    CDiskBlockPos posHeader(pos.nFile, pos.nPos - (MESSAGE_START_SIZE + sizeof(unsigned int)));
+    CAutoFile filein(OpenBlockFile(posHeader, true), SER_DISK, CLIENT_VERSION);
+    if (filein.IsNull())
+        return error("ReadRawBlockFromDisk : OpenBlockFile failed");
+
+    try {
+        unsigned char buf[MESSAGE_START_SIZE];
+        unsigned int nSize;
+        filein >> FLATDATA(buf) >> nSize;
+        if (memcmp(buf, Params().MessageStart(), MESSAGE_START_SIZE))
+            return error("ReadRawBlockFromDisk : bad index header at file %d pos %u", pos.nFile, pos.nPos);
+        if (nSize < 80 || nSize > MAX_BLOCK_SIZE_CURRENT)
+            return error("ReadRawBlockFromDisk : bad block size %u at file %d pos %u", nSize, pos.nFile, pos.nPos);
+        vchBlock.resize(nSize);
+        filein.read((char*)&vchBlock[0], nSize);
+    } catch (std::exception& e) {
+        return error("%s : I/O error - %s", __func__, e.what());
+    }
+    return true;
+}
+
 
 double ConvertBitsToDouble(unsigned int nBits)
 {
@@ -2283,19 +2571,19 @@ CAmount TeamRewards(const CBlockIndex* ptip)
 
     if (!pForkTip->IsProofOfAudit()) return 0;
     const CBlockIndex* lastPoABlock = pForkTip;
-    if (lastPoABlock->hashPrevPoABlock.IsNull()) {
+    if (lastPoABlock->GetPrevPoABlockHash().IsNull()) {
         //pay daps team after the first PoA block
         return (pForkTip->nHeight - Params().LAST_POW_BLOCK() - 1 + 1 /*+1 for the being created PoS block*/) * 50 * COIN;
     }
 
     //loop back to find the PoA block right after which the daps team is paid
-    uint256 lastPoAHash = lastPoABlock->hashPrevPoABlock;
+    uint256 lastPoAHash = lastPoABlock->GetPrevPoABlockHash();
     CAmount ret = 0;
     int numPoABlocks = 1;
     while (!lastPoAHash.IsNull()) {
         if (numPoABlocks != 0 && numPoABlocks % Params().TEAM_REWARD_FREQUENCY == 0) break;
         CBlockIndex* p = mapBlockIndex[lastPoAHash];
-        lastPoAHash = p->hashPrevPoABlock;
+        lastPoAHash = p->GetPrevPoABlockHash();
         numPoABlocks++;
     }
 
@@ -2623,6 +2911,47 @@ void UpdateCoins(const CTransaction& tx, CValidationState& state, CCoinsViewCach
     inputs.ModifyCoins(tx.GetHash())->FromTx(tx, nHeight);
 }
 
+void UpdateUtxoStats(const CTransaction& tx, const CCoinsViewCache& inputs, const CTxUndo& txundo, CUtxoStats& stats)
+{
+    // The undo data holds the outputs UpdateCoins spent, with the height of
+    // their transaction if it has no unspent outputs left
+    for (unsigned int i = 0; i < txundo.vprevout.size(); i++) {
+        const CTxInUndo& undo = txundo.vprevout[i];
+        if (undo.txout.IsNull())
+            continue;
+        stats.RemoveOutput(tx.vin[i].prevout, undo.txout);
+        if (undo.nHeight != 0)
+            stats.nTransactions--;
+    }
+
+    const uint256& hash = tx.GetHash();
+    const CCoins* coins = inputs.AccessCoins(hash);
+    if (!coins || coins->IsPruned())
+        return;
+    stats.nTransactions++;
+    for (unsigned int i = 0; i < coins->vout.size(); i++) {
+        if (!coins->vout[i].IsNull())
+            stats.AddOutput(COutPoint(hash, i), coins->vout[i]);
+    }
+}
+
+void GetBlockSupplyChange(const CBlock& block, CAmount& nMint, CAmount& nFees)
+{
+    // The same sums ConnectBlock derives nMoneySupply and nMint from
+    CAmount nValueOut = 0, nValueIn = 0;
+    nFees = 0;
+    BOOST_FOREACH (const CTransaction& tx, block.vtx) {
+        nValueOut += tx.GetValueOut();
+        if (block.IsPoABlockByVersion() || tx.IsCoinBase())
+            continue;
+        if (tx.IsCoinStake())
+            nValueIn += GetCoinStakeValueIn(tx);
+        else
+            nFees += tx.nTxFee;
+    }
+    nMint = nValueOut - nValueIn;
+}
+
 bool CScriptCheck::operator()()
 {
     const CScript& scriptSig = ptxTo->vin[nIn].scriptSig;
@@ -2680,7 +3009,7 @@ CAmount GetInvalidUTXOValue()
     return nValue;
 }
 
-bool CheckInputs(const CTransaction& tx, CValidationState& state, const CCoinsViewCache& inputs, bool fScriptChecks, unsigned int flags, bool cacheStore, std::vector<CScriptCheck>* pvChecks)
+bool CheckInputs(const CTransaction& tx, CValidationState& state, const CCoinsViewCache& inputs, bool fScriptChecks, unsigned int flags, bool cacheStore, std::vector<CScriptCheck>* pvChecks, CResolvedRing* pring)
 {
     if (!tx.IsCoinBase()) {
         if (pvChecks)
@@ -2688,7 +3017,7 @@ bool CheckInputs(const CTransaction& tx, CValidationState& state, const CCoinsVi
 
         // This doesn't trigger the DoS code on purpose; if it did, it would make it easier
         // for an attacker to attempt to split the network.
-        if (!CheckHaveInputs(inputs, tx))
+        if (!CheckHaveInputs(inputs, tx, pring))
             return state.Invalid(error("CheckInputs() : %s inputs unavailable", tx.GetHash().ToString()));
 
         // While checking, GetBestBlock() refers to the parent block.
@@ -2783,6 +3112,7 @@ bool DisconnectBlock(CBlock& block, CValidationState& state, CBlockIndex* pindex
         *pfClean = false;
 
     bool fClean = true;
+    CUtxoStats statsDelta;
 
     CBlockUndo blockUndo;
     CDiskBlockPos pos = pindex->GetUndoPos();
@@ -2819,9 +3149,21 @@ bool DisconnectBlock(CBlock& block, CValidationState& state, CBlockIndex* pindex
                 fClean = fClean && error("DisconnectBlock() : added transaction mismatch? database corrupted");
 
             // remove outputs
+            if (!outs->IsPruned())
+                statsDelta.nTransactions--;
+            for (unsigned int j = 0; j < outs->vout.size(); j++) {
+                if (!outs->vout[j].IsNull())
+                    statsDelta.RemoveOutput(COutPoint(hash, j), outs->vout[j]);
+            }
             outs->Clear();
         }
 
+        // forget the key images this block spent
+        if (!tx.IsCoinBase()) {
+            BOOST_FOREACH (const CTxIn& in, tx.vin)
+                pblocktree->EraseKeyImage(in.keyImage.GetHex(), pindex->GetBlockHash());
+        }
+
         // restore inputs
         if (!tx.IsCoinBase() && tx.IsCoinStake()) { // not coinbases because they dont have traditional inputs
             const CTxUndo& txundo = blockUndo.vtxundo[i - 1];
@@ -2850,10 +3192,22 @@ bool DisconnectBlock(CBlock& block, CValidationState& state, CBlockIndex* pindex
                 if (coins->vout.size() < out.n + 1)
                     coins->vout.resize(out.n + 1);
                 coins->vout[out.n] = undo.txout;
+                if (!undo.txout.IsNull()) {
+                    statsDelta.AddOutput(out, undo.txout);
+                    if (undo.nHeight != 0)
+                        statsDelta.nTransactions++;
+                }
             }
         }
     }
 
+    // take the coins and fees of the block off the supply totals, computed
+    // again from its transactions rather than from its index record
+    CAmount nMint, nFees;
+    GetBlockSupplyChange(block, nMint, nFees);
+    statsDelta.AddBlock(-nMint, -nFees);
+    view.AddStatsDelta(statsDelta);
+
     // move best block pointer to prevout block
     view.SetBestBlock(pindex->pprev->GetBlockHash());
 
@@ -2865,10 +3219,13 @@ bool DisconnectBlock(CBlock& block, CValidationState& state, CBlockIndex* pindex
     }
 }
 
-void static FlushBlockFile(bool fFinalize = false)
+bool static FlushBlockFile(bool fFinalize = false)
 {
     LOCK(cs_LastBlockFile);
 
+    // Write out queued block and undo records and fsync every file they went to
+    bool fOk = blockFileWriter.Flush();
+
     CDiskBlockPos posOld(nLastBlockFile, 0);
 
     FILE* fileOld = OpenBlockFile(posOld);
@@ -2886,6 +3243,8 @@ void static FlushBlockFile(bool fFinalize = false)
         FileCommit(fileOld);
         fclose(fileOld);
     }
+
+    return fOk;
 }
 
 bool FindUndoPos(CValidationState& state, int nFile, CDiskBlockPos& pos, unsigned int nAddSize);
@@ -2982,6 +3341,36 @@ static int64_t nTimeIndex = 0;
 static int64_t nTimeCallbacks = 0;
 static int64_t nTimeTotal = 0;
 
+bool CheckCoinStakeRewards(const CBlock& block, CBlockIndex* pindexPrev, CValidationState& state)
+{
+    const CTransaction& coinstake = block.vtx[1];
+    size_t numUTXO = coinstake.vout.size();
+    CAmount posBlockReward = PoSBlockReward();
+    CAmount blockValue = GetBlockValue(pindexPrev);
+    if (blockValue > posBlockReward) {
+        //numUTXO - 1 is team rewards, numUTXO - 2 is masternode reward
+        const CTxOut& mnOut = coinstake.vout[numUTXO - 2];
+        std::string mnsa(mnOut.masternodeStealthAddress.begin(), mnOut.masternodeStealthAddress.end());
+        if (!VerifyDerivedAddress(mnOut, mnsa))
+            return state.DoS(100, error("ConnectBlock() : Incorrect derived address for masternode rewards"));
+
+        CAmount teamReward = blockValue - posBlockReward;
+        const CTxOut& foundationOut = coinstake.vout[numUTXO - 1];
+        if (foundationOut.nValue != teamReward)
+            return state.DoS(100, error("ConnectBlock() : Incorrect amount PoS rewards for foundation, reward = %d while the correct reward = %d", foundationOut.nValue, teamReward));
+
+        if (!VerifyDerivedAddress(foundationOut, FOUNDATION_WALLET))
+            return state.DoS(100, error("ConnectBlock() : Incorrect derived address PoS rewards for foundation"));
+    } else {
+        //there is no team rewards in this block
+        const CTxOut& mnOut = coinstake.vout[numUTXO - 1];
+        std::string mnsa(mnOut.masternodeStealthAddress.begin(), mnOut.masternodeStealthAddress.end());
+        if (!VerifyDerivedAddress(mnOut, mnsa))
+            return state.DoS(100, error("ConnectBlock() : Incorrect derived address for masternode rewards"));
+    }
+    return true;
+}
+
 bool ConnectBlock(const CBlock& block, CValidationState& state, CBlockIndex* pindex, CCoinsViewCache& view, bool fJustCheck, bool fAlreadyChecked)
 {
     AssertLockHeld(cs_main);
@@ -3063,9 +3452,11 @@ bool ConnectBlock(const CBlock& block, CValidationState& state, CBlockIndex* pin
     CDiskTxPos pos(pindex->GetBlockPos(), GetSizeOfCompactSize(block.vtx.size()));
     std::vector<std::pair<uint256, CDiskTxPos> > vPos;
     vPos.reserve(block.vtx.size());
+    std::vector<std::string> vKeyImagesSpent;
     blockundo.vtxundo.reserve(block.vtx.size() - 1);
     CAmount nValueOut = 0;
     CAmount nValueIn = 0;
+    CUtxoStats statsDelta;
     unsigned int nMaxBlockSigOps = MAX_BLOCK_SIGOPS_CURRENT;
     for (unsigned int i = 0; i < block.vtx.size(); i++) {
         const CTransaction& tx = block.vtx[i];
@@ -3076,9 +3467,10 @@ bool ConnectBlock(const CBlock& block, CValidationState& state, CBlockIndex* pin
                 REJECT_INVALID, "bad-blk-sigops");
 
         if (!block.IsPoABlockByVersion() && !tx.IsCoinBase()) {
+            CResolvedRing ring;
             if (!tx.IsCoinStake()) {
                 if (!tx.IsCoinAudit()) {
-                    if (!VerifyRingSignatureWithTxFee(tx, pindex))
+                    if (!VerifyRingSignatureWithTxFee(tx, pindex, &ring))
                         return state.DoS(100, error("ConnectBlock() : Ring Signature check for transaction %s failed", tx.GetHash().ToString()),
                             REJECT_INVALID, "bad-ring-signature");
                     if (!VerifyBulletProofAggregate(tx))
@@ -3097,7 +3489,7 @@ bool ConnectBlock(const CBlock& block, CValidationState& state, CBlockIndex* pin
                     return state.Invalid(error("ConnectBlock() : key image already spent"),
                         REJECT_DUPLICATE, "bad-txns-inputs-spent");
                 }
-                pblocktree->WriteKeyImage(keyImage.GetHex(), bh);
+                vKeyImagesSpent.push_back(kh);
                 if (pwalletMain != NULL && !pwalletMain->IsLocked()) {
                     if (pwalletMain->GetDebit(in, ISMINE_ALL)) {
                         pwalletMain->keyImagesSpends[keyImage.GetHex()] = true;
@@ -3115,7 +3507,7 @@ bool ConnectBlock(const CBlock& block, CValidationState& state, CBlockIndex* pin
             nValueIn += valTemp;
 
             std::vector<CScriptCheck> vChecks;
-            if (!CheckInputs(tx, state, view, fScriptChecks, flags, false, nScriptCheckThreads ? &vChecks : NULL))
+            if (!CheckInputs(tx, state, view, fScriptChecks, flags, false, nScriptCheckThreads ? &vChecks : NULL, &ring))
                 return false;
             control.Add(vChecks);
         }
@@ -3126,41 +3518,19 @@ bool ConnectBlock(const CBlock& block, CValidationState& state, CBlockIndex* pin
             blockundo.vtxundo.push_back(CTxUndo());
         }
         UpdateCoins(tx, state, view, i == 0 ? undoDummy : blockundo.vtxundo.back(), pindex->nHeight);
+        UpdateUtxoStats(tx, view, i == 0 ? undoDummy : blockundo.vtxundo.back(), statsDelta);
 
         vPos.push_back(std::make_pair(tx.GetHash(), pos));
         pos.nTxOffset += ::GetSerializeSize(tx, SER_DISK, CLIENT_VERSION);
     }
 
     if (block.IsProofOfStake()) {
-        const CTransaction coinstake = block.vtx[1];
-        size_t numUTXO = coinstake.vout.size();
-        CAmount posBlockReward = PoSBlockReward();
         if (mapBlockIndex.count(block.hashPrevBlock) < 1) {
             return state.DoS(100, error("ConnectBlock() : Previous block not found, received block %s, previous %s, current tip %s", block.GetHash().GetHex(), block.hashPrevBlock.GetHex(), chainActive.Tip()->GetBlockHash().GetHex()));
         }
-        int thisBlockHeight = mapBlockIndex[block.hashPrevBlock]->nHeight + 1; //avoid potential block disorder during download
-        CAmount blockValue = GetBlockValue(mapBlockIndex[block.hashPrevBlock]);
-        if (blockValue > posBlockReward) {
-            //numUTXO - 1 is team rewards, numUTXO - 2 is masternode reward
-            const CTxOut& mnOut = coinstake.vout[numUTXO - 2];
-            std::string mnsa(mnOut.masternodeStealthAddress.begin(), mnOut.masternodeStealthAddress.end());
-            if (!VerifyDerivedAddress(mnOut, mnsa))
-                return state.DoS(100, error("ConnectBlock() : Incorrect derived address for masternode rewards"));
-
-            CAmount teamReward = blockValue - posBlockReward;
-            const CTxOut& foundationOut = coinstake.vout[numUTXO - 1];
-            if (foundationOut.nValue != teamReward)
-                return state.DoS(100, error("ConnectBlock() : Incorrect amount PoS rewards for foundation, reward = %d while the correct reward = %d", foundationOut.nValue, teamReward));
-
-            if (!VerifyDerivedAddress(foundationOut, FOUNDATION_WALLET))
-                return state.DoS(100, error("ConnectBlock() : Incorrect derived address PoS rewards for foundation"));
-        } else {
-            //there is no team rewards in this block
-            const CTxOut& mnOut = coinstake.vout[numUTXO - 1];
-            std::string mnsa(mnOut.masternodeStealthAddress.begin(), mnOut.masternodeStealthAddress.end());
-            if (!VerifyDerivedAddress(mnOut, mnsa))
-                return state.DoS(100, error("ConnectBlock() : Incorrect derived address for masternode rewards"));
-        }
+        //avoid potential block disorder during download
+        if (!CheckCoinStakeRewards(block, mapBlockIndex[block.hashPrevBlock], state))
+            return false;
     }
 
     // track money supply and mint amount info
@@ -3168,6 +3538,7 @@ bool ConnectBlock(const CBlock& block, CValidationState& state, CBlockIndex* pin
     pindex->nMoneySupply = nMoneySupplyPrev + nValueOut - nValueIn - nFees;
     //LogPrintf("%s: nValueOut=%d, nValueIn=%d, nMoneySupplyPrev=%d, pindex->nMoneySupply=%d, nFees=%d", __func__, nValueOut, nValueIn, nMoneySupplyPrev, pindex->nMoneySupply, nFees);
     pindex->nMint = pindex->nMoneySupply - nMoneySupplyPrev + nFees;
+    statsDelta.AddBlock(pindex->nMint, nFees);
 
     if (!pblocktree->WriteBlockIndex(CDiskBlockIndex(pindex)))
         return error("Connect() : WriteBlockIndex for pindex failed");
@@ -3198,6 +3569,9 @@ bool ConnectBlock(const CBlock& block, CValidationState& state, CBlockIndex* pin
         0.001 * (nTime2 - nTimeStart), nInputs <= 1 ? 0 : 0.001 * (nTime2 - nTimeStart) / (nInputs - 1),
         nTimeVerify * 0.000001);
 
+    // The changes to the UTXO statistics go with the coins, also into views that are only checked
+    view.AddStatsDelta(statsDelta);
+
     if (fJustCheck)
         return true;
 
@@ -3223,6 +3597,11 @@ bool ConnectBlock(const CBlock& block, CValidationState& state, CBlockIndex* pin
         if (!pblocktree->WriteTxIndex(vPos))
             return state.Abort("Failed to write transaction index");
 
+    // Record spent key images only once the block is known to be valid; they
+    // are committed with the block index on the next FlushStateToDisk
+    BOOST_FOREACH (const std::string& keyImage, vKeyImagesSpent)
+        pblocktree->WriteKeyImage(keyImage, pindex->GetBlockHash());
+
     // add this block to the view's block chain
     view.SetBestBlock(pindex->GetBlockHash());
 
@@ -3260,7 +3639,7 @@ bool static FlushStateToDisk(CValidationState& state, FlushStateMode mode)
     try {
         if ((mode == FLUSH_STATE_ALWAYS) ||
             ((mode == FLUSH_STATE_PERIODIC || mode == FLUSH_STATE_IF_NEEDED) &&
-                pcoinsTip->GetCacheSize() > nCoinCacheSize) ||
+                pcoinsTip->GetCacheSize() + pblocktree->GetDirtyKeyImageCount() > nCoinCacheSize) ||
             (mode == FLUSH_STATE_PERIODIC && GetTimeMicros() > nLastWrite + DATABASE_WRITE_INTERVAL * 1000000)) {
             // Typical CCoins structures on disk are around 100 bytes in size.
             // Pushing a new one to the database can cause it to be written
@@ -3270,7 +3649,8 @@ bool static FlushStateToDisk(CValidationState& state, FlushStateMode mode)
             if (!CheckDiskSpace(100 * 2 * 2 * pcoinsTip->GetCacheSize()))
                 return state.Error("out of disk space");
             // First make sure all block and undo data is flushed to disk.
-            FlushBlockFile();
+            if (!FlushBlockFile())
+                return state.Abort("Failed to write to block files");
             // Then update all block file information (which may refer to block and undo files).
             {
                 std::vector<std::pair<int, const CBlockFileInfo*> > vFiles;
@@ -3382,6 +3762,7 @@ bool static DisconnectTip(CValidationState& state)
     }
     mempool.removeCoinbaseSpends(pcoinsTip, pindexDelete->nHeight);
     mempool.check(pcoinsTip);
+    decoyProvider.BlockDisconnected(pindexDelete);
     // Update chainActive and related variables.
     UpdateTip(pindexDelete->pprev);
     // Let wallets know transactions went from 1-confirmed to
@@ -3464,6 +3845,7 @@ bool static ConnectTip(CValidationState& state, CBlockIndex* pindexNew, CBlock*
     mempool.check(pcoinsTip);
     // Update chainActive & related variables.
     UpdateTip(pindexNew);
+    decoyProvider.BlockConnected(*pblock, pindexNew);
     // Tell wallet about transactions that went from mempool
     // to conflicted:
     BOOST_FOREACH (
@@ -3908,8 +4290,7 @@ CBlockIndex* AddToBlockIndex(const CBlock& block)
         return it->second;
 
     // Construct new block index object
-    CBlockIndex* pindexNew = new CBlockIndex(block);
-    assert(pindexNew);
+    CBlockIndex* pindexNew = blockIndexArena.New<CBlockIndex>(block);
     // We assign the sequence id to blocks only when the full data is available,
     // to avoid miners withholding blocks but broadcasting headers, to get a
     // competitive advantage.
@@ -4121,22 +4502,13 @@ bool CheckBlockHeader(const CBlockHeader& block, CValidationState& state, bool f
 }
 
 
-bool CheckBlock(const CBlock& block, CValidationState& state, bool fCheckPOW, bool fCheckMerkleRoot, bool fCheckSig)
+bool CheckBlockContextFree(const CBlock& block, CValidationState& state, bool fCheckMerkleRoot, bool fCheckStakeProof)
 {
-    // These are checks that are independent of context.
-
-    // Check that the header is valid (particularly PoW).  This is mostly
-    // redundant with the call in AcceptBlockHeader.
-    if (!CheckBlockHeader(block, state, block.IsProofOfWork()))
-        return state.DoS(100, error("CheckBlock() : CheckBlockHeader failed"),
+    // Only the block itself and, for the coinstake proof, the staked output in
+    // the txindex are looked at, so this may run without cs_main.
+    if (block.IsProofOfWork() && !CheckProofOfWork(block.GetHash(), block.nBits))
+        return state.DoS(100, error("CheckBlock() : proof of work failed"),
             REJECT_INVALID, "bad-header", true);
-    // Check timestamp
-    LogPrint("debug", "%s: block=%s  is proof of stake=%d, is proof of audit=%d\n", __func__, block.GetHash().ToString().c_str(),
-        block.IsProofOfStake(), block.IsProofOfAudit());
-    if (!block.IsPoABlockByVersion() && block.GetBlockTime() >
-                                            GetAdjustedTime() + (block.IsProofOfStake() ? 180 : 7200)) // 3 minute future drift for PoS
-        return state.Invalid(error("CheckBlock() : block timestamp too far in the future"),
-            REJECT_INVALID, "time-too-new");
 
     //check duplicate key image in blocks
     set<CKeyImage> keyimages;
@@ -4218,7 +4590,7 @@ bool CheckBlock(const CBlock& block, CValidationState& state, bool fCheckPOW, bo
         int numUTXO = coinstake.vout.size();
 
         //verify shnorr signature
-        if (!VerifyShnorrKeyImageTx(coinstake)) {
+        if (fCheckStakeProof && !VerifyShnorrKeyImageTx(coinstake)) {
             return state.DoS(100, error("CheckBlock() : Failed to verify shnorr signature"));
         }
 
@@ -4235,6 +4607,42 @@ bool CheckBlock(const CBlock& block, CValidationState& state, bool fCheckPOW, bo
             return state.DoS(100, error("CheckBlock() : PoS rewards commitment not correct"));
     }
 
+    unsigned int nSigOps = 0;
+    BOOST_FOREACH (
+        const CTransaction& tx, block.vtx) {
+        nSigOps += GetLegacySigOpCount(tx);
+    }
+    unsigned int nMaxBlockSigOps = MAX_BLOCK_SIGOPS_LEGACY;
+    if (nSigOps > nMaxBlockSigOps)
+        return state.DoS(100, error("CheckBlock() : out-of-bounds SigOpCount"),
+            REJECT_INVALID, "bad-blk-sigops", true);
+
+    if (fCheckMerkleRoot && fCheckStakeProof)
+        block.fChecked = true;
+    return true;
+}
+
+bool CheckBlock(const CBlock& block, CValidationState& state, bool fCheckPOW, bool fCheckMerkleRoot, bool fCheckSig)
+{
+    // These are checks that are independent of context.
+
+    // Check that the header is valid (particularly PoW).  This is mostly
+    // redundant with the call in AcceptBlockHeader.
+    if (!CheckBlockHeader(block, state, block.IsProofOfWork() && !block.fChecked))
+        return state.DoS(100, error("CheckBlock() : CheckBlockHeader failed"),
+            REJECT_INVALID, "bad-header", true);
+    // Check timestamp
+    LogPrint("debug", "%s: block=%s  is proof of stake=%d, is proof of audit=%d\n", __func__, block.GetHash().ToString().c_str(),
+        block.IsProofOfStake(), block.IsProofOfAudit());
+    if (!block.IsPoABlockByVersion() && block.GetBlockTime() >
+                                            GetAdjustedTime() + (block.IsProofOfStake() ? 180 : 7200)) // 3 minute future drift for PoS
+        return state.Invalid(error("CheckBlock() : block timestamp too far in the future"),
+            REJECT_INVALID, "time-too-new");
+
+    // Already done on a message pre-check thread for blocks received from peers
+    if (!block.fChecked && !CheckBlockContextFree(block, state, fCheckMerkleRoot))
+        return false;
+
     /**
      * @todo Audit checkblock
      */
@@ -4274,16 +4682,6 @@ bool CheckBlock(const CBlock& block, CValidationState& state, bool fCheckPOW, bo
         }
     }
 
-    unsigned int nSigOps = 0;
-    BOOST_FOREACH (
-        const CTransaction& tx, block.vtx) {
-        nSigOps += GetLegacySigOpCount(tx);
-    }
-    unsigned int nMaxBlockSigOps = MAX_BLOCK_SIGOPS_LEGACY;
-    if (nSigOps > nMaxBlockSigOps)
-        return state.DoS(100, error("CheckBlock() : out-of-bounds SigOpCount"),
-            REJECT_INVALID, "bad-blk-sigops", true);
-
     return true;
 }
 
@@ -4321,7 +4719,7 @@ bool CheckWork(const CBlock block, CBlockIndex* const pindexPrev)
     return true;
 }
 
-bool ContextualCheckBlockHeader(const CBlockHeader& block, CValidationState& state, CBlockIndex* const pindexPrev)
+bool ContextualCheckBlockHeader(const CBlockHeader& block, CValidationState& state, CBlockIndex* const pindexPrev, bool fNewBlock)
 {
     uint256 hash = block.GetHash();
 
@@ -4334,7 +4732,7 @@ bool ContextualCheckBlockHeader(const CBlockHeader& block, CValidationState& sta
 
     //If this is a reorg, check that it is not too deep
     int nMaxReorgDepth = GetArg("-maxreorg", Params().MaxReorganizationDepth());
-    if (chainActive.Height() - nHeight >= nMaxReorgDepth)
+    if (fNewBlock && chainActive.Height() - nHeight >= nMaxReorgDepth)
         return state.DoS(1,
             error("%s: forked chain older than max reorganization depth (height %d)", __func__, nHeight));
 
@@ -4352,7 +4750,7 @@ bool ContextualCheckBlockHeader(const CBlockHeader& block, CValidationState& sta
 
     // Don't accept any forks from the main chain prior to last checkpoint
     CBlockIndex* pcheckpoint = Checkpoints::GetLastCheckpoint();
-    if (pcheckpoint && nHeight < pcheckpoint->nHeight)
+    if (fNewBlock && pcheckpoint && nHeight < pcheckpoint->nHeight)
         return state.DoS(0, error("%s : forked chain older than last checkpoint (height %d)", __func__, nHeight));
 
     // Reject block.nVersion=1 blocks when 95% (75% on testnet) of the network has upgraded:
@@ -4669,6 +5067,7 @@ bool ProcessNewBlock(CValidationState& state, CNode* pfrom, CBlock* pblock, CDis
                 LOCK(pwalletMain->cs_wallet);
                 if (pblock->IsProofOfStake()) {
                     if (pwalletMain->IsMine(pblock->vtx[1].vin[0])) {
+                        pwalletMain->RemoveFromHistory(pblock->vtx[1].GetHash());
                         pwalletMain->mapWallet.erase(pblock->vtx[1].GetHash());
                     }
                 }
@@ -4701,11 +5100,11 @@ bool ProcessNewBlock(CValidationState& state, CNode* pfrom, CBlock* pblock, CDis
         pwalletMain->resetPendingOutPoints();
     }
 
-    //Block is accepted, let's update decoys pool
+    //Block is accepted, let's update decoys pool unless the node-side decoy index serves them
     //First, update user decoy pool
     int userTxStartIdx = 1;
     int coinbaseIdx = 0;
-    if (pwalletMain) {
+    if (pwalletMain && !decoyProvider.IsReady()) {
         LOCK2(cs_main, pwalletMain->cs_wallet);
         {
             if (pblock->IsProofOfStake()) {
@@ -4888,9 +5287,7 @@ CBlockIndex* InsertBlockIndex(uint256 hash)
         return (*mi).second;
 
     // Create new
-    CBlockIndex* pindexNew = new CBlockIndex();
-    if (!pindexNew)
-        throw runtime_error("LoadBlockIndex() : new CBlockIndex failed");
+    CBlockIndex* pindexNew = blockIndexArena.New<CBlockIndex>();
     mi = mapBlockIndex.insert(make_pair(hash, pindexNew)).first;
 
     //mark as PoS seen
@@ -4909,17 +5306,20 @@ bool static LoadBlockIndexDB(string& strError)
 
     boost::this_thread::interruption_point();
 
-    // Calculate nChainWork
-    vector<pair<int, CBlockIndex*> > vSortedByHeight;
-    vSortedByHeight.reserve(mapBlockIndex.size());
-    for (const PAIRTYPE(uint256, CBlockIndex*) & item : mapBlockIndex) {
-        CBlockIndex* pindex = item.second;
-        vSortedByHeight.push_back(make_pair(pindex->nHeight, pindex));
-    }
-    sort(vSortedByHeight.begin(), vSortedByHeight.end());
-    BOOST_FOREACH (
-        const PAIRTYPE(int, CBlockIndex*) & item, vSortedByHeight) {
-        CBlockIndex* pindex = item.second;
+    // Calculate nChainWork, visiting entries in height order. Heights are
+    // dense, so a counting sort replaces the comparison sort of the whole index.
+    int nMaxHeight = 0;
+    for (const PAIRTYPE(uint256, CBlockIndex*) & item : mapBlockIndex)
+        nMaxHeight = std::max(nMaxHeight, item.second->nHeight);
+    vector<size_t> vHeightOffset(nMaxHeight + 2, 0);
+    for (const PAIRTYPE(uint256, CBlockIndex*) & item : mapBlockIndex)
+        vHeightOffset[item.second->nHeight + 1]++;
+    for (int nHeight = 1; nHeight <= nMaxHeight + 1; nHeight++)
+        vHeightOffset[nHeight] += vHeightOffset[nHeight - 1];
+    vector<CBlockIndex*> vSortedByHeight(mapBlockIndex.size());
+    for (const PAIRTYPE(uint256, CBlockIndex*) & item : mapBlockIndex)
+        vSortedByHeight[vHeightOffset[item.second->nHeight]++] = item.second;
+    BOOST_FOREACH (CBlockIndex* pindex, vSortedByHeight) {
         pindex->nChainWork = (pindex->pprev ? pindex->pprev->nChainWork : 0) + GetBlockProof(*pindex);
         if (pindex->nStatus & BLOCK_HAVE_DATA) {
             if (pindex->pprev) {
@@ -4987,7 +5387,7 @@ bool static LoadBlockIndexDB(string& strError)
     if (!fLastShutdownWasPrepared && !GetBoolArg("-forcestart", false) && !GetBoolArg("-reindex", false)) {
         unsigned int nHeightLastBlockFile = vinfoBlockFile[nLastBlockFile].nHeightLast + 1;
         if (vSortedByHeight.size() > nHeightLastBlockFile &&
-            pcoinsTip->GetBestBlock() != vSortedByHeight[nHeightLastBlockFile].second->GetBlockHash()) {
+            pcoinsTip->GetBestBlock() != vSortedByHeight[nHeightLastBlockFile]->GetBlockHash()) {
             //The database is in a state where a block has been accepted and written to disk, but the
             //transaction database (pcoinsTip) was not flushed to disk, and is therefore not in sync with
             //the block index database.
@@ -5000,13 +5400,13 @@ bool static LoadBlockIndexDB(string& strError)
                 mapBlockIndex[pcoinsTip->GetBestBlock()]->nHeight, vSortedByHeight.size());
 
             //get the index associated with the point in the chain that pcoinsTip is synced to
-            CBlockIndex* pindexLastMeta = vSortedByHeight[vinfoBlockFile[nLastBlockFile].nHeightLast + 1].second;
-            CBlockIndex* pindex = vSortedByHeight[0].second;
+            CBlockIndex* pindexLastMeta = vSortedByHeight[vinfoBlockFile[nLastBlockFile].nHeightLast + 1];
+            CBlockIndex* pindex = vSortedByHeight[0];
             unsigned int nSortedPos = 0;
             for (unsigned int i = 0; i < vSortedByHeight.size(); i++) {
                 nSortedPos = i;
-                if (vSortedByHeight[i].first == mapBlockIndex[pcoinsTip->GetBestBlock()]->nHeight + 1) {
-                    pindex = vSortedByHeight[i].second;
+                if (vSortedByHeight[i]->nHeight == mapBlockIndex[pcoinsTip->GetBestBlock()]->nHeight + 1) {
+                    pindex = vSortedByHeight[i];
                     break;
                 }
             }
@@ -5036,7 +5436,7 @@ bool static LoadBlockIndexDB(string& strError)
                 if (pindex->nHeight >= pindexLastMeta->nHeight)
                     break;
 
-                pindex = vSortedByHeight[++nSortedPos].second;
+                pindex = vSortedByHeight[++nSortedPos];
             }
 
             // Save the updates to disk
@@ -5236,10 +5636,129 @@ bool InitBlockIndex()
 }
 
 
+bool StoreSnapshotBlock(CBlock& block, CDiskBlockIndex& diskindex, CBlockUndo* pundo, CValidationState& state)
+{
+    LOCK(cs_main);
+    unsigned int nBlockSize = ::GetSerializeSize(block, SER_DISK, CLIENT_VERSION);
+    CDiskBlockPos blockPos;
+    if (!FindBlockPos(state, blockPos, nBlockSize + 8, diskindex.nHeight, block.GetBlockTime()))
+        return error("%s : FindBlockPos failed", __func__);
+    if (!WriteBlockToDisk(block, blockPos))
+        return state.Abort("Failed to write block");
+    diskindex.nFile = blockPos.nFile;
+    diskindex.nDataPos = blockPos.nPos;
+    diskindex.nUndoPos = 0;
+    diskindex.nStatus = (diskindex.nStatus & ~BLOCK_HAVE_UNDO) | BLOCK_HAVE_DATA;
+
+    if (pundo) {
+        CDiskBlockPos undoPos;
+        if (!FindUndoPos(state, blockPos.nFile, undoPos, ::GetSerializeSize(*pundo, SER_DISK, CLIENT_VERSION) + 40))
+            return error("%s : FindUndoPos failed", __func__);
+        if (!pundo->WriteToDisk(undoPos, block.hashPrevBlock))
+            return state.Abort("Failed to write undo data");
+        diskindex.nUndoPos = undoPos.nPos;
+        diskindex.nStatus |= BLOCK_HAVE_UNDO;
+    }
+    if (!pblocktree->WriteBlockIndex(diskindex))
+        return state.Abort("Failed to write block index");
+
+    uint256 hash = block.GetHash();
+    if (fTxIndex) {
+        CDiskTxPos pos(blockPos, GetSizeOfCompactSize(block.vtx.size()));
+        std::vector<std::pair<uint256, CDiskTxPos> > vPos;
+        vPos.reserve(block.vtx.size());
+        BOOST_FOREACH (const CTransaction& tx, block.vtx) {
+            vPos.push_back(std::make_pair(tx.GetHash(), pos));
+            pos.nTxOffset += ::GetSerializeSize(tx, SER_DISK, CLIENT_VERSION);
+        }
+        if (!pblocktree->WriteTxIndex(vPos))
+            return state.Abort("Failed to write transaction index");
+    }
+    // The key images ConnectBlock records as spent
+    if (!block.IsPoABlockByVersion()) {
+        BOOST_FOREACH (const CTransaction& tx, block.vtx) {
+            if (tx.IsCoinBase())
+                continue;
+            BOOST_FOREACH (const CTxIn& txin, tx.vin)
+                pblocktree->WriteKeyImage(txin.keyImage.GetHex(), hash);
+        }
+    }
+    return true;
+}
+
+bool FlushSnapshotBlocks(CValidationState& state)
+{
+    LOCK(cs_main);
+    if (!FlushBlockFile())
+        return state.Abort("Failed to write to block files");
+    std::vector<std::pair<int, const CBlockFileInfo*> > vFiles;
+    vFiles.reserve(setDirtyFileInfo.size());
+    for (set<int>::iterator it = setDirtyFileInfo.begin(); it != setDirtyFileInfo.end();) {
+        vFiles.push_back(make_pair(*it, &vinfoBlockFile[*it]));
+        setDirtyFileInfo.erase(it++);
+    }
+    if (!pblocktree->WriteBatchSync(vFiles, nLastBlockFile, std::vector<const CBlockIndex*>()))
+        return state.Abort("Failed to write to block index database");
+    return true;
+}
+
+// Map of disk positions for blocks with unknown parent (only used for reindex)
+static std::multimap<uint256, CDiskBlockPos> mapBlocksUnknownParent;
+
+bool ProcessImportedBlock(CBlock& block, CDiskBlockPos* dbp, int& nLoaded)
+{
+    // detect out of order blocks, and store them for later
+    uint256 hash = block.GetHash();
+    if (hash != Params().HashGenesisBlock() &&
+        mapBlockIndex.find(block.hashPrevBlock) == mapBlockIndex.end()) {
+        LogPrint("reindex", "%s: Out of order block %s, parent %s not known\n", __func__, hash.ToString(),
+            block.hashPrevBlock.ToString());
+        if (dbp)
+            mapBlocksUnknownParent.insert(std::make_pair(block.hashPrevBlock, *dbp));
+        return true;
+    }
+
+    // process in case the block isn't known yet
+    if (mapBlockIndex.count(hash) == 0 || (mapBlockIndex[hash] == NULL) || (mapBlockIndex[hash]->nStatus & BLOCK_HAVE_DATA) == 0) {
+        CValidationState state;
+        if (ProcessNewBlock(state, NULL, &block, dbp))
+            nLoaded++;
+        if (state.IsError())
+            return false;
+    } else if (hash != Params().HashGenesisBlock() && mapBlockIndex[hash]->nHeight % 1000 == 0) {
+        LogPrintf("Block Import: already had block %s at height %d\n", hash.ToString(),
+            mapBlockIndex[hash]->nHeight);
+    }
+
+    // Recursively process earlier encountered successors of this block
+    deque<uint256> queue;
+    queue.push_back(hash);
+    while (!queue.empty()) {
+        uint256 head = queue.front();
+        queue.pop_front();
+        std::pair<std::multimap<uint256, CDiskBlockPos>::iterator, std::multimap<uint256, CDiskBlockPos>::iterator> range = mapBlocksUnknownParent.equal_range(
+            head);
+        while (range.first != range.second) {
+            std::multimap<uint256, CDiskBlockPos>::iterator it = range.first;
+            if (ReadBlockFromDisk(block, it->second)) {
+                LogPrintf("%s: Processing out of order child %s of %s\n", __func__,
+                    block.GetHash().ToString(),
+                    head.ToString());
+                CValidationState dummy;
+                if (ProcessNewBlock(dummy, NULL, &block, &it->second)) {
+                    nLoaded++;
+                    queue.push_back(block.GetHash());
+                }
+            }
+            range.first++;
+            mapBlocksUnknownParent.erase(it);
+        }
+    }
+    return true;
+}
+
 bool LoadExternalBlockFile(FILE* fileIn, CDiskBlockPos* dbp)
 {
-    // Map of disk positions for blocks with unknown parent (only used for reindex)
-    static std::multimap<uint256, CDiskBlockPos> mapBlocksUnknownParent;
     int64_t nStart = GetTimeMillis();
 
     int nLoaded = 0;
@@ -5281,53 +5800,8 @@ bool LoadExternalBlockFile(FILE* fileIn, CDiskBlockPos* dbp)
                 blkdat >> block;
                 nRewind = blkdat.GetPos();
 
-                // detect out of order blocks, and store them for later
-                uint256 hash = block.GetHash();
-                if (hash != Params().HashGenesisBlock() &&
-                    mapBlockIndex.find(block.hashPrevBlock) == mapBlockIndex.end()) {
-                    LogPrint("reindex", "%s: Out of order block %s, parent %s not known\n", __func__, hash.ToString(),
-                        block.hashPrevBlock.ToString());
-                    if (dbp)
-                        mapBlocksUnknownParent.insert(std::make_pair(block.hashPrevBlock, *dbp));
-                    continue;
-                }
-
-                // process in case the block isn't known yet
-                if (mapBlockIndex.count(hash) == 0 || (mapBlockIndex[hash] == NULL) || (mapBlockIndex[hash]->nStatus & BLOCK_HAVE_DATA) == 0) {
-                    CValidationState state;
-                    if (ProcessNewBlock(state, NULL, &block, dbp))
-                        nLoaded++;
-                    if (state.IsError())
-                        break;
-                } else if (hash != Params().HashGenesisBlock() && mapBlockIndex[hash]->nHeight % 1000 == 0) {
-                    LogPrintf("Block Import: already had block %s at height %d\n", hash.ToString(),
-                        mapBlockIndex[hash]->nHeight);
-                }
-
-                // Recursively process earlier encountered successors of this block
-                deque<uint256> queue;
-                queue.push_back(hash);
-                while (!queue.empty()) {
-                    uint256 head = queue.front();
-                    queue.pop_front();
-                    std::pair<std::multimap<uint256, CDiskBlockPos>::iterator, std::multimap<uint256, CDiskBlockPos>::iterator> range = mapBlocksUnknownParent.equal_range(
-                        head);
-                    while (range.first != range.second) {
-                        std::multimap<uint256, CDiskBlockPos>::iterator it = range.first;
-                        if (ReadBlockFromDisk(block, it->second)) {
-                            LogPrintf("%s: Processing out of order child %s of %s\n", __func__,
-                                block.GetHash().ToString(),
-                                head.ToString());
-                            CValidationState dummy;
-                            if (ProcessNewBlock(dummy, NULL, &block, &it->second)) {
-                                nLoaded++;
-                                queue.push_back(block.GetHash());
-                            }
-                        }
-                        range.first++;
-                        mapBlocksUnknownParent.erase(it);
-                    }
-                }
+                if (!ProcessImportedBlock(block, dbp, nLoaded))
+                    break;
             } catch (std::exception& e) {
                 LogPrintf("%s : Deserialize or I/O error - %s", __func__, e.what());
             }
@@ -5575,6 +6049,7 @@ bool static AlreadyHave(const CInv& inv)
         bool txInMap = false;
         txInMap = mempool.exists(inv.hash);
         return txInMap || mapOrphanTransactions.count(inv.hash) ||
+               txPreValidator.IsQueued(inv.hash) ||
                pcoinsTip->HaveCoins(inv.hash);
     }
     case MSG_DSTX:
@@ -5857,7 +6332,110 @@ void static ProcessGetData(CNode* pfrom)
     }
 }
 
-bool static ProcessMessage(CNode* pfrom, string strCommand, CDataStream& vRecv, int64_t nTimeReceived)
+void ProcessTransaction(CNode* pfrom, const CTransaction& tx, const std::string& strCommand, bool ignoreFees, CValidationState& state)
+{
+    vector<uint256> vWorkQueue;
+    vector<uint256> vEraseQueue;
+    CInv inv(MSG_TX, tx.GetHash());
+
+    LOCK(cs_main);
+
+    bool fMissingInputs = false;
+
+    mapAlreadyAskedFor.erase(inv);
+
+    if (state.IsValid() && AcceptToMemoryPool(mempool, state, tx, true, &fMissingInputs, false, ignoreFees)) {
+        mempool.check(pcoinsTip);
+        RelayTransaction(tx);
+        vWorkQueue.push_back(inv.hash);
+
+        LogPrint("mempool", "AcceptToMemoryPool: peer=%d %s : accepted %s (poolsz %u)\n",
+            pfrom->id, pfrom->cleanSubVer,
+            tx.GetHash().ToString(),
+            mempool.mapTx.size());
+
+        // Recursively process any orphan transactions that depended on this one
+        set<NodeId> setMisbehaving;
+        for (unsigned int i = 0; i < vWorkQueue.size(); i++) {
+            map<uint256, set<uint256> >::iterator
+                itByPrev = mapOrphanTransactionsByPrev.find(vWorkQueue[i]);
+            if (itByPrev == mapOrphanTransactionsByPrev.end())
+                continue;
+            for (set<uint256>::iterator mi = itByPrev->second.begin();
+                 mi != itByPrev->second.end();
+                 ++mi) {
+                const uint256& orphanHash = *mi;
+                const CTransaction& orphanTx = mapOrphanTransactions[orphanHash].tx;
+                NodeId fromPeer = mapOrphanTransactions[orphanHash].fromPeer;
+                bool fMissingInputs2 = false;
+                // Use a dummy CValidationState so someone can't setup nodes to counter-DoS based on orphan
+                // resolution (that is, feeding people an invalid transaction based on LegitTxX in order to get
+                // anyone relaying LegitTxX banned)
+                CValidationState stateDummy;
+
+
+                if (setMisbehaving.count(fromPeer))
+                    continue;
+                if (AcceptToMemoryPool(mempool, stateDummy, orphanTx, true, &fMissingInputs2)) {
+                    LogPrint("mempool", "   accepted orphan tx %s\n", orphanHash.ToString());
+                    RelayTransaction(orphanTx);
+                    vWorkQueue.push_back(orphanHash);
+                    vEraseQueue.push_back(orphanHash);
+                } else if (!fMissingInputs2) {
+                    int nDos = 0;
+                    if (stateDummy.IsInvalid(nDos) && nDos > 0) {
+                        // Punish peer that gave us an invalid orphan tx
+                        Misbehaving(fromPeer, nDos);
+                        setMisbehaving.insert(fromPeer);
+                        LogPrint("mempool", "   invalid orphan tx %s\n", orphanHash.ToString());
+                    }
+                    // Has inputs but not accepted to mempool
+                    // Probably non-standard or insufficient fee/priority
+                    LogPrint("mempool", "   removed orphan tx %s\n", orphanHash.ToString());
+                    vEraseQueue.push_back(orphanHash);
+                }
+                mempool.check(pcoinsTip);
+            }
+        }
+
+        BOOST_FOREACH (uint256 hash, vEraseQueue)
+            EraseOrphanTx(hash);
+    } else if (fMissingInputs) {
+        AddOrphanTx(tx, pfrom->GetId());
+
+        // DoS prevention: do not allow mapOrphanTransactions to grow unbounded
+        unsigned int nMaxOrphanTx = (unsigned int)std::max((int64_t)0, GetArg("-maxorphantx",
+                                                                           DEFAULT_MAX_ORPHAN_TRANSACTIONS));
+        unsigned int nEvicted = LimitOrphanTxSize(nMaxOrphanTx);
+        if (nEvicted > 0)
+            LogPrint("mempool", "mapOrphan overflow, removed %u tx\n", nEvicted);
+    } else if (pfrom->fWhitelisted) {
+        // Always relay transactions received from whitelisted peers, even
+        // if they are already in the mempool (allowing the node to function
+        // as a gateway for nodes hidden behind it).
+
+        RelayTransaction(tx);
+    }
+
+    if (strCommand == "dstx") {
+        CInv inv(MSG_DSTX, tx.GetHash());
+        RelayInv(inv);
+    }
+
+    int nDoS = 0;
+    if (state.IsInvalid(nDoS)) {
+        LogPrint("mempool", "%s from peer=%d %s was not accepted into the memory pool: %s\n",
+            tx.GetHash().ToString(),
+            pfrom->id, pfrom->cleanSubVer,
+            state.GetRejectReason());
+        pfrom->PushMessage("reject", strCommand, state.GetRejectCode(),
+            state.GetRejectReason().substr(0, MAX_REJECT_MESSAGE_LENGTH), inv.hash);
+        if (nDoS > 0)
+            Misbehaving(pfrom->GetId(), nDoS);
+    }
+}
+
+bool static ProcessMessage(CNode* pfrom, string strCommand, CDataStream& vRecv, int64_t nTimeReceived, CPreCheckedMessage* pchecked = NULL)
 {
     RandAddSeedPerfmon();
     if (fDebug)
@@ -6219,8 +6797,6 @@ bool static ProcessMessage(CNode* pfrom, string strCommand, CDataStream& vRecv,
         }
         pfrom->PushMessage("headers", vHeaders);
     } else if (strCommand == "tx" || strCommand == "dstx") {
-        vector<uint256> vWorkQueue;
-        vector<uint256> vEraseQueue;
         CTransaction tx;
 
         //masternode signed transaction
@@ -6230,7 +6806,10 @@ bool static ProcessMessage(CNode* pfrom, string strCommand, CDataStream& vRecv,
         int64_t sigTime;
 
         if (strCommand == "tx") {
-            vRecv >> tx;
+            if (pchecked && pchecked->fParsed)
+                tx = pchecked->tx;
+            else
+                vRecv >> tx;
         } else if (strCommand == "dstx") {
             //these allow masternodes to publish a limited amount of free transactions
             vRecv >> tx >> vin >> vchSig >> sigTime;
@@ -6273,102 +6852,12 @@ bool static ProcessMessage(CNode* pfrom, string strCommand, CDataStream& vRecv,
         CInv inv(MSG_TX, tx.GetHash());
         pfrom->AddInventoryKnown(inv);
 
-        LOCK(cs_main);
+        // Check the proofs on the pre-validation threads, away from cs_main
+        if (txPreValidator.Submit(pfrom, tx, strCommand, ignoreFees))
+            return true;
 
-        bool fMissingInputs = false;
         CValidationState state;
-
-        mapAlreadyAskedFor.erase(inv);
-
-        if (AcceptToMemoryPool(mempool, state, tx, true, &fMissingInputs, false, ignoreFees)) {
-            mempool.check(pcoinsTip);
-            RelayTransaction(tx);
-            vWorkQueue.push_back(inv.hash);
-
-            LogPrint("mempool", "AcceptToMemoryPool: peer=%d %s : accepted %s (poolsz %u)\n",
-                pfrom->id, pfrom->cleanSubVer,
-                tx.GetHash().ToString(),
-                mempool.mapTx.size());
-
-            // Recursively process any orphan transactions that depended on this one
-            set<NodeId> setMisbehaving;
-            for (unsigned int i = 0; i < vWorkQueue.size(); i++) {
-                map<uint256, set<uint256> >::iterator
-                    itByPrev = mapOrphanTransactionsByPrev.find(vWorkQueue[i]);
-                if (itByPrev == mapOrphanTransactionsByPrev.end())
-                    continue;
-                for (set<uint256>::iterator mi = itByPrev->second.begin();
-                     mi != itByPrev->second.end();
-                     ++mi) {
-                    const uint256& orphanHash = *mi;
-                    const CTransaction& orphanTx = mapOrphanTransactions[orphanHash].tx;
-                    NodeId fromPeer = mapOrphanTransactions[orphanHash].fromPeer;
-                    bool fMissingInputs2 = false;
-                    // Use a dummy CValidationState so someone can't setup nodes to counter-DoS based on orphan
-                    // resolution (that is, feeding people an invalid transaction based on LegitTxX in order to get
-                    // anyone relaying LegitTxX banned)
-                    CValidationState stateDummy;
-
-
-                    if (setMisbehaving.count(fromPeer))
-                        continue;
-                    if (AcceptToMemoryPool(mempool, stateDummy, orphanTx, true, &fMissingInputs2)) {
-                        LogPrint("mempool", "   accepted orphan tx %s\n", orphanHash.ToString());
-                        RelayTransaction(orphanTx);
-                        vWorkQueue.push_back(orphanHash);
-                        vEraseQueue.push_back(orphanHash);
-                    } else if (!fMissingInputs2) {
-                        int nDos = 0;
-                        if (stateDummy.IsInvalid(nDos) && nDos > 0) {
-                            // Punish peer that gave us an invalid orphan tx
-                            Misbehaving(fromPeer, nDos);
-                            setMisbehaving.insert(fromPeer);
-                            LogPrint("mempool", "   invalid orphan tx %s\n", orphanHash.ToString());
-                        }
-                        // Has inputs but not accepted to mempool
-                        // Probably non-standard or insufficient fee/priority
-                        LogPrint("mempool", "   removed orphan tx %s\n", orphanHash.ToString());
-                        vEraseQueue.push_back(orphanHash);
-                    }
-                    mempool.check(pcoinsTip);
-                }
-            }
-
-            BOOST_FOREACH (uint256 hash, vEraseQueue)
-                EraseOrphanTx(hash);
-        } else if (fMissingInputs) {
-            AddOrphanTx(tx, pfrom->GetId());
-
-            // DoS prevention: do not allow mapOrphanTransactions to grow unbounded
-            unsigned int nMaxOrphanTx = (unsigned int)std::max((int64_t)0, GetArg("-maxorphantx",
-                                                                               DEFAULT_MAX_ORPHAN_TRANSACTIONS));
-            unsigned int nEvicted = LimitOrphanTxSize(nMaxOrphanTx);
-            if (nEvicted > 0)
-                LogPrint("mempool", "mapOrphan overflow, removed %u tx\n", nEvicted);
-        } else if (pfrom->fWhitelisted) {
-            // Always relay transactions received from whitelisted peers, even
-            // if they are already in the mempool (allowing the node to function
-            // as a gateway for nodes hidden behind it).
-
-            RelayTransaction(tx);
-        }
-
-        if (strCommand == "dstx") {
-            CInv inv(MSG_DSTX, tx.GetHash());
-            RelayInv(inv);
-        }
-
-        int nDoS = 0;
-        if (state.IsInvalid(nDoS)) {
-            LogPrint("mempool", "%s from peer=%d %s was not accepted into the memory pool: %s\n",
-                tx.GetHash().ToString(),
-                pfrom->id, pfrom->cleanSubVer,
-                state.GetRejectReason());
-            pfrom->PushMessage("reject", strCommand, state.GetRejectCode(),
-                state.GetRejectReason().substr(0, MAX_REJECT_MESSAGE_LENGTH), inv.hash);
-            if (nDoS > 0)
-                Misbehaving(pfrom->GetId(), nDoS);
-        }
+        ProcessTransaction(pfrom, tx, strCommand, ignoreFees, state);
     } else if (strCommand == "headers" && Params().HeadersFirstSyncingActive() && !fImporting &&
                !fReindex) // Ignore headers received while importing
     {
@@ -6430,8 +6919,14 @@ bool static ProcessMessage(CNode* pfrom, string strCommand, CDataStream& vRecv,
         CheckBlockIndex();
     } else if (strCommand == "block" && !fImporting && !fReindex) // Ignore blocks received while importing
     {
-        CBlock block;
-        vRecv >> block;
+        // Deserialized and checked on a pre-check thread unless those were busy
+        CBlock blockRecv;
+        if (!pchecked || !pchecked->fParsed)
+            vRecv >> blockRecv;
+        CBlock& block = pchecked && pchecked->fParsed ? pchecked->block : blockRecv;
+        // The pre-check thread leaves out the coinstake proof, which its batch put in the proof cache if it verified
+        if (pchecked && pchecked->fParsed && pchecked->fContextFree)
+            block.fChecked = !block.IsProofOfStake() || VerifyShnorrKeyImageTx(block.vtx[1]);
         uint256 hashBlock = block.GetHash();
         CInv inv(MSG_BLOCK, hashBlock);
         LogPrint("net", "received block %s peer=%d, height=%d\n", inv.hash.ToString(), pfrom->id, chainActive.Height());
@@ -6703,6 +7198,9 @@ bool ProcessMessages(CNode* pfrom)
     // this maintains the order of responses
     if (!pfrom->vRecvGetData.empty()) return fOk;
 
+    // Deserialize and check the next blocks and transactions of this peer on the pre-check threads
+    messagePreChecker.Submit(pfrom);
+
     std::deque<CNetMessage>::iterator it = pfrom->vRecvMsg.begin();
     while (!pfrom->fDisconnect && it != pfrom->vRecvMsg.end()) {
         // Don't bother if send buffer is too full to respond anyway
@@ -6715,6 +7213,11 @@ bool ProcessMessages(CNode* pfrom)
         if (!msg.complete())
             break;
 
+        // keep the messages of this peer in order while its next one is being checked
+        if (messagePreChecker.IsPending(msg))
+            break;
+        CPreCheckedMessage* pchecked = msg.pchecked && msg.pchecked->fChecked ? msg.pchecked.get() : NULL;
+
         // at this point, any failure means we can delete the current message
         it++;
 
@@ -6739,9 +7242,13 @@ bool ProcessMessages(CNode* pfrom)
 
         // Checksum
         CDataStream& vRecv = msg.vRecv;
-        uint256 hash = Hash(vRecv.begin(), vRecv.begin() + nMessageSize);
         unsigned int nChecksum = 0;
-        memcpy(&nChecksum, &hash, sizeof(nChecksum));
+        if (pchecked) {
+            nChecksum = pchecked->nChecksum;
+        } else {
+            uint256 hash = Hash(vRecv.begin(), vRecv.begin() + nMessageSize);
+            memcpy(&nChecksum, &hash, sizeof(nChecksum));
+        }
         if (nChecksum != hdr.nChecksum) {
             LogPrintf("ProcessMessages(%s, %u bytes): CHECKSUM ERROR nChecksum=%08x hdr.nChecksum=%08x\n",
                 SanitizeString(strCommand), nMessageSize, nChecksum, hdr.nChecksum);
@@ -6750,7 +7257,7 @@ bool ProcessMessages(CNode* pfrom)
         // Process message
         bool fRet = false;
         try {
-            fRet = ProcessMessage(pfrom, strCommand, vRecv, msg.nTime);
+            fRet = ProcessMessage(pfrom, strCommand, vRecv, msg.nTime, pchecked);
             boost::this_thread::interruption_point();
         } catch (std::ios_base::failure& e) {
             pfrom->PushMessage("reject", strCommand, REJECT_MALFORMED, string("error parsing message"));
@@ -7023,45 +7530,55 @@ bool SendMessages(CNode* pto, bool fSendTrickle)
 
 bool CBlockUndo::WriteToDisk(CDiskBlockPos& pos, const uint256& hashBlock)
 {
-    // Open history file to append
-    CAutoFile fileout(OpenUndoFile(pos), SER_DISK, CLIENT_VERSION);
-    if (fileout.IsNull())
-        return error("CBlockUndo::WriteToDisk : OpenUndoFile failed");
+    CDataStream ss(SER_DISK, CLIENT_VERSION);
 
     // Write index header
-    unsigned int nSize = fileout.GetSerializeSize(*this);
-    fileout << FLATDATA(Params().MessageStart()) << nSize;
+    unsigned int nSize = ss.GetSerializeSize(*this);
+    ss << FLATDATA(Params().MessageStart()) << nSize;
 
     // Write undo data
-    long fileOutPos = ftell(fileout.Get());
-    if (fileOutPos < 0)
-        return error("CBlockUndo::WriteToDisk : ftell failed");
-    pos.nPos = (unsigned int)fileOutPos;
-    fileout << *this;
+    CDiskBlockPos posRecord = pos;
+    pos.nPos += ss.size();
+    ss << *this;
 
     // calculate & write checksum
     CHashWriter hasher(SER_GETHASH, PROTOCOL_VERSION);
     hasher << hashBlock;
     hasher << *this;
-    fileout << hasher.GetHash();
+    ss << hasher.GetHash();
+
+    // Hand the record to the block file writer
+    std::vector<char> vch(ss.begin(), ss.end());
+    if (!blockFileWriter.Write(CBlockFileWriter::UNDO_FILE, posRecord, vch))
+        return error("CBlockUndo::WriteToDisk : write to undo file failed");
 
     return true;
 }
 
 bool CBlockUndo::ReadFromDisk(const CDiskBlockPos& pos, const uint256& hashBlock)
 {
-    // Open history file to read
-    CAutoFile filein(OpenUndoFile(pos, true), SER_DISK, CLIENT_VERSION);
-    if (filein.IsNull())
-        return error("CBlockUndo::ReadFromDisk : OpenBlockFile failed");
-
-    // Read block
+    // Read block, possibly still queued for the block file writer
     uint256 hashChecksum;
-    try {
-        filein >> *this;
-        filein >> hashChecksum;
-    } catch (std::exception& e) {
-        return error("%s : Deserialize or I/O error - %s", __func__, e.what());
+    CDataStream ssPending(SER_DISK, CLIENT_VERSION);
+    if (blockFileWriter.ReadPending(CBlockFileWriter::UNDO_FILE, pos, ssPending)) {
+        try {
+            ssPending >> *this;
+            ssPending >> hashChecksum;
+        } catch (std::exception& e) {
+            return error("%s : Deserialize error - %s", __func__, e.what());
+        }
+    } else {
+        // Open history file to read
+        CAutoFile filein(OpenUndoFile(pos, true), SER_DISK, CLIENT_VERSION);
+        if (filein.IsNull())
+            return error("CBlockUndo::ReadFromDisk : OpenBlockFile failed");
+
+        try {
+            filein >> *this;
+            filein >> hashChecksum;
+        } catch (std::exception& e) {
+            return error("%s : Deserialize or I/O error - %s", __func__, e.what());
+        }
     }
 
     // Verify checksum
@@ -7088,10 +7605,7 @@ public:
 
     ~CMainCleanup()
     {
-        // block headers
-        BlockMap::iterator it1 = mapBlockIndex.begin();
-        for (; it1 != mapBlockIndex.end(); it1++)
-            delete (*it1).second;
+        // block headers, the entries themselves are released with blockIndexArena
         mapBlockIndex.clear();
 
         // orphan transactions
@@ -45,11 +45,12 @@
 #include "secp256k1_bulletproofs.h"
 #include "secp256k1_commitment.h"
 #include "secp256k1_generator.h"
-#include "secp256k1.h"
+#include "ecutil.h"
 #include "secp256k1-mw/src/hash_impl.h"
 
 class CBlockIndex;
 class CBlockTreeDB;
+class CBlockUndo;
 class CBloomFilter;
 class CInv;
 class CScriptCheck;
@@ -189,14 +190,60 @@ void RegisterNodeSignals(CNodeSignals& nodeSignals);
 /** Unregister a network node */
 void UnregisterNodeSignals(CNodeSignals& nodeSignals);
 
-secp256k1_context2* GetContext();
+/**
+ * The ring members of a transaction, resolved once to the output and the
+ * block holding it. Input i's members are its prevout followed by its
+ * decoys, in the order the MLSAG uses them.
+ *
+ * CheckHaveInputs, CheckInputs and VerifyRingSignatureWithTxFee take the
+ * same instance for a transaction, so every member is read from disk and
+ * looked up in mapBlockIndex once. Maturity and ancestry depend on the
+ * chain, so they are checked again by every caller, which is cheap.
+ */
+class CResolvedRing
+{
+public:
+    struct CMember {
+        COutPoint outpoint;
+        uint256 hashBlock;
+        CBlockIndex* pindex;
+        //! Output of a coinbase, coinstake or coin audit, which has to mature
+        bool fCoinBase;
+        bool fHavePubKey;
+        CPubKey pubKey;
+        std::vector<unsigned char> commitment;
+    };
+
+    std::vector<std::vector<CMember> > vInputs;
+
+    CResolvedRing() : fResolved(false), fValid(false) {}
+
+    //! Resolve every member of tx, the first time it is called for tx
+    bool Resolve(const CTransaction& tx);
+    //! Whether every coinbase member is mature in a block at nSpendHeight
+    bool IsMature(int nSpendHeight) const;
+    //! Whether every member is in the active chain
+    bool IsInActiveChain() const;
+    //! Commit to the blocks, keys and commitments resolved, for verification caches
+    void AddToHash(CHashWriter& hasher) const;
+
+private:
+    uint256 hashTx;
+    bool fResolved;
+    bool fValid;
+};
+
 secp256k1_scratch_space2* GetScratch();
 secp256k1_bulletproof_generators* GetGenerator();
 bool VerifyBulletProofAggregate(const CTransaction& tx);
-bool VerifyRingSignatureWithTxFee(const CTransaction& tx, CBlockIndex* pindex);
+bool VerifyBulletProofAggregate(const CTransaction& tx, secp256k1_scratch_space2* scratch);
+bool VerifyRingSignatureWithTxFee(const CTransaction& tx, CBlockIndex* pindex, CResolvedRing* pring = NULL);
 void DestroyContext();
 bool VerifyDerivedAddress(const CTxOut& out, std::string stealth);
 bool ReVerifyPoSBlock(CBlockIndex* pindex);
+bool ReVerifyPoSBlock(CBlockIndex* pindex, const CBlock& block);
+//! Read the PoS blocks audited by a PoA block and batch verify their coinstake key image proofs
+void ReadAuditedPoSBlocks(const CBlock& block, std::map<uint256, CBlock>& mapBlocks);
 
 /** 
  * Process an incoming block. This only returns after the best known valid
@@ -220,6 +267,12 @@ FILE* OpenUndoFile(const CDiskBlockPos& pos, bool fReadOnly = false);
 boost::filesystem::path GetBlockPosFilename(const CDiskBlockPos& pos, const char* prefix);
 /** Import blocks from an external file */
 bool LoadExternalBlockFile(FILE* fileIn, CDiskBlockPos* dbp = NULL);
+/** Write a block of a UTXO snapshot, with its undo data if pundo is set, its index record, transaction index and key images, without validating it */
+bool StoreSnapshotBlock(CBlock& block, CDiskBlockIndex& diskindex, CBlockUndo* pundo, CValidationState& state);
+/** Flush the block files written by StoreSnapshotBlock and commit their file info and the staged key images */
+bool FlushSnapshotBlocks(CValidationState& state);
+/** Hand a block read from an external file to validation, holding it back until its parent is known; false on a system error that ends the import */
+bool ProcessImportedBlock(CBlock& block, CDiskBlockPos* dbp, int& nLoaded);
 /** Initialize a new block tree database + block data on disk */
 bool InitBlockIndex();
 /** Load the block tree and coins database from disk */
@@ -250,9 +303,12 @@ bool IsInitialBlockDownload();
 std::string GetWarnings(std::string strFor);
 /** Retrieve a transaction (from memory pool, or from disk, if possible) */
 bool GetTransaction(const uint256& hash, CTransaction& tx, uint256& hashBlock, bool fAllowSlow = false);
+/** Retrieve a transaction from the memory pool or the txindex without taking cs_main (falls back to GetTransaction without -txindex) */
+bool LookupTransaction(const uint256& hash, CTransaction& tx, uint256& hashBlock);
 /** Find the best known block, and make it the tip of the block chain */
 
-bool CheckHaveInputs(const CCoinsViewCache& view, const CTransaction& tx);
+bool CheckHaveInputs(const CCoinsViewCache& view, const CTransaction& tx, CResolvedRing* pring = NULL);
+bool CheckHaveInputs(const CBlockIndex* pindexPrev, const CTransaction& tx, CResolvedRing* pring = NULL);
 
 bool DisconnectBlocksAndReprocess(int blocks);
 
@@ -286,10 +342,27 @@ CAmount GetValueIn(CCoinsViewCache view, const CTransaction& tx);
 /** (try to) add transaction to memory pool **/
 bool AcceptToMemoryPool(CTxMemPool& pool, CValidationState& state, const CTransaction& tx, bool fLimitFree, bool* pfMissingInputs, bool fRejectInsaneFee = false, bool ignoreFees = false);
 
+/**
+ * Check the proofs of a loose transaction against the current tip without
+ * holding cs_main, leaving the results in the proof cache so the following
+ * AcceptToMemoryPool only does the checks that need the lock. Returns false
+ * only with a verdict AcceptToMemoryPool would have reached as well; anything
+ * it cannot decide on its own is left to AcceptToMemoryPool.
+ */
+bool PreValidateTransaction(const CTransaction& tx, CValidationState& state, secp256k1_scratch_space2* scratch);
+/**
+ * Handle a "tx" or "dstx" message from pfrom: accept it to the memory pool,
+ * relay it and resolve orphans, or reject it. If state is already invalid,
+ * from PreValidateTransaction, only the rejection is done.
+ */
+void ProcessTransaction(CNode* pfrom, const CTransaction& tx, const std::string& strCommand, bool ignoreFees, CValidationState& state);
+
 bool AcceptableInputs(CTxMemPool& pool, CValidationState& state, const CTransaction& tx, bool fLimitFree, bool* pfMissingInputs, bool fRejectInsaneFee = false, bool isDSTX = false);
 
 bool IsKeyImageSpend1(const std::string& kiHex, const uint256& againsHash);
 bool CheckKeyImageSpendInMainChain(const std::string& kiHex, int& confirmations);
+/** Block of the active chain that spent the key image, NULL if none did. cs_main must be held */
+CBlockIndex* FindKeyImageSpendBlock(const std::string& kiHex);
 
 double GetPriority(const CTransaction& tx, int nHeight);
 
@@ -298,8 +371,15 @@ uint256 GetTxSignatureHash(const CTransaction& tx);
 uint256 GetTxInSignatureHash(const CTxIn& txin);
 bool VerifyShnorrKeyImageTx(const CTransaction& tx);
 bool VerifyShnorrKeyImageTxIn(const CTxIn& txin, uint256 sigHash);
+/**
+ * Verify the key image proofs of all coinstakes in vtx with one multi-scalar
+ * multiplication. Valid proofs go to the proof cache, so the per-transaction
+ * checks that follow are lookups. Returns false if a proof is invalid or could
+ * not be batched, the callers' own checks then find out which one.
+ */
+bool VerifyShnorrKeyImageTxs(const std::vector<const CTransaction*>& vtx);
 
-int GetInputAge(CTxIn& vin);
+int GetInputAge(const CTxIn& vin);
 int GetInputAgeIX(uint256 nTXHash, CTxIn& vin);
 bool GetCoinAge(const CTransaction& tx, unsigned int nTxTime, uint64_t& nCoinAge);
 int GetIXConfirmations(uint256 nTXHash);
@@ -374,10 +454,16 @@ unsigned int GetLegacySigOpCount(const CTransaction& tx);
  * This does not modify the UTXO set. If pvChecks is not NULL, script checks are pushed onto it
  * instead of being performed inline.
  */
-bool CheckInputs(const CTransaction& tx, CValidationState& state, const CCoinsViewCache& view, bool fScriptChecks, unsigned int flags, bool cacheStore, std::vector<CScriptCheck>* pvChecks = NULL);
+bool CheckInputs(const CTransaction& tx, CValidationState& state, const CCoinsViewCache& view, bool fScriptChecks, unsigned int flags, bool cacheStore, std::vector<CScriptCheck>* pvChecks = NULL, CResolvedRing* pring = NULL);
 
 /** Apply the effects of this transaction on the UTXO set represented by view */
 void UpdateCoins(const CTransaction& tx, CValidationState& state, CCoinsViewCache& inputs, CTxUndo& txundo, int nHeight);
+/** Record in stats the outputs UpdateCoins spent and added for tx, as given by txundo and inputs */
+void UpdateUtxoStats(const CTransaction& tx, const CCoinsViewCache& inputs, const CTxUndo& txundo, CUtxoStats& stats);
+/** Coins block creates and fees it destroys, summed from its transactions as ConnectBlock does */
+void GetBlockSupplyChange(const CBlock& block, CAmount& nMint, CAmount& nFees);
+/** Check the masternode and foundation outputs of the coinstake of the proof-of-stake block on top of pindexPrev */
+bool CheckCoinStakeRewards(const CBlock& block, CBlockIndex* pindexPrev, CValidationState& state);
 
 /** Context-independent validity checks */
 bool CheckTransaction(const CTransaction& tx, bool fzcActive, bool fRejectBadUTXO, CValidationState& state);
@@ -465,6 +551,8 @@ public:
 bool WriteBlockToDisk(CBlock& block, CDiskBlockPos& pos);
 bool ReadBlockFromDisk(CBlock& block, const CDiskBlockPos& pos);
 bool ReadBlockFromDisk(CBlock& block, const CBlockIndex* pindex);
+/** Serialized block as stored on disk, without deserializing it */
+bool ReadRawBlockFromDisk(std::vector<unsigned char>& vchBlock, const CDiskBlockPos& pos);
 
 
 /** Functions for validating blocks and updating the block tree */
@@ -484,10 +572,17 @@ bool ConnectBlock(const CBlock& block, CValidationState& state, CBlockIndex* pin
 /** Context-independent validity checks */
 bool CheckBlockHeader(const CBlockHeader& block, CValidationState& state, bool fCheckPOW = true);
 bool CheckBlock(const CBlock& block, CValidationState& state, bool fCheckPOW = true, bool fCheckMerkleRoot = true, bool fCheckSig = true);
+/**
+ * The part of CheckBlock that only looks at the block itself; sets block.fChecked when it passes with fCheckMerkleRoot
+ * and fCheckStakeProof. The coinstake's key image proof reads the staked output through the transaction index, without
+ * fCheckStakeProof the remaining checks need neither it nor cs_main.
+ */
+bool CheckBlockContextFree(const CBlock& block, CValidationState& state, bool fCheckMerkleRoot = true, bool fCheckStakeProof = true);
 bool CheckWork(const CBlock block, CBlockIndex* const pindexPrev);
 
 /** Context-dependent validity checks */
-bool ContextualCheckBlockHeader(const CBlockHeader& block, CValidationState& state, CBlockIndex* pindexPrev);
+/** fNewBlock is false for blocks of the active chain being checked again, which are exempt from the reorganization depth and checkpoint fork rules */
+bool ContextualCheckBlockHeader(const CBlockHeader& block, CValidationState& state, CBlockIndex* pindexPrev, bool fNewBlock = true);
 bool ContextualCheckBlock(const CBlock& block, CValidationState& state, CBlockIndex* pindexPrev);
 
 /** Check a block is completely valid from start to finish (only works on top of our current best block, with cs_main held) */
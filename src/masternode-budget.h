@@ -69,6 +69,7 @@ public:
     bool Sign(CKey& keyMasternode, CPubKey& pubKeyMasternode);
     bool SignatureValid(bool fSignatureCheck);
     void Relay();
+    std::string GetStrMessage();
 
     std::string GetVoteString()
     {
@@ -121,6 +122,7 @@ public:
     bool Sign(CKey& keyMasternode, CPubKey& pubKeyMasternode);
     bool SignatureValid(bool fSignatureCheck);
     void Relay();
+    std::string GetStrMessage();
 
     uint256 GetHash()
     {
@@ -143,7 +145,7 @@ public:
     }
 };
 
-/** Save Budget Manager (budget.dat)
+/** Budget Manager as saved in budget.dat, only read to import it into the masternode state database
  */
 class CBudgetDB
 {
@@ -163,7 +165,6 @@ public:
     };
 
     CBudgetDB();
-    bool Write(const CBudgetManager& objToSave);
     ReadResult Read(CBudgetManager& objToLoad, bool fDryRun = false);
 };
 
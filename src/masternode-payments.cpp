@@ -8,6 +8,7 @@
 #include "addrman.h"
 #include "masternode-budget.h"
 #include "masternode-sync.h"
+#include "masternodedb.h"
 #include "masternodeman.h"
 #include "obfuscation.h"
 #include "sync.h"
@@ -33,37 +34,6 @@ CMasternodePaymentDB::CMasternodePaymentDB()
     strMagicMessage = "MasternodePayments";
 }
 
-bool CMasternodePaymentDB::Write(const CMasternodePayments& objToSave)
-{
-    int64_t nStart = GetTimeMillis();
-
-    // serialize, checksum data up to that point, then append checksum
-    CDataStream ssObj(SER_DISK, CLIENT_VERSION);
-    ssObj << strMagicMessage;                   // masternode cache file specific magic message
-    ssObj << FLATDATA(Params().MessageStart()); // network specific magic number
-    ssObj << objToSave;
-    uint256 hash = Hash(ssObj.begin(), ssObj.end());
-    ssObj << hash;
-
-    // open output file, and associate with CAutoFile
-    FILE* file = fopen(pathDB.string().c_str(), "wb");
-    CAutoFile fileout(file, SER_DISK, CLIENT_VERSION);
-    if (fileout.IsNull())
-        return error("%s : Failed to open file %s", __func__, pathDB.string());
-
-    // Write and commit header, data
-    try {
-        fileout << ssObj;
-    } catch (std::exception& e) {
-        return error("%s : Serialize or I/O error - %s", __func__, e.what());
-    }
-    fileout.fclose();
-
-    LogPrint("masternode","Written info to mnpayments.dat  %dms\n", GetTimeMillis() - nStart);
-
-    return true;
-}
-
 CMasternodePaymentDB::ReadResult CMasternodePaymentDB::Read(CMasternodePayments& objToLoad, bool fDryRun)
 {
     int64_t nStart = GetTimeMillis();
@@ -128,6 +98,7 @@ CMasternodePaymentDB::ReadResult CMasternodePaymentDB::Read(CMasternodePayments&
 
         // de-serialize data into CMasternodePayments object
         ssObj >> objToLoad;
+        objToLoad.RebuildPaidIndex();
     } catch (std::exception& e) {
         objToLoad.Clear();
         error("%s : Deserialize or I/O error - %s", __func__, e.what());
@@ -148,29 +119,8 @@ CMasternodePaymentDB::ReadResult CMasternodePaymentDB::Read(CMasternodePayments&
 
 void DumpMasternodePayments()
 {
-    int64_t nStart = GetTimeMillis();
-
-    CMasternodePaymentDB paymentdb;
-    CMasternodePayments tempPayments;
-
-    LogPrint("masternode","Verifying mnpayments.dat format...\n");
-    CMasternodePaymentDB::ReadResult readResult = paymentdb.Read(tempPayments, true);
-    // there was an error and it was not an error on file opening => do not proceed
-    if (readResult == CMasternodePaymentDB::FileError)
-        LogPrint("masternode","Missing budgets file - mnpayments.dat, will try to recreate\n");
-    else if (readResult != CMasternodePaymentDB::Ok) {
-        LogPrint("masternode","Error reading mnpayments.dat: ");
-        if (readResult == CMasternodePaymentDB::IncorrectFormat)
-            LogPrint("masternode","magic is ok but data has invalid format, will try to recreate\n");
-        else {
-            LogPrint("masternode","file format is unknown or invalid, please fix it manually\n");
-            return;
-        }
-    }
-    LogPrint("masternode","Writting info to mnpayments.dat...\n");
-    paymentdb.Write(masternodePayments);
-
-    LogPrint("masternode","Budget dump finished  %dms\n", GetTimeMillis() - nStart);
+    if (pmnstatedb)
+        pmnstatedb->Save(masternodePayments);
 }
 
 bool IsBlockValueValid(const CBlock& block, CAmount nExpectedValue, CAmount nMinted)
@@ -263,8 +213,8 @@ bool CMasternodePayments::FillBlockPayee(CMutableTransaction& txNew, int64_t nFe
     masternodePayments.GetBlockPayee(pindexPrev->nHeight + 1, payeeAddr);
     if (payeeAddr.size() != 0) {
     	bool isNotSpent = false;
-    	std::vector <CMasternode> mns = mnodeman.GetFullMasternodeVector();
-    	BOOST_FOREACH(CMasternode& mn, mns) {
+    	MasternodeListRef mns = mnodeman.GetList();
+    	BOOST_FOREACH(const CMasternode& mn, *mns) {
     		if (mn.vin.masternodeStealthAddress == payeeAddr && mn.IsEnabled()) {
     			isNotSpent = true;
     			break;
@@ -282,8 +232,8 @@ bool CMasternodePayments::FillBlockPayee(CMutableTransaction& txNew, int64_t nFe
 
         if (payeeAddr.size() != 0) {
         	bool isNotSpent = false;
-        	std::vector <CMasternode> mns = mnodeman.GetFullMasternodeVector();
-            BOOST_FOREACH(CMasternode& mn, mns) {
+        	MasternodeListRef mns = mnodeman.GetList();
+            BOOST_FOREACH(const CMasternode& mn, *mns) {
         		if (mn.vin.masternodeStealthAddress == payeeAddr && mn.IsEnabled()) {
         			isNotSpent = true;
         			break;
@@ -427,9 +377,7 @@ bool CMasternodePaymentWinner::Sign(CKey& keyMasternode, CPubKey& pubKeyMasterno
     std::string errorMessage;
     std::string strMasterNodeSignMessage;
     std::string payeeString(payee.begin(), payee.end());
-    HEX_DATA_STREAM_PROTOCOL(PROTOCOL_VERSION) << vinMasternode.prevout.GetHash() << nBlockHeight << payee;
-    std::string strMessage = HEX_STR(ser);
-
+    std::string strMessage = GetStrMessage();
 
     if (!obfuScationSigner.SignMessage(strMessage, errorMessage, vchSig, keyMasternode)) {
         LogPrint("masternode","CMasternodePing::Sign() - Error: %s\n", errorMessage.c_str());
@@ -455,7 +403,7 @@ bool CMasternodePayments::GetBlockPayee(int nBlockHeight, std::vector<unsigned c
 
 // Is this masternode scheduled to get paid soon?
 // -- Only look ahead up to 8 blocks to allow for propagation of the latest 2 winners
-bool CMasternodePayments::IsScheduled(CMasternode& mn, int nNotBlockHeight)
+bool CMasternodePayments::IsScheduled(const CMasternode& mn, int nNotBlockHeight)
 {
     LOCK(cs_mapMasternodeBlocks);
 
@@ -499,16 +447,73 @@ bool CMasternodePayments::AddWinningMasternode(CMasternodePaymentWinner& winnerI
         }
 
         mapMasternodePayeeVotes[winnerIn.GetHash()] = winnerIn;
+        AddPayeeVote(winnerIn.nBlockHeight, winnerIn.vinMasternode.masternodeStealthAddress);
+    }
+
+    return true;
+}
 
-        if (!mapMasternodeBlocks.count(winnerIn.nBlockHeight)) {
-            CMasternodeBlockPayees blockPayees(winnerIn.nBlockHeight);
-            mapMasternodeBlocks[winnerIn.nBlockHeight] = blockPayees;
+void CMasternodePayments::AddPayeeVote(int nBlockHeight, const std::vector<unsigned char>& payee)
+{
+    LOCK(cs_mapMasternodeBlocks);
+
+    if (!mapMasternodeBlocks.count(nBlockHeight)) {
+        CMasternodeBlockPayees blockPayees(nBlockHeight);
+        mapMasternodeBlocks[nBlockHeight] = blockPayees;
+    }
+
+    CMasternodeBlockPayees& blockPayees = mapMasternodeBlocks[nBlockHeight];
+    blockPayees.AddPayee(1, payee);
+    if (blockPayees.HasPayeeWithVotes(payee, MNPAYMENTS_PAID_VOTES))
+        mapPaidHeights[payee].insert(nBlockHeight);
+}
+
+void CMasternodePayments::RemoveBlock(int nBlockHeight)
+{
+    LOCK2(cs_mapMasternodeBlocks, cs_vecPayments);
+
+    std::map<int, CMasternodeBlockPayees>::iterator it = mapMasternodeBlocks.find(nBlockHeight);
+    if (it == mapMasternodeBlocks.end())
+        return;
+
+    BOOST_FOREACH (const CMasternodePayee& payee, it->second.vecPayments) {
+        std::map<std::vector<unsigned char>, std::set<int> >::iterator mi = mapPaidHeights.find(payee.masternodeStealthAddress);
+        if (mi == mapPaidHeights.end())
+            continue;
+        mi->second.erase(nBlockHeight);
+        if (mi->second.empty())
+            mapPaidHeights.erase(mi);
+    }
+    mapMasternodeBlocks.erase(it);
+}
+
+void CMasternodePayments::RebuildPaidIndex()
+{
+    LOCK2(cs_mapMasternodeBlocks, cs_vecPayments);
+
+    mapPaidHeights.clear();
+    for (std::map<int, CMasternodeBlockPayees>::const_iterator it = mapMasternodeBlocks.begin(); it != mapMasternodeBlocks.end(); ++it) {
+        BOOST_FOREACH (const CMasternodePayee& payee, it->second.vecPayments) {
+            if (payee.nVotes >= MNPAYMENTS_PAID_VOTES)
+                mapPaidHeights[payee.masternodeStealthAddress].insert(it->first);
         }
     }
+}
 
-    mapMasternodeBlocks[winnerIn.nBlockHeight].AddPayee(1, winnerIn.vinMasternode.masternodeStealthAddress);
+int CMasternodePayments::GetLastPaidHeight(const std::vector<unsigned char>& payee, int nMinHeight, int nMaxHeight)
+{
+    LOCK(cs_mapMasternodeBlocks);
 
-    return true;
+    std::map<std::vector<unsigned char>, std::set<int> >::const_iterator mi = mapPaidHeights.find(payee);
+    if (mi == mapPaidHeights.end() || nMinHeight > nMaxHeight)
+        return 0;
+
+    // the first height past the window, the one before it is the latest payment if it is in the window
+    std::set<int>::const_iterator it = mi->second.upper_bound(nMaxHeight);
+    if (it == mi->second.begin())
+        return 0;
+    --it;
+    return *it >= nMinHeight ? *it : 0;
 }
 
 bool CMasternodeBlockPayees::IsTransactionValid(const CTransaction& txNew)
@@ -622,7 +627,7 @@ void CMasternodePayments::CleanPaymentList()
             LogPrint("mnpayments", "CMasternodePayments::CleanPaymentList - Removing old Masternode payment - block %d\n", winner.nBlockHeight);
             masternodeSync.mapSeenSyncMNW.erase((*it).first);
             mapMasternodePayeeVotes.erase(it++);
-            mapMasternodeBlocks.erase(winner.nBlockHeight);
+            RemoveBlock(winner.nBlockHeight);
         } else {
             ++it;
         }
@@ -735,13 +740,18 @@ void CMasternodePaymentWinner::Relay()
     RelayInv(inv);
 }
 
+std::string CMasternodePaymentWinner::GetStrMessage()
+{
+    HEX_DATA_STREAM_PROTOCOL(PROTOCOL_VERSION) << vinMasternode.prevout.GetHash() << nBlockHeight << payee;
+    return HEX_STR(ser);
+}
+
 bool CMasternodePaymentWinner::SignatureValid()
 {
     CMasternode* pmn = mnodeman.Find(vinMasternode);
 
     if (pmn != NULL) {
-        HEX_DATA_STREAM_PROTOCOL(PROTOCOL_VERSION) << vinMasternode.prevout.GetHash() << nBlockHeight << payee;
-        std::string strMessage = HEX_STR(ser);
+        std::string strMessage = GetStrMessage();
         std::string errorMessage = "";
         if (!obfuScationSigner.VerifyMessage(pmn->pubKeyMasternode, vchSig, strMessage, errorMessage)) {
             return error("CMasternodePaymentWinner::SignatureValid() - Got bad Masternode address signature %s\n", vinMasternode.prevout.hash.ToString());
@@ -12,6 +12,8 @@
 #include "masternode.h"
 #include <boost/lexical_cast.hpp>
 
+#include <set>
+
 using namespace std;
 
 extern CCriticalSection cs_vecPayments;
@@ -26,6 +28,8 @@ extern CMasternodePayments masternodePayments;
 
 #define MNPAYMENTS_SIGNATURES_REQUIRED 6
 #define MNPAYMENTS_SIGNATURES_TOTAL 10
+// votes a payee needs in a block for the masternode to count as paid there
+#define MNPAYMENTS_PAID_VOTES 2
 
 void ProcessMessageMasternodePayments(CNode* pfrom, std::string& strCommand, CDataStream& vRecv);
 bool IsBlockPayeeValid(const CBlock& block, int nBlockHeight);
@@ -35,7 +39,7 @@ bool FillBlockPayee(CMutableTransaction& txNew, CAmount nFees, bool fProofOfStak
 
 void DumpMasternodePayments();
 
-/** Save Masternode Payment Data (mnpayments.dat)
+/** Masternode Payment Data as saved in mnpayments.dat, only read to import it into the masternode state database
  */
 class CMasternodePaymentDB
 {
@@ -55,7 +59,6 @@ public:
     };
 
     CMasternodePaymentDB();
-    bool Write(const CMasternodePayments& objToSave);
     ReadResult Read(CMasternodePayments& objToLoad, bool fDryRun = false);
 };
 
@@ -195,6 +198,7 @@ public:
     bool IsValid(CNode* pnode, std::string& strError);
     bool SignatureValid();
     void Relay();
+    std::string GetStrMessage();
 
     void AddPayee(std::vector<unsigned char> payeeIn)
     {
@@ -236,6 +240,9 @@ private:
     int nSyncedFromPeer;
     int nLastBlockHeight;
 
+    // heights of mapMasternodeBlocks where each payee has MNPAYMENTS_PAID_VOTES, see GetLastPaidHeight
+    std::map<std::vector<unsigned char>, std::set<int> > mapPaidHeights;
+
 public:
     std::map<uint256, CMasternodePaymentWinner> mapMasternodePayeeVotes;
     std::map<int, CMasternodeBlockPayees> mapMasternodeBlocks;
@@ -252,8 +259,18 @@ public:
         LOCK2(cs_mapMasternodeBlocks, cs_mapMasternodePayeeVotes);
         mapMasternodeBlocks.clear();
         mapMasternodePayeeVotes.clear();
+        mapPaidHeights.clear();
     }
 
+    /// Count a vote for payee in block nBlockHeight
+    void AddPayeeVote(int nBlockHeight, const std::vector<unsigned char>& payee);
+    /// Forget the votes for block nBlockHeight
+    void RemoveBlock(int nBlockHeight);
+    /// Index mapMasternodeBlocks again after it was loaded as a whole
+    void RebuildPaidIndex();
+    /// Highest height from nMinHeight to nMaxHeight at which payee was voted paid, 0 if there is none
+    int GetLastPaidHeight(const std::vector<unsigned char>& payee, int nMinHeight, int nMaxHeight);
+
     bool AddWinningMasternode(CMasternodePaymentWinner& winner);
     bool ProcessBlock(int nBlockHeight);
 
@@ -263,7 +280,7 @@ public:
 
     bool GetBlockPayee(int nBlockHeight, std::vector<unsigned char>& payee);
     bool IsTransactionValid(const CTransaction& txNew, int nBlockHeight);
-    bool IsScheduled(CMasternode& mn, int nNotBlockHeight);
+    bool IsScheduled(const CMasternode& mn, int nNotBlockHeight);
 
     bool CanVote(COutPoint outMasternode, int nBlockHeight)
     {
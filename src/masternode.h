@@ -64,6 +64,7 @@ public:
     bool Sign(CKey& keyMasternode, CPubKey& pubKeyMasternode);
     bool VerifySignature(CPubKey& pubKeyMasternode, int &nDos);
     void Relay();
+    std::string GetStrMessage();
 
     uint256 GetHash()
     {
@@ -192,7 +193,7 @@ public:
         return !(a.vin == b.vin);
     }
 
-    uint256 CalculateScore(int mod = 1, int64_t nBlockHeight = 0);
+    uint256 CalculateScore(int mod = 1, int64_t nBlockHeight = 0) const;
 
     ADD_SERIALIZE_METHODS;
 
@@ -219,7 +220,8 @@ public:
         READWRITE(nLastScanningErrorBlockHeight);
     }
 
-    int64_t SecondsSincePayment();
+    /// nEnabled is CountEnabled(), it is looked up when not given
+    int64_t SecondsSincePayment(int nEnabled = -1) const;
 
     bool UpdateFromNewBroadcast(CMasternodeBroadcast& mnb);
 
@@ -232,12 +234,12 @@ public:
 
     void Check(bool forceCheck = false);
 
-    bool IsBroadcastedWithin(int seconds)
+    bool IsBroadcastedWithin(int seconds) const
     {
         return (GetAdjustedTime() - sigTime) < seconds;
     }
 
-    bool IsPingedWithin(int seconds, int64_t now = -1)
+    bool IsPingedWithin(int seconds, int64_t now = -1) const
     {
         now == -1 ? now = GetAdjustedTime() : now;
 
@@ -250,7 +252,7 @@ public:
         lastPing = CMasternodePing();
     }
 
-    bool IsEnabled()
+    bool IsEnabled() const
     {
         return activeState == MASTERNODE_ENABLED;
     }
@@ -267,9 +269,20 @@ public:
         return cacheInputAge + (chainActive.Tip()->nHeight - cacheInputAgeBlock);
     }
 
-    std::string GetStatus();
+    /// Same as above for entries of a published list, the age is only looked up when it was not cached
+    int GetMasternodeInputAge() const
+    {
+        if (chainActive.Tip() == NULL) return 0;
+
+        if (cacheInputAge == 0)
+            return GetInputAge(vin);
+
+        return cacheInputAge + (chainActive.Tip()->nHeight - cacheInputAgeBlock);
+    }
+
+    std::string GetStatus() const;
 
-    std::string Status()
+    std::string Status() const
     {
         std::string strStatus = "ACTIVE";
 
@@ -282,7 +295,7 @@ public:
         return strStatus;
     }
 
-    int64_t GetLastPaid();
+    int64_t GetLastPaid(int nEnabled = -1) const;
     bool IsValidNetAddr();
 };
 
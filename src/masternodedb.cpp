@@ -0,0 +1,191 @@
+// Copyright (c) 2018-2019 The DAPS Project developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include "masternodedb.h"
+
+#include "masternode-budget.h"
+#include "masternode-payments.h"
+#include "masternodeman.h"
+#include "util.h"
+
+using namespace std;
+
+CMasternodeStateDB* pmnstatedb = NULL;
+
+CMasternodeStateDB::CMasternodeStateDB(size_t nCacheSize, bool fMemory, bool fWipe) : CLevelDBWrapper(GetDataDir() / "masternodes", nCacheSize, fMemory, fWipe)
+{
+}
+
+bool CMasternodeStateDB::Read(CMasternodeMan& mnodemanToLoad)
+{
+    int64_t nStart = GetTimeMillis();
+    map<COutPoint, CMasternode> mapMasternodes;
+    map<CNetAddr, int64_t> mapAskedUs, mapWeAsked;
+    map<COutPoint, int64_t> mapWeAskedEntry;
+    map<string, uint256> mapHashesN, mapHashesA, mapHashesW, mapHashesE;
+    bool fOk = true;
+    fOk &= ReadTable('n', mapMasternodes, mapHashesN);
+    fOk &= ReadTable('a', mapAskedUs, mapHashesA);
+    fOk &= ReadTable('w', mapWeAsked, mapHashesW);
+    fOk &= ReadTable('e', mapWeAskedEntry, mapHashesE);
+    {
+        LOCK2(cs, mnodemanToLoad.cs);
+        map<COutPoint, CMasternode> mapKnown;
+        MergeTable('n', mapMasternodes, mapHashesN, mapKnown);
+        MergeTable('a', mapAskedUs, mapHashesA, mnodemanToLoad.mAskedUsForMasternodeList);
+        MergeTable('w', mapWeAsked, mapHashesW, mnodemanToLoad.mWeAskedForMasternodeList);
+        MergeTable('e', mapWeAskedEntry, mapHashesE, mnodemanToLoad.mWeAskedForMasternodeListEntry);
+        ReadRecord('q', 0, mnodemanToLoad.nDsqCount);
+
+        mnodemanToLoad.vMasternodes.clear();
+        mnodemanToLoad.vMasternodes.reserve(mapKnown.size());
+        for (map<COutPoint, CMasternode>::iterator it = mapKnown.begin(); it != mapKnown.end(); ++it) {
+            CMasternode& mn = it->second;
+            mnodemanToLoad.vMasternodes.push_back(mn);
+
+            // Answer dseg requests and recognize known broadcasts and pings straight away
+            CMasternodeBroadcast mnb(mn);
+            mnodemanToLoad.mapSeenMasternodeBroadcast[mnb.GetHash()] = mnb;
+            if (!(mn.lastPing == CMasternodePing()))
+                mnodemanToLoad.mapSeenMasternodePing[mn.lastPing.GetHash()] = mn.lastPing;
+        }
+        LogPrint("masternode", "Loaded %d masternodes  %dms\n", mapKnown.size(), GetTimeMillis() - nStart);
+    }
+
+    LogPrint("masternode", "Masternode manager - cleaning....\n");
+    mnodemanToLoad.CheckAndRemove(true);
+    LogPrint("masternode", "  %s\n", mnodemanToLoad.ToString());
+    return fOk;
+}
+
+bool CMasternodeStateDB::Save(const CMasternodeMan& mnodemanToSave)
+{
+    int64_t nStart = GetTimeMillis();
+    CLevelDBBatch batch;
+    {
+        LOCK(cs);
+        map<COutPoint, CMasternode> mapMasternodes;
+        map<CNetAddr, int64_t> mapAskedUs, mapWeAsked;
+        map<COutPoint, int64_t> mapWeAskedEntry;
+        int64_t nDsqCount;
+        {
+            // Copy under the manager's lock, serialize and hash without it
+            LOCK(mnodemanToSave.cs);
+            for (vector<CMasternode>::const_iterator it = mnodemanToSave.vMasternodes.begin(); it != mnodemanToSave.vMasternodes.end(); ++it)
+                mapMasternodes.insert(make_pair(it->vin.prevout, *it));
+            mapAskedUs = mnodemanToSave.mAskedUsForMasternodeList;
+            mapWeAsked = mnodemanToSave.mWeAskedForMasternodeList;
+            mapWeAskedEntry = mnodemanToSave.mWeAskedForMasternodeListEntry;
+            nDsqCount = mnodemanToSave.nDsqCount;
+        }
+        CRecordUpdates updates;
+        WriteTable(batch, updates, 'n', mapMasternodes);
+        WriteTable(batch, updates, 'a', mapAskedUs);
+        WriteTable(batch, updates, 'w', mapWeAsked);
+        WriteTable(batch, updates, 'e', mapWeAskedEntry);
+        WriteRecord(batch, updates, 'q', 0, nDsqCount);
+        if (!CommitBatch(batch, updates))
+            return error("%s : Failed to write the masternode list", __func__);
+    }
+    LogPrint("masternode", "Written masternode list  %dms\n", GetTimeMillis() - nStart);
+    return true;
+}
+
+bool CMasternodeStateDB::Read(CMasternodePayments& paymentsToLoad)
+{
+    int64_t nStart = GetTimeMillis();
+    map<uint256, CMasternodePaymentWinner> mapVotes;
+    map<int, CMasternodeBlockPayees> mapBlocks;
+    map<string, uint256> mapHashesV, mapHashesB;
+    bool fOk = true;
+    fOk &= ReadTable('v', mapVotes, mapHashesV);
+    fOk &= ReadTable('b', mapBlocks, mapHashesB);
+    {
+        LOCK2(cs, cs_mapMasternodePayeeVotes);
+        LOCK(cs_mapMasternodeBlocks);
+        MergeTable('v', mapVotes, mapHashesV, paymentsToLoad.mapMasternodePayeeVotes);
+        MergeTable('b', mapBlocks, mapHashesB, paymentsToLoad.mapMasternodeBlocks);
+    }
+    paymentsToLoad.RebuildPaidIndex();
+    LogPrint("masternode", "Loaded masternode payments  %dms\n", GetTimeMillis() - nStart);
+    LogPrint("masternode", "  %s\n", paymentsToLoad.ToString());
+    return fOk;
+}
+
+bool CMasternodeStateDB::Save(const CMasternodePayments& paymentsToSave)
+{
+    int64_t nStart = GetTimeMillis();
+    CLevelDBBatch batch;
+    {
+        LOCK(cs);
+        map<uint256, CMasternodePaymentWinner> mapVotes;
+        map<int, CMasternodeBlockPayees> mapBlocks;
+        {
+            LOCK2(cs_mapMasternodePayeeVotes, cs_mapMasternodeBlocks);
+            mapVotes = paymentsToSave.mapMasternodePayeeVotes;
+            mapBlocks = paymentsToSave.mapMasternodeBlocks;
+        }
+        CRecordUpdates updates;
+        WriteTable(batch, updates, 'v', mapVotes);
+        WriteTable(batch, updates, 'b', mapBlocks);
+        if (!CommitBatch(batch, updates))
+            return error("%s : Failed to write the masternode payments", __func__);
+    }
+    LogPrint("masternode", "Written masternode payments  %dms\n", GetTimeMillis() - nStart);
+    return true;
+}
+
+bool CMasternodeStateDB::Read(CBudgetManager& budgetToLoad)
+{
+    int64_t nStart = GetTimeMillis();
+    map<uint256, CBudgetVote> mapOrphanBudgetVotes;
+    map<uint256, CFinalizedBudgetVote> mapOrphanFinalizedVotes;
+    map<uint256, CBudgetProposal> mapProposals;
+    map<uint256, CFinalizedBudget> mapFinalizedBudgets;
+    map<string, uint256> mapHashesO, mapHashesR, mapHashesP, mapHashesF;
+    bool fOk = true;
+    fOk &= ReadTable('o', mapOrphanBudgetVotes, mapHashesO);
+    fOk &= ReadTable('r', mapOrphanFinalizedVotes, mapHashesR);
+    fOk &= ReadTable('p', mapProposals, mapHashesP);
+    fOk &= ReadTable('f', mapFinalizedBudgets, mapHashesF);
+    {
+        LOCK2(cs, budgetToLoad.cs);
+        MergeTable('o', mapOrphanBudgetVotes, mapHashesO, budgetToLoad.mapOrphanMasternodeBudgetVotes);
+        MergeTable('r', mapOrphanFinalizedVotes, mapHashesR, budgetToLoad.mapOrphanFinalizedBudgetVotes);
+        MergeTable('p', mapProposals, mapHashesP, budgetToLoad.mapProposals);
+        MergeTable('f', mapFinalizedBudgets, mapHashesF, budgetToLoad.mapFinalizedBudgets);
+    }
+    LogPrint("masternode", "Loaded budgets  %dms\n", GetTimeMillis() - nStart);
+    LogPrint("masternode", "  %s\n", budgetToLoad.ToString());
+    return fOk;
+}
+
+bool CMasternodeStateDB::Save(const CBudgetManager& budgetToSave)
+{
+    int64_t nStart = GetTimeMillis();
+    CLevelDBBatch batch;
+    {
+        LOCK(cs);
+        map<uint256, CBudgetVote> mapOrphanBudgetVotes;
+        map<uint256, CFinalizedBudgetVote> mapOrphanFinalizedVotes;
+        map<uint256, CBudgetProposal> mapProposals;
+        map<uint256, CFinalizedBudget> mapFinalizedBudgets;
+        {
+            LOCK(budgetToSave.cs);
+            mapOrphanBudgetVotes = budgetToSave.mapOrphanMasternodeBudgetVotes;
+            mapOrphanFinalizedVotes = budgetToSave.mapOrphanFinalizedBudgetVotes;
+            mapProposals = budgetToSave.mapProposals;
+            mapFinalizedBudgets = budgetToSave.mapFinalizedBudgets;
+        }
+        CRecordUpdates updates;
+        WriteTable(batch, updates, 'o', mapOrphanBudgetVotes);
+        WriteTable(batch, updates, 'r', mapOrphanFinalizedVotes);
+        WriteTable(batch, updates, 'p', mapProposals);
+        WriteTable(batch, updates, 'f', mapFinalizedBudgets);
+        if (!CommitBatch(batch, updates))
+            return error("%s : Failed to write the budgets", __func__);
+    }
+    LogPrint("masternode", "Written budgets  %dms\n", GetTimeMillis() - nStart);
+    return true;
+}
@@ -0,0 +1,226 @@
+// Copyright (c) 2018-2019 The DAPS Project developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#ifndef BITCOIN_MASTERNODEDB_H
+#define BITCOIN_MASTERNODEDB_H
+
+#include "hash.h"
+#include "leveldbwrapper.h"
+#include "sync.h"
+
+#include <map>
+#include <set>
+#include <string>
+#include <utility>
+
+#include <boost/scoped_ptr.hpp>
+#include <boost/thread.hpp>
+
+class CBudgetManager;
+class CMasternodeMan;
+class CMasternodePayments;
+
+//! LevelDB cache of the masternode state database (bytes)
+static const size_t MASTERNODE_STATE_DB_CACHE = 2 << 20;
+
+/** A database key that is already serialized, written as it is */
+class CRawKey
+{
+public:
+    std::string str;
+
+    CRawKey(char chTable, const std::string& strKey) : str(1, chTable) { str += strKey; }
+
+    unsigned int GetSerializeSize(int nType, int nVersion) const { return str.size(); }
+
+    template <typename Stream>
+    void Serialize(Stream& s, int nType, int nVersion) const
+    {
+        s.write(str.data(), str.size());
+    }
+};
+
+/**
+ * Masternode list, payment votes and budgets (masternodes/).
+ *
+ * Replaces mncache.dat, mnpayments.dat and budget.dat, which were rewritten
+ * as a whole (and read back first to check their format) on every dump.
+ * Each object is a record of its own, keyed by table and object key. A save
+ * copies a manager's objects under its lock and then serializes and hashes
+ * every one of them holding only the database's lock; it writes the records
+ * whose serialization changed since the last save or load and erases the ones
+ * that are gone. The managers are mutated in too many places to track dirty
+ * keys, so the cost of hashing the whole state every MASTERNODES_DUMP_SECONDS
+ * remains, but no manager is locked while it is paid and the disk only sees
+ * the changes. LevelDB compacts the tables in the background.
+ *
+ * A load reads the records without the manager's lock and merges them in
+ * afterwards, keeping objects the manager already received from the network.
+ * This lets init load the budgets and payment votes on a thread of their own
+ * (see ThreadLoadMasternodeState) while the node starts answering; only the
+ * masternode list is loaded before the network starts.
+ *
+ * Seen-message maps are not stored: the masternode broadcasts and pings are
+ * rebuilt from the list, so dseg requests can be answered and known
+ * broadcasts recognized straight away, and the budget ones are cleared at
+ * startup anyway.
+ *
+ * Lock order: cs, then the manager's locks.
+ */
+class CMasternodeStateDB : public CLevelDBWrapper
+{
+public:
+    CMasternodeStateDB(size_t nCacheSize, bool fMemory = false, bool fWipe = false);
+
+    //! Load a manager, returns false when unreadable records were skipped
+    bool Read(CMasternodeMan& mnodemanToLoad);
+    bool Read(CMasternodePayments& paymentsToLoad);
+    bool Read(CBudgetManager& budgetToLoad);
+
+    //! Write the changes since the last save, returns false on a write error
+    bool Save(const CMasternodeMan& mnodemanToSave);
+    bool Save(const CMasternodePayments& paymentsToSave);
+    bool Save(const CBudgetManager& budgetToSave);
+
+private:
+    CMasternodeStateDB(const CMasternodeStateDB&);
+    void operator=(const CMasternodeStateDB&);
+
+    typedef std::pair<char, std::string> RecordKey;
+
+    //! Hash changes of a batch, only applied to mapRecordHashes once the batch is written
+    struct CRecordUpdates {
+        std::map<RecordKey, uint256> mapWritten;
+        std::set<RecordKey> setErased;
+    };
+
+    CCriticalSection cs;
+    //! Hash of each record as last written or read, by table and serialized key
+    std::map<RecordKey, uint256> mapRecordHashes;
+
+    template <typename K>
+    static std::string SerializeKey(const K& key)
+    {
+        CDataStream ssKey(SER_DISK, CLIENT_VERSION);
+        ssKey << key;
+        return ssKey.str();
+    }
+
+    template <typename V>
+    static uint256 HashValue(const V& value)
+    {
+        CHashWriter ss(SER_DISK, CLIENT_VERSION);
+        ss << value;
+        return ss.GetHash();
+    }
+
+    //! Queue a record if it differs from what is on disk, cs must be held
+    template <typename K, typename V>
+    void WriteRecord(CLevelDBBatch& batch, CRecordUpdates& updates, char chTable, const K& key, const V& value)
+    {
+        RecordKey record(chTable, SerializeKey(key));
+        uint256 hash = HashValue(value);
+        std::map<RecordKey, uint256>::const_iterator it = mapRecordHashes.find(record);
+        if (it != mapRecordHashes.end() && it->second == hash)
+            return;
+        batch.Write(std::make_pair(chTable, key), value);
+        updates.mapWritten[record] = hash;
+    }
+
+    //! Queue the changed records of a table and erase the ones not in mapObjects, cs must be held
+    template <typename K, typename V>
+    void WriteTable(CLevelDBBatch& batch, CRecordUpdates& updates, char chTable, const std::map<K, V>& mapObjects)
+    {
+        std::set<std::string> setKeep;
+        for (typename std::map<K, V>::const_iterator mi = mapObjects.begin(); mi != mapObjects.end(); ++mi) {
+            WriteRecord(batch, updates, chTable, mi->first, mi->second);
+            setKeep.insert(SerializeKey(mi->first));
+        }
+        std::map<RecordKey, uint256>::const_iterator it = mapRecordHashes.lower_bound(RecordKey(chTable, std::string()));
+        for (; it != mapRecordHashes.end() && it->first.first == chTable; ++it) {
+            if (setKeep.count(it->first.second))
+                continue;
+            batch.Erase(CRawKey(chTable, it->first.second));
+            updates.setErased.insert(it->first);
+        }
+    }
+
+    //! Write a batch and then record its hash changes, so a failed write is retried by the next save. cs must be held
+    bool CommitBatch(CLevelDBBatch& batch, const CRecordUpdates& updates)
+    {
+        if (!WriteBatch(batch))
+            return false;
+        for (std::map<RecordKey, uint256>::const_iterator it = updates.mapWritten.begin(); it != updates.mapWritten.end(); ++it)
+            mapRecordHashes[it->first] = it->second;
+        for (std::set<RecordKey>::const_iterator it = updates.setErased.begin(); it != updates.setErased.end(); ++it)
+            mapRecordHashes.erase(*it);
+        return true;
+    }
+
+    /**
+     * Read a table into mapRead and the hashes of its records into mapHashes,
+     * needs no lock. Records that do not deserialize get a null hash, so they
+     * are erased by the next save.
+     */
+    template <typename K, typename V>
+    bool ReadTable(char chTable, std::map<K, V>& mapRead, std::map<std::string, uint256>& mapHashes)
+    {
+        bool fOk = true;
+        boost::scoped_ptr<leveldb::Iterator> pcursor(NewIterator());
+        CDataStream ssKeySet(SER_DISK, CLIENT_VERSION);
+        ssKeySet << chTable;
+        pcursor->Seek(ssKeySet.str());
+        for (; pcursor->Valid(); pcursor->Next()) {
+            boost::this_thread::interruption_point();
+            leveldb::Slice slKey = pcursor->key();
+            if (slKey.size() == 0 || slKey[0] != chTable)
+                break;
+            std::string strKey(slKey.data() + 1, slKey.size() - 1);
+            K key;
+            try {
+                CDataStream ssKey(strKey.data(), strKey.data() + strKey.size(), SER_DISK, CLIENT_VERSION);
+                ssKey >> key;
+                leveldb::Slice slValue = pcursor->value();
+                CDataStream ssValue(slValue.data(), slValue.data() + slValue.size(), SER_DISK, CLIENT_VERSION);
+                V& value = mapRead[key];
+                ssValue >> value;
+                mapHashes[strKey] = HashValue(value);
+            } catch (std::exception& e) {
+                if (SerializeKey(key) == strKey)
+                    mapRead.erase(key);
+                mapHashes[strKey] = 0;
+                fOk = error("%s : Deserialize or I/O error in table %c - %s", __func__, chTable, e.what());
+            }
+        }
+        return fOk;
+    }
+
+    /**
+     * Add the records ReadTable read to mapObjects and remember their hashes,
+     * cs and the manager's lock must be held. Objects already in mapObjects
+     * are newer than the records and kept, the next save writes them.
+     */
+    template <typename K, typename V>
+    void MergeTable(char chTable, const std::map<K, V>& mapRead, const std::map<std::string, uint256>& mapHashes, std::map<K, V>& mapObjects)
+    {
+        for (std::map<std::string, uint256>::const_iterator it = mapHashes.begin(); it != mapHashes.end(); ++it)
+            mapRecordHashes[std::make_pair(chTable, it->first)] = it->second;
+        for (typename std::map<K, V>::const_iterator mi = mapRead.begin(); mi != mapRead.end(); ++mi)
+            mapObjects.insert(*mi);
+    }
+
+    //! Load a single record written with WriteRecord, cs must be held
+    template <typename K, typename V>
+    bool ReadRecord(char chTable, const K& key, V& value)
+    {
+        if (!CLevelDBWrapper::Read(std::make_pair(chTable, key), value))
+            return false;
+        mapRecordHashes[std::make_pair(chTable, SerializeKey(key))] = HashValue(value);
+        return true;
+    }
+};
+
+extern CMasternodeStateDB* pmnstatedb;
+
+#endif // BITCOIN_MASTERNODEDB_H
@@ -8,6 +8,7 @@
 #include "activemasternode.h"
 #include "addrman.h"
 #include "masternode.h"
+#include "masternodedb.h"
 #include "obfuscation.h"
 #include "util.h"
 #include <boost/filesystem.hpp>
@@ -19,8 +20,8 @@
 CMasternodeMan mnodeman;
 
 struct CompareLastPaid {
-    bool operator()(const pair<int64_t, CTxIn>& t1,
-        const pair<int64_t, CTxIn>& t2) const
+    bool operator()(const pair<int64_t, const CMasternode*>& t1,
+        const pair<int64_t, const CMasternode*>& t2) const
     {
         return t1.first < t2.first;
     }
@@ -35,8 +36,8 @@ struct CompareScoreTxIn {
 };
 
 struct CompareScoreMN {
-    bool operator()(const pair<int64_t, CMasternode>& t1,
-        const pair<int64_t, CMasternode>& t2) const
+    bool operator()(const pair<int64_t, const CMasternode*>& t1,
+        const pair<int64_t, const CMasternode*>& t2) const
     {
         return t1.first < t2.first;
     }
@@ -52,39 +53,6 @@ CMasternodeDB::CMasternodeDB()
     strMagicMessage = "MasternodeCache";
 }
 
-bool CMasternodeDB::Write(const CMasternodeMan& mnodemanToSave)
-{
-    int64_t nStart = GetTimeMillis();
-
-    // serialize, checksum data up to that point, then append checksum
-    CDataStream ssMasternodes(SER_DISK, CLIENT_VERSION);
-    ssMasternodes << strMagicMessage;                   // masternode cache file specific magic message
-    ssMasternodes << FLATDATA(Params().MessageStart()); // network specific magic number
-    ssMasternodes << mnodemanToSave;
-    uint256 hash = Hash(ssMasternodes.begin(), ssMasternodes.end());
-    ssMasternodes << hash;
-
-    // open output file, and associate with CAutoFile
-    FILE* file = fopen(pathMN.string().c_str(), "wb");
-    CAutoFile fileout(file, SER_DISK, CLIENT_VERSION);
-    if (fileout.IsNull())
-        return error("%s : Failed to open file %s", __func__, pathMN.string());
-
-    // Write and commit header, data
-    try {
-        fileout << ssMasternodes;
-    } catch (std::exception& e) {
-        return error("%s : Serialize or I/O error - %s", __func__, e.what());
-    }
-
-    fileout.fclose();
-
-    LogPrint("masternode","Written info to mncache.dat  %dms\n", GetTimeMillis() - nStart);
-    LogPrint("masternode","  %s\n", mnodemanToSave.ToString());
-
-    return true;
-}
-
 CMasternodeDB::ReadResult CMasternodeDB::Read(CMasternodeMan& mnodemanToLoad, bool fDryRun)
 {
     int64_t nStart = GetTimeMillis();
@@ -168,34 +136,41 @@ CMasternodeDB::ReadResult CMasternodeDB::Read(CMasternodeMan& mnodemanToLoad, bo
 
 void DumpMasternodes()
 {
-    int64_t nStart = GetTimeMillis();
+    if (pmnstatedb)
+        pmnstatedb->Save(mnodeman);
+}
 
-    CMasternodeDB mndb;
-    CMasternodeMan tempMnodeman;
-
-    LogPrint("masternode","Verifying mncache.dat format...\n");
-    CMasternodeDB::ReadResult readResult = mndb.Read(tempMnodeman, true);
-    // there was an error and it was not an error on file opening => do not proceed
-    if (readResult == CMasternodeDB::FileError)
-        LogPrint("masternode","Missing masternode cache file - mncache.dat, will try to recreate\n");
-    else if (readResult != CMasternodeDB::Ok) {
-        LogPrint("masternode","Error reading mncache.dat: ");
-        if (readResult == CMasternodeDB::IncorrectFormat)
-            LogPrint("masternode","magic is ok but data has invalid format, will try to recreate\n");
-        else {
-            LogPrint("masternode","file format is unknown or invalid, please fix it manually\n");
-            return;
-        }
-    }
-    LogPrint("masternode","Writting info to mncache.dat...\n");
-    mndb.Write(mnodeman);
+CMasternodeMan::CMasternodeMan() : listPublished(new std::vector<CMasternode>()),
+                                   fListChanged(false),
+                                   nTimeListPublished(0)
+{
+    nDsqCount = 0;
+}
 
-    LogPrint("masternode","Masternode dump finished  %dms\n", GetTimeMillis() - nStart);
+void CMasternodeMan::PublishList()
+{
+    AssertLockHeld(cs);
+
+    MasternodeListRef list(new std::vector<CMasternode>(vMasternodes));
+    fListChanged = false;
+    nTimeListPublished = GetTime();
+    boost::atomic_store(&listPublished, list);
 }
 
-CMasternodeMan::CMasternodeMan()
+MasternodeListRef CMasternodeMan::GetList()
 {
-    nDsqCount = 0;
+    return boost::atomic_load(&listPublished);
+}
+
+void CMasternodeMan::PublishListChanges()
+{
+    if (GetTime() - nTimeListPublished >= MASTERNODE_CHECK_SECONDS)
+        Check();
+    if (!fListChanged)
+        return;
+    LOCK(cs);
+    if (fListChanged)
+        PublishList();
 }
 
 bool CMasternodeMan::Add(CMasternode& mn)
@@ -209,6 +184,7 @@ bool CMasternodeMan::Add(CMasternode& mn)
     if (pmn == NULL) {
         LogPrint("masternode", "CMasternodeMan: Adding new Masternode %s - %i now\n", mn.vin.prevout.hash.ToString(), size() + 1);
         vMasternodes.push_back(mn);
+        fListChanged = true;
         return true;
     }
 
@@ -237,9 +213,13 @@ void CMasternodeMan::Check()
 {
     LOCK(cs);
 
+    // Readers cannot update the entries, so they get them checked and with the input age cached
     BOOST_FOREACH (CMasternode& mn, vMasternodes) {
         mn.Check();
+        if (mn.IsEnabled())
+            mn.GetMasternodeInputAge();
     }
+    fListChanged = true;
 }
 
 void CMasternodeMan::CheckAndRemove(bool forceExpiredRemoval)
@@ -281,6 +261,7 @@ void CMasternodeMan::CheckAndRemove(bool forceExpiredRemoval)
             }
 
             it = vMasternodes.erase(it);
+            fListChanged = true;
         } else {
             ++it;
         }
@@ -348,20 +329,19 @@ void CMasternodeMan::Clear()
     mapSeenMasternodeBroadcast.clear();
     mapSeenMasternodePing.clear();
     nDsqCount = 0;
+    fListChanged = true;
 }
 
 int CMasternodeMan::stable_size ()
 {
     int nStable_size = 0;
     int nMinProtocol = ActiveProtocol();
-    int64_t nMasternode_Min_Age = MN_WINNER_MINIMUM_AGE;
-    int64_t nMasternode_Age = 0;
+    MasternodeListRef list = GetList();
 
-    BOOST_FOREACH (CMasternode& mn, vMasternodes) {
+    BOOST_FOREACH (const CMasternode& mn, *list) {
         if (mn.protocolVersion < nMinProtocol) {
             continue; // Skip obsolete versions
         }
-        mn.Check ();
         if (!mn.IsEnabled ())
             continue; // Skip not-enabled masternodes
 
@@ -375,9 +355,9 @@ int CMasternodeMan::CountEnabled(int protocolVersion)
 {
     int i = 0;
     protocolVersion = protocolVersion == -1 ? masternodePayments.GetMinMasternodePaymentsProto() : protocolVersion;
+    MasternodeListRef list = GetList();
 
-    BOOST_FOREACH (CMasternode& mn, vMasternodes) {
-        mn.Check();
+    BOOST_FOREACH (const CMasternode& mn, *list) {
         if (mn.protocolVersion < protocolVersion || !mn.IsEnabled()) continue;
         i++;
     }
@@ -388,9 +368,9 @@ int CMasternodeMan::CountEnabled(int protocolVersion)
 void CMasternodeMan::CountNetworks(int protocolVersion, int& ipv4, int& ipv6, int& onion)
 {
     protocolVersion = protocolVersion == -1 ? masternodePayments.GetMinMasternodePaymentsProto() : protocolVersion;
+    MasternodeListRef list = GetList();
 
-    BOOST_FOREACH (CMasternode& mn, vMasternodes) {
-        mn.Check();
+    BOOST_FOREACH (const CMasternode& mn, *list) {
         std::string strHost;
         int port;
         SplitHostPort(mn.addr.ToString(), port, strHost);
@@ -472,18 +452,16 @@ CMasternode* CMasternodeMan::Find(const CPubKey& pubKeyMasternode)
 //
 CMasternode* CMasternodeMan::GetNextMasternodeInQueueForPayment(int nBlockHeight, bool fFilterSigTime, int& nCount)
 {
-    LOCK(cs);
-
-    CMasternode* pBestMasternode = NULL;
-    std::vector<pair<int64_t, CTxIn> > vecMasternodeLastPaid;
+    MasternodeListRef list = GetList();
+    const CMasternode* pBestMasternode = NULL;
+    std::vector<pair<int64_t, const CMasternode*> > vecMasternodeLastPaid;
 
     /*
         Make a vector with all of the last paid times
     */
 
     int nMnCount = CountEnabled();
-    BOOST_FOREACH (CMasternode& mn, vMasternodes) {
-        mn.Check();
+    BOOST_FOREACH (const CMasternode& mn, *list) {
         if (!mn.IsEnabled()) continue;
 
         // //check protocol version
@@ -498,7 +476,7 @@ CMasternode* CMasternodeMan::GetNextMasternodeInQueueForPayment(int nBlockHeight
         //make sure it has as many confirmations as there are masternodes
         if (mn.GetMasternodeInputAge() < nMnCount) continue;
 
-        vecMasternodeLastPaid.push_back(make_pair(mn.SecondsSincePayment(), mn.vin));
+        vecMasternodeLastPaid.push_back(make_pair(mn.SecondsSincePayment(nMnCount), &mn));
     }
 
     nCount = (int)vecMasternodeLastPaid.size();
@@ -516,19 +494,16 @@ CMasternode* CMasternodeMan::GetNextMasternodeInQueueForPayment(int nBlockHeight
     int nTenthNetwork = CountEnabled() / 10;
     int nCountTenth = 0;
     uint256 nHigh = 0;
-    BOOST_FOREACH (PAIRTYPE(int64_t, CTxIn) & s, vecMasternodeLastPaid) {
-        CMasternode* pmn = Find(s.second);
-        if (!pmn) break;
-
-        uint256 n = pmn->CalculateScore(1, nBlockHeight - 100);
+    BOOST_FOREACH (PAIRTYPE(int64_t, const CMasternode*) & s, vecMasternodeLastPaid) {
+        uint256 n = s.second->CalculateScore(1, nBlockHeight - 100);
         if (n > nHigh) {
             nHigh = n;
-            pBestMasternode = pmn;
+            pBestMasternode = s.second;
         }
         nCountTenth++;
         if (nCountTenth >= nTenthNetwork) break;
     }
-    return pBestMasternode;
+    return pBestMasternode ? Find(pBestMasternode->vin) : NULL;
 }
 
 CMasternode* CMasternodeMan::FindRandomNotInVec(std::vector<CTxIn>& vecToExclude, int protocolVersion)
@@ -566,11 +541,11 @@ CMasternode* CMasternodeMan::FindRandomNotInVec(std::vector<CTxIn>& vecToExclude
 CMasternode* CMasternodeMan::GetCurrentMasterNode(int mod, int64_t nBlockHeight, int minProtocol)
 {
     int64_t score = 0;
-    CMasternode* winner = NULL;
+    const CMasternode* winner = NULL;
+    MasternodeListRef list = GetList();
 
     // scan for winner
-    BOOST_FOREACH (CMasternode& mn, vMasternodes) {
-        mn.Check();
+    BOOST_FOREACH (const CMasternode& mn, *list) {
         if (mn.protocolVersion < minProtocol || !mn.IsEnabled()) continue;
 
         // calculate the score for each Masternode
@@ -584,30 +559,27 @@ CMasternode* CMasternodeMan::GetCurrentMasterNode(int mod, int64_t nBlockHeight,
         }
     }
 
-    return winner;
+    return winner ? Find(winner->vin) : NULL;
 }
 
 int CMasternodeMan::GetMasternodeRank(const CTxIn& vin, int64_t nBlockHeight, int minProtocol, bool fOnlyActive)
 {
     std::vector<pair<int64_t, CTxIn> > vecMasternodeScores;
-    int64_t nMasternode_Min_Age = MN_WINNER_MINIMUM_AGE;
-    int64_t nMasternode_Age = 0;
 
     //make sure we know about this block
     uint256 hash = 0;
     if (!GetBlockHash(hash, nBlockHeight)) return -1;
 
     // scan for winner
-    BOOST_FOREACH (CMasternode& mn, vMasternodes) {
+    MasternodeListRef list = GetList();
+    BOOST_FOREACH (const CMasternode& mn, *list) {
         if (mn.protocolVersion < minProtocol) {
             LogPrint("masternode","Skipping Masternode with obsolete version %d\n", mn.protocolVersion);
             continue;                                                       // Skip obsolete versions
         }
 
-        if (fOnlyActive) {
-            mn.Check();
-            if (!mn.IsEnabled()) continue;
-        }
+        if (fOnlyActive && !mn.IsEnabled()) continue;
+
         uint256 n = mn.CalculateScore(1, nBlockHeight);
         int64_t n2 = n.GetCompact(false);
 
@@ -627,36 +599,34 @@ int CMasternodeMan::GetMasternodeRank(const CTxIn& vin, int64_t nBlockHeight, in
     return -1;
 }
 
-std::vector<pair<int, CMasternode> > CMasternodeMan::GetMasternodeRanks(int64_t nBlockHeight, int minProtocol)
+std::vector<pair<int, const CMasternode*> > CMasternodeMan::GetMasternodeRanks(const MasternodeListRef& list, int64_t nBlockHeight, int minProtocol)
 {
-    std::vector<pair<int64_t, CMasternode> > vecMasternodeScores;
-    std::vector<pair<int, CMasternode> > vecMasternodeRanks;
+    std::vector<pair<int64_t, const CMasternode*> > vecMasternodeScores;
+    std::vector<pair<int, const CMasternode*> > vecMasternodeRanks;
 
     //make sure we know about this block
     uint256 hash = 0;
     if (!GetBlockHash(hash, nBlockHeight)) return vecMasternodeRanks;
 
     // scan for winner
-    BOOST_FOREACH (CMasternode& mn, vMasternodes) {
-        mn.Check();
-
+    BOOST_FOREACH (const CMasternode& mn, *list) {
         if (mn.protocolVersion < minProtocol) continue;
 
         if (!mn.IsEnabled()) {
-            vecMasternodeScores.push_back(make_pair(9999, mn));
+            vecMasternodeScores.push_back(make_pair(9999, &mn));
             continue;
         }
 
         uint256 n = mn.CalculateScore(1, nBlockHeight);
         int64_t n2 = n.GetCompact(false);
 
-        vecMasternodeScores.push_back(make_pair(n2, mn));
+        vecMasternodeScores.push_back(make_pair(n2, &mn));
     }
 
     sort(vecMasternodeScores.rbegin(), vecMasternodeScores.rend(), CompareScoreMN());
 
     int rank = 0;
-    BOOST_FOREACH (PAIRTYPE(int64_t, CMasternode) & s, vecMasternodeScores) {
+    BOOST_FOREACH (PAIRTYPE(int64_t, const CMasternode*) & s, vecMasternodeScores) {
         rank++;
         vecMasternodeRanks.push_back(make_pair(rank, s.second));
     }
@@ -669,12 +639,10 @@ CMasternode* CMasternodeMan::GetMasternodeByRank(int nRank, int64_t nBlockHeight
     std::vector<pair<int64_t, CTxIn> > vecMasternodeScores;
 
     // scan for winner
-    BOOST_FOREACH (CMasternode& mn, vMasternodes) {
+    MasternodeListRef list = GetList();
+    BOOST_FOREACH (const CMasternode& mn, *list) {
         if (mn.protocolVersion < minProtocol) continue;
-        if (fOnlyActive) {
-            mn.Check();
-            if (!mn.IsEnabled()) continue;
-        }
+        if (fOnlyActive && !mn.IsEnabled()) continue;
 
         uint256 n = mn.CalculateScore(1, nBlockHeight);
         int64_t n2 = n.GetCompact(false);
@@ -975,6 +943,7 @@ void CMasternodeMan::ProcessMessage(CNode* pfrom, std::string& strCommand, CData
                     }
                     pmn->nLastDsee = sigTime;
                     pmn->Check();
+                    fListChanged = true;
                     if (pmn->IsEnabled()) {
                         TRY_LOCK(cs_vNodes, lockNodes);
                         if (!lockNodes) return;
@@ -1102,9 +1071,13 @@ void CMasternodeMan::ProcessMessage(CNode* pfrom, std::string& strCommand, CData
                 }
 
                 // fake ping for v11 masternodes, ignore for v12
+                int nActiveStateBefore = pmn->activeState;
                 if (pmn->protocolVersion < GETHEADERS_VERSION) pmn->lastPing = CMasternodePing(vin);
                 pmn->nLastDseep = sigTime;
                 pmn->Check();
+                // like mnp, a ping alone waits for the next periodic check
+                if (pmn->activeState != nActiveStateBefore)
+                    fListChanged = true;
                 if (pmn->IsEnabled()) {
                     TRY_LOCK(cs_vNodes, lockNodes);
                     if (!lockNodes) return;
@@ -1134,6 +1107,7 @@ void CMasternodeMan::Remove(CTxIn vin)
         if ((*it).vin == vin) {
             LogPrint("masternode", "CMasternodeMan: Removing Masternode %s - %i now\n", (*it).vin.prevout.hash.ToString(), size() - 1);
             vMasternodes.erase(it);
+            fListChanged = true;
             break;
         }
         ++it;
@@ -1155,6 +1129,7 @@ void CMasternodeMan::UpdateMasternodeList(CMasternodeBroadcast mnb)
             masternodeSync.AddedMasternodeList(mnb.GetHash());
         }
     } else if (pmn->UpdateFromNewBroadcast(mnb)) {
+        fListChanged = true;
         masternodeSync.AddedMasternodeList(mnb.GetHash());
     }
 }
@@ -15,6 +15,10 @@
 #include "sync.h"
 #include "util.h"
 
+#include <atomic>
+
+#include <boost/shared_ptr.hpp>
+
 #define MASTERNODES_DUMP_SECONDS (15 * 60)
 #define MASTERNODES_DSEG_SECONDS (3 * 60 * 60)
 
@@ -25,7 +29,10 @@ class CMasternodeMan;
 extern CMasternodeMan mnodeman;
 void DumpMasternodes();
 
-/** Access to the MN database (mncache.dat)
+/** A published version of the masternode list, it is never changed (see CMasternodeMan::GetList) */
+typedef boost::shared_ptr<const std::vector<CMasternode> > MasternodeListRef;
+
+/** Access to the flat MN cache (mncache.dat), only read to import it into the masternode state database
  */
 class CMasternodeDB
 {
@@ -45,12 +52,13 @@ public:
     };
 
     CMasternodeDB();
-    bool Write(const CMasternodeMan& mnodemanToSave);
     ReadResult Read(CMasternodeMan& mnodemanToLoad, bool fDryRun = false);
 };
 
 class CMasternodeMan
 {
+    friend class CMasternodeStateDB;
+
 private:
     // critical section to protect the inner data structures
     mutable CCriticalSection cs;
@@ -67,6 +75,14 @@ private:
     // which Masternodes we've asked for
     std::map<COutPoint, int64_t> mWeAskedForMasternodeListEntry;
 
+    // version of vMasternodes handed to the readers, replaced as a whole
+    MasternodeListRef listPublished;
+    std::atomic<bool> fListChanged;
+    std::atomic<int64_t> nTimeListPublished;
+
+    /// Publish a copy of vMasternodes, cs must be held
+    void PublishList();
+
 public:
     // Keep track of all broadcasts I've seen
     map<uint256, CMasternodeBroadcast> mapSeenMasternodeBroadcast;
@@ -93,7 +109,6 @@ public:
     }
 
     CMasternodeMan();
-    CMasternodeMan(CMasternodeMan& other);
 
     /// Add an entry
     bool Add(CMasternode& mn);
@@ -130,13 +145,27 @@ public:
     /// Get the current winner for this block
     CMasternode* GetCurrentMasterNode(int mod = 1, int64_t nBlockHeight = 0, int minProtocol = 0);
 
-    std::vector<CMasternode> GetFullMasternodeVector()
-    {
-        Check();
-        return vMasternodes;
-    }
-
-    std::vector<pair<int, CMasternode> > GetMasternodeRanks(int64_t nBlockHeight, int minProtocol = 0);
+    /**
+     * The current masternode list. Readers keep the version they got for as
+     * long as they need it without holding cs; getting it never copies or
+     * checks anything. New versions are published by the writer side, see
+     * PublishListChanges(). Fields changed through the pointers returned by
+     * Find() show up once ListChanged() is called, or at the next periodic check.
+     */
+    MasternodeListRef GetList();
+
+    /// Entries were changed in place, publish a new version with the next batch
+    void ListChanged() { fListChanged = true; }
+
+    /**
+     * Called by the masternode thread every second: publishes the changes made
+     * since the last version, and every MASTERNODE_CHECK_SECONDS checks all
+     * entries first, which also picks up the pings received meanwhile.
+     */
+    void PublishListChanges();
+
+    /// Rank the entries of a published list, the pointers are valid as long as the list is held
+    std::vector<pair<int, const CMasternode*> > GetMasternodeRanks(const MasternodeListRef& list, int64_t nBlockHeight, int minProtocol = 0);
     int GetMasternodeRank(const CTxIn& vin, int64_t nBlockHeight, int minProtocol = 0, bool fOnlyActive = true);
     CMasternode* GetMasternodeByRank(int nRank, int64_t nBlockHeight, int minProtocol = 0, bool fOnlyActive = true);
 
@@ -135,7 +135,7 @@ uint32_t GetListOfPoSInfo(uint32_t currentHeight, std::vector<PoSBlockSummary>&
                     PoSBlockSummary pos;
                     pos.hash = chainActive[nextAuditHeight]->GetBlockHash();
                     CBlockIndex* pindex = mapBlockIndex[pos.hash];
-                    pos.nTime = ReVerifyPoSBlock(pindex) ? chainActive[nextAuditHeight]->GetBlockHeader().nTime : 0;
+                    pos.nTime = ReVerifyPoSBlock(pindex, posBlock) ? chainActive[nextAuditHeight]->GetBlockHeader().nTime : 0;
                     pos.height = nextAuditHeight;
                     audits.push_back(pos);
                 }
@@ -0,0 +1,206 @@
+// Copyright (c) 2018-2019 The DAPS Project developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include "msgprecheck.h"
+
+#include "hash.h"
+#include "main.h"
+#include "masternode.h"
+#include "masternode-budget.h"
+#include "masternode-payments.h"
+#include "net.h"
+#include "obfuscation.h"
+#include "util.h"
+
+#include <boost/bind.hpp>
+
+CMessagePreChecker messagePreChecker;
+
+static bool IsPreCheckedCommand(const std::string& strCommand)
+{
+    return strCommand == "block" || strCommand == "tx" ||
+           strCommand == "mnb" || strCommand == "mnp" || strCommand == "mnw" ||
+           strCommand == "mvote" || strCommand == "fbvote";
+}
+
+void PreCheckGossip(CPreCheckedMessage& msg)
+{
+    CKeyID keyID;
+    if (msg.strCommand == "mnb") {
+        CMasternodeBroadcast mnb;
+        msg.vRecv >> mnb;
+        // VerifySignature tries the collateral signature against both message formats
+        std::string strNewMessage = mnb.GetNewStrMessage();
+        std::string strOldMessage = mnb.GetOldStrMessage();
+        obfuScationSigner.RecoverMessageKey(mnb.sig, strNewMessage, keyID);
+        if (strOldMessage != strNewMessage)
+            obfuScationSigner.RecoverMessageKey(mnb.sig, strOldMessage, keyID);
+        obfuScationSigner.RecoverMessageKey(mnb.lastPing.vchSig, mnb.lastPing.GetStrMessage(), keyID);
+    } else if (msg.strCommand == "mnp") {
+        CMasternodePing mnp;
+        msg.vRecv >> mnp;
+        obfuScationSigner.RecoverMessageKey(mnp.vchSig, mnp.GetStrMessage(), keyID);
+    } else if (msg.strCommand == "mnw") {
+        CMasternodePaymentWinner winner;
+        msg.vRecv >> winner;
+        obfuScationSigner.RecoverMessageKey(winner.vchSig, winner.GetStrMessage(), keyID);
+    } else if (msg.strCommand == "mvote") {
+        CBudgetVote vote;
+        msg.vRecv >> vote;
+        obfuScationSigner.RecoverMessageKey(vote.vchSig, vote.GetStrMessage(), keyID);
+    } else if (msg.strCommand == "fbvote") {
+        CFinalizedBudgetVote vote;
+        msg.vRecv >> vote;
+        obfuScationSigner.RecoverMessageKey(vote.vchSig, vote.GetStrMessage(), keyID);
+    }
+}
+
+CPreCheckedMessage::CPreCheckedMessage(const std::string& strCommandIn, CDataStream& vRecvIn) : strCommand(strCommandIn),
+                                                                                                     vRecv(vRecvIn.begin(), vRecvIn.end(), vRecvIn.GetType(), vRecvIn.GetVersion()),
+                                                                                                     fDone(false),
+                                                                                                     fChecked(false),
+                                                                                                     nChecksum(0),
+                                                                                                     fParsed(false),
+                                                                                                     fContextFree(false)
+{
+}
+
+CMessagePreChecker::CMessagePreChecker() : nThreads(0), fStop(false), nQueuedSize(0)
+{
+}
+
+CMessagePreChecker::~CMessagePreChecker()
+{
+    Stop();
+}
+
+void CMessagePreChecker::Start(int nThreadsIn)
+{
+    boost::unique_lock<boost::mutex> lock(mutex);
+    if (nThreads > 0)
+        return;
+    fStop = false;
+    nThreads = std::min(std::max(nThreadsIn, 0), MAX_MSGCHECK_THREADS);
+    for (int i = 0; i < nThreads; i++)
+        threads.create_thread(boost::bind(&CMessagePreChecker::ThreadWorker, this));
+}
+
+void CMessagePreChecker::Stop()
+{
+    {
+        boost::unique_lock<boost::mutex> lock(mutex);
+        if (nThreads == 0)
+            return;
+        fStop = true;
+        cond.notify_all();
+    }
+    threads.join_all();
+
+    // What is left stays unchecked and is handled on the message thread
+    boost::unique_lock<boost::mutex> lock(mutex);
+    queue.clear();
+    nQueuedSize = 0;
+    nThreads = 0;
+}
+
+void CMessagePreChecker::Submit(CNode* pnode)
+{
+    boost::unique_lock<boost::mutex> lock(mutex);
+    if (nThreads == 0 || fStop)
+        return;
+
+    unsigned int nLookahead = 0;
+    for (std::deque<CNetMessage>::iterator it = pnode->vRecvMsg.begin(); it != pnode->vRecvMsg.end() && nLookahead < MAX_MSGCHECK_LOOKAHEAD; ++it, ++nLookahead) {
+        CNetMessage& msg = *it;
+        if (!msg.complete())
+            break;
+        if (msg.pchecked)
+            continue;
+        std::string strCommand = msg.hdr.GetCommand();
+        if (!IsPreCheckedCommand(strCommand))
+            continue;
+        if (nQueuedSize + msg.vRecv.size() > MAX_MSGCHECK_QUEUE_SIZE)
+            break;
+
+        msg.pchecked.reset(new CPreCheckedMessage(strCommand, msg.vRecv));
+        queue.push_back(msg.pchecked);
+        nQueuedSize += msg.vRecv.size();
+        cond.notify_one();
+    }
+}
+
+bool CMessagePreChecker::IsPending(const CNetMessage& msg)
+{
+    if (!msg.pchecked)
+        return false;
+    boost::unique_lock<boost::mutex> lock(mutex);
+    return nThreads > 0 && !msg.pchecked->fDone;
+}
+
+void CMessagePreChecker::ThreadWorker()
+{
+    RenameThread("dapscoin-msgchk");
+
+    while (true) {
+        std::vector<boost::shared_ptr<CPreCheckedMessage> > vMsgs;
+        {
+            boost::unique_lock<boost::mutex> lock(mutex);
+            while (!fStop && queue.empty())
+                cond.wait(lock);
+            if (fStop)
+                break;
+            // Blocks queued back to back are taken together, their coinstake key image proofs are verified in one batch
+            do {
+                vMsgs.push_back(queue.front());
+                queue.pop_front();
+                nQueuedSize -= vMsgs.back()->vRecv.size();
+            } while (vMsgs.back()->strCommand == "block" && vMsgs.size() < MAX_MSGCHECK_BLOCK_BATCH &&
+                     !queue.empty() && queue.front()->strCommand == "block");
+        }
+
+        // The message thread does not touch the messages until fDone is set
+        std::vector<const CTransaction*> vCoinstakes;
+        for (size_t i = 0; i < vMsgs.size(); i++) {
+            CPreCheckedMessage& msg = *vMsgs[i];
+            int64_t nTimeStart = GetTimeMicros();
+            size_t nSize = msg.vRecv.size();
+            uint256 hash = Hash(msg.vRecv.begin(), msg.vRecv.end());
+            memcpy(&msg.nChecksum, &hash, sizeof(msg.nChecksum));
+            try {
+                if (msg.strCommand == "block") {
+                    msg.vRecv >> msg.block;
+                    if (msg.block.vtx.size() > 1)
+                        vCoinstakes.push_back(&msg.block.vtx[1]);
+                } else if (msg.strCommand == "tx") {
+                    msg.vRecv >> msg.tx;
+                } else {
+                    PreCheckGossip(msg);
+                }
+                msg.fParsed = true;
+            } catch (std::exception& e) {
+                // Parsed again on the message thread, which rejects the message as before
+            }
+            LogPrint("bench", "    - Pre-check %s (%u bytes): %.2fms\n", msg.strCommand, nSize, (GetTimeMicros() - nTimeStart) * 0.001);
+        }
+
+        // Fills the proof cache, where the message thread finds the coinstake proofs
+        if (!vCoinstakes.empty())
+            VerifyShnorrKeyImageTxs(vCoinstakes);
+        for (size_t i = 0; i < vMsgs.size(); i++) {
+            CPreCheckedMessage& msg = *vMsgs[i];
+            if (msg.strCommand == "block" && msg.fParsed) {
+                // A failure is reported when CheckBlock runs again on the message thread
+                CValidationState state;
+                msg.fContextFree = CheckBlockContextFree(msg.block, state, true, false);
+            }
+        }
+
+        boost::unique_lock<boost::mutex> lock(mutex);
+        for (size_t i = 0; i < vMsgs.size(); i++) {
+            vMsgs[i]->fChecked = true;
+            vMsgs[i]->fDone = true;
+        }
+        messageHandlerCondition.notify_one();
+    }
+}
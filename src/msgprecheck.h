@@ -0,0 +1,121 @@
+// Copyright (c) 2018-2019 The DAPS Project developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#ifndef BITCOIN_MSGPRECHECK_H
+#define BITCOIN_MSGPRECHECK_H
+
+#include "primitives/block.h"
+#include "primitives/transaction.h"
+#include "streams.h"
+
+#include <deque>
+#include <string>
+
+#include <boost/shared_ptr.hpp>
+#include <boost/thread/condition_variable.hpp>
+#include <boost/thread/mutex.hpp>
+#include <boost/thread/thread.hpp>
+
+class CNetMessage;
+class CNode;
+
+/** Default for -msgcheckthreads, the number of threads deserializing and checking received blocks, transactions and masternode messages */
+static const int DEFAULT_MSGCHECK_THREADS = 2;
+/** Maximum number of message pre-check threads */
+static const int MAX_MSGCHECK_THREADS = 16;
+/** Payload bytes waiting for a pre-check thread before new messages are handled on the message thread */
+static const size_t MAX_MSGCHECK_QUEUE_SIZE = 32 * 1000 * 1000;
+/** Complete messages at the front of a peer's receive buffer that are looked at for pre-checking */
+static const unsigned int MAX_MSGCHECK_LOOKAHEAD = 16;
+/** Blocks queued back to back that one pre-check thread takes at once, to batch the key image proofs of their coinstakes */
+static const unsigned int MAX_MSGCHECK_BLOCK_BATCH = 16;
+
+/** A received message whose payload is checked away from the message thread */
+class CPreCheckedMessage
+{
+public:
+    std::string strCommand;
+    //! Copy of the payload, the receive buffer may be wiped on disconnect
+    CDataStream vRecv;
+
+    //! Set under CMessagePreChecker::mutex once a thread is done with the message
+    bool fDone;
+    //! Whether the fields below were filled in, false if the threads stopped first
+    bool fChecked;
+    unsigned int nChecksum;
+    //! Whether the payload deserialized, if not the message thread parses it again to report the error
+    bool fParsed;
+    //! Deserialized payload of "block" and "tx" messages, masternode messages are always parsed again
+    CBlock block;
+    CTransaction tx;
+    //! Whether CheckBlockContextFree passed, all but the coinstake proof, which is checked on the message thread
+    bool fContextFree;
+
+    CPreCheckedMessage(const std::string& strCommandIn, CDataStream& vRecvIn);
+};
+
+/**
+ * Pre-check stage for "block" and "tx" messages and for the signed masternode
+ * messages ("mnb", "mnp", "mnw", "mvote" and "fbvote").
+ *
+ * ProcessMessages used to hash, deserialize and check every payload on the
+ * single message thread, so one peer sending a large block held up the
+ * masternode and SwiftX messages of everybody else. Complete block and
+ * transaction messages near the front of a peer's receive buffer are now
+ * handed to worker threads, which verify the checksum, deserialize the
+ * payload and run CheckBlockContextFree without the coinstake proof. The
+ * Schnorr key image proofs of the coinstakes of blocks queued together are
+ * verified in one batch into the proof cache, where the message thread
+ * finds them when it completes the block check. The
+ * message thread keeps handling each peer's messages in order: it skips a
+ * peer while the message at the front of its buffer is pending and serves
+ * the other peers meanwhile.
+ * The workers never take cs_main: the proofs read the staked outputs through
+ * LookupTransaction. Everything that needs chain state still runs on the
+ * message thread.
+ *
+ * For masternode messages the threads recover the keys behind the compact
+ * signatures into CObfuScationSigner's cache, which is looked up before any
+ * recovery. A list sync that floods us with broadcasts and pings then
+ * recovers each distinct signature once, off the message thread, and the
+ * handlers still see the messages in the order the peer sent them.
+ */
+class CMessagePreChecker
+{
+public:
+    CMessagePreChecker();
+    ~CMessagePreChecker();
+
+    //! Start nThreads worker threads
+    void Start(int nThreads);
+    //! Stop the worker threads, pending messages are then handled on the message thread
+    void Stop();
+
+    //! Queue the complete messages near the front of pnode's receive buffer that are pre-checked, cs_vRecvMsg must be held
+    void Submit(CNode* pnode);
+    //! Whether msg waits for or is undergoing its checks, later messages of the same peer have to wait too
+    bool IsPending(const CNetMessage& msg);
+
+private:
+    boost::mutex mutex;
+    boost::condition_variable cond;
+    boost::thread_group threads;
+    int nThreads;
+    bool fStop;
+    std::deque<boost::shared_ptr<CPreCheckedMessage> > queue;
+    size_t nQueuedSize;
+
+    void ThreadWorker();
+};
+
+extern CMessagePreChecker messagePreChecker;
+
+/**
+ * Recover the keys behind the signatures of a masternode message. The
+ * message thread parses the message again and finds the keys in the
+ * signer's cache, as it does for copies relayed by other peers.
+ */
+void PreCheckGossip(CPreCheckedMessage& msg);
+
+#endif // BITCOIN_MSGPRECHECK_H
@@ -16,6 +16,7 @@
 #include "chainparams.h"
 #include "clientversion.h"
 #include "miner.h"
+#include "msgprecheck.h"
 #include "obfuscation.h"
 #include "primitives/transaction.h"
 #include "scheduler.h"
@@ -29,6 +30,10 @@
 
 #endif
 
+#ifdef HAVE_SYS_EPOLL_H
+#include <sys/epoll.h>
+#endif
+
 #ifdef USE_UPNP
 #include <miniupnpc/miniupnpc.h>
 #include <miniupnpc/miniwget.h>
@@ -86,6 +91,7 @@ uint64_t nLocalHostNonce = 0;
 static std::vector <ListenSocket> vhListenSocket;
 CAddrMan addrman;
 int nMaxConnections = 125;
+SocketEventsMode nSocketEventsMode = SOCKETEVENTS_SELECT;
 bool fAddressesInitialized = false;
 
 vector<CNode *> vNodes;
@@ -366,6 +372,12 @@ CNode *FindNode(const CService &addr) {
     return NULL;
 }
 
+/** Whether ThreadSocketHandler can wait on hSocket in the configured socket events mode */
+static bool IsSocketServiceable(SOCKET hSocket)
+{
+    return nSocketEventsMode != SOCKETEVENTS_SELECT || IsSelectableSocket(hSocket);
+}
+
 CNode *ConnectNode(CAddress addrConnect, const char *pszDest, bool obfuScationMaster) {
     if (pszDest == NULL) {
         // we clean masternode connections in CMasternodeMan::ProcessMasternodeConnections()
@@ -394,7 +406,7 @@ CNode *ConnectNode(CAddress addrConnect, const char *pszDest, bool obfuScationMa
     if (pszDest ? ConnectSocketByName(addrConnect, hSocket, pszDest, Params().GetDefaultPort(), nConnectTimeout,
                                       &proxyConnectionFailed) :
         ConnectSocket(addrConnect, hSocket, nConnectTimeout, &proxyConnectionFailed)) {
-        if (!IsSelectableSocket(hSocket)) {
+        if (!IsSocketServiceable(hSocket)) {
             LogPrintf("Cannot create connection: non-selectable socket created (fd >= FD_SETSIZE ?)\n");
             CloseSocket(hSocket);
             return NULL;
@@ -796,8 +808,350 @@ void SocketSendData(CNode *pnode) {
 
 static list<CNode *> vNodesDisconnected;
 
+/** Whether there is room in pnode's receive buffer, cs_vRecvMsg must be held */
+static bool IsReceiveBufferFree(CNode* pnode)
+{
+    return pnode->vRecvMsg.empty() || !pnode->vRecvMsg.front().complete() ||
+           pnode->GetTotalRecvSize() <= ReceiveFloodSize();
+}
+
+/** Read once from pnode's socket, cs_vRecvMsg must be held. Returns false once nothing more can be read */
+static bool SocketRecvData(CNode* pnode)
+{
+    // typical socket buffer is 8K-64K
+    char pchBuf[0x10000];
+    int nBytes = recv(pnode->hSocket, pchBuf, sizeof(pchBuf), MSG_DONTWAIT);
+    if (nBytes > 0) {
+        if (!pnode->ReceiveMsgBytes(pchBuf, nBytes))
+            pnode->CloseSocketDisconnect();
+        pnode->nLastRecv = GetTime();
+        pnode->nRecvBytes += nBytes;
+        pnode->RecordBytesRecv(nBytes);
+        return pnode->hSocket != INVALID_SOCKET;
+    } else if (nBytes == 0) {
+        // socket closed gracefully
+        if (!pnode->fDisconnect)
+            LogPrint("net", "socket closed\n");
+        pnode->CloseSocketDisconnect();
+    } else if (nBytes < 0) {
+        // error
+        int nErr = WSAGetLastError();
+        if (nErr != WSAEWOULDBLOCK && nErr != WSAEMSGSIZE && nErr != WSAEINTR &&
+            nErr != WSAEINPROGRESS) {
+            if (!pnode->fDisconnect)
+                LogPrintf("socket recv error %s\n", NetworkErrorString(nErr));
+            pnode->CloseSocketDisconnect();
+        }
+    }
+    return false;
+}
+
+static void AcceptConnection(const ListenSocket& hListenSocket)
+{
+    struct sockaddr_storage sockaddr;
+    socklen_t len = sizeof(sockaddr);
+    SOCKET hSocket = accept(hListenSocket.socket, (struct sockaddr *) &sockaddr, &len);
+    CAddress addr;
+    int nInbound = 0;
+
+    if (hSocket != INVALID_SOCKET)
+        if (!addr.SetSockAddr((const struct sockaddr *) &sockaddr))
+            LogPrintf("Warning: Unknown socket family\n");
+
+    bool whitelisted = hListenSocket.whitelisted || CNode::IsWhitelistedRange(addr);
+    {
+        LOCK(cs_vNodes);
+        BOOST_FOREACH(CNode * pnode, vNodes)
+        if (pnode->fInbound)
+            nInbound++;
+    }
+
+    if (hSocket == INVALID_SOCKET) {
+        int nErr = WSAGetLastError();
+        if (nErr != WSAEWOULDBLOCK)
+            LogPrintf("socket error accept failed: %s\n", NetworkErrorString(nErr));
+    } else if (!IsSocketServiceable(hSocket)) {
+        LogPrintf("connection from %s dropped: non-selectable socket\n", addr.ToString());
+        CloseSocket(hSocket);
+    } else if (nInbound >= nMaxConnections - MAX_OUTBOUND_CONNECTIONS) {
+        LogPrint("net", "connection from %s dropped (full)\n", addr.ToString());
+        CloseSocket(hSocket);
+    } else if (CNode::IsBanned(addr) && !whitelisted) {
+        LogPrintf("connection from %s dropped (banned)\n", addr.ToString());
+        CloseSocket(hSocket);
+    } else {
+        CNode *pnode = new CNode(hSocket, addr, "", true);
+        pnode->AddRef();
+        pnode->fWhitelisted = whitelisted;
+
+        {
+            LOCK(cs_vNodes);
+            vNodes.push_back(pnode);
+        }
+    }
+}
+
+#ifdef HAVE_SYS_EPOLL_H
+/** Edge-triggered epoll instance all sockets are registered with once, or -1 */
+static int hEpoll = -1;
+/** Events fetched from epoll per iteration of the socket handler */
+static const int MAX_EPOLL_EVENTS = 1024;
+/** Reads from one socket per iteration, so one busy peer cannot starve the others */
+static const int MAX_SOCKET_READS_PER_ITERATION = 4;
+
+static bool InitSocketEvents()
+{
+    hEpoll = epoll_create1(EPOLL_CLOEXEC);
+    if (hEpoll == -1)
+        return error("%s : epoll_create1 failed: %s", __func__, NetworkErrorString(errno));
+
+    BOOST_FOREACH(ListenSocket & hListenSocket, vhListenSocket) {
+        // Level-triggered, every event is one accept()
+        struct epoll_event event;
+        event.events = EPOLLIN;
+        event.data.ptr = &hListenSocket;
+        if (epoll_ctl(hEpoll, EPOLL_CTL_ADD, hListenSocket.socket, &event) == -1) {
+            int nErr = errno;
+            close(hEpoll);
+            hEpoll = -1;
+            return error("%s : cannot add listening socket: %s", __func__, NetworkErrorString(nErr));
+        }
+    }
+    return true;
+}
+
+/** Register the socket of a new node, it is removed again when the socket is closed */
+static void AddSocketEvents(CNode* pnode)
+{
+    if (hEpoll == -1 || pnode->hSocket == INVALID_SOCKET)
+        return;
+    struct epoll_event event;
+    event.events = EPOLLIN | EPOLLOUT | EPOLLRDHUP | EPOLLET;
+    event.data.ptr = pnode;
+    if (epoll_ctl(hEpoll, EPOLL_CTL_ADD, pnode->hSocket, &event) == -1) {
+        LogPrintf("%s : cannot add socket of peer=%d: %s\n", __func__, pnode->id, NetworkErrorString(errno));
+        pnode->fDisconnect = true;
+    }
+}
+
+/**
+ * Consume the readiness epoll reported for pnode. As the events are
+ * edge-triggered, readiness is remembered until recv/send would block.
+ * Returns whether pnode has to be serviced again without a new event,
+ * because its receive buffer was full, data waits behind its send queue,
+ * a lock was taken or it hit the read limit; fMoreData is set in the last
+ * case.
+ */
+static bool ServiceSocketEvents(CNode* pnode, bool& fMoreData)
+{
+    if (pnode->hSocket == INVALID_SOCKET)
+        return false;
+
+    // Drain the send queue before receiving more, see the select() case
+    bool fSendQueued = true;
+    {
+        TRY_LOCK(pnode->cs_vSend, lockSend);
+        if (!lockSend)
+            return true;
+        if (pnode->fSocketSendReady && !pnode->vSendMsg.empty()) {
+            SocketSendData(pnode);
+            // What is left waits for the socket to become writable again
+            if (!pnode->vSendMsg.empty())
+                pnode->fSocketSendReady = false;
+        }
+        fSendQueued = !pnode->vSendMsg.empty();
+    }
+    if (!pnode->fSocketRecvReady)
+        return false;
+    // Unread data raises no new edge, so stay pending even if another thread drains the queue
+    if (fSendQueued)
+        return true;
+
+    TRY_LOCK(pnode->cs_vRecvMsg, lockRecv);
+    if (!lockRecv)
+        return true;
+    for (int i = 0; i < MAX_SOCKET_READS_PER_ITERATION; i++) {
+        if (!IsReceiveBufferFree(pnode))
+            return true;
+        if (!SocketRecvData(pnode)) {
+            pnode->fSocketRecvReady = false;
+            return false;
+        }
+    }
+    fMoreData = true;
+    return true;
+}
+
+/**
+ * Wait for socket events with epoll and service the ready sockets. Nodes
+ * whose readiness could not be consumed completely are kept in
+ * setNodesPending and serviced again on the next call.
+ */
+static void HandleSocketEventsEpoll(std::set<CNode*>& setNodesPending, bool& fMoreData)
+{
+    struct epoll_event events[MAX_EPOLL_EVENTS];
+    int nEvents = epoll_wait(hEpoll, events, MAX_EPOLL_EVENTS, fMoreData ? 0 : 50);
+    boost::this_thread::interruption_point();
+    if (nEvents == -1) {
+        if (errno != EINTR)
+            LogPrintf("socket epoll_wait error %s\n", NetworkErrorString(errno));
+        nEvents = 0;
+    }
+
+    for (int i = 0; i < nEvents; i++) {
+        bool fListen = false;
+        BOOST_FOREACH(const ListenSocket & hListenSocket, vhListenSocket) {
+            if (events[i].data.ptr == &hListenSocket) {
+                AcceptConnection(hListenSocket);
+                fListen = true;
+                break;
+            }
+        }
+        if (fListen)
+            continue;
+
+        CNode* pnode = (CNode*)events[i].data.ptr;
+        if (events[i].events & (EPOLLIN | EPOLLRDHUP | EPOLLHUP | EPOLLERR))
+            pnode->fSocketRecvReady = true;
+        if (events[i].events & EPOLLOUT)
+            pnode->fSocketSendReady = true;
+        setNodesPending.insert(pnode);
+    }
+
+    // Nodes still in vNodes; disconnected ones were taken out of setNodesPending
+    fMoreData = false;
+    for (std::set<CNode*>::iterator it = setNodesPending.begin(); it != setNodesPending.end();) {
+        boost::this_thread::interruption_point();
+        if (ServiceSocketEvents(*it, fMoreData))
+            ++it;
+        else
+            setNodesPending.erase(it++);
+    }
+}
+#endif // HAVE_SYS_EPOLL_H
+
+/** Wait for socket events with select() and service the ready sockets */
+static void HandleSocketEventsSelect(const std::vector<CNode*>& vNodesCopy)
+{
+    struct timeval timeout;
+    timeout.tv_sec = 0;
+    timeout.tv_usec = 50000; // frequency to poll pnode->vSend
+
+    fd_set fdsetRecv;
+    fd_set fdsetSend;
+    fd_set fdsetError;
+    FD_ZERO(&fdsetRecv);
+    FD_ZERO(&fdsetSend);
+    FD_ZERO(&fdsetError);
+    SOCKET hSocketMax = 0;
+    bool have_fds = false;
+
+    BOOST_FOREACH(
+    const ListenSocket &hListenSocket, vhListenSocket) {
+        FD_SET(hListenSocket.socket, &fdsetRecv);
+        hSocketMax = max(hSocketMax, hListenSocket.socket);
+        have_fds = true;
+    }
+
+    BOOST_FOREACH(CNode * pnode, vNodesCopy)
+    {
+        if (pnode->hSocket == INVALID_SOCKET)
+            continue;
+        FD_SET(pnode->hSocket, &fdsetError);
+        hSocketMax = max(hSocketMax, pnode->hSocket);
+        have_fds = true;
+
+        // Implement the following logic:
+        // * If there is data to send, select() for sending data. As this only
+        //   happens when optimistic write failed, we choose to first drain the
+        //   write buffer in this case before receiving more. This avoids
+        //   needlessly queueing received data, if the remote peer is not themselves
+        //   receiving data. This means properly utilizing TCP flow control signalling.
+        // * Otherwise, if there is no (complete) message in the receive buffer,
+        //   or there is space left in the buffer, select() for receiving data.
+        // * (if neither of the above applies, there is certainly one message
+        //   in the receiver buffer ready to be processed).
+        // Together, that means that at least one of the following is always possible,
+        // so we don't deadlock:
+        // * We send some data.
+        // * We wait for data to be received (and disconnect after timeout).
+        // * We process a message in the buffer (message handler thread).
+        {
+            TRY_LOCK(pnode->cs_vSend, lockSend);
+            if (lockSend && !pnode->vSendMsg.empty()) {
+                FD_SET(pnode->hSocket, &fdsetSend);
+                continue;
+            }
+        }
+        {
+            TRY_LOCK(pnode->cs_vRecvMsg, lockRecv);
+            if (lockRecv && IsReceiveBufferFree(pnode))
+                FD_SET(pnode->hSocket, &fdsetRecv);
+        }
+    }
+
+    int nSelect = select(have_fds ? hSocketMax + 1 : 0,
+                         &fdsetRecv, &fdsetSend, &fdsetError, &timeout);
+    boost::this_thread::interruption_point();
+
+    if (nSelect == SOCKET_ERROR) {
+        if (have_fds) {
+            int nErr = WSAGetLastError();
+            LogPrintf("socket select error %s\n", NetworkErrorString(nErr));
+            for (unsigned int i = 0; i <= hSocketMax; i++)
+                FD_SET(i, &fdsetRecv);
+        }
+        FD_ZERO(&fdsetSend);
+        FD_ZERO(&fdsetError);
+        MilliSleep(timeout.tv_usec / 1000);
+    }
+
+    //
+    // Accept new connections
+    //
+    BOOST_FOREACH(
+    const ListenSocket &hListenSocket, vhListenSocket) {
+        if (hListenSocket.socket != INVALID_SOCKET && FD_ISSET(hListenSocket.socket, &fdsetRecv))
+            AcceptConnection(hListenSocket);
+    }
+
+    //
+    // Service each socket
+    //
+    BOOST_FOREACH(CNode * pnode, vNodesCopy)
+    {
+        boost::this_thread::interruption_point();
+
+        //
+        // Receive
+        //
+        if (pnode->hSocket == INVALID_SOCKET)
+            continue;
+        if (FD_ISSET(pnode->hSocket, &fdsetRecv) || FD_ISSET(pnode->hSocket, &fdsetError)) {
+            TRY_LOCK(pnode->cs_vRecvMsg, lockRecv);
+            if (lockRecv)
+                SocketRecvData(pnode);
+        }
+
+        //
+        // Send
+        //
+        if (pnode->hSocket == INVALID_SOCKET)
+            continue;
+        if (FD_ISSET(pnode->hSocket, &fdsetSend)) {
+            TRY_LOCK(pnode->cs_vSend, lockSend);
+            if (lockSend)
+                SocketSendData(pnode);
+        }
+    }
+}
+
 void ThreadSocketHandler() {
     unsigned int nPrevNodeCount = 0;
+#ifdef HAVE_SYS_EPOLL_H
+    std::set<CNode*> setNodesPending;
+    bool fMoreData = false;
+#endif
     while (true) {
         //
         // Disconnect nodes
@@ -813,6 +1167,9 @@ void ThreadSocketHandler() {
                      pnode->ssSend.empty())) {
                     // remove from vNodes
                     vNodes.erase(remove(vNodes.begin(), vNodes.end(), pnode), vNodes.end());
+#ifdef HAVE_SYS_EPOLL_H
+                    setNodesPending.erase(pnode);
+#endif
 
                     // release outbound grant (if any)
                     pnode->grantOutbound.Release();
@@ -863,139 +1220,6 @@ void ThreadSocketHandler() {
             uiInterface.NotifyNumConnectionsChanged(nPrevNodeCount);
         }
 
-        //
-        // Find which sockets have data to receive
-        //
-        struct timeval timeout;
-        timeout.tv_sec = 0;
-        timeout.tv_usec = 50000; // frequency to poll pnode->vSend
-
-        fd_set fdsetRecv;
-        fd_set fdsetSend;
-        fd_set fdsetError;
-        FD_ZERO(&fdsetRecv);
-        FD_ZERO(&fdsetSend);
-        FD_ZERO(&fdsetError);
-        SOCKET hSocketMax = 0;
-        bool have_fds = false;
-
-        BOOST_FOREACH(
-        const ListenSocket &hListenSocket, vhListenSocket) {
-            FD_SET(hListenSocket.socket, &fdsetRecv);
-            hSocketMax = max(hSocketMax, hListenSocket.socket);
-            have_fds = true;
-        }
-
-        {
-            LOCK(cs_vNodes);
-            BOOST_FOREACH(CNode * pnode, vNodes)
-            {
-                if (pnode->hSocket == INVALID_SOCKET)
-                    continue;
-                FD_SET(pnode->hSocket, &fdsetError);
-                hSocketMax = max(hSocketMax, pnode->hSocket);
-                have_fds = true;
-
-                // Implement the following logic:
-                // * If there is data to send, select() for sending data. As this only
-                //   happens when optimistic write failed, we choose to first drain the
-                //   write buffer in this case before receiving more. This avoids
-                //   needlessly queueing received data, if the remote peer is not themselves
-                //   receiving data. This means properly utilizing TCP flow control signalling.
-                // * Otherwise, if there is no (complete) message in the receive buffer,
-                //   or there is space left in the buffer, select() for receiving data.
-                // * (if neither of the above applies, there is certainly one message
-                //   in the receiver buffer ready to be processed).
-                // Together, that means that at least one of the following is always possible,
-                // so we don't deadlock:
-                // * We send some data.
-                // * We wait for data to be received (and disconnect after timeout).
-                // * We process a message in the buffer (message handler thread).
-                {
-                    TRY_LOCK(pnode->cs_vSend, lockSend);
-                    if (lockSend && !pnode->vSendMsg.empty()) {
-                        FD_SET(pnode->hSocket, &fdsetSend);
-                        continue;
-                    }
-                }
-                {
-                    TRY_LOCK(pnode->cs_vRecvMsg, lockRecv);
-                    if (lockRecv && (pnode->vRecvMsg.empty() || !pnode->vRecvMsg.front().complete() ||
-                                     pnode->GetTotalRecvSize() <= ReceiveFloodSize()))
-                        FD_SET(pnode->hSocket, &fdsetRecv);
-                }
-            }
-        }
-
-        int nSelect = select(have_fds ? hSocketMax + 1 : 0,
-                             &fdsetRecv, &fdsetSend, &fdsetError, &timeout);
-        boost::this_thread::interruption_point();
-
-        if (nSelect == SOCKET_ERROR) {
-            if (have_fds) {
-                int nErr = WSAGetLastError();
-                LogPrintf("socket select error %s\n", NetworkErrorString(nErr));
-                for (unsigned int i = 0; i <= hSocketMax; i++)
-                    FD_SET(i, &fdsetRecv);
-            }
-            FD_ZERO(&fdsetSend);
-            FD_ZERO(&fdsetError);
-            MilliSleep(timeout.tv_usec / 1000);
-        }
-
-        //
-        // Accept new connections
-        //
-        BOOST_FOREACH(
-        const ListenSocket &hListenSocket, vhListenSocket) {
-            if (hListenSocket.socket != INVALID_SOCKET && FD_ISSET(hListenSocket.socket, &fdsetRecv)) {
-                struct sockaddr_storage sockaddr;
-                socklen_t len = sizeof(sockaddr);
-                SOCKET hSocket = accept(hListenSocket.socket, (struct sockaddr *) &sockaddr, &len);
-                CAddress addr;
-                int nInbound = 0;
-
-                if (hSocket != INVALID_SOCKET)
-                    if (!addr.SetSockAddr((const struct sockaddr *) &sockaddr))
-                        LogPrintf("Warning: Unknown socket family\n");
-
-                bool whitelisted = hListenSocket.whitelisted || CNode::IsWhitelistedRange(addr);
-                {
-                    LOCK(cs_vNodes);
-                    BOOST_FOREACH(CNode * pnode, vNodes)
-                    if (pnode->fInbound)
-                        nInbound++;
-                }
-
-                if (hSocket == INVALID_SOCKET) {
-                    int nErr = WSAGetLastError();
-                    if (nErr != WSAEWOULDBLOCK)
-                        LogPrintf("socket error accept failed: %s\n", NetworkErrorString(nErr));
-                } else if (!IsSelectableSocket(hSocket)) {
-                    LogPrintf("connection from %s dropped: non-selectable socket\n", addr.ToString());
-                    CloseSocket(hSocket);
-                } else if (nInbound >= nMaxConnections - MAX_OUTBOUND_CONNECTIONS) {
-                    LogPrint("net", "connection from %s dropped (full)\n", addr.ToString());
-                    CloseSocket(hSocket);
-                } else if (CNode::IsBanned(addr) && !whitelisted) {
-                    LogPrintf("connection from %s dropped (banned)\n", addr.ToString());
-                    CloseSocket(hSocket);
-                } else {
-                    CNode *pnode = new CNode(hSocket, addr, "", true);
-                    pnode->AddRef();
-                    pnode->fWhitelisted = whitelisted;
-
-                    {
-                        LOCK(cs_vNodes);
-                        vNodes.push_back(pnode);
-                    }
-                }
-            }
-        }
-
-        //
-        // Service each socket
-        //
         vector < CNode * > vNodesCopy;
         {
             LOCK(cs_vNodes);
@@ -1003,57 +1227,18 @@ void ThreadSocketHandler() {
             BOOST_FOREACH(CNode * pnode, vNodesCopy)
             pnode->AddRef();
         }
-        BOOST_FOREACH(CNode * pnode, vNodesCopy)
-        {
-            boost::this_thread::interruption_point();
 
-            //
-            // Receive
-            //
-            if (pnode->hSocket == INVALID_SOCKET)
-                continue;
-            if (FD_ISSET(pnode->hSocket, &fdsetRecv) || FD_ISSET(pnode->hSocket, &fdsetError)) {
-                TRY_LOCK(pnode->cs_vRecvMsg, lockRecv);
-                if (lockRecv) {
-                    {
-                        // typical socket buffer is 8K-64K
-                        char pchBuf[0x10000];
-                        int nBytes = recv(pnode->hSocket, pchBuf, sizeof(pchBuf), MSG_DONTWAIT);
-                        if (nBytes > 0) {
-                            if (!pnode->ReceiveMsgBytes(pchBuf, nBytes))
-                                pnode->CloseSocketDisconnect();
-                            pnode->nLastRecv = GetTime();
-                            pnode->nRecvBytes += nBytes;
-                            pnode->RecordBytesRecv(nBytes);
-                        } else if (nBytes == 0) {
-                            // socket closed gracefully
-                            if (!pnode->fDisconnect)
-                                LogPrint("net", "socket closed\n");
-                            pnode->CloseSocketDisconnect();
-                        } else if (nBytes < 0) {
-                            // error
-                            int nErr = WSAGetLastError();
-                            if (nErr != WSAEWOULDBLOCK && nErr != WSAEMSGSIZE && nErr != WSAEINTR &&
-                                nErr != WSAEINPROGRESS) {
-                                if (!pnode->fDisconnect)
-                                    LogPrintf("socket recv error %s\n", NetworkErrorString(nErr));
-                                pnode->CloseSocketDisconnect();
-                            }
-                        }
-                    }
-                }
-            }
+#ifdef HAVE_SYS_EPOLL_H
+        if (nSocketEventsMode == SOCKETEVENTS_EPOLL)
+            HandleSocketEventsEpoll(setNodesPending, fMoreData);
+        else
+#endif
+            HandleSocketEventsSelect(vNodesCopy);
 
-            //
-            // Send
-            //
+        BOOST_FOREACH(CNode * pnode, vNodesCopy)
+        {
             if (pnode->hSocket == INVALID_SOCKET)
                 continue;
-            if (FD_ISSET(pnode->hSocket, &fdsetSend)) {
-                TRY_LOCK(pnode->cs_vSend, lockSend);
-                if (lockSend)
-                    SocketSendData(pnode);
-            }
 
             //
             // Inactivity checking
@@ -1504,7 +1689,8 @@ void ThreadMessageHandler() {
                     }
                     if (pnode->nSendSize < SendBufferSize()) {
                         if (!pnode->vRecvGetData.empty() ||
-                            (!pnode->vRecvMsg.empty() && pnode->vRecvMsg[0].complete())) {
+                            (!pnode->vRecvMsg.empty() && pnode->vRecvMsg[0].complete() &&
+                                !messagePreChecker.IsPending(pnode->vRecvMsg[0]))) {
                             fSleep = false;
                         }
                     }
@@ -1555,7 +1741,7 @@ bool BindListenPort(const CService &addrBind, string &strError, bool fWhiteliste
         LogPrintf("%s\n", strError);
         return false;
     }
-    if (!IsSelectableSocket(hListenSocket)) {
+    if (!IsSocketServiceable(hListenSocket)) {
         strError = "Error: Couldn't create a listenable socket for incoming connections";
         LogPrintf("%s\n", strError);
         return false;
@@ -1707,6 +1893,13 @@ void StartNode(boost::thread_group &threadGroup, CScheduler &scheduler) {
 
     Discover(threadGroup);
 
+#ifdef HAVE_SYS_EPOLL_H
+    if (nSocketEventsMode == SOCKETEVENTS_EPOLL && hEpoll == -1 && !InitSocketEvents()) {
+        LogPrintf("Falling back to select() for socket events\n");
+        nSocketEventsMode = SOCKETEVENTS_SELECT;
+    }
+#endif
+
     //
     // Start threads
     //
@@ -1772,6 +1965,11 @@ public:
         vNodes.clear();
         vNodesDisconnected.clear();
         vhListenSocket.clear();
+#ifdef HAVE_SYS_EPOLL_H
+        if (hEpoll != -1)
+            close(hEpoll);
+        hEpoll = -1;
+#endif
         delete semOutbound;
         semOutbound = NULL;
         delete pnodeLocalHost;
@@ -2038,6 +2236,8 @@ CNode::CNode(SOCKET hSocketIn, CAddress addrIn, std::string addrNameIn, bool fIn
     nPingUsecTime = 0;
     fPingQueued = false;
     fObfuScationMaster = false;
+    fSocketRecvReady = false;
+    fSocketSendReady = false;
 
     {
         LOCK(cs_nLastNodeId);
@@ -2054,6 +2254,10 @@ CNode::CNode(SOCKET hSocketIn, CAddress addrIn, std::string addrNameIn, bool fIn
         PushVersion();
 
     GetNodeSignals().InitializeNode(GetId(), this);
+
+#ifdef HAVE_SYS_EPOLL_H
+    AddSocketEvents(this);
+#endif
 }
 
 CNode::~CNode() {
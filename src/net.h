@@ -30,10 +30,12 @@
 
 #include <boost/filesystem/path.hpp>
 #include <boost/foreach.hpp>
+#include <boost/shared_ptr.hpp>
 #include <boost/signals2/signal.hpp>
 
 class CAddrMan;
 class CBlockIndex;
+class CPreCheckedMessage;
 class CScheduler;
 class CNode;
 
@@ -62,6 +64,21 @@ static const bool DEFAULT_UPNP = false;
 #endif
 /** The maximum number of entries in mapAskFor */
 static const size_t MAPASKFOR_MAX_SZ = MAX_INV_SZ;
+/** -socketevents default */
+#ifdef HAVE_SYS_EPOLL_H
+static const char* const DEFAULT_SOCKETEVENTS = "epoll";
+#else
+static const char* const DEFAULT_SOCKETEVENTS = "select";
+#endif
+/** Maximum number of connections with epoll, which is not bound by FD_SETSIZE */
+static const int MAX_EPOLL_CONNECTIONS = 65536;
+
+/** How ThreadSocketHandler waits for socket readiness */
+enum SocketEventsMode {
+    SOCKETEVENTS_SELECT = 0,
+    //! Edge-triggered epoll, sockets are registered once (Linux only)
+    SOCKETEVENTS_EPOLL = 1
+};
 
 unsigned int ReceiveFloodSize();
 unsigned int SendBufferSize();
@@ -129,6 +146,7 @@ extern uint64_t nLocalServices;
 extern uint64_t nLocalHostNonce;
 extern CAddrMan addrman;
 extern int nMaxConnections;
+extern SocketEventsMode nSocketEventsMode;
 
 extern std::vector<CNode*> vNodes;
 extern CCriticalSection cs_vNodes;
@@ -143,6 +161,9 @@ extern CCriticalSection cs_vAddedNodes;
 extern NodeId nLastNodeId;
 extern CCriticalSection cs_nLastNodeId;
 
+/** Signalled when messages are ready for the message handler thread */
+extern boost::condition_variable messageHandlerCondition;
+
 struct LocalServiceInfo {
     int nScore;
     int nPort;
@@ -188,6 +209,8 @@ public:
 
     int64_t nTime; // time (in microseconds) of message receipt.
 
+    boost::shared_ptr<CPreCheckedMessage> pchecked; // payload handed to the message pre-check threads, if any
+
     CNetMessage(int nTypeIn, int nVersionIn) : hdrbuf(nTypeIn, nVersionIn), vRecv(nTypeIn, nVersionIn)
     {
         hdrbuf.resize(24);
@@ -326,6 +349,9 @@ public:
     // (even if it's relative to mixing e.g. for blinding) should NOT set this to 'true'.
     // For such cases node should be released manually (preferably right after corresponding code).
     bool fObfuScationMaster;
+    // Readiness reported by edge-triggered epoll and not consumed yet, only used by ThreadSocketHandler
+    bool fSocketRecvReady;
+    bool fSocketSendReady;
     CSemaphoreGrant grantOutbound;
     CCriticalSection cs_filter;
     CBloomFilter* pfilter;
@@ -8,6 +8,7 @@
 #include "coincontrol.h"
 #include "init.h"
 #include "main.h"
+#include "masternode-budget.h"
 #include "masternodeman.h"
 #include "script/sign.h"
 #include "swifttx.h"
@@ -17,6 +18,8 @@
 #include <boost/filesystem.hpp>
 #include <boost/filesystem/fstream.hpp>
 #include <boost/lexical_cast.hpp>
+#include <boost/thread/locks.hpp>
+#include <boost/thread/shared_mutex.hpp>
 
 #include <algorithm>
 #include <boost/assign/list_of.hpp>
@@ -1893,21 +1896,80 @@ bool CObfuScationSigner::SignMessage(std::string strMessage, std::string& errorM
 
 bool CObfuScationSigner::VerifyMessage(CPubKey pubkey, vector<unsigned char>& vchSig, std::string strMessage, std::string& errorMessage)
 {
-    CHashWriter ss(SER_GETHASH, 0);
-    ss << strMessageMagic;
-    ss << strMessage;
-
-    CPubKey pubkey2;
-    if (!pubkey2.RecoverCompact(ss.GetHash(), vchSig)) {
+    CKeyID keyID;
+    if (!RecoverMessageKey(vchSig, strMessage, keyID)) {
         errorMessage = _("Error recovering public key.");
         LogPrintf("CObfuScationSigner::VerifyMessage -- Failed to receiver key\n");
         return false;
     }
 
-    if (fDebug && pubkey2.GetID() != pubkey.GetID())
-        LogPrintf("CObfuScationSigner::VerifyMessage -- keys don't match: %s %s\n", pubkey2.GetID().ToString(), pubkey.GetID().ToString());
+    if (fDebug && keyID != pubkey.GetID())
+        LogPrintf("CObfuScationSigner::VerifyMessage -- keys don't match: %s %s\n", keyID.ToString(), pubkey.GetID().ToString());
+
+    return (keyID == pubkey.GetID());
+}
+
+namespace
+{
+/**
+ * Keys recovered from masternode message signatures, by hash of message and
+ * signature. Every ping, winner and budget vote reaches us from several
+ * peers, and the pre-check threads recover the key before the message
+ * thread looks at it. A null key ID marks a signature that failed to
+ * recover.
+ */
+class CRecoveredKeyCache
+{
+private:
+    std::map<uint256, CKeyID> mapKeys;
+    boost::shared_mutex cs_keycache;
+
+public:
+    bool Get(const uint256& hash, CKeyID& keyID)
+    {
+        boost::shared_lock<boost::shared_mutex> lock(cs_keycache);
+        std::map<uint256, CKeyID>::const_iterator it = mapKeys.find(hash);
+        if (it == mapKeys.end())
+            return false;
+        keyID = it->second;
+        return true;
+    }
+
+    void Set(const uint256& hash, const CKeyID& keyID)
+    {
+        boost::unique_lock<boost::shared_mutex> lock(cs_keycache);
+        while (mapKeys.size() >= MAX_RECOVERED_KEY_CACHE_SIZE) {
+            // Evict a random entry, as the signature cache does
+            std::map<uint256, CKeyID>::iterator it = mapKeys.lower_bound(GetRandHash());
+            if (it == mapKeys.end())
+                it = mapKeys.begin();
+            mapKeys.erase(it);
+        }
+        mapKeys[hash] = keyID;
+    }
+};
+
+CRecoveredKeyCache recoveredKeyCache;
+
+} // anon namespace
 
-    return (pubkey2.GetID() == pubkey.GetID());
+bool CObfuScationSigner::RecoverMessageKey(const std::vector<unsigned char>& vchSig, const std::string& strMessage, CKeyID& keyID, bool* pfCached)
+{
+    CHashWriter ss(SER_GETHASH, 0);
+    ss << strMessageMagic;
+    ss << strMessage;
+    uint256 hashMessage = ss.GetHash();
+    uint256 hashEntry = Hash(hashMessage.begin(), hashMessage.end(), vchSig.begin(), vchSig.end());
+
+    bool fCached = recoveredKeyCache.Get(hashEntry, keyID);
+    if (pfCached)
+        *pfCached = fCached;
+    if (!fCached) {
+        CPubKey pubkey;
+        keyID = pubkey.RecoverCompact(hashMessage, vchSig) ? pubkey.GetID() : CKeyID();
+        recoveredKeyCache.Set(hashEntry, keyID);
+    }
+    return !keyID.IsNull();
 }
 
 bool CObfuscationQueue::Sign()
@@ -2025,6 +2087,9 @@ void ThreadCheckObfuScationPool()
         // try to sync from all available nodes, one step at a time
         masternodeSync.Process();
 
+        // hand the masternode list changes of the last second to the readers
+        mnodeman.PublishListChanges();
+
         if (masternodeSync.IsBlockchainSynced()) {
             c++;
 
@@ -2039,6 +2104,13 @@ void ThreadCheckObfuScationPool()
                 CleanTransactionLocksList();
             }
 
+            // only what changed since the last dump is written
+            if (c % MASTERNODES_DUMP_SECONDS == 0) {
+                DumpMasternodes();
+                DumpBudgets();
+                DumpMasternodePayments();
+            }
+
             obfuScationPool.CheckTimeout();
             obfuScationPool.CheckForCompleteQueue();
 
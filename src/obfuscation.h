@@ -49,6 +49,8 @@ class CActiveMasternode;
 
 static const CAmount OBFUSCATION_COLLATERAL = (10 * COIN);
 static const CAmount OBFUSCATION_POOL_MAX = (99999.99 * COIN);
+/** Keys recovered from masternode message signatures that are remembered, about 100 bytes each */
+static const unsigned int MAX_RECOVERED_KEY_CACHE_SIZE = 50000;
 
 extern CObfuscationPool obfuScationPool;
 extern CObfuScationSigner obfuScationSigner;
@@ -258,6 +260,10 @@ public:
     bool SignMessage(std::string strMessage, std::string& errorMessage, std::vector<unsigned char>& vchSig, CKey key);
     /// Verify the message, returns true if succcessful
     bool VerifyMessage(CPubKey pubkey, std::vector<unsigned char>& vchSig, std::string strMessage, std::string& errorMessage);
+    /// Recover the key that signed the message, returns false if the signature is malformed.
+    /// Results are cached, so a message relayed by many peers or checked twice is only recovered once.
+    /// pfCached, if given, tells whether the result came from the cache.
+    bool RecoverMessageKey(const std::vector<unsigned char>& vchSig, const std::string& strMessage, CKeyID& keyID, bool* pfCached = NULL);
 };
 
 /** Used to keep track of current status of Obfuscation pool
@@ -188,6 +188,9 @@ bool CheckPoAContainRecentHash(const CBlock& block)
         }
         pindex = pindex->pprev;
     }
+    // Each audited block is read once and their coinstake key image proofs cost a single multi-exp
+    std::map<uint256, CBlock> mapAuditedBlocks;
+    ReadAuditedPoSBlocks(block, mapAuditedBlocks);
     bool ret = true;
     if (pindex->nHeight <= Params().START_POA_BLOCK()) {
         //this is the first PoA block ==> check all PoS blocks from LAST_POW_BLOCK up to currentHeight - POA_BLOCK_PERIOD - 1 inclusive
@@ -203,7 +206,7 @@ bool CheckPoAContainRecentHash(const CBlock& block)
                 break;
             }
             CBlockIndex* p = mapBlockIndex[pos.hash];
-            bool auditResult = ReVerifyPoSBlock(p);
+            bool auditResult = mapAuditedBlocks.count(pos.hash) ? ReVerifyPoSBlock(p, mapAuditedBlocks[pos.hash]) : ReVerifyPoSBlock(p);
             if (!auditResult) {
                 if (pos.nTime) {
                     ret = false;
@@ -250,7 +253,7 @@ bool CheckPoAContainRecentHash(const CBlock& block)
                     }
 
                     CBlockIndex* p = mapBlockIndex[pos.hash];
-                    bool auditResult = ReVerifyPoSBlock(p);
+                    bool auditResult = mapAuditedBlocks.count(pos.hash) ? ReVerifyPoSBlock(p, mapAuditedBlocks[pos.hash]) : ReVerifyPoSBlock(p);
                     if (!auditResult) {
                         if (pos.nTime) {
                             ret = false;
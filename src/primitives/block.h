@@ -158,6 +158,8 @@ public:
     mutable CScript payee;
     mutable std::vector<uint256> vMerkleTree;
     mutable std::vector<uint256> poaMerkleTree;
+    // set once CheckBlockContextFree() passed, the checks only depend on the block itself
+    mutable bool fChecked;
 
     CBlock()
     {
@@ -192,6 +194,7 @@ public:
         poaMerkleTree.clear();
         payee = CScript();
         vchBlockSig.clear();
+        fChecked = false;
     }
 
     CBlockHeader GetBlockHeader() const
@@ -14,7 +14,6 @@
 #include "tinyformat.h"
 #include "utilstrencodings.h"
 #include "transaction.h"
-#include "secp256k1.h"
 
 #include <boost/foreach.hpp>
 
@@ -0,0 +1,52 @@
+// Copyright (c) 2018-2019 The DAPS Project developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include "proofcache.h"
+
+#include "random.h"
+#include "serialize.h"
+#include "version.h"
+
+CProofCache proofCache;
+
+CProofCache::CProofCache() : nMaxEntries(0)
+{
+}
+
+void CProofCache::Setup(size_t nMaxEntriesIn)
+{
+    boost::unique_lock<boost::shared_mutex> lock(cs_proofcache);
+    salt = GetRandHash();
+    nMaxEntries = nMaxEntriesIn;
+    setValid.clear();
+}
+
+CHashWriter CProofCache::KeyWriter(ProofType type, const uint256& txid) const
+{
+    CHashWriter ss(SER_GETHASH, PROTOCOL_VERSION);
+    ss << salt << (unsigned char)type << txid;
+    return ss;
+}
+
+bool CProofCache::Contains(const uint256& key)
+{
+    boost::shared_lock<boost::shared_mutex> lock(cs_proofcache);
+    return setValid.count(key) != 0;
+}
+
+void CProofCache::Insert(const uint256& key)
+{
+    boost::unique_lock<boost::shared_mutex> lock(cs_proofcache);
+    if (nMaxEntries == 0)
+        return;
+
+    while (setValid.size() >= nMaxEntries) {
+        // Evict a random entry, so nobody can predict which proofs stay cached
+        std::set<uint256>::iterator it = setValid.lower_bound(GetRandHash());
+        if (it == setValid.end())
+            it = setValid.begin();
+        setValid.erase(it);
+    }
+    setValid.insert(key);
+}
@@ -0,0 +1,59 @@
+// Copyright (c) 2018-2019 The DAPS Project developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#ifndef BITCOIN_PROOFCACHE_H
+#define BITCOIN_PROOFCACHE_H
+
+#include "hash.h"
+#include "uint256.h"
+
+#include <set>
+
+#include <boost/thread/shared_mutex.hpp>
+
+/** Default for -maxproofcachesize, the number of verified proofs remembered */
+static const unsigned int DEFAULT_MAX_PROOF_CACHE_SIZE = 50000;
+
+/**
+ * Valid proof cache, so the MLSAG and bulletproof of a transaction are
+ * verified once when it enters the memory pool and not again when it is
+ * connected in a block or a PoS block is re-verified for an audit. The
+ * Schnorr key image proofs of coinstakes and masternode inputs are cached
+ * the same way, after a batch of them was verified together.
+ *
+ * Keys are salted per process, so peers cannot aim collisions at us or
+ * learn what we cached. A ring signature key also commits to the block and
+ * output data every ring member resolved to, so a reorg that makes a decoy
+ * resolve differently misses the cache and is verified from scratch.
+ */
+class CProofCache
+{
+public:
+    enum ProofType {
+        RING_SIGNATURE = 0,
+        BULLETPROOF = 1,
+        KEY_IMAGE_PROOF = 2
+    };
+
+    CProofCache();
+
+    //! Pick a new salt and keep at most nMaxEntries proofs, 0 disables the cache
+    void Setup(size_t nMaxEntries);
+
+    //! Start a key for a proof of txid; callers append the data the proof was checked against
+    CHashWriter KeyWriter(ProofType type, const uint256& txid) const;
+
+    bool Contains(const uint256& key);
+    void Insert(const uint256& key);
+
+private:
+    boost::shared_mutex cs_proofcache;
+    uint256 salt;
+    size_t nMaxEntries;
+    std::set<uint256> setValid;
+};
+
+extern CProofCache proofCache;
+
+#endif // BITCOIN_PROOFCACHE_H
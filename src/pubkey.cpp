@@ -4,29 +4,24 @@
 
 #include "pubkey.h"
 
-#include "eccryptoverify.h"
+#include "ecutil.h"
 
-#ifdef USE_SECP256K1
-#include <secp256k1.h>
-#else
-#include "ecwrapper.h"
-#endif
+#include "secp256k1-mw/contrib/lax_der_parsing.h"
+#include "secp256k1_recovery.h"
 
 bool CPubKey::Verify(const uint256& hash, const std::vector<unsigned char>& vchSig) const
 {
-    if (!IsValid())
-        return false;
-#ifdef USE_SECP256K1
-    if (secp256k1_ecdsa_verify((const unsigned char*)&hash, 32, &vchSig[0], vchSig.size(), begin(), size()) != 1)
+    if (!IsValid() || vchSig.empty())
         return false;
-#else
-    CECKey key;
-    if (!key.SetPubKey(begin(), size()))
+    secp256k1_pubkey2 pubkey;
+    secp256k1_ecdsa_sign2ature2 sig;
+    if (!secp256k1_ec_pubkey_parse2(GetContext(), &pubkey, begin(), size()))
         return false;
-    if (!key.Verify(hash, vchSig))
+    // Accept the DER encodings and high-S signatures OpenSSL used to accept
+    if (!ecdsa_signature_parse_der_lax(GetContext(), &sig, &vchSig[0], vchSig.size()))
         return false;
-#endif
-    return true;
+    secp256k1_ecdsa_sign2ature2_normalize(GetContext(), &sig, &sig);
+    return secp256k1_ecdsa_verify2(GetContext(), &sig, (const unsigned char*)&hash, &pubkey);
 }
 
 bool CPubKey::RecoverCompact(const uint256& hash, const std::vector<unsigned char>& vchSig)
@@ -35,19 +30,16 @@ bool CPubKey::RecoverCompact(const uint256& hash, const std::vector<unsigned cha
         return false;
     int recid = (vchSig[0] - 27) & 3;
     bool fComp = ((vchSig[0] - 27) & 4) != 0;
-#ifdef USE_SECP256K1
-    int pubkeylen = 65;
-    if (!secp256k1_ecdsa_recover_compact((const unsigned char*)&hash, 32, &vchSig[1], (unsigned char*)begin(), &pubkeylen, fComp, recid))
+    secp256k1_pubkey2 pubkey;
+    secp256k1_ecdsa_recoverable_signature sig;
+    if (!secp256k1_ecdsa_recoverable_signature_parse_compact(GetContext(), &sig, &vchSig[1], recid))
         return false;
-    assert((int)size() == pubkeylen);
-#else
-    CECKey key;
-    if (!key.Recover(hash, &vchSig[1], recid))
+    if (!secp256k1_ecdsa_recover(GetContext(), &pubkey, &sig, (const unsigned char*)&hash))
         return false;
-    std::vector<unsigned char> pubkey;
-    key.GetPubKey(pubkey, fComp);
-    Set(pubkey.begin(), pubkey.end());
-#endif
+    unsigned char pub[65];
+    size_t publen = 65;
+    secp256k1_ec_pubkey_serialize2(GetContext(), pub, &publen, &pubkey, fComp ? SECP256K1_EC_COMPRESSED : SECP256K1_EC_UNCOMPRESSED);
+    Set(pub, pub + publen);
     return true;
 }
 
@@ -55,34 +47,21 @@ bool CPubKey::IsFullyValid() const
 {
     if (!IsValid())
         return false;
-#ifdef USE_SECP256K1
-    if (!secp256k1_ecdsa_pubkey_verify(begin(), size()))
-        return false;
-#else
-    CECKey key;
-    if (!key.SetPubKey(begin(), size()))
-        return false;
-#endif
-    return true;
+    secp256k1_pubkey2 pubkey;
+    return secp256k1_ec_pubkey_parse2(GetContext(), &pubkey, begin(), size());
 }
 
 bool CPubKey::Decompress()
 {
     if (!IsValid())
         return false;
-#ifdef USE_SECP256K1
-    int clen = size();
-    int ret = secp256k1_ecdsa_pubkey_decompress((unsigned char*)begin(), &clen);
-    assert(ret);
-    assert(clen == (int)size());
-#else
-    CECKey key;
-    if (!key.SetPubKey(begin(), size()))
+    secp256k1_pubkey2 pubkey;
+    if (!secp256k1_ec_pubkey_parse2(GetContext(), &pubkey, begin(), size()))
         return false;
-    std::vector<unsigned char> pubkey;
-    key.GetPubKey(pubkey, false);
-    Set(pubkey.begin(), pubkey.end());
-#endif
+    unsigned char pub[65];
+    size_t publen = 65;
+    secp256k1_ec_pubkey_serialize2(GetContext(), pub, &publen, &pubkey, SECP256K1_EC_UNCOMPRESSED);
+    Set(pub, pub + publen);
     return true;
 }
 
@@ -94,18 +73,8 @@ bool CPubKey::Derive(CPubKey& pubkeyChild, unsigned char ccChild[32], unsigned i
     unsigned char out[64];
     BIP32Hash(cc, nChild, *begin(), begin() + 1, out);
     memcpy(ccChild, out + 32, 32);
-#ifdef USE_SECP256K1
     pubkeyChild = *this;
-    bool ret = secp256k1_ecdsa_pubkey_tweak_add((unsigned char*)pubkeyChild.begin(), pubkeyChild.size(), out);
-#else
-    CECKey key;
-    bool ret = key.SetPubKey(begin(), size());
-    ret &= key.TweakPublic(out);
-    std::vector<unsigned char> pubkey;
-    key.GetPubKey(pubkey, true);
-    pubkeyChild.Set(pubkey.begin(), pubkey.end());
-#endif
-    return ret;
+    return ECPubKeyTweakAdd((unsigned char*)pubkeyChild.begin(), pubkeyChild.size(), out);
 }
 
 void CExtPubKey::Encode(unsigned char code[74]) const
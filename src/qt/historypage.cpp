@@ -15,7 +15,6 @@
 #include "transactionrecord.h"
 #include "walletmodel.h"
 #include "revealtxdialog.h"
-#include "custom/dapstablewidgetitem.h"
 
 #include <algorithm>
 
@@ -32,26 +31,18 @@
 #include <QTextStream>
 #include <QProcess>
 
-bool TxCompare (std::map<QString, QString> i, std::map<QString, QString> j) { 
-    QString str_i = i.at("date");
-    QString str_j = j.at("date");
-    QDateTime date_i = QDateTime::fromString(str_i,"MM/dd/yy hh:mm");
-    QDateTime date_j = QDateTime::fromString(str_j,"MM/dd/yy hh:mm");
-
-    return date_i > date_j;
-}
-
 HistoryPage::HistoryPage(QWidget* parent) : QDialog(parent, Qt::WindowSystemMenuHint | Qt::WindowTitleHint | Qt::WindowCloseButtonHint),
                                             ui(new Ui::HistoryPage),
                                             // m_SizeGrip(this),
-                                            model(0)
+                                            model(0),
+                                            tableModel(0),
+                                            fDateFilter(false)
 
 {
     ui->setupUi(this);
 
     initWidgets();
     connectWidgets();
-    updateTableData(pwalletMain);
     updateAddressBookData(pwalletMain);
 }
 
@@ -65,10 +56,10 @@ void HistoryPage::initWidgets()
 {
     //set String for all addresses
     allAddressString = "All addresses...";
-    //adjust qt paint flags
-    ui->tableView->verticalHeader()->setSectionResizeMode(QHeaderView::ResizeToContents);
+    //adjust qt paint flags, fixed row heights so the model only decodes the visible rows
+    ui->tableView->verticalHeader()->setSectionResizeMode(QHeaderView::Fixed);
     ui->tableView->setAttribute(Qt::WA_TranslucentBackground, true);
-    connect(ui->tableView, SIGNAL(cellDoubleClicked(int, int)), this, SLOT(on_cellClicked(int, int)));
+    connect(ui->tableView, SIGNAL(doubleClicked(const QModelIndex&)), this, SLOT(on_doubleClicked(const QModelIndex&)));
 
     //set date formats and init date from current timestamp
     ui->dateTimeEditTo->setDisplayFormat("M/d/yy");
@@ -93,8 +84,8 @@ void HistoryPage::initWidgets()
 
 void HistoryPage::connectWidgets() //add functions to widget signals
 {
-    connect(ui->dateTimeEditTo, SIGNAL(dateChanged(const QDate&)), this, SLOT(updateFilter()));
-    connect(ui->dateTimeEditFrom, SIGNAL(dateChanged(const QDate&)), this, SLOT(updateFilter()));
+    connect(ui->dateTimeEditTo, SIGNAL(dateChanged(const QDate&)), this, SLOT(enableDateFilter()));
+    connect(ui->dateTimeEditFrom, SIGNAL(dateChanged(const QDate&)), this, SLOT(enableDateFilter()));
     connect(ui->comboBoxType, SIGNAL(currentIndexChanged(const int&)), this, SLOT(updateFilter()));
     //
     connect(ui->lineEditDesc, SIGNAL(currentIndexChanged(const int&)), this, SLOT(updateFilter()));
@@ -103,22 +94,19 @@ void HistoryPage::connectWidgets() //add functions to widget signals
     //
     connect(ui->lineEditAmount, SIGNAL(textChanged(const QString&)), this, SLOT(updateFilter()));
     //
-    connect(timeEditFrom, SIGNAL(timeChanged(const QTime&)), this, SLOT(updateFilter()));
-    connect(timeEditTo, SIGNAL(timeChanged(const QTime&)), this, SLOT(updateFilter()));
+    connect(timeEditFrom, SIGNAL(timeChanged(const QTime&)), this, SLOT(enableDateFilter()));
+    connect(timeEditTo, SIGNAL(timeChanged(const QTime&)), this, SLOT(enableDateFilter()));
 }
 
-void HistoryPage::on_cellClicked(int row, int column) 
+void HistoryPage::on_doubleClicked(const QModelIndex& index)
 {
-    if (pwalletMain->IsLocked()) return;
-    //1 is column index for type
-    QTableWidgetItem* cell = ui->tableView->item(row, 1);
-    QString type = cell->data(0).toString();
+    if (pwalletMain->IsLocked() || !index.isValid()) return;
+    QString type = index.sibling(index.row(), TransactionHistoryModel::Type).data().toString();
     std::string stdType = type.trimmed().toStdString();
-    //2 is column index for address
-    cell = ui->tableView->item(row, 2);
-    QString address = cell->data(0).toString();
+    QString address = index.sibling(index.row(), TransactionHistoryModel::ToAddress).data().toString();
     std::string stdAddress = address.trimmed().toStdString();
-    if (pwalletMain->addrToTxHashMap.count(stdAddress) == 1) {
+    std::string txHash = index.data(TransactionHistoryModel::TxHashRole).toString().toStdString();
+    if (!txHash.empty()) {
         // QMessageBox txHashShow;
         // txHashShow.setText("Transaction Hash.");
         // txHashShow.setInformativeText(pwalletMain->addrToTxHashMap[stdAddress].c_str());
@@ -129,17 +117,22 @@ void HistoryPage::on_cellClicked(int row, int column)
         RevealTxDialog txdlg;
         txdlg.setStyleSheet(GUIUtil::loadStyleSheet());
 
-        txdlg.setTxID(pwalletMain->addrToTxHashMap[stdAddress].c_str());
+        txdlg.setTxID(txHash.c_str());
 
         txdlg.setTxAddress(stdAddress.c_str());
         bool privkeyFound = false;
-        std::string txHash = pwalletMain->addrToTxHashMap[stdAddress];
         if (IsHex(txHash)) {
         	uint256 hash;
         	hash.SetHex(txHash);
 
-        	if (pwalletMain && pwalletMain->mapWallet.count(hash) == 1) {
-        		CWalletTx tx = pwalletMain->mapWallet[hash];
+        	const CWalletTx* pwtx = NULL;
+        	CWalletTx tx;
+        	if (pwalletMain) {
+        		LOCK(pwalletMain->cs_wallet);
+        		if ((pwtx = pwalletMain->GetWalletTxBody(hash)))
+        			tx = *pwtx;
+        	}
+        	if (pwtx) {
         		for (size_t i = 0; i < tx.vout.size(); i++) {
         			txnouttype type;
         			vector<CTxDestination> addresses;
@@ -195,89 +188,10 @@ void HistoryPage::keyPressEvent(QKeyEvent* event)
     this->QDialog::keyPressEvent(event);
 }
 
-void HistoryPage::addTableData(std::map<QString, QString>)
-{
-}
-
 void HistoryPage::updateTableData()
 {
-	if (pwalletMain) {
-		updateTableData(pwalletMain);
-	}
-}
-
-void HistoryPage::updateTableData(CWallet* wallet)
-{
-	if (!wallet) return;
-    TRY_LOCK(cs_main, lockMain);
-    if (!lockMain)
-        return;
-    TRY_LOCK(pwalletMain->cs_wallet, lockWallet);
-    if (!lockWallet)
-        return;
-    {
-        if (!wallet || wallet->IsLocked()) return;
-        ui->tableView->setSortingEnabled(false);
-        while (ui->tableView->rowCount() > 0)
-        {
-            ui->tableView->removeRow(0);
-        }
-        ui->tableView->setRowCount(0);
-        vector<std::map<QString, QString> > txs;
-        if (wallet->IsLocked()) {
-            {
-                LOCK(pwalletMain->cs_wallet);
-                vector<std::map<QString, QString>> txs;// = WalletUtil::getTXs(pwalletMain);
-
-                std::map<uint256, CWalletTx> txMap = pwalletMain->mapWallet;
-                std::vector<CWalletTx> latestTxes;
-                for (std::map<uint256, CWalletTx>::iterator tx = txMap.begin(); tx != txMap.end(); ++tx) {
-                    if (tx->second.GetDepthInMainChain() > 0) {
-                        latestTxes.push_back(tx->second);
-                    }
-                }
-
-                for (int i = 0; i < (int)latestTxes.size(); i++) {
-                    txs.push_back(WalletUtil::getTx(pwalletMain, latestTxes[i]));
-                }
-            }
-        } else {
-            txs = WalletUtil::getTXs(wallet);
-        }
-        std::sort (txs.begin(), txs.end(), TxCompare);
-        for (int row = 0; row < (short)txs.size(); row++) {
-            ui->tableView->insertRow(row);
-            int col = 0;
-            for (QString dataName : {"date", "type", "address", "amount", "confirmations"}) {
-                QString data = txs[row].at(dataName);
-                QString date = data;
-                DAPSTableWidgetItem* cell = new DAPSTableWidgetItem();
-                switch (col) {
-                case 0: /*date*/
-                    cell->setData(0, date);
-                    break;
-                case 3: /*amount*/
-                    if (wallet->IsLocked()) {
-                        cell->setData(0, QString("Locked; Hidden"));
-                    } else {
-                        cell->setData(0, data);
-                    }
-                    break;
-                case 4: /*confirmations*/
-                    cell->setData(0, data.toInt());
-                    break;
-                default:
-                    cell->setData(0, data);
-                    break;
-                }
-                ui->tableView->setItem(row, col, cell);
-                col++;
-            }
-        }
-        ui->tableView->setVisible(ui->tableView->rowCount());
-        ui->tableView->sortByColumn(0);
-        ui->tableView->setSortingEnabled(true);
-    }
+    if (tableModel)
+        tableModel->refresh();
 }
 
 void HistoryPage::updateAddressBookData(CWallet* wallet)
@@ -292,41 +206,24 @@ void HistoryPage::updateAddressBookData(CWallet* wallet)
 
 void HistoryPage::updateFilter()
 {
+    if (!tableModel) return;
     syncTime(ui->dateTimeEditFrom, timeEditFrom);
-    syncTime(ui->dateTimeEditFrom, timeEditFrom);
-    auto selectedAmount = ui->lineEditAmount->text().toFloat();
-    QString selectedType = ui->comboBoxType->currentText();
-    QList<QString> selectedAddresses = ui->lineEditDesc->lineEdit()->text().split(" | ");
-
-    for (int row = 0; row < ui->tableView->rowCount(); row++) {
-        bool hide = false;
-        QDateTime date = QDateTime::fromString(ui->tableView->item(row, 0)->text(), "M/d/yyyy h:m");
-        QString type = ui->tableView->item(row, 1)->text();
-        QString address = ui->tableView->item(row, 2)->text();
-        auto amount = ui->tableView->item(row, 3)->text().toFloat();
-
-        if (
-            (ui->dateTimeEditFrom->dateTime() > date) || (ui->dateTimeEditTo->dateTime() < date) || //record is not between selected dates
-
-            (amount < selectedAmount) //record smaller than selected min amount
-        )
-            hide = true;
-        if (selectedType != tr("All Types")) {
-            if (selectedType == tr("Received")) {
-                hide = !(type == tr("Received") || type == tr("Masternode Reward") || type == tr("Staking Reward") || type == ("PoA Reward"));
-            } else
-                hide = (selectedType != type) || hide;
-        }
-        if (ui->lineEditDesc->currentText() != allAddressString) {
-            bool found = false;
-            for (QString selectedAddress : selectedAddresses)
-                if (address.contains(selectedAddress))
-                    found = true;
-            hide = !found || hide;
-        }
+    syncTime(ui->dateTimeEditTo, timeEditTo);
+    QStringList selectedAddresses;
+    if (ui->lineEditDesc->currentText() != allAddressString)
+        selectedAddresses = ui->lineEditDesc->lineEdit()->text().split(" | ");
+    // The whole history is listed until the user picks a date range
+    QDateTime dateFrom = fDateFilter ? ui->dateTimeEditFrom->dateTime() : QDateTime();
+    QDateTime dateTo = fDateFilter ? ui->dateTimeEditTo->dateTime() : QDateTime();
+    tableModel->setFilter(dateFrom, dateTo,
+        ui->comboBoxType->currentText(), selectedAddresses, ui->lineEditAmount->text().toFloat());
+    ui->tableView->setVisible(tableModel->rowCount(QModelIndex()));
+}
 
-        ui->tableView->setRowHidden(row, false);
-    }
+void HistoryPage::enableDateFilter()
+{
+    fDateFilter = true;
+    updateFilter();
 }
 
 void HistoryPage::syncTime(QDateTimeEdit* calendar, QTimeEdit* clock)
@@ -337,6 +234,10 @@ void HistoryPage::syncTime(QDateTimeEdit* calendar, QTimeEdit* clock)
 void HistoryPage::setModel(WalletModel* model)
 {
 	this->model = model;
+	if (!model) return;
+	tableModel = model->getTransactionHistoryModel();
+	ui->tableView->setModel(tableModel);
+	updateFilter();
 	connect(model, SIGNAL(WalletUnlocked()), this,
 	                                         SLOT(updateTableData()));
 }
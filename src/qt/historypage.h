@@ -7,7 +7,7 @@
 
 #include "guiutil.h"
 #include "togglebutton.h"
-#include "transactiontablemodel.h"
+#include "transactionhistorymodel.h"
 
 #include <QAbstractTableModel>
 #include <QDialog>
@@ -45,6 +45,7 @@ public:
 
 public slots:
     void updateFilter();
+    void enableDateFilter();
     void syncTime(QDateTimeEdit* calendar, QTimeEdit* clock);
     void txalert(QString, int, CAmount, QString, QString, QString);
 
@@ -56,7 +57,8 @@ private:
     Ui::HistoryPage* ui;
     GUIUtil::TableViewLastColumnResizingFixer* columnResizingFixer;
     WalletModel* model;
-    QAbstractTableModel* tableModel;
+    TransactionHistoryModel* tableModel;
+    bool fDateFilter;
 
     QTimeEdit* timeEditTo;
     QTimeEdit* timeEditFrom;
@@ -66,13 +68,11 @@ private:
     void initWidgets();
     void connectWidgets();
     virtual void resizeEvent(QResizeEvent* event);
-    void addTableData(std::map<QString, QString>);
-    void updateTableData(CWallet *wallet);
     void updateAddressBookData(CWallet *wallet);
     QTimer* updateHistoryTimer;
 
 public slots:
-    void on_cellClicked(int row, int column);
+    void on_doubleClicked(const QModelIndex& index);
     void updateTableData();
 };
 
@@ -164,7 +164,7 @@ void MasternodeList::StartAll(std::string strCommand)
     updateMyNodeList(true);
 }
 
-void MasternodeList::updateMyMasternodeInfo(QString strAlias, QString strAddr, CMasternode* pmn)
+void MasternodeList::updateMyMasternodeInfo(QString strAlias, QString strAddr, const CMasternode* pmn)
 {
     LOCK(cs_mnlistupdate);
     bool fOldRowFound = false;
@@ -210,14 +210,20 @@ void MasternodeList::updateMyNodeList(bool fForce)
         if (nSecondsTillUpdate > 0 && !fForce) return;
         nTimeMyListUpdated = GetTime();
 
+        // One pass over the published list instead of a locked lookup per entry
+        MasternodeListRef list = mnodeman.GetList();
+        std::map<COutPoint, const CMasternode*> mapListed;
+        BOOST_FOREACH (const CMasternode& mn, *list)
+            mapListed[mn.vin.prevout] = &mn;
+
         ui->tableWidgetMyMasternodes->setSortingEnabled(false);
         BOOST_FOREACH (CMasternodeConfig::CMasternodeEntry mne, masternodeConfig.getEntries()) {
             int nIndex;
             if(!mne.castOutputIndex(nIndex))
                 continue;
 
-            CTxIn txin = CTxIn(uint256S(mne.getTxHash()), uint32_t(nIndex));
-            CMasternode* pmn = mnodeman.Find(txin);
+            std::map<COutPoint, const CMasternode*>::const_iterator it = mapListed.find(COutPoint(uint256S(mne.getTxHash()), uint32_t(nIndex)));
+            const CMasternode* pmn = it != mapListed.end() ? it->second : NULL;
             updateMyMasternodeInfo(QString::fromStdString(mne.getAlias()), QString::fromStdString(mne.getIp()), pmn);
         }
         ui->tableWidgetMyMasternodes->setSortingEnabled(true);
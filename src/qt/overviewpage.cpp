@@ -447,41 +447,17 @@ void OverviewPage::updateRecentTransactions(){
         }
         if (pwalletMain) {
             {
-                vector<std::map<QString, QString>> txs;// = WalletUtil::getTXs(pwalletMain);
-
-                std::map<uint256, CWalletTx> txMap = pwalletMain->mapWallet;
-                std::vector<CWalletTx> latestTxes;
-                for (std::map<uint256, CWalletTx>::iterator tx = txMap.begin(); tx != txMap.end(); ++tx) {
-                    if (tx->second.GetDepthInMainChain() > 0) {
-                        int64_t txTime = tx->second.GetComputedTxTime();
-                        int idx = -1;
-                        for (int i = 0; i < (int)latestTxes.size(); i++) {
-                            if (txTime >= latestTxes[i].GetComputedTxTime()) {
-                                idx = i;
-                                break;
-                            }
-                        }
-                        if (idx == -1) {
-                            latestTxes.push_back(tx->second);
-                        } else {
-                            latestTxes.insert(latestTxes.begin() + idx, tx->second);
-                        }
-                    }
-                }
-
-                for (int i = 0; i < (int)latestTxes.size(); i++) {
-                    txs.push_back(WalletUtil::getTx(pwalletMain, latestTxes[i]));
-                    if (txs.size() >= 5) break;
-                }
+                // Newest first from the wallet's history index, only the shown rows are decoded
+                vector<std::map<QString, QString>> txs = WalletUtil::getRecentTXs(pwalletMain, 5);
 
-                int length = (txs.size()>5)? 5:txs.size();
+                int length = txs.size();
                 for (int i = 0; i< length; i++){
                     uint256 txHash;
                     txHash.SetHex(txs[i]["id"].toStdString());
                     TxEntry* entry = new TxEntry(this);
                     ui->verticalLayoutRecent->addWidget(entry);
-                    CWalletTx wtx = pwalletMain->mapWallet[txHash];
-                    int64_t txTime = wtx.GetComputedTxTime();
+                    const CWalletTx* pwtx = pwalletMain->GetWalletTxBody(txHash);
+                    int64_t txTime = pwtx ? pwtx->GetComputedTxTime() : 0;
                     if (pwalletMain->IsLocked()) {
                         entry->setData(txTime, "Locked; Hidden", "Locked; Hidden", "Locked; Hidden", "Locked; Hidden");
                     } else {
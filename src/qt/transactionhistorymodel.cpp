@@ -0,0 +1,407 @@
+// Copyright (c) 2018-2019 The DAPS Project developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include "transactionhistorymodel.h"
+
+#include "guiconstants.h"
+#include "walletmodel.h"
+
+#include "main.h"
+#include "sync.h"
+#include "ui_interface.h"
+#include "wallet.h"
+
+#include <algorithm>
+#include <limits>
+
+#include <QTimer>
+
+#include <boost/bind.hpp>
+
+/** Decoded rows kept around, the view only ever shows a screenful of them */
+static const size_t MAX_HISTORY_CACHE_SIZE = 1000;
+/** Rows a filter pass decodes per turn of the event loop */
+static const size_t HISTORY_FILTER_CHUNK_SIZE = 100;
+
+static bool NewestFirst(const std::pair<int64_t, uint256>& a, const std::pair<int64_t, uint256>& b)
+{
+    if (a.first != b.first)
+        return a.first > b.first;
+    return a.second < b.second;
+}
+
+TransactionHistoryModel::TransactionHistoryModel(CWallet* wallet, WalletModel* parent) : QAbstractTableModel(parent),
+                                                                                         wallet(wallet),
+                                                                                         walletModel(parent),
+                                                                                         fRetryScheduled(false),
+                                                                                         nFilterPos(0),
+                                                                                         fFilterScheduled(false),
+                                                                                         nFilterFrom(0),
+                                                                                         nFilterTo(std::numeric_limits<int64_t>::max()),
+                                                                                         nFilterMinAmount(0)
+{
+    columns << tr("Date") << tr("Type") << tr("Address/Description") << tr("Amount (DAPS)") << tr("Confirmations");
+
+    loadIndex();
+    applyFilter();
+
+    subscribeToCoreSignals();
+}
+
+TransactionHistoryModel::~TransactionHistoryModel()
+{
+    unsubscribeFromCoreSignals();
+}
+
+void TransactionHistoryModel::loadIndex()
+{
+    // Only transactions in the active chain are listed. Rather than asking every transaction for
+    // its depth under both locks, note the blocks under cs_wallet and look each block up once.
+    std::vector<std::pair<Entry, uint256> > vCandidates;
+    {
+        LOCK(wallet->cs_wallet);
+        vCandidates.reserve(wallet->setTxHistory.size());
+        for (std::set<std::pair<int64_t, uint256> >::reverse_iterator it = wallet->setTxHistory.rbegin(); it != wallet->setTxHistory.rend(); ++it) {
+            // Settled transactions are listed from their metadata, their bodies stay on disk
+            std::map<uint256, CWalletTx>::const_iterator mi = wallet->mapWallet.find(it->second);
+            std::map<uint256, CWalletTxMeta>::const_iterator ai = wallet->mapWalletArchive.find(it->second);
+            if (mi != wallet->mapWallet.end()) {
+                if (mi->second.hashBlock == 0 || mi->second.nIndex == -1)
+                    continue;
+                vCandidates.push_back(std::make_pair(*it, mi->second.hashBlock));
+            } else if (ai != wallet->mapWalletArchive.end() && ai->second.hashBlock != 0 && ai->second.nIndex != -1) {
+                vCandidates.push_back(std::make_pair(*it, ai->second.hashBlock));
+            }
+        }
+    }
+
+    std::map<uint256, bool> mapInActiveChain;
+    for (size_t i = 0; i < vCandidates.size(); i++)
+        mapInActiveChain[vCandidates[i].second] = false;
+    {
+        LOCK(cs_main);
+        for (std::map<uint256, bool>::iterator it = mapInActiveChain.begin(); it != mapInActiveChain.end(); ++it) {
+            BlockMap::const_iterator mi = mapBlockIndex.find(it->first);
+            it->second = mi != mapBlockIndex.end() && mi->second && chainActive.Contains(mi->second);
+        }
+    }
+
+    vIndex.clear();
+    mapIndexTime.clear();
+    cache.clear();
+    mapFilterFields.clear();
+    vIndex.reserve(vCandidates.size());
+    for (size_t i = 0; i < vCandidates.size(); i++) {
+        if (!mapInActiveChain[vCandidates[i].second])
+            continue;
+        vIndex.push_back(vCandidates[i].first);
+        mapIndexTime[vCandidates[i].first.second] = vCandidates[i].first.first;
+    }
+    // setTxHistory breaks ties by ascending hash, keep the order used for inserts
+    std::sort(vIndex.begin(), vIndex.end(), NewestFirst);
+}
+
+void TransactionHistoryModel::applyFilter()
+{
+    beginResetModel();
+    vRows.clear();
+    nFilterPos = 0;
+    endResetModel();
+    if (!fFilterScheduled)
+        filterNextChunk();
+}
+
+void TransactionHistoryModel::filterNextChunk()
+{
+    fFilterScheduled = false;
+
+    // Rows whose filter fields are known need no locks. The others are decoded a chunk at a
+    // time, and only when both locks are free, so the GUI thread never waits on the core.
+    TRY_LOCK(cs_main, lockMain);
+    TRY_LOCK(wallet->cs_wallet, lockWallet);
+    bool fLocked = lockMain && lockWallet;
+    std::vector<Entry> vMatched;
+    size_t nDecoded = 0;
+    while (nFilterPos < vIndex.size()) {
+        const Entry& entry = vIndex[nFilterPos];
+        if (!isFilterDecoded(entry)) {
+            if (!fLocked || nDecoded == HISTORY_FILTER_CHUNK_SIZE)
+                break;
+            nDecoded++;
+        }
+        if (matchesFilter(entry))
+            vMatched.push_back(entry);
+        nFilterPos++;
+    }
+
+    if (!vMatched.empty()) {
+        beginInsertRows(QModelIndex(), vRows.size(), vRows.size() + vMatched.size() - 1);
+        vRows.insert(vRows.end(), vMatched.begin(), vMatched.end());
+        endInsertRows();
+    }
+    if (nFilterPos < vIndex.size()) {
+        fFilterScheduled = true;
+        QTimer::singleShot(fLocked ? 0 : MODEL_UPDATE_DELAY, this, SLOT(filterNextChunk()));
+    }
+}
+
+void TransactionHistoryModel::refresh()
+{
+    loadIndex();
+    applyFilter();
+}
+
+void TransactionHistoryModel::setFilter(const QDateTime& dateFrom, const QDateTime& dateTo, const QString& type, const QStringList& addresses, double minAmount)
+{
+    // An invalid date leaves that end of the range open
+    nFilterFrom = dateFrom.isValid() ? dateFrom.toMSecsSinceEpoch() / 1000 : 0;
+    nFilterTo = dateTo.isValid() ? dateTo.toMSecsSinceEpoch() / 1000 : std::numeric_limits<int64_t>::max();
+    strFilterType = type;
+    filterAddresses = addresses;
+    nFilterMinAmount = minAmount;
+    applyFilter();
+}
+
+bool TransactionHistoryModel::hasFieldFilter() const
+{
+    return !(strFilterType.isEmpty() || strFilterType == tr("All Types")) || !filterAddresses.isEmpty() || nFilterMinAmount > 0;
+}
+
+bool TransactionHistoryModel::isFilterDecoded(const Entry& entry) const
+{
+    if (entry.first < nFilterFrom || entry.first > nFilterTo || !hasFieldFilter())
+        return true;
+    return mapFilterFields.count(entry.second) > 0;
+}
+
+bool TransactionHistoryModel::matchesFilter(const Entry& entry) const
+{
+    // The date comes with the index, everything else needs the row to have been decoded once
+    if (entry.first < nFilterFrom || entry.first > nFilterTo)
+        return false;
+    if (!hasFieldFilter())
+        return true;
+
+    std::map<uint256, FilterFields>::const_iterator fi = mapFilterFields.find(entry.second);
+    if (fi == mapFilterFields.end()) {
+        getRecord(entry.second);
+        fi = mapFilterFields.find(entry.second);
+    }
+    const QString& type = fi->second.type;
+    const QString& address = fi->second.address;
+
+    if (!strFilterType.isEmpty() && strFilterType != tr("All Types")) {
+        if (strFilterType == tr("Received")) {
+            if (!(type == tr("Received") || type == tr("Masternode Reward") || type == tr("Staking Reward") || type == tr("PoA Reward")))
+                return false;
+        } else if (strFilterType != type)
+            return false;
+    }
+    if (!filterAddresses.isEmpty()) {
+        bool found = false;
+        for (const QString& filterAddress : filterAddresses)
+            if (address.contains(filterAddress))
+                found = true;
+        if (!found)
+            return false;
+    }
+    return fi->second.amount >= nFilterMinAmount;
+}
+
+const std::map<QString, QString>& TransactionHistoryModel::getRecord(const uint256& hash) const
+{
+    std::map<uint256, std::map<QString, QString> >::iterator it = cache.find(hash);
+    if (it != cache.end())
+        return it->second;
+
+    if (cache.size() >= MAX_HISTORY_CACHE_SIZE)
+        cache.clear();
+    std::map<QString, QString>& rec = cache[hash];
+    {
+        LOCK(wallet->cs_wallet);
+        const CWalletTx* pwtx = wallet->GetWalletTxBody(hash);
+        if (pwtx)
+            rec = WalletUtil::getTx(wallet, *pwtx);
+    }
+
+    // Unlike the rows, the few fields the filter looks at are kept until the transaction changes
+    FilterFields& fields = mapFilterFields[hash];
+    std::map<QString, QString>::const_iterator it;
+    fields.type = (it = rec.find("type")) != rec.end() ? it->second : QString();
+    fields.address = (it = rec.find("address")) != rec.end() ? it->second : QString();
+    fields.amount = (it = rec.find("amount")) != rec.end() ? it->second.toFloat() : 0;
+    return rec;
+}
+
+int TransactionHistoryModel::rowCount(const QModelIndex& parent) const
+{
+    Q_UNUSED(parent);
+    return vRows.size();
+}
+
+int TransactionHistoryModel::columnCount(const QModelIndex& parent) const
+{
+    Q_UNUSED(parent);
+    return columns.length();
+}
+
+QVariant TransactionHistoryModel::data(const QModelIndex& index, int role) const
+{
+    if (!index.isValid() || index.row() < 0 || index.row() >= (int)vRows.size())
+        return QVariant();
+    const uint256& hash = vRows[index.row()].second;
+
+    if (role == TxHashRole)
+        return QString::fromStdString(hash.GetHex());
+    if (role != Qt::DisplayRole)
+        return QVariant();
+
+    if (cache.count(hash) == 0) {
+        // Never block the GUI thread on a busy core, the row is filled in on the next try
+        TRY_LOCK(cs_main, lockMain);
+        TRY_LOCK(wallet->cs_wallet, lockWallet);
+        if (!lockMain || !lockWallet) {
+            if (!fRetryScheduled) {
+                fRetryScheduled = true;
+                QTimer::singleShot(MODEL_UPDATE_DELAY, const_cast<TransactionHistoryModel*>(this), SLOT(emitRowsChanged()));
+            }
+            return QVariant();
+        }
+        getRecord(hash);
+    }
+    const std::map<QString, QString>& rec = cache[hash];
+    std::map<QString, QString>::const_iterator it;
+
+    switch (index.column()) {
+    case Date:
+        return (it = rec.find("date")) != rec.end() ? it->second : QString();
+    case Type:
+        return (it = rec.find("type")) != rec.end() ? it->second : QString();
+    case ToAddress:
+        return (it = rec.find("address")) != rec.end() ? it->second : QString();
+    case Amount:
+        if (wallet->IsLocked())
+            return QString("Locked; Hidden");
+        return (it = rec.find("amount")) != rec.end() ? it->second : QString();
+    case Confirmations:
+        return (it = rec.find("confirmations")) != rec.end() ? it->second.toInt() : 0;
+    }
+    return QVariant();
+}
+
+QVariant TransactionHistoryModel::headerData(int section, Qt::Orientation orientation, int role) const
+{
+    if (orientation == Qt::Horizontal && role == Qt::DisplayRole && section >= 0 && section < columns.length())
+        return columns[section];
+    return QVariant();
+}
+
+void TransactionHistoryModel::emitRowsChanged()
+{
+    fRetryScheduled = false;
+    if (!vRows.empty())
+        emit dataChanged(index(0, 0), index(vRows.size() - 1, columns.length() - 1));
+}
+
+void TransactionHistoryModel::updateConfirmations()
+{
+    AssertLockHeld(cs_main);
+    AssertLockHeld(wallet->cs_wallet);
+    // Rows are decoded again as they are shown, the row set itself only changes through updateTransaction
+    cache.clear();
+    emitRowsChanged();
+}
+
+void TransactionHistoryModel::updateTransaction(const QString& hash, int status)
+{
+    Q_UNUSED(status);
+    uint256 updated;
+    updated.SetHex(hash.toStdString());
+    setPending.insert(updated);
+    processPending();
+}
+
+void TransactionHistoryModel::processPending()
+{
+    if (setPending.empty())
+        return;
+    TRY_LOCK(cs_main, lockMain);
+    TRY_LOCK(wallet->cs_wallet, lockWallet);
+    if (!lockMain || !lockWallet) {
+        QTimer::singleShot(MODEL_UPDATE_DELAY, this, SLOT(processPending()));
+        return;
+    }
+
+    for (std::set<uint256>::const_iterator pit = setPending.begin(); pit != setPending.end(); ++pit) {
+        const uint256& hash = *pit;
+        cache.erase(hash);
+        mapFilterFields.erase(hash);
+
+        // Drop the old position, the transaction time may have changed
+        std::map<uint256, int64_t>::iterator ti = mapIndexTime.find(hash);
+        if (ti != mapIndexTime.end()) {
+            Entry old(ti->second, hash);
+            std::vector<Entry>::iterator it = std::lower_bound(vIndex.begin(), vIndex.end(), old, NewestFirst);
+            if (it != vIndex.end() && *it == old) {
+                if ((size_t)(it - vIndex.begin()) < nFilterPos)
+                    nFilterPos--;
+                vIndex.erase(it);
+            }
+            it = std::lower_bound(vRows.begin(), vRows.end(), old, NewestFirst);
+            if (it != vRows.end() && *it == old) {
+                int row = it - vRows.begin();
+                beginRemoveRows(QModelIndex(), row, row);
+                vRows.erase(it);
+                endRemoveRows();
+            }
+            mapIndexTime.erase(ti);
+        }
+
+        std::map<uint256, CWalletTx>::const_iterator mi = wallet->mapWallet.find(hash);
+        std::map<uint256, CWalletTxMeta>::const_iterator ai = wallet->mapWalletArchive.find(hash);
+        int64_t nTime;
+        if (mi != wallet->mapWallet.end() && mi->second.GetDepthInMainChain() > 0)
+            nTime = mi->second.GetTxTime();
+        else if (ai != wallet->mapWalletArchive.end() && wallet->GetArchivedDepth(ai->second) > 0)
+            nTime = ai->second.GetTxTime();
+        else
+            continue;
+        Entry entry(nTime, hash);
+        std::vector<Entry>::iterator pos = std::upper_bound(vIndex.begin(), vIndex.end(), entry, NewestFirst);
+        // A filter pass still running picks up entries past its position by itself
+        bool fFiltered = (size_t)(pos - vIndex.begin()) < nFilterPos || nFilterPos == vIndex.size();
+        vIndex.insert(pos, entry);
+        mapIndexTime[hash] = entry.first;
+        if (!fFiltered)
+            continue;
+        nFilterPos++;
+        if (matchesFilter(entry)) {
+            std::vector<Entry>::iterator it = std::upper_bound(vRows.begin(), vRows.end(), entry, NewestFirst);
+            int row = it - vRows.begin();
+            beginInsertRows(QModelIndex(), row, row);
+            vRows.insert(it, entry);
+            endInsertRows();
+        }
+    }
+    setPending.clear();
+}
+
+static void NotifyTransactionChanged(TransactionHistoryModel* thm, CWallet* wallet, const uint256& hash, ChangeType status)
+{
+    Q_UNUSED(wallet);
+    // Called with cs_wallet held, the model picks the change up on the GUI thread
+    QMetaObject::invokeMethod(thm, "updateTransaction", Qt::QueuedConnection,
+        Q_ARG(QString, QString::fromStdString(hash.GetHex())),
+        Q_ARG(int, status));
+}
+
+void TransactionHistoryModel::subscribeToCoreSignals()
+{
+    wallet->NotifyTransactionChanged.connect(boost::bind(NotifyTransactionChanged, this, _1, _2, _3));
+}
+
+void TransactionHistoryModel::unsubscribeFromCoreSignals()
+{
+    wallet->NotifyTransactionChanged.disconnect(boost::bind(NotifyTransactionChanged, this, _1, _2, _3));
+}
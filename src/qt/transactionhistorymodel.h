@@ -0,0 +1,127 @@
+// Copyright (c) 2018-2019 The DAPS Project developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#ifndef BITCOIN_QT_TRANSACTIONHISTORYMODEL_H
+#define BITCOIN_QT_TRANSACTIONHISTORYMODEL_H
+
+#include "uint256.h"
+
+#include <map>
+#include <set>
+#include <stdint.h>
+#include <utility>
+#include <vector>
+
+#include <QAbstractTableModel>
+#include <QDateTime>
+#include <QStringList>
+
+class WalletModel;
+
+class CWallet;
+
+/** UI model for the history page: the confirmed wallet transactions, newest first.
+ *
+ * The row order is read from the wallet's setTxHistory index, so building the
+ * model neither copies nor sorts mapWallet. A row is only decoded with
+ * WalletUtil::getTx when the view asks for it or when a type, address or
+ * amount filter first looks at it; the filter decodes in chunks whenever the
+ * locks are free and keeps the fields it needs, so changing the filter again
+ * decodes nothing. Wallet changes are applied to the affected rows only.
+ */
+class TransactionHistoryModel : public QAbstractTableModel
+{
+    Q_OBJECT
+
+public:
+    explicit TransactionHistoryModel(CWallet* wallet, WalletModel* parent = 0);
+    ~TransactionHistoryModel();
+
+    enum ColumnIndex {
+        Date = 0,
+        Type = 1,
+        ToAddress = 2,
+        Amount = 3,
+        Confirmations = 4
+    };
+
+    enum RoleIndex {
+        /** Transaction hash as hex string */
+        TxHashRole = Qt::UserRole
+    };
+
+    int rowCount(const QModelIndex& parent) const;
+    int columnCount(const QModelIndex& parent) const;
+    QVariant data(const QModelIndex& index, int role) const;
+    QVariant headerData(int section, Qt::Orientation orientation, int role) const;
+
+    /** Show the transactions between dateFrom and dateTo of the given type, to one of the addresses
+        (all when empty) and of at least minAmount. */
+    void setFilter(const QDateTime& dateFrom, const QDateTime& dateTo, const QString& type, const QStringList& addresses, double minAmount);
+    /** Decoded rows are stale after a new block, cs_main and cs_wallet must be held */
+    void updateConfirmations();
+
+public slots:
+    /** Reload the index and the filter, e.g. after the wallet was unlocked */
+    void refresh();
+    /* New transaction, or transaction changed status */
+    void updateTransaction(const QString& hash, int status);
+
+private slots:
+    void processPending();
+    void emitRowsChanged();
+    /** Continue the filter pass from nFilterPos */
+    void filterNextChunk();
+
+private:
+    /** (GetTxTime(), hash), ordered newest first */
+    typedef std::pair<int64_t, uint256> Entry;
+
+    /** What the type, address and amount filters compare against */
+    struct FilterFields {
+        QString type;
+        QString address;
+        double amount;
+
+        FilterFields() : amount(0) {}
+    };
+
+    CWallet* wallet;
+    WalletModel* walletModel;
+    QStringList columns;
+
+    std::vector<Entry> vIndex;
+    std::map<uint256, int64_t> mapIndexTime;
+    std::vector<Entry> vRows;
+    std::set<uint256> setPending;
+
+    mutable std::map<uint256, std::map<QString, QString> > cache;
+    mutable std::map<uint256, FilterFields> mapFilterFields;
+    mutable bool fRetryScheduled;
+    /** vIndex entries before this one have been filtered into vRows */
+    size_t nFilterPos;
+    bool fFilterScheduled;
+
+    int64_t nFilterFrom;
+    int64_t nFilterTo;
+    QString strFilterType;
+    QStringList filterAddresses;
+    double nFilterMinAmount;
+
+    /** Decoded row, cs_main and cs_wallet must be held */
+    const std::map<QString, QString>& getRecord(const uint256& hash) const;
+    /** Whether a type, address or amount filter is set */
+    bool hasFieldFilter() const;
+    /** Whether matchesFilter can decide on the entry without decoding it */
+    bool isFilterDecoded(const Entry& entry) const;
+    /** cs_main and cs_wallet must be held unless isFilterDecoded(entry) */
+    bool matchesFilter(const Entry& entry) const;
+    void loadIndex();
+    void applyFilter();
+
+    void subscribeToCoreSignals();
+    void unsubscribeFromCoreSignals();
+};
+
+#endif // BITCOIN_QT_TRANSACTIONHISTORYMODEL_H
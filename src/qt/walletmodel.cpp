@@ -12,6 +12,7 @@
 #include "guiconstants.h"
 #include "guiutil.h"
 #include "recentrequeststablemodel.h"
+#include "transactionhistorymodel.h"
 #include "transactionrecord.h"
 #include "transactiontablemodel.h"
 
@@ -40,6 +41,7 @@ using namespace std;
 
 WalletModel::WalletModel(CWallet* wallet, OptionsModel* optionsModel, QObject* parent) : QObject(parent), wallet(wallet), optionsModel(optionsModel), addressTableModel(0),
                                                                                          transactionTableModel(0),
+                                                                                         transactionHistoryModel(0),
                                                                                          recentRequestsTableModel(0),
                                                                                          cachedBalance(0), cachedUnconfirmedBalance(0), spendableBalance(0), cachedImmatureBalance(0), cachedWatchOnlyBalance(0),
                                                                                          cachedWatchUnconfBalance(0), cachedWatchImmatureBalance(0),
@@ -54,6 +56,7 @@ WalletModel::WalletModel(CWallet* wallet, OptionsModel* optionsModel, QObject* p
 
     addressTableModel = new AddressTableModel(wallet, this);
     transactionTableModel = new TransactionTableModel(wallet, this);
+    transactionHistoryModel = new TransactionHistoryModel(wallet, this);
     recentRequestsTableModel = new RecentRequestsTableModel(wallet, this);
 
     // This timer will be fired repeatedly to update the balance
@@ -155,6 +158,9 @@ void WalletModel::pollBalanceChanged()
         if (transactionTableModel) {
             transactionTableModel->updateConfirmations();
         }
+        if (transactionHistoryModel) {
+            transactionHistoryModel->updateConfirmations();
+        }
     } else {
         checkBalanceChanged();
     }
@@ -375,6 +381,11 @@ TransactionTableModel* WalletModel::getTransactionTableModel()
     return transactionTableModel;
 }
 
+TransactionHistoryModel* WalletModel::getTransactionHistoryModel()
+{
+    return transactionHistoryModel;
+}
+
 RecentRequestsTableModel* WalletModel::getRecentRequestsTableModel()
 {
     return recentRequestsTableModel;
@@ -721,7 +732,9 @@ namespace WalletUtil
 {
 std::map<QString, QString> getTx(CWallet* wallet, uint256 hash)
 {
-    return getTx(wallet, *wallet->GetWalletTx(hash));
+    LOCK(wallet->cs_wallet);
+    const CWalletTx* pwtx = wallet->GetWalletTxBody(hash);
+    return pwtx ? getTx(wallet, *pwtx) : std::map<QString, QString>();
 }
 
 vector<std::map<QString, QString> > getTXs(CWallet* wallet)
@@ -741,6 +754,19 @@ vector<std::map<QString, QString> > getTXs(CWallet* wallet)
     return txs;
 }
 
+vector<std::map<QString, QString> > getRecentTXs(CWallet* wallet, int nCount)
+{
+    vector<std::map<QString, QString> > txs;
+    if (!wallet) return txs;
+    LOCK2(cs_main, wallet->cs_wallet);
+    for (std::set<std::pair<int64_t, uint256> >::reverse_iterator it = wallet->setTxHistory.rbegin(); it != wallet->setTxHistory.rend() && (int)txs.size() < nCount; ++it) {
+        const CWalletTx* pwtx = wallet->GetWalletTxBody(it->second);
+        if (pwtx && pwtx->GetDepthInMainChain() > 0)
+            txs.push_back(getTx(wallet, *pwtx));
+    }
+    return txs;
+}
+
 std::map<QString, QString> getTx(CWallet* wallet, CWalletTx tx)
 {
 
@@ -751,7 +777,11 @@ std::map<QString, QString> getTx(CWallet* wallet, CWalletTx tx)
     	for (CTxIn in: tx.vin) {
     		COutPoint prevout = wallet->findMyOutPoint(in);
     		map<uint256, CWalletTx>::const_iterator mi = wallet->mapWallet.find(prevout.hash);
-    		if (mi != wallet->mapWallet.end()) {
+    		if (mi == wallet->mapWallet.end()) {
+    			// A settled input keeps its decoded value with its metadata
+    			LOCK(wallet->cs_wallet);
+    			totalIn += wallet->GetArchivedOutValue(prevout.hash, prevout.n);
+    		} else {
     			const CWalletTx& prev = (*mi).second;
     			if (prevout.n < prev.vout.size()) {
     				if (wallet->IsMine(prev.vout[prevout.n])) {
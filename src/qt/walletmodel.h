@@ -24,6 +24,7 @@
 class AddressTableModel;
 class OptionsModel;
 class RecentRequestsTableModel;
+class TransactionHistoryModel;
 class TransactionTableModel;
 class WalletModelTransaction;
 
@@ -132,6 +133,7 @@ public:
     OptionsModel* getOptionsModel();
     AddressTableModel* getAddressTableModel();
     TransactionTableModel* getTransactionTableModel();
+    TransactionHistoryModel* getTransactionHistoryModel();
     QAbstractTableModel* getTxTableModel();
     RecentRequestsTableModel* getRecentRequestsTableModel();
 
@@ -232,6 +234,7 @@ private:
 
     AddressTableModel* addressTableModel;
     TransactionTableModel* transactionTableModel;
+    TransactionHistoryModel* transactionHistoryModel;
     RecentRequestsTableModel* recentRequestsTableModel;
     QAbstractTableModel* txTableModel;
 
@@ -302,6 +305,8 @@ namespace WalletUtil
 {
 // get transaction string maps with keys ["date","address", "amount", "id", "type"]
 vector<std::map<QString, QString> > getTXs(CWallet* wallet);
+// the nCount most recent transactions in a block, newest first
+vector<std::map<QString, QString> > getRecentTXs(CWallet* wallet, int nCount);
 std::map<QString, QString> getTx(CWallet* wallet, uint256 hash);
 std::map<QString, QString> getTx(CWallet* wallet, CWalletTx tx);
 //
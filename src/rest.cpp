@@ -7,10 +7,12 @@
 #include "primitives/block.h"
 #include "primitives/transaction.h"
 #include "main.h"
+#include "script/standard.h"
 #include "httpserver.h"
 #include "rpcserver.h"
 #include "streams.h"
 #include "sync.h"
+#include "txdb.h"
 #include "txmempool.h"
 #include "utilstrencodings.h"
 #include "version.h"
@@ -20,6 +22,8 @@
 #include <boost/dynamic_bitset.hpp>
 
 static const size_t MAX_GETUTXOS_OUTPOINTS = 15; //allow a max of 15 outpoints to be queried at once
+static const size_t MAX_REST_KEYIMAGES = 10000; //allow a max of 10000 key images to be checked at once
+static const size_t MAX_REST_OUTPOINTS = 1000; //allow a max of 1000 ring members to be fetched at once
 
 using namespace std;
 
@@ -55,6 +59,44 @@ struct CCoin {
     }
 };
 
+struct CKeyImageStatus {
+    enum {
+        UNSPENT = 0,
+        SPENT = 1,
+        MEMPOOL = 2, // only reported with checkmempool
+    };
+
+    uint8_t nStatus;
+    int32_t nHeight; // -1 unless spent in the active chain
+    uint256 hashBlock;
+
+    ADD_SERIALIZE_METHODS;
+
+    template<typename Stream, typename Operation>
+    inline void SerializationOp(Stream &s, Operation ser_action, int nType, int nVersion) {
+        READWRITE(nStatus);
+        READWRITE(nHeight);
+        READWRITE(hashBlock);
+    }
+};
+
+struct CRingMember {
+    uint32_t nHeight;
+    bool fCoinBase; // coinbase, coinstake or coin audit output, needs maturity before it can be a decoy
+    CPubKey pubKey;
+    std::vector<unsigned char> commitment;
+
+    ADD_SERIALIZE_METHODS;
+
+    template<typename Stream, typename Operation>
+    inline void SerializationOp(Stream &s, Operation ser_action, int nType, int nVersion) {
+        READWRITE(nHeight);
+        READWRITE(fCoinBase);
+        READWRITE(pubKey);
+        READWRITE(commitment);
+    }
+};
+
 
 extern void TxToJSON(const CTransaction& tx, const uint256 hashBlock, UniValue& entry);
 
@@ -587,6 +629,375 @@ static bool rest_getutxos(HTTPRequest *req, const std::string &strURIPart) {
     return true; // continue to process further HTTP reqs on this cxn
 }
 
+static bool rest_keyimages(HTTPRequest *req, const std::string &strURIPart) {
+    if (!CheckWarmup(req))
+        return false;
+    vector <string> params;
+    enum RetFormat rf = ParseDataFormat(params, strURIPart);
+
+    vector <string> uriParts;
+    if (params.size() > 0 && params[0].length() > 1) {
+        std::string strUriParams = params[0].substr(1);
+        boost::split(uriParts, strUriParams, boost::is_any_of("/"));
+    }
+
+    std::string strRequestMutable = req->ReadBody();
+    if (strRequestMutable.length() == 0 && uriParts.size() == 0)
+        return RESTERR(req, HTTP_INTERNAL_SERVER_ERROR, "Error: empty request");
+
+    bool fInputParsed = false;
+    bool fCheckMemPool = false;
+    vector <CKeyImage> vKeyImages;
+
+    if (uriParts.size() > 0) {
+
+        //inputs are sent over URI scheme (/rest/keyimages/checkmempool/keyimage1/keyimage2/...)
+        if (uriParts[0] == "checkmempool")
+            fCheckMemPool = true;
+
+        for (size_t i = (fCheckMemPool) ? 1 : 0; i < uriParts.size(); i++) {
+            if (!IsHex(uriParts[i]))
+                return RESTERR(req, HTTP_INTERNAL_SERVER_ERROR, "Parse error");
+            std::vector<unsigned char> vch = ParseHex(uriParts[i]);
+            CKeyImage ki(vch.begin(), vch.end());
+            if (!ki.IsValid())
+                return RESTERR(req, HTTP_INTERNAL_SERVER_ERROR, "Parse error");
+            vKeyImages.push_back(ki);
+        }
+
+        if (vKeyImages.size() > 0)
+            fInputParsed = true;
+        else
+            return RESTERR(req, HTTP_INTERNAL_SERVER_ERROR, "Error: empty request");
+    }
+
+    switch (rf) {
+        case RF_HEX: {
+            // convert hex to bin, continue then with bin part
+            std::vector<unsigned char> strRequestV = ParseHex(strRequestMutable);
+            strRequestMutable.assign(strRequestV.begin(), strRequestV.end());
+        }
+
+        case RF_BINARY: {
+            try {
+                //deserialize only if user sent a request
+                if (strRequestMutable.size() > 0) {
+                    if (fInputParsed) //don't allow sending input over URI and HTTP RAW DATA
+                        return RESTERR(req, HTTP_INTERNAL_SERVER_ERROR,
+                                       "Combination of URI scheme inputs and raw post data is not allowed");
+
+                    CDataStream oss(SER_NETWORK, PROTOCOL_VERSION);
+                    oss << strRequestMutable;
+                    oss >> fCheckMemPool;
+                    oss >> vKeyImages;
+                }
+            } catch (const std::ios_base::failure &e) {
+                // abort in case of unreadable binary data
+                return RESTERR(req, HTTP_INTERNAL_SERVER_ERROR, "Parse error");
+            }
+            break;
+        }
+
+        case RF_JSON: {
+            if (!fInputParsed)
+                return RESTERR(req, HTTP_INTERNAL_SERVER_ERROR, "Error: empty request");
+            break;
+        }
+
+        default: {
+            return RESTERR(req, HTTP_NOT_FOUND,
+                           "output format not found (available: " + AvailableDataFormatsString() + ")");
+        }
+    }
+
+    if (vKeyImages.size() > MAX_REST_KEYIMAGES)
+        return RESTERR(req, HTTP_INTERNAL_SERVER_ERROR,
+                       strprintf("Error: max key images exceeded (max: %d, tried: %d)", MAX_REST_KEYIMAGES,
+                                 vKeyImages.size()));
+
+    // look every key image up in the key image index of the block tree db. The mempool is read first and
+    // the index before the chain, so a transaction mined meanwhile shows up in one of them.
+    std::set<CKeyImage> setMempoolKeyImages;
+    if (fCheckMemPool) {
+        LOCK(mempool.cs);
+        for (std::map<uint256, CTxMemPoolEntry>::const_iterator it = mempool.mapTx.begin(); it != mempool.mapTx.end(); ++it)
+            BOOST_FOREACH (const CTxIn& txin, it->second.GetTx().vin)
+                setMempoolKeyImages.insert(txin.keyImage);
+    }
+
+    // the database reads need no lock, cs_main is only held to match the spending blocks to the active chain
+    vector <vector <uint256> > vSpendBlocks(vKeyImages.size());
+    for (size_t i = 0; i < vKeyImages.size(); i++)
+        pblocktree->ReadKeyImages(vKeyImages[i].GetHex(), vSpendBlocks[i]);
+
+    vector <CKeyImageStatus> statuses(vKeyImages.size());
+    int nChainHeight;
+    uint256 hashChainTip;
+    {
+        LOCK(cs_main);
+        nChainHeight = chainActive.Height();
+        hashChainTip = chainActive.Tip()->GetBlockHash();
+
+        for (size_t i = 0; i < vKeyImages.size(); i++) {
+            CKeyImageStatus& status = statuses[i];
+            status.nStatus = CKeyImageStatus::UNSPENT;
+            status.nHeight = -1;
+            BOOST_FOREACH (const uint256& hashBlock, vSpendBlocks[i]) {
+                BlockMap::iterator mi = mapBlockIndex.find(hashBlock);
+                if (mi != mapBlockIndex.end() && mi->second && chainActive.Contains(mi->second)) {
+                    status.nStatus = CKeyImageStatus::SPENT;
+                    status.nHeight = mi->second->nHeight;
+                    status.hashBlock = hashBlock;
+                    break;
+                }
+            }
+        }
+    }
+    for (size_t i = 0; i < vKeyImages.size(); i++) {
+        if (statuses[i].nStatus == CKeyImageStatus::UNSPENT && setMempoolKeyImages.count(vKeyImages[i]))
+            statuses[i].nStatus = CKeyImageStatus::MEMPOOL;
+    }
+
+    switch (rf) {
+        case RF_BINARY:
+        case RF_HEX: {
+            CDataStream ssResponse(SER_NETWORK, PROTOCOL_VERSION);
+            ssResponse << nChainHeight << hashChainTip << statuses;
+
+            if (rf == RF_BINARY) {
+                req->WriteHeader("Content-Type", "application/octet-stream");
+                req->WriteReply(HTTP_OK, ssResponse.str());
+            } else {
+                req->WriteHeader("Content-Type", "text/plain");
+                req->WriteReply(HTTP_OK, HexStr(ssResponse.begin(), ssResponse.end()) + "\n");
+            }
+            return true;
+        }
+
+        case RF_JSON: {
+            UniValue objResponse(UniValue::VOBJ);
+            objResponse.push_back(Pair("chainHeight", nChainHeight));
+            objResponse.push_back(Pair("chaintipHash", hashChainTip.GetHex()));
+
+            UniValue keyimages(UniValue::VARR);
+            for (size_t i = 0; i < statuses.size(); i++) {
+                const CKeyImageStatus& status = statuses[i];
+                UniValue ki(UniValue::VOBJ);
+                ki.push_back(Pair("keyimage", vKeyImages[i].GetHex()));
+                ki.push_back(Pair("spent", status.nStatus == CKeyImageStatus::SPENT));
+                if (status.nStatus == CKeyImageStatus::SPENT) {
+                    ki.push_back(Pair("height", status.nHeight));
+                    ki.push_back(Pair("blockhash", status.hashBlock.GetHex()));
+                } else if (fCheckMemPool) {
+                    ki.push_back(Pair("mempool", status.nStatus == CKeyImageStatus::MEMPOOL));
+                }
+                keyimages.push_back(ki);
+            }
+            objResponse.push_back(Pair("keyimages", keyimages));
+
+            string strJSON = objResponse.write() + "\n";
+            req->WriteHeader("Content-Type", "application/json");
+            req->WriteReply(HTTP_OK, strJSON);
+            return true;
+        }
+        default: {
+            return RESTERR(req, HTTP_NOT_FOUND,  "output format not found (available: " + AvailableDataFormatsString() + ")");
+        }
+    }
+
+    // not reached
+    return true; // continue to process further HTTP reqs on this cxn
+}
+
+static bool rest_outpoints(HTTPRequest *req, const std::string &strURIPart) {
+    if (!CheckWarmup(req))
+        return false;
+    vector <string> params;
+    enum RetFormat rf = ParseDataFormat(params, strURIPart);
+
+    vector <string> uriParts;
+    if (params.size() > 0 && params[0].length() > 1) {
+        std::string strUriParams = params[0].substr(1);
+        boost::split(uriParts, strUriParams, boost::is_any_of("/"));
+    }
+
+    std::string strRequestMutable = req->ReadBody();
+    if (strRequestMutable.length() == 0 && uriParts.size() == 0)
+        return RESTERR(req, HTTP_INTERNAL_SERVER_ERROR, "Error: empty request");
+
+    bool fInputParsed = false;
+    vector <COutPoint> vOutPoints;
+
+    if (uriParts.size() > 0) {
+
+        //inputs are sent over URI scheme (/rest/outpoints/txid1-n/txid2-n/...)
+        for (size_t i = 0; i < uriParts.size(); i++) {
+            int32_t nOutput;
+            std::string strTxid = uriParts[i].substr(0, uriParts[i].find("-"));
+            std::string strOutput = uriParts[i].substr(uriParts[i].find("-") + 1);
+
+            uint256 txid;
+            if (!ParseInt32(strOutput, &nOutput) || nOutput < 0 || !ParseHashStr(strTxid, txid))
+                return RESTERR(req, HTTP_INTERNAL_SERVER_ERROR, "Parse error");
+
+            vOutPoints.push_back(COutPoint(txid, (uint32_t) nOutput));
+        }
+
+        if (vOutPoints.size() > 0)
+            fInputParsed = true;
+        else
+            return RESTERR(req, HTTP_INTERNAL_SERVER_ERROR, "Error: empty request");
+    }
+
+    switch (rf) {
+        case RF_HEX: {
+            // convert hex to bin, continue then with bin part
+            std::vector<unsigned char> strRequestV = ParseHex(strRequestMutable);
+            strRequestMutable.assign(strRequestV.begin(), strRequestV.end());
+        }
+
+        case RF_BINARY: {
+            try {
+                //deserialize only if user sent a request
+                if (strRequestMutable.size() > 0) {
+                    if (fInputParsed) //don't allow sending input over URI and HTTP RAW DATA
+                        return RESTERR(req, HTTP_INTERNAL_SERVER_ERROR,
+                                       "Combination of URI scheme inputs and raw post data is not allowed");
+
+                    CDataStream oss(SER_NETWORK, PROTOCOL_VERSION);
+                    oss << strRequestMutable;
+                    oss >> vOutPoints;
+                }
+            } catch (const std::ios_base::failure &e) {
+                // abort in case of unreadable binary data
+                return RESTERR(req, HTTP_INTERNAL_SERVER_ERROR, "Parse error");
+            }
+            break;
+        }
+
+        case RF_JSON: {
+            if (!fInputParsed)
+                return RESTERR(req, HTTP_INTERNAL_SERVER_ERROR, "Error: empty request");
+            break;
+        }
+
+        default: {
+            return RESTERR(req, HTTP_NOT_FOUND,
+                           "output format not found (available: " + AvailableDataFormatsString() + ")");
+        }
+    }
+
+    if (vOutPoints.size() > MAX_REST_OUTPOINTS)
+        return RESTERR(req, HTTP_INTERNAL_SERVER_ERROR,
+                       strprintf("Error: max outpoints exceeded (max: %d, tried: %d)", MAX_REST_OUTPOINTS,
+                                 vOutPoints.size()));
+
+    // decoys are usually drawn from few transactions, every transaction is looked up once per request.
+    // The reads go through the txindex and the mempool without cs_main.
+    std::map<uint256, std::pair<CTransaction, uint256> > mapTxs;
+    for (size_t i = 0; i < vOutPoints.size(); i++) {
+        if (mapTxs.count(vOutPoints[i].hash))
+            continue;
+        CTransaction tx;
+        uint256 hashBlock;
+        if (!LookupTransaction(vOutPoints[i].hash, tx, hashBlock))
+            hashBlock = 0;
+        mapTxs.insert(std::make_pair(vOutPoints[i].hash, std::make_pair(tx, hashBlock)));
+    }
+
+    // cs_main is only held to find the heights of the containing blocks in the active chain
+    std::map<uint256, int> mapBlockHeights;
+    int nChainHeight;
+    uint256 hashChainTip;
+    {
+        LOCK(cs_main);
+        nChainHeight = chainActive.Height();
+        hashChainTip = chainActive.Tip()->GetBlockHash();
+
+        for (std::map<uint256, std::pair<CTransaction, uint256> >::const_iterator it = mapTxs.begin(); it != mapTxs.end(); ++it) {
+            const uint256& hashBlock = it->second.second;
+            if (hashBlock == 0 || mapBlockHeights.count(hashBlock))
+                continue;
+            BlockMap::iterator mi = mapBlockIndex.find(hashBlock);
+            if (mi != mapBlockIndex.end() && mi->second && chainActive.Contains(mi->second))
+                mapBlockHeights[hashBlock] = mi->second->nHeight;
+        }
+    }
+
+    vector<unsigned char> bitmap;
+    vector <CRingMember> members;
+    std::string bitmapStringRepresentation;
+    boost::dynamic_bitset<unsigned char> hits(vOutPoints.size());
+    for (size_t i = 0; i < vOutPoints.size(); i++) {
+        const COutPoint& prevout = vOutPoints[i];
+        const std::pair<CTransaction, uint256>& entry = mapTxs[prevout.hash];
+
+        // only outputs confirmed in the active chain can be ring members
+        const CTransaction& tx = entry.first;
+        std::map<uint256, int>::const_iterator hi = mapBlockHeights.find(entry.second);
+        if (hi != mapBlockHeights.end() && prevout.n < tx.vout.size() && !tx.vout[prevout.n].IsEmpty()) {
+            const CTxOut& out = tx.vout[prevout.n];
+            CRingMember member;
+            member.nHeight = hi->second;
+            member.fCoinBase = tx.IsCoinBase() || tx.IsCoinStake() || tx.IsCoinAudit();
+            member.commitment = out.commitment;
+            if (ExtractPubKey(out.scriptPubKey, member.pubKey)) {
+                hits[i] = true;
+                members.push_back(member);
+            }
+        }
+
+        bitmapStringRepresentation.append(hits[i] ? "1" : "0");
+    }
+    boost::to_block_range(hits, std::back_inserter(bitmap));
+
+    switch (rf) {
+        case RF_BINARY:
+        case RF_HEX: {
+            CDataStream ssResponse(SER_NETWORK, PROTOCOL_VERSION);
+            ssResponse << nChainHeight << hashChainTip << bitmap << members;
+
+            if (rf == RF_BINARY) {
+                req->WriteHeader("Content-Type", "application/octet-stream");
+                req->WriteReply(HTTP_OK, ssResponse.str());
+            } else {
+                req->WriteHeader("Content-Type", "text/plain");
+                req->WriteReply(HTTP_OK, HexStr(ssResponse.begin(), ssResponse.end()) + "\n");
+            }
+            return true;
+        }
+
+        case RF_JSON: {
+            UniValue objResponse(UniValue::VOBJ);
+            objResponse.push_back(Pair("chainHeight", nChainHeight));
+            objResponse.push_back(Pair("chaintipHash", hashChainTip.GetHex()));
+            objResponse.push_back(Pair("bitmap", bitmapStringRepresentation));
+
+            UniValue outpoints(UniValue::VARR);
+            BOOST_FOREACH (const CRingMember& member, members) {
+                UniValue o(UniValue::VOBJ);
+                o.push_back(Pair("height", (int32_t) member.nHeight));
+                o.push_back(Pair("coinbase", member.fCoinBase));
+                o.push_back(Pair("pubkey", HexStr(member.pubKey.begin(), member.pubKey.end())));
+                o.push_back(Pair("commitment", HexStr(member.commitment)));
+                outpoints.push_back(o);
+            }
+            objResponse.push_back(Pair("outpoints", outpoints));
+
+            string strJSON = objResponse.write() + "\n";
+            req->WriteHeader("Content-Type", "application/json");
+            req->WriteReply(HTTP_OK, strJSON);
+            return true;
+        }
+        default: {
+            return RESTERR(req, HTTP_NOT_FOUND,  "output format not found (available: " + AvailableDataFormatsString() + ")");
+        }
+    }
+
+    // not reached
+    return true; // continue to process further HTTP reqs on this cxn
+}
+
 static const struct {
     const char *prefix;
     bool (*handler)(HTTPRequest* req, const std::string& strReq);
@@ -599,6 +1010,8 @@ static const struct {
         {"/rest/mempool/contents", rest_mempool_contents},
         {"/rest/headers/", rest_headers},
         {"/rest/getutxos", rest_getutxos},
+        {"/rest/keyimages", rest_keyimages},
+        {"/rest/outpoints", rest_outpoints},
 };
 
 bool StartREST()
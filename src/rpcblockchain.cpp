@@ -6,16 +6,20 @@
 // Distributed under the MIT software license, see the accompanying
 // file COPYING or http://www.opensource.org/licenses/mit-license.php.
 
+#include "blockimporter.h"
 #include "checkpoints.h"
 #include "main.h"
 #include "rpcserver.h"
 #include "sync.h"
 #include "util.h"
 #include "utilmoneystr.h"
+#include "utxosnapshot.h"
 #include "base58.h"
 
 #include <stdint.h>
 
+#include <boost/filesystem/operations.hpp>
+
 #include <univalue.h>
 #include "clientversion.h"
 
@@ -416,15 +420,16 @@ UniValue gettxoutsetinfo(const UniValue& params, bool fHelp)
         throw runtime_error(
             "gettxoutsetinfo\n"
             "\nReturns statistics about the unspent transaction output set.\n"
-            "Note this call may take some time.\n"
+            "The statistics are kept up to date as blocks are connected; a node upgraded from a version without them rebuilds them once at startup.\n"
             "\nResult:\n"
             "{\n"
             "  \"height\":n,     (numeric) The current block height (index)\n"
             "  \"bestblock\": \"hex\",   (string) the best block hash hex\n"
             "  \"transactions\": n,      (numeric) The number of transactions\n"
             "  \"txouts\": n,            (numeric) The number of output transactions\n"
-            "  \"bytes_serialized\": n,  (numeric) The serialized size\n"
-            "  \"hash_serialized\": \"hash\",   (string) The serialized hash\n"
+            "  \"bytes_serialized\": n,  (numeric) The serialized size of the outputs and their outpoints\n"
+            "  \"muhash\": \"hash\",      (string) The order independent hash of the outputs and their outpoints\n"
+            "  \"public_amount\": x.xxx,  (numeric) The total amount of the outputs, hidden amounts count as 0\n"
             "  \"total_amount\": x.xxx          (numeric) The total amount\n"
             "}\n"
             "\nExamples:\n" +
@@ -435,19 +440,98 @@ UniValue gettxoutsetinfo(const UniValue& params, bool fHelp)
     UniValue ret(UniValue::VOBJ);
 
     CCoinsStats stats;
-    FlushStateToDisk();
     if (pcoinsTip->GetStats(stats)) {
-        ret.push_back(Pair("height", (int64_t)stats.nHeight));
+        ret.push_back(Pair("height", (int64_t)chainActive.Height()));
         ret.push_back(Pair("bestblock", stats.hashBlock.GetHex()));
-        ret.push_back(Pair("transactions", (int64_t)stats.nTransactions));
-        ret.push_back(Pair("txouts", (int64_t)stats.nTransactionOutputs));
-        ret.push_back(Pair("bytes_serialized", (int64_t)stats.nSerializedSize));
-        ret.push_back(Pair("hash_serialized", stats.hashSerialized.GetHex()));
+        ret.push_back(Pair("transactions", stats.utxo.nTransactions));
+        ret.push_back(Pair("txouts", stats.utxo.nTransactionOutputs));
+        ret.push_back(Pair("bytes_serialized", stats.utxo.nSerializedSize));
+        ret.push_back(Pair("muhash", stats.utxo.muhash.Finalize().GetHex()));
+        ret.push_back(Pair("public_amount", ValueFromAmount(stats.utxo.nPublicAmount)));
         ret.push_back(Pair("total_amount", ValueFromAmount(chainActive.Tip()->nMoneySupply)));
     }
     return ret;
 }
 
+UniValue getsupplyinfo(const UniValue& params, bool fHelp)
+{
+    if (fHelp || params.size() != 0)
+        throw runtime_error(
+            "getsupplyinfo\n"
+            "\nCompares the money supply recorded in the block index with totals kept in the coin database.\n"
+            "The coins minted and the fees burned are summed from the transactions of each block when it is connected,\n"
+            "and computed again from the transactions when it is disconnected or the totals are rebuilt, while the block\n"
+            "index keeps the money supply ConnectBlock recorded for each block. On a node that connected every block itself\n"
+            "both follow from the same sums, so a mismatch points at a corrupt database or a bad UTXO snapshot.\n"
+            "\nResult:\n"
+            "{\n"
+            "  \"height\": n,           (numeric) The current block height\n"
+            "  \"bestblockhash\": \"hex\", (string) The best block hash\n"
+            "  \"moneysupply\": x.xxx,   (numeric) The money supply recorded in the block index\n"
+            "  \"minted\": x.xxx,        (numeric) The public value of the outputs of all blocks less their public inputs, fees included\n"
+            "  \"feesburned\": x.xxx,    (numeric) The fees destroyed by all blocks\n"
+            "  \"consistent\": true|false, (boolean) Whether minted less feesburned equals moneysupply\n"
+            "  \"maxsupply\": x.xxx      (numeric) The maximum money supply\n"
+            "}\n"
+            "\nExamples:\n" +
+            HelpExampleCli("getsupplyinfo", "") + HelpExampleRpc("getsupplyinfo", ""));
+
+    LOCK(cs_main);
+
+    CCoinsStats stats;
+    if (!pcoinsTip->GetStats(stats))
+        throw JSONRPCError(RPC_DATABASE_ERROR, "Unable to read UTXO statistics");
+
+    CBlockIndex* pindexTip = chainActive.Tip();
+    UniValue ret(UniValue::VOBJ);
+    ret.push_back(Pair("height", pindexTip->nHeight));
+    ret.push_back(Pair("bestblockhash", pindexTip->GetBlockHash().GetHex()));
+    ret.push_back(Pair("moneysupply", ValueFromAmount(pindexTip->nMoneySupply)));
+    ret.push_back(Pair("minted", ValueFromAmount(stats.utxo.nMinted)));
+    ret.push_back(Pair("feesburned", ValueFromAmount(stats.utxo.nFeesBurned)));
+    ret.push_back(Pair("consistent", stats.utxo.nMinted - stats.utxo.nFeesBurned == pindexTip->nMoneySupply));
+    ret.push_back(Pair("maxsupply", ValueFromAmount(Params().TOTAL_SUPPLY)));
+    return ret;
+}
+
+UniValue dumptxoutset(const UniValue& params, bool fHelp)
+{
+    if (fHelp || params.size() != 1)
+        throw runtime_error(
+            "dumptxoutset \"path\"\n"
+            "\nWrites the unspent transaction output set and the blocks of the active chain to a UTXO snapshot file.\n"
+            "A new node started with -loadtxoutset=<file> continues from the tip of the snapshot.\n"
+            "Note this call may take some time.\n"
+            "\nArguments:\n"
+            "1. \"path\"       (string, required) The file to write, relative to the data directory\n"
+            "\nResult:\n"
+            "{\n"
+            "  \"height\": n,            (numeric) The height of the snapshot's block\n"
+            "  \"bestblockhash\": \"hex\",  (string) The hash of the snapshot's block\n"
+            "  \"hash\": \"hex\",           (string) The hash of the snapshot, -loadtxoutset accepts the snapshots listed by hash in the chain parameters\n"
+            "  \"path\": \"path\"           (string) The file written\n"
+            "}\n"
+            "\nExamples:\n" +
+            HelpExampleCli("dumptxoutset", "\"utxo.dat\"") + HelpExampleRpc("dumptxoutset", "\"utxo.dat\""));
+
+    boost::filesystem::path path = boost::filesystem::absolute(params[0].get_str(), GetDataDir());
+    if (boost::filesystem::exists(path))
+        throw JSONRPCError(RPC_INVALID_PARAMETER, path.string() + " already exists");
+
+    CSnapshotHeader header;
+    uint256 hashSnapshot;
+    std::string strError;
+    if (!DumpTxOutSnapshot(path, header, hashSnapshot, strError))
+        throw JSONRPCError(RPC_MISC_ERROR, strError);
+
+    UniValue ret(UniValue::VOBJ);
+    ret.push_back(Pair("height", header.nHeight));
+    ret.push_back(Pair("bestblockhash", header.hashBlock.GetHex()));
+    ret.push_back(Pair("hash", hashSnapshot.GetHex()));
+    ret.push_back(Pair("path", path.string()));
+    return ret;
+}
+
 UniValue gettxout(const UniValue& params, bool fHelp)
 {
     if (fHelp || params.size() < 2 || params.size() > 3)
@@ -562,7 +646,14 @@ UniValue getblockchaininfo(const UniValue& params, bool fHelp)
             "  \"bestblockhash\": \"...\", (string) the hash of the currently best block\n"
             "  \"difficulty\": xxxxxx,     (numeric) the current difficulty\n"
             "  \"verificationprogress\": xxxx, (numeric) estimate of verification progress [0..1]\n"
-            "  \"chainwork\": \"xxxx\"     (string) total amount of work in active chain, in hexadecimal\n"
+            "  \"chainwork\": \"xxxx\",    (string) total amount of work in active chain, in hexadecimal\n"
+            "  \"import\": {               (object) only while -reindex, bootstrap.dat or -loadblock blocks are imported\n"
+            "    \"file\": \"xxxx\",        (string) name of the file being imported, empty between files\n"
+            "    \"filesdone\": xxxx,      (numeric) files imported so far\n"
+            "    \"files\": xxxx,          (numeric) files to import\n"
+            "    \"fileposition\": xxxx,   (numeric) bytes of the current file handed to validation\n"
+            "    \"filesize\": xxxx        (numeric) size of the current file in bytes\n"
+            "  }\n"
             "}\n"
             "\nExamples:\n" +
             HelpExampleCli("getblockchaininfo", "") + HelpExampleRpc("getblockchaininfo", ""));
@@ -577,6 +668,16 @@ UniValue getblockchaininfo(const UniValue& params, bool fHelp)
     obj.push_back(Pair("difficulty", (double)GetDifficulty()));
     obj.push_back(Pair("verificationprogress", Checkpoints::GuessVerificationProgress(chainActive.Tip())));
     obj.push_back(Pair("chainwork", chainActive.Tip()->nChainWork.GetHex()));
+    CImportProgress progress;
+    if (GetImportProgress(progress)) {
+        UniValue import(UniValue::VOBJ);
+        import.push_back(Pair("file", progress.strFile));
+        import.push_back(Pair("filesdone", progress.nFilesDone));
+        import.push_back(Pair("files", progress.nFiles));
+        import.push_back(Pair("fileposition", progress.nFilePos));
+        import.push_back(Pair("filesize", progress.nFileSize));
+        obj.push_back(Pair("import", import));
+    }
     return obj;
 }
 
@@ -18,7 +18,6 @@
 #include "wallet.h"
 
 #include <fstream>
-#include <secp256k1.h>
 #include <stdint.h>
 
 #include <boost/algorithm/string.hpp>
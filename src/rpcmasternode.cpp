@@ -309,14 +309,15 @@ UniValue listmasternodes(const UniValue& params, bool fHelp)
         if(!pindex) return 0;
         nHeight = pindex->nHeight;
     }
-    std::vector<pair<int, CMasternode> > vMasternodeRanks = mnodeman.GetMasternodeRanks(nHeight);
-    BOOST_FOREACH (PAIRTYPE(int, CMasternode) & s, vMasternodeRanks) {
+    MasternodeListRef list = mnodeman.GetList();
+    std::vector<pair<int, const CMasternode*> > vMasternodeRanks = mnodeman.GetMasternodeRanks(list, nHeight);
+    BOOST_FOREACH (PAIRTYPE(int, const CMasternode*) & s, vMasternodeRanks) {
         UniValue obj(UniValue::VOBJ);
-        std::string strVin = s.second.vin.prevout.ToStringShort();
-        std::string strTxHash = s.second.vin.prevout.hash.ToString();
-        uint32_t oIdx = s.second.vin.prevout.n;
+        std::string strVin = s.second->vin.prevout.ToStringShort();
+        std::string strTxHash = s.second->vin.prevout.hash.ToString();
+        uint32_t oIdx = s.second->vin.prevout.n;
 
-        CMasternode* mn = mnodeman.Find(s.second.vin);
+        const CMasternode* mn = s.second;
 
         if (mn != NULL) {
             if (strFilter != "" && strTxHash.find(strFilter) == string::npos &&
@@ -931,11 +932,11 @@ UniValue getmasternodescores (const UniValue& params, bool fHelp)
     }
     UniValue obj(UniValue::VOBJ);
 
-    std::vector<CMasternode> vMasternodes = mnodeman.GetFullMasternodeVector();
+    MasternodeListRef list = mnodeman.GetList();
     for (int nHeight = chainActive.Tip()->nHeight - nLast; nHeight < chainActive.Tip()->nHeight + 20; nHeight++) {
         uint256 nHigh = 0;
-        CMasternode* pBestMasternode = NULL;
-        BOOST_FOREACH (CMasternode& mn, vMasternodes) {
+        const CMasternode* pBestMasternode = NULL;
+        BOOST_FOREACH (const CMasternode& mn, *list) {
             uint256 n = mn.CalculateScore(1, nHeight - 100);
             if (n > nHigh) {
                 nHigh = n;
@@ -459,6 +459,75 @@ UniValue setmocktime(const UniValue& params, bool fHelp) {
     return NullUniValue;
 }
 
+UniValue getlockstats(const UniValue& params, bool fHelp)
+{
+    if (fHelp || params.size() > 3)
+        throw runtime_error(
+            "getlockstats ( \"lock\" count reset )\n"
+            "\nReturns the lock call sites with the highest total wait time (requires -lockstats)\n"
+            "\nArguments:\n"
+            "1. \"lock\"    (string, optional, default=\"\") Only sites locking a name containing this, e.g. \"cs_main\" or \"mempool.cs\"\n"
+            "2. count       (numeric, optional, default=20) The number of sites to return, 0 for all\n"
+            "3. reset       (boolean, optional, default=false) Clear the statistics after reading them\n"
+            "\nResult:\n"
+            "[\n"
+            "  {\n"
+            "    \"lock\": \"name\",        (string) the locked expression\n"
+            "    \"site\": \"file:line\",   (string) the LOCK or TRY_LOCK call site\n"
+            "    \"count\": n,            (numeric) acquisitions\n"
+            "    \"contended\": n,        (numeric) acquisitions that had to wait\n"
+            "    \"tryfailed\": n,        (numeric) TRY_LOCKs that did not get the lock\n"
+            "    \"wait_us\": n,          (numeric) total wait time in microseconds\n"
+            "    \"wait_max_us\": n,      (numeric) longest wait\n"
+            "    \"hold_us\": n,          (numeric) total hold time in microseconds\n"
+            "    \"hold_max_us\": n,      (numeric) longest hold\n"
+            "    \"wait_histogram\": [n,...], (array) entry 0 counts waits below 1us, entry i those of [2^(i-1), 2^i) us\n"
+            "    \"hold_histogram\": [n,...]  (array) the same for hold times\n"
+            "  },...\n"
+            "]\n"
+            "\nExamples:\n" +
+            HelpExampleCli("getlockstats", "\"cs_main\" 10") + HelpExampleRpc("getlockstats", "\"cs_main\", 10"));
+
+    if (!fLockStats)
+        throw JSONRPCError(RPC_MISC_ERROR, "Lock statistics are not recorded, restart with -lockstats");
+
+    std::string strLock = params.size() > 0 ? params[0].get_str() : "";
+    int nCount = params.size() > 1 ? params[1].get_int() : 20;
+    bool fReset = params.size() > 2 ? params[2].get_bool() : false;
+
+    std::vector<CLockSiteStats> vStats = GetLockStats();
+    if (fReset)
+        ResetLockStats();
+
+    UniValue result(UniValue::VARR);
+    BOOST_FOREACH (const CLockSiteStats& stats, vStats) {
+        if (nCount > 0 && (int)result.size() >= nCount)
+            break;
+        if (!strLock.empty() && stats.strName.find(strLock) == std::string::npos)
+            continue;
+        UniValue entry(UniValue::VOBJ);
+        entry.push_back(Pair("lock", stats.strName));
+        entry.push_back(Pair("site", strprintf("%s:%d", stats.strFile, stats.nLine)));
+        entry.push_back(Pair("count", stats.nCount));
+        entry.push_back(Pair("contended", stats.nContended));
+        entry.push_back(Pair("tryfailed", stats.nTryFailed));
+        entry.push_back(Pair("wait_us", stats.nWaitTotal));
+        entry.push_back(Pair("wait_max_us", stats.nWaitMax));
+        entry.push_back(Pair("hold_us", stats.nHoldTotal));
+        entry.push_back(Pair("hold_max_us", stats.nHoldMax));
+        UniValue waits(UniValue::VARR);
+        UniValue holds(UniValue::VARR);
+        for (int i = 0; i < LOCKSTATS_BUCKETS; i++) {
+            waits.push_back(stats.vWaitHist[i]);
+            holds.push_back(stats.vHoldHist[i]);
+        }
+        entry.push_back(Pair("wait_histogram", waits));
+        entry.push_back(Pair("hold_histogram", holds));
+        result.push_back(entry);
+    }
+    return result;
+}
+
 #ifdef ENABLE_WALLET
 UniValue getstakingstatus(const UniValue& params, bool fHelp)
 {
@@ -69,6 +69,31 @@ void WalletTxToJSON(const CWalletTx& wtx, UniValue& entry)
         entry.push_back(Pair(item.first, item.second));
 }
 
+/**
+ * Walks mapWallet and then the archived transactions, for tallies over the whole history.
+ * Archived bodies are read one at a time, the result of Next() is only valid until the next call.
+ */
+class CWalletTxWalker
+{
+private:
+    map<uint256, CWalletTx>::const_iterator itResident;
+    map<uint256, CWalletTxMeta>::const_iterator itArchived;
+    CWalletTx wtxArchived;
+
+public:
+    CWalletTxWalker() : itResident(pwalletMain->mapWallet.begin()), itArchived(pwalletMain->mapWalletArchive.begin()) {}
+
+    const CWalletTx* Next()
+    {
+        if (itResident != pwalletMain->mapWallet.end())
+            return &(itResident++)->second;
+        while (itArchived != pwalletMain->mapWalletArchive.end())
+            if (pwalletMain->ReadArchivedTx((itArchived++)->first, wtxArchived))
+                return &wtxArchived;
+        return NULL;
+    }
+};
+
 string AccountFromValue(const UniValue& value)
 {
     string strAccount = value.get_str();
@@ -557,8 +582,9 @@ UniValue getreceivedbyaddress(const UniValue& params, bool fHelp)
 
     // Tally
     CAmount nAmount = 0;
-    for (map<uint256, CWalletTx>::iterator it = pwalletMain->mapWallet.begin(); it != pwalletMain->mapWallet.end(); ++it) {
-        const CWalletTx& wtx = (*it).second;
+    CWalletTxWalker walker;
+    for (const CWalletTx* pwtx = walker.Next(); pwtx; pwtx = walker.Next()) {
+        const CWalletTx& wtx = *pwtx;
         if (wtx.IsCoinBase() || !IsFinalTx(wtx))
             continue;
 
@@ -603,8 +629,9 @@ UniValue getreceivedbyaccount(const UniValue& params, bool fHelp)
 
     // Tally
     CAmount nAmount = 0;
-    for (map<uint256, CWalletTx>::iterator it = pwalletMain->mapWallet.begin(); it != pwalletMain->mapWallet.end(); ++it) {
-        const CWalletTx& wtx = (*it).second;
+    CWalletTxWalker walker;
+    for (const CWalletTx* pwtx = walker.Next(); pwtx; pwtx = walker.Next()) {
+        const CWalletTx& wtx = *pwtx;
         if (wtx.IsCoinBase() || !IsFinalTx(wtx))
             continue;
 
@@ -625,8 +652,9 @@ CAmount GetAccountBalance(CWalletDB& walletdb, const string& strAccount, int nMi
     CAmount nBalance = 0;
 
     // Tally wallet transactions
-    for (map<uint256, CWalletTx>::iterator it = pwalletMain->mapWallet.begin(); it != pwalletMain->mapWallet.end(); ++it) {
-        const CWalletTx& wtx = (*it).second;
+    CWalletTxWalker walker;
+    for (const CWalletTx* pwtx = walker.Next(); pwtx; pwtx = walker.Next()) {
+        const CWalletTx& wtx = *pwtx;
         if (!IsFinalTx(wtx) || wtx.GetBlocksToMaturity() > 0 || wtx.GetDepthInMainChain() < 0)
             continue;
 
@@ -691,8 +719,9 @@ UniValue getbalance(const UniValue& params, bool fHelp)
         // (GetBalance() sums up all unspent TxOuts)
         // getbalance and "getbalance * 1 true" should return the same number
         CAmount nBalance = 0;
-        for (map<uint256, CWalletTx>::iterator it = pwalletMain->mapWallet.begin(); it != pwalletMain->mapWallet.end(); ++it) {
-            const CWalletTx& wtx = (*it).second;
+        CWalletTxWalker walker;
+        for (const CWalletTx* pwtx = walker.Next(); pwtx; pwtx = walker.Next()) {
+            const CWalletTx& wtx = *pwtx;
             if (!IsFinalTx(wtx) || wtx.GetBlocksToMaturity() > 0 || wtx.GetDepthInMainChain() < 0)
                 continue;
 
@@ -1031,8 +1060,9 @@ UniValue ListReceived(const UniValue& params, bool fByAccounts)
 
     // Tally
     map<CBitcoinAddress, tallyitem> mapTally;
-    for (map<uint256, CWalletTx>::iterator it = pwalletMain->mapWallet.begin(); it != pwalletMain->mapWallet.end(); ++it) {
-        const CWalletTx& wtx = (*it).second;
+    CWalletTxWalker walker;
+    for (const CWalletTx* pwtx = walker.Next(); pwtx; pwtx = walker.Next()) {
+        const CWalletTx& wtx = *pwtx;
 
         if (wtx.IsCoinBase() || !IsFinalTx(wtx))
             continue;
@@ -1357,8 +1387,21 @@ UniValue listtransactions(const UniValue& params, bool fHelp)
     std::list<CAccountingEntry> acentries;
     CWallet::TxItems txOrdered = pwalletMain->OrderedTxItems(acentries, strAccount);
 
+    // Settled transactions are merged in by their order position, only the bodies listed are read
+    multimap<int64_t, uint256> mapArchivedOrdered;
+    for (map<uint256, CWalletTxMeta>::const_iterator mi = pwalletMain->mapWalletArchive.begin(); mi != pwalletMain->mapWalletArchive.end(); ++mi)
+        mapArchivedOrdered.insert(make_pair(mi->second.nOrderPos, mi->first));
+    multimap<int64_t, uint256>::reverse_iterator ait = mapArchivedOrdered.rbegin();
+
     // iterate backwards until we have nCount items to return:
-    for (CWallet::TxItems::reverse_iterator it = txOrdered.rbegin(); it != txOrdered.rend(); ++it) {
+    for (CWallet::TxItems::reverse_iterator it = txOrdered.rbegin(); it != txOrdered.rend() || ait != mapArchivedOrdered.rend(); ) {
+        if (ait != mapArchivedOrdered.rend() && (it == txOrdered.rend() || ait->first > (*it).first)) {
+            CWalletTx wtxArchived;
+            if (pwalletMain->ReadArchivedTx((ait++)->second, wtxArchived))
+                ListTransactions(wtxArchived, strAccount, 0, true, ret, filter);
+            if ((int)ret.size() >= (nCount + nFrom)) break;
+            continue;
+        }
         CWalletTx* const pwtx = (*it).second.first;
         if (pwtx != 0)
             ListTransactions(*pwtx, strAccount, 0, true, ret, filter);
@@ -1366,6 +1409,7 @@ UniValue listtransactions(const UniValue& params, bool fHelp)
         if (pacentry != 0)
             AcentryToJSON(*pacentry, strAccount, ret);
 
+        ++it;
         if ((int)ret.size() >= (nCount + nFrom)) break;
     }
     // ret is newest to oldest
@@ -1432,8 +1476,9 @@ UniValue listaccounts(const UniValue& params, bool fHelp)
             mapAccountBalances[entry.second.name] = 0;
     }
 
-    for (map<uint256, CWalletTx>::iterator it = pwalletMain->mapWallet.begin(); it != pwalletMain->mapWallet.end(); ++it) {
-        const CWalletTx& wtx = (*it).second;
+    CWalletTxWalker walker;
+    for (const CWalletTx* pwtx = walker.Next(); pwtx; pwtx = walker.Next()) {
+        const CWalletTx& wtx = *pwtx;
         CAmount nFee;
         string strSentAccount;
         list<COutputEntry> listReceived;
@@ -1532,8 +1577,9 @@ UniValue listsinceblock(const UniValue& params, bool fHelp)
 
     UniValue transactions(UniValue::VARR);
 
-    for (map<uint256, CWalletTx>::iterator it = pwalletMain->mapWallet.begin(); it != pwalletMain->mapWallet.end(); it++) {
-        CWalletTx tx = (*it).second;
+    CWalletTxWalker walker;
+    for (const CWalletTx* pwtx = walker.Next(); pwtx; pwtx = walker.Next()) {
+        const CWalletTx& tx = *pwtx;
 
         if (depth == -1 || tx.GetDepthInMainChain(false) < depth)
             ListTransactions(tx, "*", 0, true, transactions, filter);
@@ -1596,9 +1642,11 @@ UniValue gettransaction(const UniValue& params, bool fHelp)
             filter = filter | ISMINE_WATCH_ONLY;
 
     UniValue entry(UniValue::VOBJ);
-    if (!pwalletMain->mapWallet.count(hash))
+    const CWalletTx* pwtx = pwalletMain->GetWalletTxBody(hash);
+    if (!pwtx)
         throw JSONRPCError(RPC_INVALID_ADDRESS_OR_KEY, "Invalid or non-wallet transaction id");
-    const CWalletTx& wtx = pwalletMain->mapWallet[hash];
+    // Copied, decoding the inputs below may read other archived bodies
+    const CWalletTx wtx = *pwtx;
 
     CAmount nCredit = wtx.GetCredit(filter);
     CAmount nDebit = wtx.GetDebit(filter);
@@ -2018,7 +2066,7 @@ UniValue getwalletinfo(const UniValue& params, bool fHelp)
     UniValue obj(UniValue::VOBJ);
     obj.push_back(Pair("walletversion", pwalletMain->GetVersion()));
     obj.push_back(Pair("balance", ValueFromAmount(pwalletMain->GetBalance())));
-    obj.push_back(Pair("txcount", (int)pwalletMain->mapWallet.size()));
+    obj.push_back(Pair("txcount", (int)(pwalletMain->mapWallet.size() + pwalletMain->mapWalletArchive.size())));
     obj.push_back(Pair("keypoololdest", pwalletMain->GetOldestKeyPoolTime()));
     obj.push_back(Pair("keypoolsize", (int)pwalletMain->GetKeyPoolSize()));
     if (pwalletMain->IsCrypted())
@@ -2667,6 +2715,7 @@ UniValue createprivacysubaddress(const UniValue& params, bool fHelp)
             account.viewAccount = viewAccount;
             account.spendAccount = spendAccount;
             walletdb.AppendStealthAccountList(label);
+            pwalletMain->ResetAccountKeyCache();
             break;
         }
     }
@@ -2777,6 +2826,94 @@ UniValue sendtostealthaddress(const UniValue& params, bool fHelp)
     return wtx.GetHash().GetHex();
 }
 
+UniValue sendtostealthaddresses(const UniValue& params, bool fHelp)
+{
+    if (fHelp || params.size() != 1)
+        throw runtime_error(
+                "sendtostealthaddresses [{\"address\":\"dapsstealthaddress\",\"amount\":x},...]\n"
+                "\nPay several daps stealth addresses at once, one transaction per payout. The wallet is scanned once\n"
+                "for all payouts and the ring signatures are created in parallel. Nothing is sent if a payout cannot be\n"
+                "built, but a payout the mempool rejects does not stop the others, so the sends can be partial.\n" +
+                HelpRequiringPassphrase() +
+                "\nArguments:\n"
+                "1. \"payouts\"     (array, required) A json array of payouts\n"
+                "    [\n"
+                "      {\n"
+                "        \"address\":\"dapsstealthaddress\",  (string, required) The dapscoin stealth address to send to\n"
+                "        \"amount\":x                       (numeric, required) The amount in DAPS to send. eg 0.1\n"
+                "      }\n"
+                "      ,...\n"
+                "    ]\n"
+                "\nResult:\n"
+                "{\n"
+                "  \"sent\": [               (array) The payouts that were broadcast\n"
+                "    {\n"
+                "      \"index\": n,         (numeric) The position of the payout in the array given\n"
+                "      \"address\": \"addr\",  (string) The stealth address paid\n"
+                "      \"txid\": \"hash\"      (string) The transaction id\n"
+                "    }\n"
+                "    ,...\n"
+                "  ],\n"
+                "  \"failed\": [             (array) The payouts the mempool rejected or the wallet could not store, nothing was sent for them\n"
+                "    {\n"
+                "      \"index\": n,         (numeric) The position of the payout in the array given\n"
+                "      \"address\": \"addr\",  (string) The stealth address\n"
+                "      \"error\": \"text\"     (string) Why it was not sent, the mempool's reject reason or \"wallet write failed\"\n"
+                "    }\n"
+                "    ,...\n"
+                "  ]\n"
+                "}\n"
+                "\nExamples:\n" +
+                HelpExampleCli("sendtostealthaddresses", "\"[{\\\"address\\\":\\\"41kYDmcd27f2ULWE6tfC19UnEHYpEhMBtfiYwVFUYbZhXrjLomZXSovQPGzwTCAgwQLpWiEQPA5uyNjmEVLPr4g71AUMNjaVD3n\\\",\\\"amount\\\":0.1}]\"") +
+                HelpExampleRpc("sendtostealthaddresses", "[{\"address\":\"41kYDmcd27f2ULWE6tfC19UnEHYpEhMBtfiYwVFUYbZhXrjLomZXSovQPGzwTCAgwQLpWiEQPA5uyNjmEVLPr4g71AUMNjaVD3n\",\"amount\":0.1}]"));
+
+    UniValue payouts = params[0].get_array();
+    if (payouts.empty() || payouts.size() > MAX_STEALTH_PAYOUTS)
+        throw JSONRPCError(RPC_INVALID_PARAMETER, strprintf("Invalid parameter, expected between 1 and %u payouts", MAX_STEALTH_PAYOUTS));
+
+    std::vector<std::pair<std::string, CAmount> > vecSend;
+    for (unsigned int idx = 0; idx < payouts.size(); idx++) {
+        const UniValue& payout = payouts[idx];
+        if (!payout.isObject())
+            throw JSONRPCError(RPC_INVALID_PARAMETER, "Invalid parameter, expected object");
+        const UniValue& o = payout.get_obj();
+        RPCTypeCheckObj(o, boost::assign::map_list_of("address", UniValue::VSTR));
+        CAmount nAmount = AmountFromValue(find_value(o, "amount"));
+        if (nAmount <= 0)
+            throw JSONRPCError(RPC_TYPE_ERROR, "Invalid amount for send");
+        vecSend.push_back(std::make_pair(find_value(o, "address").get_str(), nAmount));
+    }
+
+    EnsureWalletIsUnlocked();
+
+    std::vector<CWalletTx> vwtx;
+    std::vector<char> vSent;
+    std::vector<std::string> vRejectReason;
+    std::string strError;
+    if (!pwalletMain->SendToStealthAddresses(vecSend, vwtx, vSent, vRejectReason, strError))
+        throw JSONRPCError(RPC_WALLET_ERROR, strError);
+
+    // Payouts that went out are reported as sent even when others were rejected
+    UniValue sent(UniValue::VARR);
+    UniValue failed(UniValue::VARR);
+    for (size_t n = 0; n < vwtx.size(); n++) {
+        UniValue entry(UniValue::VOBJ);
+        entry.push_back(Pair("index", (int64_t)n));
+        entry.push_back(Pair("address", vecSend[n].first));
+        if (vSent[n]) {
+            entry.push_back(Pair("txid", vwtx[n].GetHash().GetHex()));
+            sent.push_back(entry);
+        } else {
+            entry.push_back(Pair("error", vRejectReason[n]));
+            failed.push_back(entry);
+        }
+    }
+    UniValue ret(UniValue::VOBJ);
+    ret.push_back(Pair("sent", sent));
+    ret.push_back(Pair("failed", failed));
+    return ret;
+}
+
 UniValue setdecoyconfirmation(const UniValue& params, bool fHelp)
 {
     if (fHelp || params.size() != 1)
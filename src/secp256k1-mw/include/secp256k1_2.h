@@ -653,6 +653,40 @@ SECP256K1_API SECP256K1_WARN_UNUSED_RESULT int secp256k1_ec_pubkey_combine2(
     size_t n
 ) SECP256K1_ARG_NONNULL(2) SECP256K1_ARG_NONNULL(3);
 
+/** Verify a batch of Schnorr proofs of key image ownership.
+ *
+ *  Proof i claims s_i*H_i = R_i + e_i*I_i, where H_i is the point hashed from
+ *  the spent output key, R_i the commitment, I_i the key image and e_i the
+ *  challenge. The equations are weighted with scalars derived from a hash of
+ *  all inputs and checked with a single multi-scalar multiplication, so the
+ *  batch only passes if every proof is valid (except with negligible
+ *  probability).
+ *
+ *  Returns: 1: all proofs are valid.
+ *           0: a proof is invalid, a scalar is zero or out of range, or the
+ *              scratch space is too small.
+ *  Args:    ctx:       pointer to a context object initialized for verification
+ *                      (cannot be NULL)
+ *           scratch:   scratch space for the multi-scalar multiplication
+ *                      (cannot be NULL)
+ *  In:      hashed:    array of n pointers to the points H_i
+ *           s:         array of n pointers to the 32-byte responses s_i
+ *           r:         array of n pointers to the commitments R_i
+ *           challenge: array of n pointers to the 32-byte challenges e_i
+ *           keyimage:  array of n pointers to the key images I_i
+ *           n:         the number of proofs
+ */
+SECP256K1_API SECP256K1_WARN_UNUSED_RESULT int secp256k1_keyimage_schnorr_verify_batch(
+    const secp256k1_context2* ctx,
+    secp256k1_scratch_space2* scratch,
+    const secp256k1_pubkey2 * const * hashed,
+    const unsigned char * const * s,
+    const secp256k1_pubkey2 * const * r,
+    const unsigned char * const * challenge,
+    const secp256k1_pubkey2 * const * keyimage,
+    size_t n
+) SECP256K1_ARG_NONNULL(1) SECP256K1_ARG_NONNULL(2);
+
 #ifdef __cplusplus
 }
 #endif
@@ -616,6 +616,82 @@ int secp256k1_ec_pubkey_combine2(const secp256k1_context2* ctx, secp256k1_pubkey
     return 1;
 }
 
+typedef struct {
+    const secp256k1_context2* ctx;
+    /* H_i, R_i and I_i, point idx is points[idx % 3][idx / 3] */
+    const secp256k1_pubkey2 * const * points[3];
+    const secp256k1_scalar *sc;
+} secp256k1_keyimage_batch_ecmult_data;
+
+static int secp256k1_keyimage_batch_ecmult_callback(secp256k1_scalar *sc, secp256k1_ge *pt, size_t idx, void *cbdata) {
+    secp256k1_keyimage_batch_ecmult_data *data = (secp256k1_keyimage_batch_ecmult_data *) cbdata;
+    *sc = data->sc[idx];
+    return secp256k1_pubkey2_load(data->ctx, pt, data->points[idx % 3][idx / 3]);
+}
+
+int secp256k1_keyimage_schnorr_verify_batch(const secp256k1_context2* ctx, secp256k1_scratch_space2* scratch, const secp256k1_pubkey2 * const *hashed, const unsigned char * const *s, const secp256k1_pubkey2 * const *r, const unsigned char * const *challenge, const secp256k1_pubkey2 * const *keyimage, size_t n) {
+    secp256k1_keyimage_batch_ecmult_data data;
+    secp256k1_sha256 sha;
+    unsigned char seed[32];
+    secp256k1_scalar z[2];
+    secp256k1_scalar *sc;
+    secp256k1_gej rj;
+    size_t i;
+    int ret = 1;
+
+    VERIFY_CHECK(ctx != NULL);
+    ARG_CHECK(secp256k1_ecmult_context_is_built(&ctx->ecmult_ctx));
+    ARG_CHECK(scratch != NULL);
+    ARG_CHECK(n == 0 || (hashed != NULL && s != NULL && r != NULL && challenge != NULL && keyimage != NULL));
+    if (n == 0) {
+        return 1;
+    }
+
+    /* The weights depend on every proof, so no proof can be chosen to cancel out another */
+    secp256k1_sha256_initialize(&sha);
+    for (i = 0; i < n; i++) {
+        secp256k1_sha256_write(&sha, hashed[i]->data, sizeof(hashed[i]->data));
+        secp256k1_sha256_write(&sha, s[i], 32);
+        secp256k1_sha256_write(&sha, r[i]->data, sizeof(r[i]->data));
+        secp256k1_sha256_write(&sha, challenge[i], 32);
+        secp256k1_sha256_write(&sha, keyimage[i]->data, sizeof(keyimage[i]->data));
+    }
+    secp256k1_sha256_finalize(&sha, seed);
+
+    if (!secp256k1_scratch_allocate_frame(scratch, 3 * n * sizeof(secp256k1_scalar), 1)) {
+        return 0;
+    }
+    sc = (secp256k1_scalar *) secp256k1_scratch_alloc(scratch, 3 * n * sizeof(secp256k1_scalar));
+
+    /* z_i*s_i*H_i - z_i*R_i - z_i*e_i*I_i summed over all proofs is infinity */
+    for (i = 0; i < n && ret; i++) {
+        secp256k1_scalar si, ei;
+        int overflow;
+        secp256k1_scalar_set_b32(&si, s[i], &overflow);
+        ret = !overflow && !secp256k1_scalar_is_zero(&si);
+        secp256k1_scalar_set_b32(&ei, challenge[i], &overflow);
+        ret = ret && !overflow && !secp256k1_scalar_is_zero(&ei);
+        if (i % 2 == 0) {
+            secp256k1_scalar_chacha20(&z[0], &z[1], seed, i / 2);
+        }
+        secp256k1_scalar_mul(&sc[3 * i], &z[i % 2], &si);
+        secp256k1_scalar_negate(&sc[3 * i + 1], &z[i % 2]);
+        secp256k1_scalar_mul(&sc[3 * i + 2], &sc[3 * i + 1], &ei);
+    }
+
+    if (ret) {
+        data.ctx = ctx;
+        data.points[0] = hashed;
+        data.points[1] = r;
+        data.points[2] = keyimage;
+        data.sc = sc;
+        ret = secp256k1_ecmult_multi_var(&ctx->ecmult_ctx, scratch, &rj, NULL, secp256k1_keyimage_batch_ecmult_callback, (void *) &data, 3 * n) &&
+              secp256k1_gej_is_infinity(&rj);
+    }
+    secp256k1_scratch_deallocate_frame(scratch);
+    return ret;
+}
+
 #ifdef ENABLE_MODULE_ECDH
 # include "modules/ecdh/main_impl.h"
 #endif
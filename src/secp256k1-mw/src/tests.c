@@ -2333,6 +2333,79 @@ void run_ec_combine(void) {
     }
 }
 
+void test_keyimage_schnorr_verify_batch(void) {
+    secp256k1_scratch_space2 *scratch = secp256k1_scratch_space_create(ctx, 1024 * 1024);
+    secp256k1_pubkey2 hashed[16], r[16], keyimage[16];
+    unsigned char s[16][32], challenge[16][32];
+    const secp256k1_pubkey2 *hashedp[16], *rp[16], *keyimagep[16];
+    const unsigned char *sp[16], *challengep[16];
+    const unsigned char zero[32] = {0};
+    size_t n = 1 + secp256k1_rand_int(16);
+    size_t i;
+
+    for (i = 0; i < n; i++) {
+        secp256k1_scalar h, x, alpha, e, sc;
+        secp256k1_gej pj;
+        secp256k1_ge p;
+        random_scalar_order_test(&h);
+        random_scalar_order_test(&x);
+        random_scalar_order_test(&alpha);
+        random_scalar_order_test(&e);
+
+        /* H = h*G, I = x*H, R = alpha*H and s = alpha + e*x */
+        secp256k1_ecmult_gen(&ctx->ecmult_gen_ctx, &pj, &h);
+        secp256k1_ge_set_gej(&p, &pj);
+        secp256k1_pubkey2_save(&hashed[i], &p);
+        secp256k1_scalar_mul(&sc, &h, &x);
+        secp256k1_ecmult_gen(&ctx->ecmult_gen_ctx, &pj, &sc);
+        secp256k1_ge_set_gej(&p, &pj);
+        secp256k1_pubkey2_save(&keyimage[i], &p);
+        secp256k1_scalar_mul(&sc, &h, &alpha);
+        secp256k1_ecmult_gen(&ctx->ecmult_gen_ctx, &pj, &sc);
+        secp256k1_ge_set_gej(&p, &pj);
+        secp256k1_pubkey2_save(&r[i], &p);
+        secp256k1_scalar_mul(&sc, &e, &x);
+        secp256k1_scalar_add(&sc, &sc, &alpha);
+        secp256k1_scalar_get_b32(s[i], &sc);
+        secp256k1_scalar_get_b32(challenge[i], &e);
+
+        hashedp[i] = &hashed[i];
+        sp[i] = s[i];
+        rp[i] = &r[i];
+        challengep[i] = challenge[i];
+        keyimagep[i] = &keyimage[i];
+    }
+    CHECK(secp256k1_keyimage_schnorr_verify_batch(ctx, scratch, hashedp, sp, rp, challengep, keyimagep, n) == 1);
+    CHECK(secp256k1_keyimage_schnorr_verify_batch(ctx, scratch, NULL, NULL, NULL, NULL, NULL, 0) == 1);
+
+    /* One bad proof fails the whole batch */
+    i = secp256k1_rand_int(n);
+    s[i][31] ^= 1;
+    CHECK(secp256k1_keyimage_schnorr_verify_batch(ctx, scratch, hashedp, sp, rp, challengep, keyimagep, n) == 0);
+    s[i][31] ^= 1;
+    if (n > 1) {
+        keyimagep[i] = &keyimage[(i + 1) % n];
+        CHECK(secp256k1_keyimage_schnorr_verify_batch(ctx, scratch, hashedp, sp, rp, challengep, keyimagep, n) == 0);
+        keyimagep[i] = &keyimage[i];
+    }
+
+    /* Zero and out of range scalars are rejected */
+    challengep[i] = zero;
+    CHECK(secp256k1_keyimage_schnorr_verify_batch(ctx, scratch, hashedp, sp, rp, challengep, keyimagep, n) == 0);
+    challengep[i] = challenge[i];
+    memset(s[i], 0xff, 32);
+    CHECK(secp256k1_keyimage_schnorr_verify_batch(ctx, scratch, hashedp, sp, rp, challengep, keyimagep, n) == 0);
+
+    secp256k1_scratch_space_destroy(scratch);
+}
+
+void run_keyimage_schnorr_verify_batch(void) {
+    int i;
+    for (i = 0; i < count; i++) {
+        test_keyimage_schnorr_verify_batch();
+    }
+}
+
 void test_group_decompress(const secp256k1_fe* x) {
     /* The input itself, normalized. */
     secp256k1_fe fex = *x;
@@ -5169,6 +5242,7 @@ int main(int argc, char **argv) {
     run_ecmult_const_tests();
     run_ecmult_multi_tests();
     run_ec_combine();
+    run_keyimage_schnorr_verify_batch();
 
     /* endomorphism tests */
 #ifdef USE_ENDOMORPHISM
@@ -7,11 +7,124 @@
 #include "util.h"
 #include "utilstrencodings.h"
 
+#include <algorithm>
+#include <map>
 #include <stdio.h>
 
 #include <boost/foreach.hpp>
 #include <boost/thread.hpp>
 
+bool fLockStats = false;
+
+//
+// Lock contention statistics (-lockstats).
+// Every LOCK and TRY_LOCK reports its wait and hold time when it releases
+// the lock. Sites are keyed by the pointers to their name and __FILE__
+// strings, and merged by name when read, as a header may have a copy of
+// __FILE__ in every translation unit.
+//
+
+typedef std::pair<std::pair<const char*, const char*>, int> LockSiteKey;
+
+static boost::mutex lockstats_mutex;
+static std::map<LockSiteKey, CLockSiteStats> mapLockStats;
+
+static int LockStatsBucket(int64_t nMicros)
+{
+    int nBucket = 0;
+    while (nMicros > 0 && nBucket < LOCKSTATS_BUCKETS - 1) {
+        nMicros >>= 1;
+        nBucket++;
+    }
+    return nBucket;
+}
+
+CLockSiteStats::CLockSiteStats() : nLine(0), nCount(0), nContended(0), nTryFailed(0), nWaitTotal(0), nWaitMax(0), nHoldTotal(0), nHoldMax(0)
+{
+    std::fill(vWaitHist, vWaitHist + LOCKSTATS_BUCKETS, 0);
+    std::fill(vHoldHist, vHoldHist + LOCKSTATS_BUCKETS, 0);
+}
+
+void CLockSiteStats::Add(const CLockSiteStats& other)
+{
+    nCount += other.nCount;
+    nContended += other.nContended;
+    nTryFailed += other.nTryFailed;
+    nWaitTotal += other.nWaitTotal;
+    nWaitMax = std::max(nWaitMax, other.nWaitMax);
+    nHoldTotal += other.nHoldTotal;
+    nHoldMax = std::max(nHoldMax, other.nHoldMax);
+    for (int i = 0; i < LOCKSTATS_BUCKETS; i++) {
+        vWaitHist[i] += other.vWaitHist[i];
+        vHoldHist[i] += other.vHoldHist[i];
+    }
+}
+
+void RecordLockStats(const char* pszName, const char* pszFile, int nLine, bool fAcquired, int64_t nWaitMicros, int64_t nHoldMicros)
+{
+    boost::unique_lock<boost::mutex> lock(lockstats_mutex);
+    CLockSiteStats& stats = mapLockStats[std::make_pair(std::make_pair(pszName, pszFile), nLine)];
+    if (!fAcquired) {
+        stats.nTryFailed++;
+        return;
+    }
+    stats.nCount++;
+    if (nWaitMicros > 0)
+        stats.nContended++;
+    stats.nWaitTotal += nWaitMicros;
+    stats.nWaitMax = std::max(stats.nWaitMax, nWaitMicros);
+    stats.nHoldTotal += nHoldMicros;
+    stats.nHoldMax = std::max(stats.nHoldMax, nHoldMicros);
+    stats.vWaitHist[LockStatsBucket(nWaitMicros)]++;
+    stats.vHoldHist[LockStatsBucket(nHoldMicros)]++;
+}
+
+static bool CompareLockWait(const CLockSiteStats& a, const CLockSiteStats& b)
+{
+    return a.nWaitTotal > b.nWaitTotal;
+}
+
+std::vector<CLockSiteStats> GetLockStats()
+{
+    std::map<std::pair<std::pair<std::string, std::string>, int>, CLockSiteStats> mapMerged;
+    {
+        boost::unique_lock<boost::mutex> lock(lockstats_mutex);
+        for (std::map<LockSiteKey, CLockSiteStats>::const_iterator it = mapLockStats.begin(); it != mapLockStats.end(); ++it) {
+            CLockSiteStats& stats = mapMerged[std::make_pair(std::make_pair(std::string(it->first.first.first), std::string(it->first.first.second)), it->first.second)];
+            stats.Add(it->second);
+        }
+    }
+
+    std::vector<CLockSiteStats> vStats;
+    vStats.reserve(mapMerged.size());
+    for (std::map<std::pair<std::pair<std::string, std::string>, int>, CLockSiteStats>::iterator it = mapMerged.begin(); it != mapMerged.end(); ++it) {
+        it->second.strName = it->first.first.first;
+        it->second.strFile = it->first.first.second;
+        it->second.nLine = it->first.second;
+        vStats.push_back(it->second);
+    }
+    std::sort(vStats.begin(), vStats.end(), CompareLockWait);
+    return vStats;
+}
+
+void ResetLockStats()
+{
+    boost::unique_lock<boost::mutex> lock(lockstats_mutex);
+    mapLockStats.clear();
+}
+
+void LogLockStats(int nSites)
+{
+    std::vector<CLockSiteStats> vStats = GetLockStats();
+    LogPrintf("Lock statistics, %u sites, most contended first:\n", vStats.size());
+    for (int i = 0; i < nSites && i < (int)vStats.size(); i++) {
+        const CLockSiteStats& stats = vStats[i];
+        LogPrintf("  %s %s:%d: %u locks, %u contended, %u failed tries, wait %.2fms (max %.2fms), hold %.2fms (max %.2fms)\n",
+            stats.strName, stats.strFile, stats.nLine, stats.nCount, stats.nContended, stats.nTryFailed,
+            stats.nWaitTotal * 0.001, stats.nWaitMax * 0.001, stats.nHoldTotal * 0.001, stats.nHoldMax * 0.001);
+    }
+}
+
 #ifdef DEBUG_LOCKCONTENTION
 void PrintLockContention(const char* pszName, const char* pszFile, int nLine)
 {
@@ -7,6 +7,10 @@
 #define BITCOIN_SYNC_H
 
 #include "threadsafety.h"
+#include "utiltime.h"
+
+#include <string>
+#include <vector>
 
 #include <boost/thread/condition_variable.hpp>
 #include <boost/thread/locks.hpp>
@@ -104,6 +108,42 @@ void static inline AssertLockHeldInternal(const char* pszName, const char* pszFi
 void PrintLockContention(const char* pszName, const char* pszFile, int nLine);
 #endif
 
+/** Default for -lockstatsinterval, seconds between lock statistics dumps to debug.log */
+static const int64_t DEFAULT_LOCKSTATS_INTERVAL = 600;
+/** Number of lock sites in the periodic debug.log dump */
+static const int LOCKSTATS_LOG_SITES = 10;
+/** Histogram buckets: bucket 0 counts times below 1us, bucket n those in [2^(n-1), 2^n) us, the last one the rest */
+static const int LOCKSTATS_BUCKETS = 24;
+
+/** Per call site statistics of LOCK and TRY_LOCK, recorded with -lockstats */
+struct CLockSiteStats {
+    std::string strName;
+    std::string strFile;
+    int nLine;
+    uint64_t nCount;     //!< acquisitions
+    uint64_t nContended; //!< acquisitions that had to wait
+    uint64_t nTryFailed; //!< TRY_LOCKs that did not get the lock
+    int64_t nWaitTotal;
+    int64_t nWaitMax;
+    int64_t nHoldTotal;
+    int64_t nHoldMax;
+    uint64_t vWaitHist[LOCKSTATS_BUCKETS];
+    uint64_t vHoldHist[LOCKSTATS_BUCKETS];
+
+    CLockSiteStats();
+    void Add(const CLockSiteStats& other);
+};
+
+/** Whether LOCK and TRY_LOCK record wait and hold times, set from -lockstats at startup */
+extern bool fLockStats;
+
+void RecordLockStats(const char* pszName, const char* pszFile, int nLine, bool fAcquired, int64_t nWaitMicros, int64_t nHoldMicros);
+/** Statistics of all call sites, sorted by total wait time */
+std::vector<CLockSiteStats> GetLockStats();
+void ResetLockStats();
+/** Write the nSites call sites with the highest total wait time to debug.log */
+void LogLockStats(int nSites);
+
 /** Wrapper around boost::unique_lock<Mutex> */
 template <typename Mutex>
 class CMutexLock
@@ -111,9 +151,35 @@ class CMutexLock
 private:
     boost::unique_lock<Mutex> lock;
 
+    // Call site and timings for -lockstats, pszStatsFile stays NULL when it is off
+    const char* pszStatsName;
+    const char* pszStatsFile;
+    int nStatsLine;
+    int64_t nStatsWait;
+    int64_t nStatsLocked;
+
+    void StartStats(const char* pszName, const char* pszFile, int nLine, int64_t nWaitStart)
+    {
+        pszStatsName = pszName;
+        pszStatsFile = pszFile;
+        nStatsLine = nLine;
+        nStatsLocked = GetTimeMicros();
+        nStatsWait = nWaitStart ? nStatsLocked - nWaitStart : 0;
+    }
+
     void Enter(const char* pszName, const char* pszFile, int nLine)
     {
         EnterCritical(pszName, pszFile, nLine, (void*)(lock.mutex()));
+        if (fLockStats) {
+            // The clock is only read for the wait when the lock is contended
+            int64_t nWaitStart = 0;
+            if (!lock.try_lock()) {
+                nWaitStart = GetTimeMicros();
+                lock.lock();
+            }
+            StartStats(pszName, pszFile, nLine, nWaitStart);
+            return;
+        }
 #ifdef DEBUG_LOCKCONTENTION
         if (!lock.try_lock()) {
             PrintLockContention(pszName, pszFile, nLine);
@@ -130,11 +196,17 @@ private:
         lock.try_lock();
         if (!lock.owns_lock())
             LeaveCritical();
+        if (fLockStats) {
+            if (lock.owns_lock())
+                StartStats(pszName, pszFile, nLine, 0);
+            else
+                RecordLockStats(pszName, pszFile, nLine, false, 0, 0);
+        }
         return lock.owns_lock();
     }
 
 public:
-    CMutexLock(Mutex& mutexIn, const char* pszName, const char* pszFile, int nLine, bool fTry = false) : lock(mutexIn, boost::defer_lock)
+    CMutexLock(Mutex& mutexIn, const char* pszName, const char* pszFile, int nLine, bool fTry = false) : lock(mutexIn, boost::defer_lock), pszStatsFile(NULL)
     {
         if (fTry)
             TryEnter(pszName, pszFile, nLine);
@@ -142,7 +214,7 @@ public:
             Enter(pszName, pszFile, nLine);
     }
 
-    CMutexLock(Mutex* pmutexIn, const char* pszName, const char* pszFile, int nLine, bool fTry = false)
+    CMutexLock(Mutex* pmutexIn, const char* pszName, const char* pszFile, int nLine, bool fTry = false) : pszStatsFile(NULL)
     {
         if (!pmutexIn) return;
 
@@ -155,8 +227,14 @@ public:
 
     ~CMutexLock()
     {
-        if (lock.owns_lock())
-            LeaveCritical();
+        if (!lock.owns_lock())
+            return;
+        LeaveCritical();
+        if (pszStatsFile) {
+            // Record after unlocking, so the bookkeeping does not add to the hold time of others
+            lock.unlock();
+            RecordLockStats(pszStatsName, pszStatsFile, nStatsLine, true, nStatsWait, GetTimeMicros() - nStatsLocked);
+        }
     }
 
     operator bool()
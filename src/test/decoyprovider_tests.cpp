@@ -0,0 +1,95 @@
+// Copyright (c) 2018-2019 The DAPS Project developers
+// Distributed under the MIT/X11 software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include "chainparams.h"
+#include "clientversion.h"
+#include "decoyprovider.h"
+#include "main.h"
+#include "random.h"
+
+#include <vector>
+
+#include <boost/test/unit_test.hpp>
+
+BOOST_AUTO_TEST_SUITE(decoyprovider_tests)
+
+BOOST_AUTO_TEST_CASE(decoyprovider_select_after_backfill)
+{
+    // Regtest difficulty lets the blocks below pass the header check on read
+    SelectParams(CBaseChainParams::REGTEST);
+    const int nBlocks = 300;
+
+    CBlockIndex* pindexGenesis;
+    {
+        LOCK(cs_main);
+        pindexGenesis = chainActive.Tip();
+    }
+    BOOST_REQUIRE(pindexGenesis && pindexGenesis->nHeight == 0);
+
+    // A chain that was connected before a restart: on disk, never seen by BlockConnected
+    std::vector<uint256> vHash(nBlocks + 1);
+    std::vector<CBlockIndex> vIndex(nBlocks + 1);
+    CDiskBlockPos pos(1, 0);
+    for (int i = 1; i <= nBlocks; i++) {
+        CMutableTransaction coinbase;
+        coinbase.vin.resize(1);
+        coinbase.vin[0].prevout.SetNull();
+        coinbase.vin[0].scriptSig = CScript() << i << OP_0;
+        coinbase.vout.resize(1);
+        coinbase.vout[0].nValue = 1;
+        coinbase.vout[0].scriptPubKey = CScript() << OP_TRUE;
+
+        CMutableTransaction tx;
+        tx.vin.resize(1);
+        tx.vin[0].prevout = COutPoint(GetRandHash(), 0);
+        tx.vout.resize(1);
+        tx.vout[0].nValue = 1;
+        tx.vout[0].scriptPubKey = CScript() << OP_TRUE;
+
+        CBlock block;
+        block.hashPrevBlock = i == 1 ? pindexGenesis->GetBlockHash() : vHash[i - 1];
+        block.vtx.push_back(coinbase);
+        block.vtx.push_back(tx);
+        block.hashMerkleRoot = block.BuildMerkleTree();
+        block.nBits = 0x207fffff;
+        while (!CheckProofOfWork(block.GetHash(), block.nBits))
+            block.nNonce++;
+        BOOST_REQUIRE(WriteBlockToDisk(block, pos));
+
+        vHash[i] = block.GetHash();
+        vIndex[i] = CBlockIndex(block);
+        vIndex[i].phashBlock = &vHash[i];
+        vIndex[i].pprev = i == 1 ? pindexGenesis : &vIndex[i - 1];
+        vIndex[i].nHeight = i;
+        vIndex[i].nFile = pos.nFile;
+        vIndex[i].nDataPos = pos.nPos;
+        vIndex[i].nStatus |= BLOCK_HAVE_DATA;
+        vIndex[i].BuildSkip();
+        pos.nPos += ::GetSerializeSize(block, SER_DISK, CLIENT_VERSION);
+    }
+    {
+        LOCK(cs_main);
+        chainActive.SetTip(&vIndex[nBlocks]);
+    }
+
+    CDecoyProvider provider;
+    provider.SetWindow(1000);
+    provider.Backfill();
+    BOOST_CHECK(provider.IsReady());
+    BOOST_CHECK_EQUAL(provider.GetOutputCount(CDecoyProvider::OUTPUT_REGULAR), (size_t)nBlocks);
+
+    // Ring members are drawn relative to the loaded tip, not to an empty chain
+    COutPoint prevout(GetRandHash(), 0);
+    std::vector<COutPoint> vDecoys;
+    BOOST_CHECK(provider.SelectDecoys(prevout, false, 5, 1, vDecoys));
+    BOOST_CHECK_EQUAL(vDecoys.size(), 5U);
+
+    {
+        LOCK(cs_main);
+        chainActive.SetTip(pindexGenesis);
+    }
+    SelectParams(CBaseChainParams::UNITTEST);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,67 @@
+// Copyright (c) 2018-2019 The DAPS Project developers
+// Distributed under the MIT/X11 software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include "masternode-payments.h"
+#include "random.h"
+
+#include <boost/test/unit_test.hpp>
+
+BOOST_AUTO_TEST_SUITE(mnpayments_tests)
+
+// bench/mnpayments.cpp times the same lookups over 5,000 masternodes
+static const int NUM_MASTERNODES = 1000;
+static const int NUM_BLOCKS = NUM_MASTERNODES * 5 / 4;
+
+// What GetLastPaid used to do: walk the window from the newest block down
+static int ScanLastPaidHeight(CMasternodePayments& payments, const std::vector<unsigned char>& payee, int nMinHeight, int nMaxHeight)
+{
+    for (int nHeight = nMaxHeight; nHeight >= nMinHeight; nHeight--) {
+        if (payments.mapMasternodeBlocks.count(nHeight) && payments.mapMasternodeBlocks[nHeight].HasPayeeWithVotes(payee, MNPAYMENTS_PAID_VOTES))
+            return nHeight;
+    }
+    return 0;
+}
+
+static std::vector<unsigned char> SyntheticPayee(int n)
+{
+    std::string str = strprintf("masternode-%d", n);
+    return std::vector<unsigned char>(str.begin(), str.end());
+}
+
+BOOST_AUTO_TEST_CASE(mnpayments_last_paid)
+{
+    seed_insecure_rand(true);
+    CMasternodePayments payments;
+    std::vector<std::vector<unsigned char> > vPayees;
+    for (int i = 0; i < NUM_MASTERNODES; i++)
+        vPayees.push_back(SyntheticPayee(i));
+
+    // One to three votes for the winner of each block, a stray vote for someone else now and then
+    for (int nHeight = 1; nHeight <= NUM_BLOCKS; nHeight++) {
+        const std::vector<unsigned char>& winner = vPayees[insecure_rand() % NUM_MASTERNODES];
+        int nVotes = 1 + insecure_rand() % 3;
+        for (int i = 0; i < nVotes; i++)
+            payments.AddPayeeVote(nHeight, winner);
+        if (insecure_rand() % 4 == 0)
+            payments.AddPayeeVote(nHeight, vPayees[insecure_rand() % NUM_MASTERNODES]);
+    }
+
+    int nMinHeight = NUM_BLOCKS / 2;
+    for (int i = 0; i < NUM_MASTERNODES; i++)
+        BOOST_CHECK_EQUAL(payments.GetLastPaidHeight(vPayees[i], nMinHeight, NUM_BLOCKS), ScanLastPaidHeight(payments, vPayees[i], nMinHeight, NUM_BLOCKS));
+
+    // Dropped blocks leave the index, and a rebuild gives the same answers
+    for (int nHeight = nMinHeight; nHeight < nMinHeight + NUM_BLOCKS / 5; nHeight++)
+        payments.RemoveBlock(nHeight);
+    for (int i = 0; i < NUM_MASTERNODES; i += 7)
+        BOOST_CHECK_EQUAL(payments.GetLastPaidHeight(vPayees[i], 1, NUM_BLOCKS), ScanLastPaidHeight(payments, vPayees[i], 1, NUM_BLOCKS));
+    payments.RebuildPaidIndex();
+    for (int i = 0; i < NUM_MASTERNODES; i += 7)
+        BOOST_CHECK_EQUAL(payments.GetLastPaidHeight(vPayees[i], 1, NUM_BLOCKS), ScanLastPaidHeight(payments, vPayees[i], 1, NUM_BLOCKS));
+
+    BOOST_CHECK_EQUAL(payments.GetLastPaidHeight(SyntheticPayee(NUM_MASTERNODES), 1, NUM_BLOCKS), 0);
+    BOOST_CHECK_EQUAL(payments.GetLastPaidHeight(vPayees[0], NUM_BLOCKS, 1), 0);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
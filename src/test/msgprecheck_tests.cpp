@@ -0,0 +1,53 @@
+// Copyright (c) 2018-2019 The DAPS Project developers
+// Distributed under the MIT/X11 software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include "key.h"
+#include "masternode.h"
+#include "msgprecheck.h"
+#include "obfuscation.h"
+#include "random.h"
+#include "utiltime.h"
+#include "version.h"
+
+#include <boost/test/unit_test.hpp>
+
+BOOST_AUTO_TEST_SUITE(msgprecheck_tests)
+
+BOOST_AUTO_TEST_CASE(msgprecheck_mnb_collateral_signature)
+{
+    CKey keyCollateral, keyMasternode;
+    keyCollateral.MakeNewKey(true);
+    keyMasternode.MakeNewKey(true);
+
+    CMasternodeBroadcast mnb(CService("1.2.3.4", 53572), CTxIn(COutPoint(GetRandHash(), 0)),
+        keyCollateral.GetPubKey(), keyMasternode.GetPubKey(), PROTOCOL_VERSION);
+    mnb.sigTime = GetAdjustedTime();
+    // Sign without CMasternodeBroadcast::Sign, which verifies and so would fill the cache itself
+    std::string errorMessage;
+    BOOST_REQUIRE(obfuScationSigner.SignMessage(mnb.GetNewStrMessage(), errorMessage, mnb.sig, keyCollateral));
+
+    CDataStream ss(SER_NETWORK, PROTOCOL_VERSION);
+    ss << mnb;
+    CPreCheckedMessage msg("mnb", ss);
+    PreCheckGossip(msg);
+
+    // The message thread finds the collateral key the worker recovered
+    CKeyID keyID;
+    bool fCached = false;
+    BOOST_CHECK(obfuScationSigner.RecoverMessageKey(mnb.sig, mnb.GetNewStrMessage(), keyID, &fCached));
+    BOOST_CHECK(fCached);
+    BOOST_CHECK(keyID == keyCollateral.GetPubKey().GetID());
+    fCached = false;
+    BOOST_CHECK(obfuScationSigner.RecoverMessageKey(mnb.sig, mnb.GetOldStrMessage(), keyID, &fCached));
+    BOOST_CHECK(fCached);
+    BOOST_CHECK(mnb.VerifySignature());
+
+    // A signature the workers never saw is recovered on the spot
+    std::vector<unsigned char> vchSig;
+    BOOST_REQUIRE(obfuScationSigner.SignMessage("not pre-checked", errorMessage, vchSig, keyCollateral));
+    BOOST_CHECK(obfuScationSigner.RecoverMessageKey(vchSig, "not pre-checked", keyID, &fCached));
+    BOOST_CHECK(!fCached);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
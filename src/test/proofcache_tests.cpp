@@ -0,0 +1,55 @@
+// Copyright (c) 2018-2019 The DAPS Project developers
+// Distributed under the MIT/X11 software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include "proofcache.h"
+#include "random.h"
+
+#include <boost/test/unit_test.hpp>
+
+BOOST_AUTO_TEST_SUITE(proofcache_tests)
+
+BOOST_AUTO_TEST_CASE(proofcache_keys)
+{
+    CProofCache cache;
+    cache.Setup(10);
+    uint256 txid = GetRandHash();
+
+    uint256 ring = cache.KeyWriter(CProofCache::RING_SIGNATURE, txid).GetHash();
+    BOOST_CHECK(ring == cache.KeyWriter(CProofCache::RING_SIGNATURE, txid).GetHash());
+    BOOST_CHECK(ring != cache.KeyWriter(CProofCache::BULLETPROOF, txid).GetHash());
+
+    // Ring members resolving differently must give a different key
+    CHashWriter ss = cache.KeyWriter(CProofCache::RING_SIGNATURE, txid);
+    ss << GetRandHash();
+    BOOST_CHECK(ring != ss.GetHash());
+
+    // A new salt changes every key
+    cache.Setup(10);
+    BOOST_CHECK(ring != cache.KeyWriter(CProofCache::RING_SIGNATURE, txid).GetHash());
+}
+
+BOOST_AUTO_TEST_CASE(proofcache_bounded)
+{
+    CProofCache cache;
+    cache.Setup(0);
+    uint256 key = GetRandHash();
+    cache.Insert(key);
+    BOOST_CHECK(!cache.Contains(key));
+
+    cache.Setup(100);
+    cache.Insert(key);
+    BOOST_CHECK(cache.Contains(key));
+    size_t nFound = 0;
+    std::vector<uint256> vKeys;
+    for (int i = 0; i < 1000; i++) {
+        vKeys.push_back(GetRandHash());
+        cache.Insert(vKeys.back());
+    }
+    for (size_t i = 0; i < vKeys.size(); i++)
+        nFound += cache.Contains(vKeys[i]);
+    BOOST_CHECK(nFound <= 100);
+    BOOST_CHECK(cache.Contains(vKeys.back()));
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,99 @@
+// Copyright (c) 2018-2019 The DAPS Project developers
+// Distributed under the MIT/X11 software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include "clientversion.h"
+#include "primitives/transaction.h"
+#include "random.h"
+#include "streams.h"
+#include "utxostats.h"
+
+#include <boost/test/unit_test.hpp>
+
+BOOST_AUTO_TEST_SUITE(utxostats_tests)
+
+static CTxOut RandomOutput()
+{
+    CTxOut out;
+    out.nValue = GetRand(1000 * COIN);
+    out.scriptPubKey = CScript() << ToByteVector(GetRandHash()) << OP_CHECKSIG;
+    return out;
+}
+
+BOOST_AUTO_TEST_CASE(utxostats_muhash_order)
+{
+    std::vector<unsigned char> a(1, 'a'), b(1, 'b'), c(1, 'c');
+    CMuHash3072 ab, ba, empty;
+    ab.Insert(a);
+    ab.Insert(b);
+    ba.Insert(b);
+    ba.Insert(a);
+    BOOST_CHECK(ab.Finalize() == ba.Finalize());
+    BOOST_CHECK(ab.Finalize() != empty.Finalize());
+
+    // Removing an element undoes inserting it, in any order
+    ab.Remove(a);
+    CMuHash3072 onlyb;
+    onlyb.Insert(b);
+    BOOST_CHECK(ab.Finalize() == onlyb.Finalize());
+    ab.Remove(b);
+    BOOST_CHECK(ab.Finalize() == empty.Finalize());
+
+    // Combining applies the changes of the other hash
+    CMuHash3072 changes;
+    changes.Insert(c);
+    changes.Remove(b);
+    ba *= changes;
+    CMuHash3072 ac;
+    ac.Insert(c);
+    ac.Insert(a);
+    BOOST_CHECK(ba.Finalize() == ac.Finalize());
+}
+
+BOOST_AUTO_TEST_CASE(utxostats_delta)
+{
+    COutPoint prevout1(GetRandHash(), 0), prevout2(GetRandHash(), 1);
+    CTxOut out1 = RandomOutput(), out2 = RandomOutput();
+
+    CUtxoStats stats;
+    stats.nTransactions = 1;
+    stats.AddOutput(prevout1, out1);
+    stats.AddBlock(50 * COIN, COIN);
+
+    // A block spending out1 and creating out2, then disconnected again
+    CUtxoStats connect;
+    connect.RemoveOutput(prevout1, out1);
+    connect.AddOutput(prevout2, out2);
+    connect.AddBlock(10 * COIN, 0);
+    CUtxoStats disconnect;
+    disconnect.RemoveOutput(prevout2, out2);
+    disconnect.AddOutput(prevout1, out1);
+    disconnect.AddBlock(-10 * COIN, 0);
+
+    CUtxoStats after = stats;
+    after += connect;
+    BOOST_CHECK_EQUAL(after.nTransactionOutputs, 1);
+    BOOST_CHECK_EQUAL(after.nPublicAmount, out2.nValue);
+    BOOST_CHECK_EQUAL(after.nMinted, 60 * COIN);
+    CUtxoStats expected;
+    expected.AddOutput(prevout2, out2);
+    BOOST_CHECK(after.muhash.Finalize() == expected.muhash.Finalize());
+
+    after += disconnect;
+    BOOST_CHECK_EQUAL(after.nTransactionOutputs, stats.nTransactionOutputs);
+    BOOST_CHECK_EQUAL(after.nSerializedSize, stats.nSerializedSize);
+    BOOST_CHECK_EQUAL(after.nPublicAmount, stats.nPublicAmount);
+    BOOST_CHECK_EQUAL(after.nMinted, stats.nMinted);
+    BOOST_CHECK_EQUAL(after.nFeesBurned, stats.nFeesBurned);
+    BOOST_CHECK(after.muhash.Finalize() == stats.muhash.Finalize());
+
+    // Statistics survive a round trip through the database format
+    CDataStream ss(SER_DISK, CLIENT_VERSION);
+    ss << after;
+    CUtxoStats read;
+    ss >> read;
+    BOOST_CHECK_EQUAL(read.nTransactions, after.nTransactions);
+    BOOST_CHECK(read.muhash.Finalize() == after.muhash.Finalize());
+}
+
+BOOST_AUTO_TEST_SUITE_END()
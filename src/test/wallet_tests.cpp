@@ -391,4 +391,89 @@ BOOST_AUTO_TEST_CASE(test_StealthSend)
     // check stealth sending on not enough balance wallet
     SelectParams(CBaseChainParams::UNITTEST);
 }
+
+BOOST_AUTO_TEST_CASE(test_ArchiveSettledTransactions)
+{
+    SelectParams(CBaseChainParams::REGTEST);
+    mapArgs["-walletarchivedepth"] = "1"; // raised to COINBASE_MATURITY + 1
+    std::string stealthAddr = "41iK3WWry6hR9QBMrYRXcybkXk8TCuvcBSeBov1PBehUR8bYVsiGecoEuq9pcLBHkVAJ5CNr3nAoqEjtRJywPUKX19URn9t22yF";
+
+    // Spend mature coinbases and bury the spend, the coinbases it used are then settled
+    generate_block(COINBASE_MATURITY + 1);
+    CWalletTx wtxSpend;
+    BOOST_CHECK(pwalletMain->SendToStealthAddress(stealthAddr, 10 * COIN, wtxSpend));
+    generate_block(COINBASE_MATURITY + 2);
+
+    CAmount nBalance = pwalletMain->GetBalance();
+    size_t nResident, nHistory;
+    std::vector<uint256> vArchived;
+    {
+        LOCK2(cs_main, pwalletMain->cs_wallet);
+        size_t nTotal = pwalletMain->mapWallet.size() + pwalletMain->mapWalletArchive.size();
+        nHistory = pwalletMain->setTxHistory.size();
+        pwalletMain->ArchiveSettledTransactions();
+        BOOST_REQUIRE(!pwalletMain->mapWalletArchive.empty());
+        BOOST_CHECK(!pwalletMain->mapWalletArchive.count(wtxSpend.GetHash()));
+        BOOST_CHECK_EQUAL(pwalletMain->mapWallet.size() + pwalletMain->mapWalletArchive.size(), nTotal);
+        BOOST_CHECK_EQUAL(pwalletMain->setTxHistory.size(), nHistory);
+        BOOST_CHECK(pwalletMain->GetVersion() >= FEATURE_WALLETARCHIVE);
+        nResident = pwalletMain->mapWallet.size();
+
+        // Bodies are read back on demand and their outputs still count as spent
+        for (std::map<uint256, CWalletTxMeta>::const_iterator it = pwalletMain->mapWalletArchive.begin(); it != pwalletMain->mapWalletArchive.end(); ++it) {
+            BOOST_CHECK(!pwalletMain->mapWallet.count(it->first));
+            const CWalletTx* pwtx = pwalletMain->GetWalletTxBody(it->first);
+            BOOST_REQUIRE(pwtx);
+            BOOST_CHECK(pwtx->GetHash() == it->first);
+            BOOST_CHECK_EQUAL(pwtx->vout.size(), it->second.vIsMine.size());
+            for (unsigned int i = 0; i < pwtx->vout.size(); i++)
+                if (it->second.vIsMine[i] != ISMINE_NO)
+                    BOOST_CHECK(pwalletMain->IsSpent(it->first, i));
+            vArchived.push_back(it->first);
+        }
+    }
+    BOOST_CHECK_EQUAL(pwalletMain->GetBalance(), nBalance);
+
+    // Reopening the wallet file only loads the metadata of archived transactions
+    {
+        CWallet walletReloaded(pwalletMain->strWalletFile);
+        bool fFirstRun;
+        BOOST_CHECK_EQUAL(walletReloaded.LoadWallet(fFirstRun), DB_LOAD_OK);
+        BOOST_CHECK_EQUAL(walletReloaded.GetBalance(), nBalance);
+        LOCK2(cs_main, walletReloaded.cs_wallet);
+        BOOST_CHECK(walletReloaded.GetVersion() >= FEATURE_WALLETARCHIVE);
+        BOOST_CHECK_EQUAL(walletReloaded.mapWallet.size(), nResident);
+        BOOST_CHECK_EQUAL(walletReloaded.mapWalletArchive.size(), vArchived.size());
+        BOOST_CHECK_EQUAL(walletReloaded.setTxHistory.size(), nHistory);
+        BOOST_FOREACH (const uint256& hash, vArchived) {
+            BOOST_CHECK(walletReloaded.mapWalletArchive.count(hash));
+            const CWalletTx* pwtx = walletReloaded.GetWalletTxBody(hash);
+            BOOST_REQUIRE(pwtx);
+            BOOST_CHECK(pwtx->GetHash() == hash);
+        }
+    }
+
+    // Restoring moves the transaction back to mapWallet and the "tx" record
+    uint256 hashRestored = vArchived[0];
+    {
+        LOCK2(cs_main, pwalletMain->cs_wallet);
+        BOOST_CHECK(pwalletMain->RestoreArchivedTx(hashRestored));
+        BOOST_CHECK(pwalletMain->mapWallet.count(hashRestored));
+        BOOST_CHECK(!pwalletMain->mapWalletArchive.count(hashRestored));
+        BOOST_CHECK_EQUAL(pwalletMain->setTxHistory.size(), nHistory);
+    }
+    BOOST_CHECK_EQUAL(pwalletMain->GetBalance(), nBalance);
+    {
+        CWallet walletReloaded(pwalletMain->strWalletFile);
+        bool fFirstRun;
+        BOOST_CHECK_EQUAL(walletReloaded.LoadWallet(fFirstRun), DB_LOAD_OK);
+        LOCK(walletReloaded.cs_wallet);
+        BOOST_CHECK(walletReloaded.mapWallet.count(hashRestored));
+        BOOST_CHECK(!walletReloaded.mapWalletArchive.count(hashRestored));
+        BOOST_CHECK_EQUAL(walletReloaded.mapWalletArchive.size(), vArchived.size() - 1);
+    }
+
+    mapArgs.erase("-walletarchivedepth");
+    SelectParams(CBaseChainParams::UNITTEST);
+}
 BOOST_AUTO_TEST_SUITE_END()
\ No newline at end of file
@@ -7,12 +7,17 @@
 
 #include "txdb.h"
 
+#include "init.h"
 #include "main.h"
 #include "pow.h"
+#include "ui_interface.h"
 #include "uint256.h"
+#include "util.h"
 
+#include <algorithm>
 #include <stdint.h>
 
+#include <boost/bind.hpp>
 #include <boost/thread.hpp>
 
 using namespace std;
@@ -30,8 +35,12 @@ void static BatchWriteHashBestChain(CLevelDBBatch& batch, const uint256& hash)
     batch.Write('B', hash);
 }
 
-CCoinsViewDB::CCoinsViewDB(size_t nCacheSize, bool fMemory, bool fWipe) : db(GetDataDir() / "chainstate", nCacheSize, fMemory, fWipe)
+CCoinsViewDB::CCoinsViewDB(size_t nCacheSize, bool fMemory, bool fWipe, const std::string& strName) : db(GetDataDir() / strName, nCacheSize, fMemory, fWipe)
 {
+    // Databases written before the statistics were kept get them once from RebuildStats at startup
+    fStatsValid = db.Read('S', stats) || !db.Exists('B');
+    if (!fStatsValid)
+        LogPrintf("No UTXO statistics in the coin database, they are rebuilt at startup\n");
 }
 
 bool CCoinsViewDB::GetCoins(const uint256& txid, CCoins& coins) const
@@ -52,7 +61,7 @@ uint256 CCoinsViewDB::GetBestBlock() const
     return hashBestChain;
 }
 
-bool CCoinsViewDB::BatchWrite(CCoinsMap& mapCoins, const uint256& hashBlock)
+bool CCoinsViewDB::BatchWrite(CCoinsMap& mapCoins, const uint256& hashBlock, const CUtxoStats& statsDelta)
 {
     CLevelDBBatch batch;
     size_t count = 0;
@@ -68,9 +77,17 @@ bool CCoinsViewDB::BatchWrite(CCoinsMap& mapCoins, const uint256& hashBlock)
     }
     if (hashBlock != uint256(0))
         BatchWriteHashBestChain(batch, hashBlock);
+    CUtxoStats statsNew = stats;
+    if (fStatsValid) {
+        statsNew += statsDelta;
+        batch.Write('S', statsNew);
+    }
 
     LogPrint("coindb", "Committing %u changed transactions (out of %u) to coin database...\n", (unsigned int)changed, (unsigned int)count);
-    return db.WriteBatch(batch);
+    if (!db.WriteBatch(batch))
+        return false;
+    stats = statsNew;
+    return true;
 }
 
 CBlockTreeDB::CBlockTreeDB(size_t nCacheSize, bool fMemory, bool fWipe) : CLevelDBWrapper(GetDataDir() / "blocks" / "index", nCacheSize, fMemory, fWipe)
@@ -107,60 +124,137 @@ bool CBlockTreeDB::ReadLastBlockFile(int& nFile)
     return Read('l', nFile);
 }
 
-bool CCoinsViewDB::GetStats(CCoinsStats& stats) const
+static bool AddCoinsToStats(CUtxoStats* pstats, const uint256& txid, const CCoins& coins)
+{
+    pstats->nTransactions++;
+    for (unsigned int i = 0; i < coins.vout.size(); i++) {
+        if (!coins.vout[i].IsNull())
+            pstats->AddOutput(COutPoint(txid, i), coins.vout[i]);
+    }
+    return true;
+}
+
+bool CCoinsViewDB::RebuildStats()
+{
+    AssertLockHeld(cs_main);
+    LogPrintf("Rebuilding UTXO statistics...\n");
+    int64_t nStart = GetTimeMillis();
+    uiInterface.ShowProgress(_("Rebuilding UTXO statistics..."), 0);
+    CUtxoStats statsNew;
+    if (!ForEachCoins(boost::bind(&AddCoinsToStats, &statsNew, _1, _2)))
+        return false;
+
+    // The supply totals are summed from the transactions of the blocks, not
+    // taken from their index records, so getsupplyinfo can compare the two
+    BlockMap::const_iterator mi = mapBlockIndex.find(GetBestBlock());
+    if (mi == mapBlockIndex.end())
+        return error("%s : best block of the coin database not in the block index", __func__);
+    int nHeightBest = mi->second->nHeight;
+    for (const CBlockIndex* pindex = mi->second; pindex->pprev; pindex = pindex->pprev) {
+        if (ShutdownRequested())
+            return false;
+        uiInterface.ShowProgress(_("Rebuilding UTXO statistics..."), std::max(1, std::min(99, 100 - pindex->nHeight * 100 / nHeightBest)));
+        CBlock block;
+        if (!ReadBlockFromDisk(block, pindex))
+            return error("%s : failed to read block %s", __func__, pindex->GetBlockHash().ToString());
+        CAmount nMint, nFees;
+        GetBlockSupplyChange(block, nMint, nFees);
+        statsNew.AddBlock(nMint, nFees);
+    }
+    uiInterface.ShowProgress("", 100);
+
+    if (!db.Write('S', statsNew, true))
+        return error("%s : failed to write UTXO statistics", __func__);
+    stats = statsNew;
+    fStatsValid = true;
+    LogPrintf("Rebuilt UTXO statistics of %d blocks in %dms\n", nHeightBest, GetTimeMillis() - nStart);
+    return true;
+}
+
+bool CCoinsViewDB::GetStats(CCoinsStats& statsOut) const
 {
-    /* It seems that there are no "const iterators" for LevelDB.  Since we
-       only need read operations on it, use a const-cast to get around
-       that restriction.  */
-    boost::scoped_ptr<leveldb::Iterator> pcursor(const_cast<CLevelDBWrapper*>(&db)->NewIterator());
-    pcursor->SeekToFirst();
+    if (!fStatsValid)
+        return false;
+    statsOut.hashBlock = GetBestBlock();
+    statsOut.utxo = stats;
+    return true;
+}
 
-    CHashWriter ss(SER_GETHASH, PROTOCOL_VERSION);
-    stats.hashBlock = GetBestBlock();
-    ss << stats.hashBlock;
-    CAmount nTotalAmount = 0;
-    while (pcursor->Valid()) {
+bool CCoinsViewDB::ForEachCoins(const boost::function<bool(const uint256&, const CCoins&)>& fn) const
+{
+    boost::scoped_ptr<CCoinsViewCursor> pcursor(Cursor());
+    for (; pcursor->Valid(); pcursor->Next()) {
         boost::this_thread::interruption_point();
-        try {
-            leveldb::Slice slKey = pcursor->key();
-            CDataStream ssKey(slKey.data(), slKey.data() + slKey.size(), SER_DISK, CLIENT_VERSION);
-            char chType;
-            ssKey >> chType;
-            if (chType == 'c') {
-                leveldb::Slice slValue = pcursor->value();
-                CDataStream ssValue(slValue.data(), slValue.data() + slValue.size(), SER_DISK, CLIENT_VERSION);
-                CCoins coins;
-                ssValue >> coins;
-                uint256 txhash;
-                ssKey >> txhash;
-                ss << txhash;
-                ss << VARINT(coins.nVersion);
-                ss << (coins.fCoinBase ? 'c' : 'n');
-                ss << VARINT(coins.nHeight);
-                stats.nTransactions++;
-                for (unsigned int i = 0; i < coins.vout.size(); i++) {
-                    const CTxOut& out = coins.vout[i];
-                    if (!out.IsNull()) {
-                        stats.nTransactionOutputs++;
-                        ss << VARINT(i + 1);
-                        ss << out;
-                        nTotalAmount += out.nValue;
-                    }
-                }
-                stats.nSerializedSize += 32 + slValue.size();
-                ss << VARINT(0);
-            }
-            pcursor->Next();
-        } catch (std::exception& e) {
-            return error("%s : Deserialize or I/O error - %s", __func__, e.what());
-        }
+        uint256 txhash;
+        CCoins coins;
+        if (!pcursor->GetKey(txhash) || !pcursor->GetValue(coins))
+            return error("%s : Deserialize or I/O error", __func__);
+        if (!fn(txhash, coins))
+            return false;
     }
-    stats.nHeight = mapBlockIndex.find(GetBestBlock())->second->nHeight;
-    stats.hashSerialized = ss.GetHash();
-    stats.nTotalAmount = nTotalAmount;
     return true;
 }
 
+CCoinsViewCursor* CCoinsViewDB::Cursor() const
+{
+    CCoinsViewDBCursor* pcursor = new CCoinsViewDBCursor(const_cast<CLevelDBWrapper&>(db).NewIterator(), GetBestBlock());
+    // The coins records are the ones with the key type 'c'
+    pcursor->pcursor->Seek(std::string(1, 'c'));
+    pcursor->ReadKey();
+    return pcursor;
+}
+
+CCoinsViewDBCursor::CCoinsViewDBCursor(leveldb::Iterator* pcursorIn, const uint256& hashBlockIn) : CCoinsViewCursor(hashBlockIn), pcursor(pcursorIn)
+{
+}
+
+void CCoinsViewDBCursor::ReadKey()
+{
+    keyTmp.first = 0;
+    if (!pcursor->Valid())
+        return;
+    try {
+        leveldb::Slice slKey = pcursor->key();
+        CDataStream ssKey(slKey.data(), slKey.data() + slKey.size(), SER_DISK, CLIENT_VERSION);
+        ssKey >> keyTmp.first;
+        if (keyTmp.first == 'c')
+            ssKey >> keyTmp.second;
+    } catch (const std::exception&) {
+        keyTmp.first = 0;
+    }
+}
+
+bool CCoinsViewDBCursor::GetKey(uint256& txid) const
+{
+    if (keyTmp.first != 'c')
+        return false;
+    txid = keyTmp.second;
+    return true;
+}
+
+bool CCoinsViewDBCursor::GetValue(CCoins& coins) const
+{
+    try {
+        leveldb::Slice slValue = pcursor->value();
+        CDataStream ssValue(slValue.data(), slValue.data() + slValue.size(), SER_DISK, CLIENT_VERSION);
+        ssValue >> coins;
+    } catch (const std::exception& e) {
+        return error("%s : Deserialize or I/O error - %s", __func__, e.what());
+    }
+    return true;
+}
+
+bool CCoinsViewDBCursor::Valid() const
+{
+    return keyTmp.first == 'c';
+}
+
+void CCoinsViewDBCursor::Next()
+{
+    pcursor->Next();
+    ReadKey();
+}
+
 bool CBlockTreeDB::WriteBatchSync(const std::vector<std::pair<int, const CBlockFileInfo*> >& fileInfo, int nLastFile, const std::vector<const CBlockIndex*>& blockinfo) {
     CLevelDBBatch batch;
     for (std::vector<std::pair<int, const CBlockFileInfo*> >::const_iterator it=fileInfo.begin(); it != fileInfo.end(); it++) {
@@ -170,7 +264,19 @@ bool CBlockTreeDB::WriteBatchSync(const std::vector<std::pair<int, const CBlockF
     for (std::vector<const CBlockIndex*>::const_iterator it=blockinfo.begin(); it != blockinfo.end(); it++) {
         batch.Write(make_pair('b', (*it)->GetBlockHash()), CDiskBlockIndex(*it));
     }
-    return WriteBatch(batch, true);
+
+    LOCK(cs_keyImages);
+    for (std::map<std::string, CKeyImageEntry>::const_iterator it = mapKeyImagesDirty.begin(); it != mapKeyImagesDirty.end(); it++) {
+        const CKeyImageEntry& entry = it->second;
+        for (size_t i = entry.nUnchanged; i < entry.vBlocks.size(); i++)
+            batch.Write(make_pair('k', KeyImageRecordKey(it->first, i)), entry.vBlocks[i]);
+        for (size_t i = entry.vBlocks.size(); i < entry.nOnDisk; i++)
+            batch.Erase(make_pair('k', KeyImageRecordKey(it->first, i)));
+    }
+    if (!WriteBatch(batch, true))
+        return false;
+    mapKeyImagesDirty.clear();
+    return true;
 }
 
 bool CBlockTreeDB::ReadTxIndex(const uint256& txid, CDiskTxPos& pos)
@@ -193,8 +299,39 @@ bool CBlockTreeDB::ReadKeyImage(const string& keyImage, uint256& bh)
     return Read(std::make_pair('k', keyImage), bh);
 }
 
+std::string CBlockTreeDB::KeyImageRecordKey(const std::string& keyImage, size_t i)
+{
+    return i == 0 ? keyImage : keyImage + std::to_string(i);
+}
+
+CBlockTreeDB::CKeyImageEntry& CBlockTreeDB::GetKeyImageEntry(const std::string& keyImage)
+{
+    AssertLockHeld(cs_keyImages);
+    std::map<std::string, CKeyImageEntry>::iterator it = mapKeyImagesDirty.find(keyImage);
+    if (it != mapKeyImagesDirty.end())
+        return it->second;
+
+    CKeyImageEntry& entry = mapKeyImagesDirty[keyImage];
+    uint256 bh;
+    while (ReadKeyImage(KeyImageRecordKey(keyImage, entry.vBlocks.size()), bh))
+        entry.vBlocks.push_back(bh);
+    entry.nOnDisk = entry.nUnchanged = entry.vBlocks.size();
+    return entry;
+}
+
 bool CBlockTreeDB::ReadKeyImages(const string& keyImage, std::vector<uint256>& bhs)
 {
+    {
+        LOCK(cs_keyImages);
+        std::map<std::string, CKeyImageEntry>::const_iterator it = mapKeyImagesDirty.find(keyImage);
+        if (it != mapKeyImagesDirty.end()) {
+            if (it->second.vBlocks.empty())
+                return false;
+            bhs.insert(bhs.end(), it->second.vBlocks.begin(), it->second.vBlocks.end());
+            return true;
+        }
+    }
+
     uint256 bh;
     if (!Read(std::make_pair('k', keyImage), bh)) return false;
     bhs.push_back(bh);
@@ -208,15 +345,29 @@ bool CBlockTreeDB::ReadKeyImages(const string& keyImage, std::vector<uint256>& b
 
 bool CBlockTreeDB::WriteKeyImage(const string& keyImage, const uint256& bh)
 {
-    uint256 blockHash;
-    if (!ReadKeyImage(keyImage, blockHash)) {
-        return Write(std::make_pair('k', keyImage), bh);
-    }
-    int i = 1;
-    while (ReadKeyImage(keyImage + std::to_string(i), blockHash)) {
-        i++;
+    LOCK(cs_keyImages);
+    CKeyImageEntry& entry = GetKeyImageEntry(keyImage);
+    if (std::find(entry.vBlocks.begin(), entry.vBlocks.end(), bh) == entry.vBlocks.end())
+        entry.vBlocks.push_back(bh);
+    return true;
+}
+
+bool CBlockTreeDB::EraseKeyImage(const string& keyImage, const uint256& bh)
+{
+    LOCK(cs_keyImages);
+    CKeyImageEntry& entry = GetKeyImageEntry(keyImage);
+    std::vector<uint256>::iterator it = std::find(entry.vBlocks.begin(), entry.vBlocks.end(), bh);
+    if (it != entry.vBlocks.end()) {
+        entry.nUnchanged = std::min(entry.nUnchanged, (size_t)(it - entry.vBlocks.begin()));
+        entry.vBlocks.erase(it);
     }
-    return Write(std::make_pair('k', keyImage + std::to_string(i)), bh);
+    return true;
+}
+
+size_t CBlockTreeDB::GetDirtyKeyImageCount()
+{
+    LOCK(cs_keyImages);
+    return mapKeyImagesDirty.size();
 }
 
 bool CBlockTreeDB::WriteFlag(const std::string& name, bool fValue)
@@ -243,6 +394,49 @@ bool CBlockTreeDB::ReadInt(const std::string& name, int& nValue)
     return Read(std::make_pair('I', name), nValue);
 }
 
+bool CBlockTreeDB::WriteSnapshotStats(const CUtxoStats& stats)
+{
+    return Write('U', stats);
+}
+
+bool CBlockTreeDB::ReadSnapshotStats(CUtxoStats& stats)
+{
+    return Read('U', stats);
+}
+
+namespace
+{
+/** Number of block index records decoded per parallel batch at startup */
+const size_t BLOCK_INDEX_LOAD_BATCH = 16384;
+
+/** A raw 'b' record read off the iterator and its decoded form */
+struct CBlockIndexRecord {
+    std::string strValue;
+    CDiskBlockIndex diskindex;
+    uint256 hash;
+    std::string strError;
+};
+
+/** Deserialize and hash a range of records; safe to run concurrently on disjoint ranges */
+void DecodeBlockIndexRecords(std::vector<CBlockIndexRecord>* pvRecords, size_t nBegin, size_t nEnd)
+{
+    for (size_t i = nBegin; i < nEnd; i++) {
+        CBlockIndexRecord& record = (*pvRecords)[i];
+        try {
+            CDataStream ssValue(record.strValue.data(), record.strValue.data() + record.strValue.size(), SER_DISK, CLIENT_VERSION);
+            ssValue >> record.diskindex;
+            record.hash = record.diskindex.GetBlockHash();
+            if (record.diskindex.nHeight <= Params().LAST_POW_BLOCK() &&
+                !CheckProofOfWork(record.hash, record.diskindex.nBits))
+                record.strError = strprintf("CheckProofOfWork failed: %s", record.diskindex.ToString());
+        } catch (std::exception& e) {
+            record.strError = strprintf("Deserialize or I/O error - %s", e.what());
+        }
+        std::string().swap(record.strValue);
+    }
+}
+}
+
 bool CBlockTreeDB::LoadBlockIndexGuts()
 {
     boost::scoped_ptr<leveldb::Iterator> pcursor(NewIterator());
@@ -251,72 +445,90 @@ bool CBlockTreeDB::LoadBlockIndexGuts()
     ssKeySet << make_pair('b', uint256(0));
     pcursor->Seek(ssKeySet.str());
 
+    // Decoding and hashing every header dominates startup, so records are
+    // read off the iterator in batches and decoded on all cores before being
+    // linked into mapBlockIndex on this thread.
+    int nThreads = std::min(std::max((int)boost::thread::hardware_concurrency(), 1), MAX_SCRIPTCHECK_THREADS);
+    std::vector<CBlockIndexRecord> vRecords;
+    vRecords.reserve(BLOCK_INDEX_LOAD_BATCH);
+
     // Load mapBlockIndex
-    uint256 nPreviousCheckpoint;
-    while (pcursor->Valid()) {
+    bool fDone = false;
+    while (!fDone) {
         boost::this_thread::interruption_point();
+        vRecords.clear();
         try {
-            leveldb::Slice slKey = pcursor->key();
-            CDataStream ssKey(slKey.data(), slKey.data() + slKey.size(), SER_DISK, CLIENT_VERSION);
-            char chType;
-            ssKey >> chType;
-            if (chType == 'b') {
-                leveldb::Slice slValue = pcursor->value();
-                CDataStream ssValue(slValue.data(), slValue.data() + slValue.size(), SER_DISK, CLIENT_VERSION);
-                CDiskBlockIndex diskindex;
-                ssValue >> diskindex;
-
-                // Construct block index object
-                CBlockIndex* pindexNew = InsertBlockIndex(diskindex.GetBlockHash());
-                pindexNew->pprev = InsertBlockIndex(diskindex.hashPrev);
-                pindexNew->pnext = InsertBlockIndex(diskindex.hashNext);
-                pindexNew->nHeight = diskindex.nHeight;
-                pindexNew->nFile = diskindex.nFile;
-                pindexNew->nDataPos = diskindex.nDataPos;
-                pindexNew->nUndoPos = diskindex.nUndoPos;
-                pindexNew->nVersion = diskindex.nVersion;
-                pindexNew->hashMerkleRoot = diskindex.hashMerkleRoot;
-                pindexNew->nTime = diskindex.nTime;
-                pindexNew->nBits = diskindex.nBits;
-                pindexNew->nNonce = diskindex.nNonce;
-                pindexNew->nStatus = diskindex.nStatus;
-                pindexNew->nTx = diskindex.nTx;
-
-                //Proof of Audit
-                pindexNew->hashPoAMerkleRoot = diskindex.hashPoAMerkleRoot;
-                pindexNew->hashPrevPoABlock = diskindex.hashPrevPoABlock;
-                pindexNew->minedHash = diskindex.minedHash;
-
-                //Proof Of Stake
-                pindexNew->nMint = diskindex.nMint;
-                pindexNew->nMoneySupply = diskindex.nMoneySupply;
-                pindexNew->nFlags = diskindex.nFlags;
-                pindexNew->nStakeModifier = diskindex.nStakeModifier;
-                pindexNew->prevoutStake = diskindex.prevoutStake;
-                pindexNew->nStakeTime = diskindex.nStakeTime;
-                pindexNew->hashProofOfStake = diskindex.hashProofOfStake;
-
-                if (pindexNew->nHeight <= Params().LAST_POW_BLOCK()) {
-                    if (!CheckProofOfWork(pindexNew->GetBlockHash(), pindexNew->nBits))
-                        return error("LoadBlockIndex() : CheckProofOfWork failed: %s", pindexNew->ToString());
+            while (vRecords.size() < BLOCK_INDEX_LOAD_BATCH) {
+                if (!pcursor->Valid()) {
+                    fDone = true;
+                    break;
                 }
-                // ppcoin: build setStakeSeen
-                if (pindexNew->IsProofOfStake())
-                    setStakeSeen.insert(make_pair(pindexNew->prevoutStake, pindexNew->nStakeTime));
-
-                //populate accumulator checksum map in memory
-                if(pindexNew->nAccumulatorCheckpoint != 0 && pindexNew->nAccumulatorCheckpoint != nPreviousCheckpoint) {
-                    nPreviousCheckpoint = pindexNew->nAccumulatorCheckpoint;
+                leveldb::Slice slKey = pcursor->key();
+                CDataStream ssKey(slKey.data(), slKey.data() + slKey.size(), SER_DISK, CLIENT_VERSION);
+                char chType;
+                ssKey >> chType;
+                if (chType != 'b') {
+                    fDone = true; // finished loading block index
+                    break;
                 }
-
+                leveldb::Slice slValue = pcursor->value();
+                vRecords.push_back(CBlockIndexRecord());
+                vRecords.back().strValue.assign(slValue.data(), slValue.size());
                 pcursor->Next();
-            } else {
-                break; // if shutdown requested or finished loading block index
             }
         } catch (std::exception& e) {
             return error("%s : Deserialize or I/O error - %s", __func__, e.what());
         }
+
+        size_t nPerThread = (vRecords.size() + nThreads - 1) / nThreads;
+        boost::thread_group decoders;
+        for (size_t nBegin = nPerThread; nBegin < vRecords.size(); nBegin += nPerThread)
+            decoders.create_thread(boost::bind(&DecodeBlockIndexRecords, &vRecords, nBegin, std::min(nBegin + nPerThread, vRecords.size())));
+        DecodeBlockIndexRecords(&vRecords, 0, std::min(nPerThread, vRecords.size()));
+        decoders.join_all();
+
+        BOOST_FOREACH (const CBlockIndexRecord& record, vRecords) {
+            if (!record.strError.empty())
+                return error("LoadBlockIndex() : %s", record.strError);
+            const CDiskBlockIndex& diskindex = record.diskindex;
+
+            // Construct block index object
+            CBlockIndex* pindexNew = InsertBlockIndex(record.hash);
+            pindexNew->pprev = InsertBlockIndex(diskindex.hashPrev);
+            pindexNew->pnext = InsertBlockIndex(diskindex.hashNext);
+            pindexNew->nHeight = diskindex.nHeight;
+            pindexNew->nFile = diskindex.nFile;
+            pindexNew->nDataPos = diskindex.nDataPos;
+            pindexNew->nUndoPos = diskindex.nUndoPos;
+            pindexNew->nVersion = diskindex.nVersion;
+            pindexNew->hashMerkleRoot = diskindex.hashMerkleRoot;
+            pindexNew->nTime = diskindex.nTime;
+            pindexNew->nBits = diskindex.nBits;
+            pindexNew->nNonce = diskindex.nNonce;
+            pindexNew->nStatus = diskindex.nStatus;
+            pindexNew->nTx = diskindex.nTx;
+
+            //Proof Of Stake
+            pindexNew->nMint = diskindex.nMint;
+            pindexNew->nMoneySupply = diskindex.nMoneySupply;
+            pindexNew->nFlags = diskindex.nFlags;
+            pindexNew->nStakeModifier = diskindex.nStakeModifier;
+            pindexNew->prevoutStake = diskindex.prevoutStake;
+            pindexNew->nStakeTime = diskindex.nStakeTime;
+            pindexNew->hashProofOfStake = diskindex.hashProofOfStake;
+
+            //Proof of Audit
+            if (pindexNew->IsProofOfAudit())
+                pindexNew->SetPoAHeader(diskindex.hashPoAMerkleRoot, diskindex.minedHash, diskindex.hashPrevPoABlock);
+
+            // ppcoin: build setStakeSeen
+            if (pindexNew->IsProofOfStake())
+                setStakeSeen.insert(make_pair(pindexNew->prevoutStake, pindexNew->nStakeTime));
+        }
     }
 
+    LogPrint("bench", "%s: %u block index entries, %.2fMiB in arena\n", __func__, mapBlockIndex.size(),
+        blockIndexArena.GetAllocated() / 1048576.0);
+
     return true;
 }
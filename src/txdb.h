@@ -10,12 +10,15 @@
 
 #include "leveldbwrapper.h"
 #include "main.h"
+#include "sync.h"
 
 #include <map>
 #include <string>
 #include <utility>
 #include <vector>
 
+#include <boost/scoped_ptr.hpp>
+
 class CCoins;
 class uint256;
 
@@ -26,20 +29,54 @@ static const int64_t nMaxDbCache = sizeof(void*) > 4 ? 4096 : 1024;
 //! min. -dbcache in (MiB)
 static const int64_t nMinDbCache = 4;
 
-/** CCoinsView backed by the LevelDB coin database (chainstate/) */
+/** CCoinsView backed by the LevelDB coin database (chainstate/, or strName/ in the data directory) */
 class CCoinsViewDB : public CCoinsView
 {
 protected:
     CLevelDBWrapper db;
 
+    //! Statistics of the coins as of the best block, written with them by BatchWrite
+    CUtxoStats stats;
+    //! False until RebuildStats computes the statistics of a database written without them
+    bool fStatsValid;
+
 public:
-    CCoinsViewDB(size_t nCacheSize, bool fMemory = false, bool fWipe = false);
+    CCoinsViewDB(size_t nCacheSize, bool fMemory = false, bool fWipe = false, const std::string& strName = "chainstate");
+
+    //! Whether the database has its statistics, GetStats fails until RebuildStats computed them
+    bool HaveStats() const { return fStatsValid; }
+    //! Compute the statistics of the coins written so far, reading every block of their chain; run once at
+    //! startup with cs_main held, the changes still in the caches above are added by them
+    bool RebuildStats();
 
     bool GetCoins(const uint256& txid, CCoins& coins) const;
     bool HaveCoins(const uint256& txid) const;
     uint256 GetBestBlock() const;
-    bool BatchWrite(CCoinsMap& mapCoins, const uint256& hashBlock);
+    bool BatchWrite(CCoinsMap& mapCoins, const uint256& hashBlock, const CUtxoStats& statsDelta);
     bool GetStats(CCoinsStats& stats) const;
+    bool ForEachCoins(const boost::function<bool(const uint256&, const CCoins&)>& fn) const;
+    CCoinsViewCursor* Cursor() const;
+};
+
+/** Cursor over the coins of a CCoinsViewDB, its iterator reads the database as it was when it was created */
+class CCoinsViewDBCursor : public CCoinsViewCursor
+{
+public:
+    bool GetKey(uint256& txid) const;
+    bool GetValue(CCoins& coins) const;
+    bool Valid() const;
+    void Next();
+
+private:
+    CCoinsViewDBCursor(leveldb::Iterator* pcursorIn, const uint256& hashBlockIn);
+
+    //! Reads the key the iterator is at into keyTmp, which is left with type 0 past the coins
+    void ReadKey();
+
+    boost::scoped_ptr<leveldb::Iterator> pcursor;
+    std::pair<char, uint256> keyTmp;
+
+    friend class CCoinsViewDB;
 };
 
 /** Access to the block database (blocks/index/) */
@@ -52,6 +89,23 @@ private:
     CBlockTreeDB(const CBlockTreeDB&);
     void operator=(const CBlockTreeDB&);
 
+    /** In-memory view of a key image's spending blocks, not yet written out */
+    struct CKeyImageEntry {
+        //! All blocks the key image is recorded against, in insertion order
+        std::vector<uint256> vBlocks;
+        //! Number of records currently in the database
+        size_t nOnDisk;
+        //! Leading records that are identical on disk and in vBlocks
+        size_t nUnchanged;
+    };
+
+    CCriticalSection cs_keyImages;
+    //! Key images modified since the last WriteBatchSync
+    std::map<std::string, CKeyImageEntry> mapKeyImagesDirty;
+
+    CKeyImageEntry& GetKeyImageEntry(const std::string& keyImage);
+    static std::string KeyImageRecordKey(const std::string& keyImage, size_t i);
+
 public:
     bool WriteBlockIndex(const CDiskBlockIndex& blockindex);
 	bool WriteBatchSync(const std::vector<std::pair<int, const CBlockFileInfo*> >& fileInfo, int nLastFile, const std::vector<const CBlockIndex*>& blockinfo);
@@ -65,11 +119,20 @@ public:
     bool ReadFlag(const std::string& name, bool& fValue);
     bool WriteInt(const std::string& name, int nValue);
     bool ReadInt(const std::string& name, int& nValue);
+    //! Statistics of the coins of a loaded UTXO snapshot, checked once its blocks are replayed
+    bool WriteSnapshotStats(const CUtxoStats& stats);
+    bool ReadSnapshotStats(CUtxoStats& stats);
     bool LoadBlockIndexGuts();
 
     bool ReadKeyImage(const string& keyImage, uint256& bh);
     bool ReadKeyImages(const string& keyImage, std::vector<uint256>& bhs);
 
+    /**
+     * Key image writes are staged in memory and committed by the next
+     * WriteBatchSync, in the same batch as the block index they refer to.
+     */
     bool WriteKeyImage(const string& keyImage, const uint256& height);
+    bool EraseKeyImage(const string& keyImage, const uint256& bh);
+    size_t GetDirtyKeyImageCount();
 };
 #endif // BITCOIN_TXDB_H
@@ -0,0 +1,137 @@
+// Copyright (c) 2018-2019 The DAPS Project developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include "txprevalidator.h"
+
+#include "main.h"
+#include "net.h"
+#include "util.h"
+
+#include <boost/bind.hpp>
+#include <boost/foreach.hpp>
+
+CTxPreValidator txPreValidator;
+
+CTxPreValidator::CTxPreValidator() : nThreads(0), fStop(false)
+{
+}
+
+CTxPreValidator::~CTxPreValidator()
+{
+    Stop();
+}
+
+void CTxPreValidator::Start(int nThreadsIn)
+{
+    boost::unique_lock<boost::mutex> lock(mutex);
+    if (nThreads > 0)
+        return;
+    fStop = false;
+    nThreads = std::min(std::max(nThreadsIn, 0), MAX_TXPREVALIDATION_THREADS);
+    for (int i = 0; i < nThreads; i++)
+        threads.create_thread(boost::bind(&CTxPreValidator::ThreadWorker, this));
+}
+
+void CTxPreValidator::Stop()
+{
+    {
+        boost::unique_lock<boost::mutex> lock(mutex);
+        if (nThreads == 0)
+            return;
+        fStop = true;
+        cond.notify_all();
+    }
+    threads.join_all();
+
+    boost::unique_lock<boost::mutex> lock(mutex);
+    BOOST_FOREACH (const boost::shared_ptr<CJob>& job, queue)
+        BOOST_FOREACH (const CSender& sender, job->vSenders)
+            sender.pfrom->Release();
+    queue.clear();
+    mapQueued.clear();
+    nThreads = 0;
+}
+
+bool CTxPreValidator::Submit(CNode* pfrom, const CTransaction& tx, const std::string& strCommand, bool ignoreFees)
+{
+    boost::unique_lock<boost::mutex> lock(mutex);
+    if (nThreads == 0 || fStop || queue.size() >= MAX_TXPREVALIDATION_QUEUE)
+        return false;
+    CSender sender;
+    sender.pfrom = pfrom->AddRef();
+    sender.strCommand = strCommand;
+    sender.ignoreFees = ignoreFees;
+
+    // Another peer relayed it first, this one is handled with the same verdict
+    boost::shared_ptr<CJob>& job = mapQueued[tx.GetHash()];
+    if (job) {
+        job->vSenders.push_back(sender);
+        return true;
+    }
+
+    job.reset(new CJob());
+    job->tx = tx;
+    job->vSenders.push_back(sender);
+    queue.push_back(job);
+    cond.notify_one();
+    return true;
+}
+
+bool CTxPreValidator::IsQueued(const uint256& hash)
+{
+    boost::unique_lock<boost::mutex> lock(mutex);
+    return mapQueued.count(hash) > 0;
+}
+
+void CTxPreValidator::ThreadWorker()
+{
+    RenameThread("dapscoin-txval");
+
+    // The shared scratch space of GetScratch() may only be used under cs_main
+    secp256k1_scratch_space2* scratch = secp256k1_scratch_space_create(GetContext(), 1024 * 1024 * 512);
+    while (true) {
+        boost::shared_ptr<CJob> job;
+        {
+            boost::unique_lock<boost::mutex> lock(mutex);
+            while (!fStop && queue.empty())
+                cond.wait(lock);
+            if (fStop)
+                break;
+            job = queue.front();
+            queue.pop_front();
+        }
+
+        CValidationState statePre;
+        try {
+            PreValidateTransaction(job->tx, statePre, scratch);
+        } catch (std::exception& e) {
+            PrintExceptionContinue(&e, "ThreadTxPreValidator()");
+        } catch (...) {
+            PrintExceptionContinue(NULL, "ThreadTxPreValidator()");
+        }
+
+        // Senders can still be added until the job leaves mapQueued, later ones queue a new job
+        for (size_t i = 0;; i++) {
+            CSender sender;
+            {
+                boost::unique_lock<boost::mutex> lock(mutex);
+                if (i == job->vSenders.size()) {
+                    mapQueued.erase(job->tx.GetHash());
+                    break;
+                }
+                sender = job->vSenders[i];
+            }
+            try {
+                CValidationState state = statePre;
+                ProcessTransaction(sender.pfrom, job->tx, sender.strCommand, sender.ignoreFees, state);
+            } catch (std::exception& e) {
+                PrintExceptionContinue(&e, "ThreadTxPreValidator()");
+            } catch (...) {
+                PrintExceptionContinue(NULL, "ThreadTxPreValidator()");
+            }
+            sender.pfrom->Release();
+        }
+    }
+    secp256k1_scratch_space_destroy(scratch);
+}
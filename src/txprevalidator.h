@@ -0,0 +1,92 @@
+// Copyright (c) 2018-2019 The DAPS Project developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#ifndef BITCOIN_TXPREVALIDATOR_H
+#define BITCOIN_TXPREVALIDATOR_H
+
+#include "primitives/transaction.h"
+#include "uint256.h"
+
+#include <deque>
+#include <map>
+#include <string>
+#include <vector>
+
+#include <boost/shared_ptr.hpp>
+#include <boost/thread/condition_variable.hpp>
+#include <boost/thread/mutex.hpp>
+#include <boost/thread/thread.hpp>
+
+class CNode;
+
+/** Default for -txprevalidationthreads, the number of threads checking relayed transaction proofs */
+static const int DEFAULT_TXPREVALIDATION_THREADS = 2;
+/** Maximum number of transaction pre-validation threads */
+static const int MAX_TXPREVALIDATION_THREADS = 16;
+/** Transactions waiting for pre-validation before new ones are handled on the message thread */
+static const size_t MAX_TXPREVALIDATION_QUEUE = 1000;
+
+/**
+ * Pre-validation stage for transactions relayed by peers.
+ *
+ * The ring signature and bulletproof of a transaction used to be verified in
+ * AcceptToMemoryPool with cs_main and mempool.cs held, which stalls block
+ * processing and every other peer during a transaction flood. The message
+ * thread now queues "tx"/"dstx" messages here; worker threads run
+ * PreValidateTransaction against a snapshot of the tip, with a scratch space
+ * of their own, and then hand the transaction to ProcessTransaction. Its
+ * AcceptToMemoryPool finds the proofs in the proof cache, so cs_main is only
+ * taken for the key image and chain checks that need it.
+ *
+ * When no threads run (-txprevalidationthreads=0) or the queue is full,
+ * Submit returns false and the caller handles the message inline, exactly
+ * as before. A transaction that is already queued is not checked twice:
+ * later senders are added to its job and each goes through
+ * ProcessTransaction once the verdict is known, so they still get the
+ * relay, "dstx" and reject handling of the inline path.
+ */
+class CTxPreValidator
+{
+public:
+    CTxPreValidator();
+    ~CTxPreValidator();
+
+    //! Start nThreads worker threads
+    void Start(int nThreads);
+    //! Stop the worker threads, dropping what is still queued
+    void Stop();
+
+    //! Queue a transaction received from pfrom, returns false if the caller has to handle it
+    bool Submit(CNode* pfrom, const CTransaction& tx, const std::string& strCommand, bool ignoreFees);
+
+    //! Whether a transaction is waiting for or undergoing pre-validation
+    bool IsQueued(const uint256& hash);
+
+private:
+    struct CSender {
+        CNode* pfrom;
+        std::string strCommand;
+        bool ignoreFees;
+    };
+    struct CJob {
+        CTransaction tx;
+        //! Every peer that relayed tx while it was queued, in order of arrival
+        std::vector<CSender> vSenders;
+    };
+
+    boost::mutex mutex;
+    boost::condition_variable cond;
+    boost::thread_group threads;
+    int nThreads;
+    bool fStop;
+    std::deque<boost::shared_ptr<CJob> > queue;
+    //! Jobs waiting for or undergoing pre-validation, by transaction hash
+    std::map<uint256, boost::shared_ptr<CJob> > mapQueued;
+
+    void ThreadWorker();
+};
+
+extern CTxPreValidator txPreValidator;
+
+#endif // BITCOIN_TXPREVALIDATOR_H
@@ -29,7 +29,7 @@
 #include <openssl/evp.h>
 #include "pubkey.h"
 #include "key.h"
-#include "secp256k1.h"
+#include "ecutil.h"
 
 
 #ifndef WIN32
@@ -814,23 +814,29 @@ void SetupEnvironment()
     boost::filesystem::path::imbue(loc);
 }
 
-bool PointHashingSuccessively(const CPubKey& pk, const unsigned char* tweak, unsigned char* out) {
+bool PointHashing(const CPubKey& pk, unsigned char* out) {
     unsigned char pubData[65];
     uint256 hash = pk.GetHash();
     pubData[0] = *(pk.begin());
     memcpy(pubData + 1, hash.begin(), 32);
     CPubKey newPubKey(pubData, pubData + 33);
-    memcpy(out, newPubKey.begin(), newPubKey.size());
-    while (!secp256k1_ec_pubkey_tweak_mul(out, newPubKey.size(), tweak)) {
+    // Rehash until the candidate is on the curve, a candidate of the wrong length never gets there
+    while (newPubKey.IsValid() && !newPubKey.IsFullyValid()) {
         hash = newPubKey.GetHash();
         pubData[0] = *(newPubKey.begin());
         memcpy(pubData + 1, hash.begin(), 32);
         newPubKey.Set(pubData, pubData + 33);
-        memcpy(out, newPubKey.begin(), newPubKey.size());
     }
+    if (!newPubKey.IsValid())
+        return false;
+    memcpy(out, newPubKey.begin(), newPubKey.size());
     return true;
 }
 
+bool PointHashingSuccessively(const CPubKey& pk, const unsigned char* tweak, unsigned char* out) {
+    return PointHashing(pk, out) && ECPubKeyTweakMul(out, 33, tweak);
+}
+
 bool SetupNetworking()
 {
 #ifdef WIN32
@@ -225,6 +225,8 @@ void TraceThread(const char* name, Callable func)
     }
 }
 
+//! Hash pk to a curve point, the base of its key image, into the 33 bytes at out
+bool PointHashing(const CPubKey& pk, unsigned char* out);
 bool PointHashingSuccessively(const CPubKey& pk, const unsigned char* tweak, unsigned char* out);
 
 #endif // BITCOIN_UTIL_H
@@ -0,0 +1,552 @@
+// Copyright (c) 2018-2019 The DAPS Project developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include "utxosnapshot.h"
+
+#include "chainparams.h"
+#include "checkpoints.h"
+#include "clientversion.h"
+#include "coins.h"
+#include "hash.h"
+#include "init.h"
+#include "kernel.h"
+#include "main.h"
+#include "masternode-payments.h"
+#include "pow.h"
+#include "streams.h"
+#include "txdb.h"
+#include "ui_interface.h"
+#include "util.h"
+#include "utilmoneystr.h"
+
+#include <boost/filesystem/operations.hpp>
+#include <boost/scoped_ptr.hpp>
+#include <boost/thread.hpp>
+
+using namespace std;
+
+namespace
+{
+/** Blocks a loaded snapshot stores between flushes of the block files and staged key images */
+const int SNAPSHOT_FLUSH_INTERVAL = 10000;
+/** Blocks ThreadVerifySnapshot replays between flushes of its chainstate */
+const int SNAPSHOT_VERIFY_INTERVAL = 1000;
+/** Data directory subdirectory and LevelDB cache of the chainstate ThreadVerifySnapshot replays into */
+const char* const SNAPSHOT_CHECK_DIR = "snapshotcheck";
+const size_t SNAPSHOT_CHECK_DB_CACHE = 8 << 20;
+
+/** Writes to a file and hashes what it wrote */
+class CSnapshotWriter
+{
+private:
+    CAutoFile& file;
+    CHashWriter hasher;
+
+public:
+    explicit CSnapshotWriter(CAutoFile& fileIn) : file(fileIn), hasher(SER_DISK, CLIENT_VERSION) {}
+
+    int GetType() const { return SER_DISK; }
+    int GetVersion() const { return CLIENT_VERSION; }
+
+    CSnapshotWriter& write(const char* pch, size_t nSize)
+    {
+        file.write(pch, nSize);
+        hasher.write(pch, nSize);
+        return (*this);
+    }
+
+    template <typename T>
+    CSnapshotWriter& operator<<(const T& obj)
+    {
+        ::Serialize(*this, obj, SER_DISK, CLIENT_VERSION);
+        return (*this);
+    }
+
+    // invalidates the object
+    uint256 GetHash() { return hasher.GetHash(); }
+};
+
+/** Double SHA-256 of the first nSize bytes of file */
+uint256 HashSnapshotFile(FILE* file, uint64_t nSize)
+{
+    CHashWriter hasher(SER_DISK, CLIENT_VERSION);
+    std::vector<char> vBuf(1 << 20);
+    while (nSize > 0) {
+        size_t nRead = fread(&vBuf[0], 1, std::min<uint64_t>(nSize, vBuf.size()), file);
+        if (nRead == 0)
+            throw std::runtime_error("Failed to read snapshot file");
+        hasher.write(&vBuf[0], nRead);
+        nSize -= nRead;
+    }
+    return hasher.GetHash();
+}
+}
+
+bool DumpTxOutSnapshot(const boost::filesystem::path& path, CSnapshotHeader& header, uint256& hashSnapshot, std::string& strError)
+{
+    boost::filesystem::path pathTmp = path.string() + ".incomplete";
+    CAutoFile file(fopen(pathTmp.string().c_str(), "wb"), SER_DISK, CLIENT_VERSION);
+    if (file.IsNull()) {
+        strError = strprintf("Cannot open %s for writing", pathTmp.string());
+        return false;
+    }
+
+    try {
+        CSnapshotWriter writer(file);
+        std::vector<CBlockIndex*> vChain;
+        boost::scoped_ptr<CCoinsViewCursor> pcursor;
+        {
+            LOCK(cs_main);
+            FlushStateToDisk();
+            CBlockIndex* pindexTip = chainActive.Tip();
+            memcpy(header.pchMessageStart, Params().MessageStart(), sizeof(header.pchMessageStart));
+            header.nVersion = SNAPSHOT_VERSION;
+            header.hashBlock = pindexTip->GetBlockHash();
+            header.nHeight = pindexTip->nHeight;
+            vChain.reserve(pindexTip->nHeight + 1);
+            for (CBlockIndex* pindex = chainActive.Genesis(); pindex; pindex = chainActive.Next(pindex))
+                vChain.push_back(pindex);
+
+            // The cursor keeps reading the flushed coins of the tip once cs_main is released
+            pcursor.reset(pcoinsTip->Cursor());
+            if (!pcursor || pcursor->GetBestBlock() != header.hashBlock) {
+                strError = "Failed to read the coins database";
+                return false;
+            }
+        }
+
+        writer << header;
+        for (; pcursor->Valid(); pcursor->Next()) {
+            boost::this_thread::interruption_point();
+            uint256 txid;
+            CCoins coins;
+            if (!pcursor->GetKey(txid) || !pcursor->GetValue(coins)) {
+                strError = "Failed to read the coins database";
+                return false;
+            }
+            writer << true << txid << coins;
+        }
+        writer << false;
+        pcursor.reset();
+
+        // Blocks below the tip do not change, read them without holding cs_main
+        BOOST_FOREACH (CBlockIndex* pindex, vChain) {
+            CDiskBlockIndex diskindex;
+            CDiskBlockPos blockPos, undoPos;
+            uint256 hashPrev;
+            {
+                LOCK(cs_main);
+                diskindex = CDiskBlockIndex(pindex);
+                blockPos = pindex->GetBlockPos();
+                undoPos = pindex->GetUndoPos();
+                hashPrev = pindex->pprev ? pindex->pprev->GetBlockHash() : uint256();
+            }
+            bool fUndo = (diskindex.nStatus & BLOCK_HAVE_UNDO) && diskindex.nHeight > header.nHeight - SNAPSHOT_UNDO_DEPTH;
+            diskindex.nStatus &= ~(BLOCK_HAVE_DATA | BLOCK_HAVE_UNDO);
+
+            CBlock block;
+            if (!ReadBlockFromDisk(block, blockPos)) {
+                strError = strprintf("Failed to read block %s", diskindex.GetBlockHash().ToString());
+                return false;
+            }
+            CBlockUndo undo;
+            if (fUndo && !undo.ReadFromDisk(undoPos, hashPrev)) {
+                strError = strprintf("Failed to read undo data of block %s", diskindex.GetBlockHash().ToString());
+                return false;
+            }
+            writer << diskindex << block << fUndo;
+            if (fUndo)
+                writer << undo;
+        }
+
+        hashSnapshot = writer.GetHash();
+        file << hashSnapshot;
+    } catch (const std::exception& e) {
+        strError = strprintf("Failed to write snapshot: %s", e.what());
+        return false;
+    }
+    file.fclose();
+
+    if (!RenameOver(pathTmp, path)) {
+        strError = strprintf("Cannot rename %s to %s", pathTmp.string(), path.string());
+        return false;
+    }
+    LogPrintf("Wrote UTXO snapshot of block %s at height %d to %s, hash %s\n",
+        header.hashBlock.ToString(), header.nHeight, path.string(), hashSnapshot.ToString());
+    return true;
+}
+
+bool LoadTxOutSnapshot(const boost::filesystem::path& path, std::string& strError)
+{
+    bool fLoading = false;
+    if (pblocktree->ReadFlag("snapshotloading", fLoading) && fLoading) {
+        strError = _("Loading a UTXO snapshot was interrupted, remove the blocks and chainstate directories and start again");
+        return false;
+    }
+    int nLastBlockFile = 0;
+    if (!pcoinsTip->GetBestBlock().IsNull() || pblocktree->ReadLastBlockFile(nLastBlockFile)) {
+        LogPrintf("Ignoring -loadtxoutset, the block database is not empty\n");
+        return true;
+    }
+
+    int64_t nStart = GetTimeMillis();
+    CAutoFile file(fopen(path.string().c_str(), "rb"), SER_DISK, CLIENT_VERSION);
+    if (file.IsNull()) {
+        strError = strprintf(_("Cannot open UTXO snapshot %s"), path.string());
+        return false;
+    }
+
+    try {
+        uint64_t nFileSize = boost::filesystem::file_size(path);
+        if (nFileSize < sizeof(uint256)) {
+            strError = strprintf(_("UTXO snapshot %s is truncated"), path.string());
+            return false;
+        }
+        uint256 hashSnapshot = HashSnapshotFile(file.Get(), nFileSize - sizeof(uint256));
+        uint256 hashExpected;
+        file >> hashExpected;
+        if (hashSnapshot != hashExpected) {
+            strError = strprintf(_("UTXO snapshot %s is corrupt"), path.string());
+            return false;
+        }
+        if (fseek(file.Get(), 0, SEEK_SET) != 0)
+            throw std::runtime_error("Failed to rewind snapshot file");
+
+        CSnapshotHeader header;
+        file >> header;
+        if (memcmp(header.pchMessageStart, Params().MessageStart(), sizeof(header.pchMessageStart)) != 0 ||
+            header.nVersion != SNAPSHOT_VERSION) {
+            strError = strprintf(_("UTXO snapshot %s is not a version %d snapshot of this network"), path.string(), SNAPSHOT_VERSION);
+            return false;
+        }
+        if (!Params().MineBlocksOnDemand()) {
+            MapSnapshots::const_iterator it = Params().Snapshots().find(header.nHeight);
+            if (it == Params().Snapshots().end() || it->second != hashSnapshot) {
+                strError = strprintf(_("UTXO snapshot %s with hash %s is not a known snapshot"), path.string(), hashSnapshot.ToString());
+                return false;
+            }
+        }
+        LogPrintf("Loading UTXO snapshot of block %s at height %d\n", header.hashBlock.ToString(), header.nHeight);
+        pblocktree->WriteFlag("snapshotloading", true);
+        fTxIndex = GetBoolArg("-txindex", true);
+
+        uiInterface.InitMessage(_("Loading UTXO snapshot coins..."));
+        CUtxoStats statsSnapshot;
+        uint64_t nCoins = 0;
+        bool fMore;
+        for (file >> fMore; fMore; file >> fMore) {
+            uint256 txid;
+            CCoins coins;
+            file >> txid >> coins;
+            CUtxoStats statsCoins;
+            statsCoins.nTransactions = 1;
+            for (unsigned int i = 0; i < coins.vout.size(); i++) {
+                if (!coins.vout[i].IsNull())
+                    statsCoins.AddOutput(COutPoint(txid, i), coins.vout[i]);
+            }
+            pcoinsTip->AddStatsDelta(statsCoins);
+            statsSnapshot += statsCoins;
+            pcoinsTip->ModifyCoins(txid)->swap(coins);
+            if (pcoinsTip->GetCacheSize() > nCoinCacheSize && !pcoinsTip->Flush())
+                throw std::runtime_error("Failed to write to coin database");
+            nCoins++;
+        }
+
+        uiInterface.InitMessage(_("Loading UTXO snapshot blocks..."));
+        CValidationState state;
+        CUtxoStats statsSupply;
+        CAmount nMoneySupplyPrev = 0;
+        uint256 hashPrev;
+        for (int nHeight = 0; nHeight <= header.nHeight; nHeight++) {
+            if (ShutdownRequested())
+                throw std::runtime_error("Shutdown requested");
+            CDiskBlockIndex diskindex;
+            CBlock block;
+            bool fUndo;
+            file >> diskindex >> block >> fUndo;
+            CBlockUndo undo;
+            if (fUndo)
+                file >> undo;
+
+            // The accumulator checkpoint is part of the header hash but not of the index record
+            diskindex.nAccumulatorCheckpoint = block.nAccumulatorCheckpoint;
+            uint256 hash = block.GetHash();
+            if (diskindex.nHeight != nHeight || diskindex.GetBlockHash() != hash || block.hashPrevBlock != hashPrev ||
+                (nHeight == 0 && hash != Params().HashGenesisBlock())) {
+                strError = strprintf(_("UTXO snapshot %s has an invalid block at height %d"), path.string(), nHeight);
+                return false;
+            }
+            if (!StoreSnapshotBlock(block, diskindex, fUndo ? &undo : NULL, state) ||
+                ((nHeight + 1) % SNAPSHOT_FLUSH_INTERVAL == 0 && !FlushSnapshotBlocks(state))) {
+                strError = strprintf(_("Failed to store block %s of the UTXO snapshot: %s"), hash.ToString(), state.GetRejectReason());
+                return false;
+            }
+            statsSupply.AddBlock(diskindex.nMint, diskindex.nMint - (diskindex.nMoneySupply - nMoneySupplyPrev));
+            nMoneySupplyPrev = diskindex.nMoneySupply;
+            hashPrev = hash;
+        }
+        if (hashPrev != header.hashBlock) {
+            strError = strprintf(_("UTXO snapshot %s does not end at its block %s"), path.string(), header.hashBlock.ToString());
+            return false;
+        }
+        if (!FlushSnapshotBlocks(state)) {
+            strError = strprintf(_("Failed to store the UTXO snapshot: %s"), state.GetRejectReason());
+            return false;
+        }
+
+        pcoinsTip->AddStatsDelta(statsSupply);
+        statsSnapshot += statsSupply;
+        pcoinsTip->SetBestBlock(header.hashBlock);
+        if (!pcoinsTip->Flush())
+            throw std::runtime_error("Failed to write to coin database");
+        pblocktree->WriteFlag("txindex", fTxIndex);
+        pblocktree->WriteSnapshotStats(statsSnapshot);
+        pblocktree->WriteInt("snapshotheight", header.nHeight);
+        pblocktree->WriteInt("snapshotverified", 0);
+        pblocktree->WriteFlag("snapshotloading", false);
+        LogPrintf("Loaded UTXO snapshot with %u coins and %d blocks in %dms\n", nCoins, header.nHeight + 1, GetTimeMillis() - nStart);
+    } catch (const std::exception& e) {
+        strError = strprintf(_("Failed to load UTXO snapshot %s: %s"), path.string(), e.what());
+        return false;
+    }
+    return true;
+}
+
+namespace
+{
+/** Check the stake fields the snapshot's index record of pindex carries against the ones computed from its ancestors */
+bool CheckSnapshotStakeFields(const CBlock& block, const CBlockIndex* pindex)
+{
+    if (block.IsProofOfStake() != pindex->IsProofOfStake())
+        return error("%s : proof-of-stake flag of block %s does not match", __func__, pindex->GetBlockHash().ToString());
+    uint64_t nStakeModifier = 0;
+    bool fGeneratedStakeModifier = false;
+    bool fEntropyBit = false;
+    if (!block.IsPoABlockByVersion()) {
+        if (!ComputeNextStakeModifier(pindex->pprev, nStakeModifier, fGeneratedStakeModifier))
+            return error("%s : cannot compute the stake modifier of block %s", __func__, pindex->GetBlockHash().ToString());
+        fEntropyBit = pindex->GetStakeEntropyBit();
+    }
+    if (nStakeModifier != pindex->nStakeModifier || fGeneratedStakeModifier != pindex->GeneratedStakeModifier() ||
+        fEntropyBit != ((pindex->nFlags & CBlockIndex::BLOCK_STAKE_ENTROPY) != 0))
+        return error("%s : stake modifier of block %s does not match", __func__, pindex->GetBlockHash().ToString());
+    return true;
+}
+
+/**
+ * Connect block to view with the checks AcceptBlock and ConnectBlock run. index
+ * is a private copy of the block's index record, linked to the active chain,
+ * whose supply fields are recomputed. Unlike ConnectBlock it writes neither
+ * the block index nor the key image index nor the wallet, and runs the ring
+ * signature, bulletproof and stake proof checks without cs_main, which it only
+ * takes for the lookups in the block index and the active chain.
+ */
+bool ConnectSnapshotBlock(const CBlock& block, CBlockIndex& index, CCoinsViewCache& view, CValidationState& state)
+{
+    CBlockIndex* pindexPrev = index.pprev;
+    const uint256 hash = index.GetBlockHash();
+    assert(pindexPrev && pindexPrev->GetBlockHash() == view.GetBestBlock());
+
+    if (!CheckBlockContextFree(block, state))
+        return false;
+    if (index.nHeight <= Params().LAST_POW_BLOCK() && block.IsProofOfStake())
+        return state.DoS(100, error("%s : PoS period not active", __func__), REJECT_INVALID, "PoS-early");
+    if (index.nHeight > Params().LAST_POW_BLOCK() && block.IsProofOfWork())
+        return state.DoS(100, error("%s : PoW period ended", __func__), REJECT_INVALID, "PoW-ended");
+
+    bool fScriptChecks = index.nHeight >= Checkpoints::GetTotalBlocksEstimate();
+    // BIP16 didn't become active until Apr 1 2012
+    unsigned int flags = index.GetBlockTime() >= 1333238400 ? SCRIPT_VERIFY_P2SH : SCRIPT_VERIFY_NONE;
+    CAmount nMoneySupplyPrev;
+    {
+        LOCK(cs_main);
+        if (!CheckWork(block, pindexPrev) || !ContextualCheckBlockHeader(block, state, pindexPrev, false) ||
+            !ContextualCheckBlock(block, state, pindexPrev) || !CheckSnapshotStakeFields(block, &index))
+            return error("%s : block %s is invalid: %s", __func__, hash.ToString(), state.GetRejectReason());
+        if (block.IsPoABlockByVersion() && (!CheckPoAblockTime(block) || !CheckPoABlockNotAuditingOverlap(block)))
+            return state.Invalid(error("%s : PoA block %s does not follow its parent", __func__, hash.ToString()),
+                REJECT_INVALID, "bad-poa-parent");
+        if (block.IsProofOfAudit() &&
+            (!CheckPoAContainRecentHash(block) || !CheckNumberOfAuditedPoSBlocks(block) || !CheckPoABlockNotContainingPoABlockInfo(block)))
+            return state.DoS(100, error("%s : PoA block %s audits the wrong blocks", __func__, hash.ToString()));
+        if (block.nVersion >= 3 && CBlockIndex::IsSuperMajority(3, pindexPrev, Params().EnforceBlockUpgradeMajority()))
+            flags |= SCRIPT_VERIFY_DERSIG;
+        nMoneySupplyPrev = pindexPrev->nMoneySupply;
+    }
+
+    unsigned int nSigOps = 0;
+    CUtxoStats statsDelta;
+    for (unsigned int i = 0; i < block.vtx.size(); i++) {
+        const CTransaction& tx = block.vtx[i];
+        nSigOps += GetLegacySigOpCount(tx);
+        if (!block.IsPoABlockByVersion() && nSigOps > MAX_BLOCK_SIGOPS_CURRENT)
+            return state.DoS(100, error("%s : too many sigops", __func__), REJECT_INVALID, "bad-blk-sigops");
+
+        if (!block.IsPoABlockByVersion() && !tx.IsCoinBase()) {
+            CResolvedRing ring;
+            if (!tx.IsCoinStake() && !tx.IsCoinAudit()) {
+                if (!VerifyRingSignatureWithTxFee(tx, &index, &ring))
+                    return state.DoS(100, error("%s : Ring Signature check for transaction %s failed", __func__, tx.GetHash().ToString()),
+                        REJECT_INVALID, "bad-ring-signature");
+                if (!VerifyBulletProofAggregate(tx))
+                    return state.DoS(100, error("%s : Bulletproof check for transaction %s failed", __func__, tx.GetHash().ToString()),
+                        REJECT_INVALID, "bad-bulletproof");
+            }
+
+            // The ring is resolved, what is left are lookups of its blocks and of the key images' blocks
+            LOCK(cs_main);
+            BOOST_FOREACH (const CTxIn& in, tx.vin) {
+                if (IsKeyImageSpend1(in.keyImage.GetHex(), hash))
+                    return state.Invalid(error("%s : key image already spent", __func__), REJECT_DUPLICATE, "bad-txns-inputs-spent");
+                if (!ValidOutPoint(in.prevout, index.nHeight))
+                    return state.DoS(100, error("%s : tried to spend invalid input %s in tx %s", __func__, in.prevout.ToString(), tx.GetHash().GetHex()),
+                        REJECT_INVALID, "bad-txns-invalid-inputs");
+            }
+            if (!CheckInputs(tx, state, view, fScriptChecks, flags, false, NULL, &ring))
+                return false;
+        }
+
+        CTxUndo undo;
+        UpdateCoins(tx, state, view, undo, index.nHeight);
+        UpdateUtxoStats(tx, view, undo, statsDelta);
+    }
+    if (block.IsProofOfStake() && !CheckCoinStakeRewards(block, pindexPrev, state))
+        return false;
+
+    CAmount nMint, nFees;
+    GetBlockSupplyChange(block, nMint, nFees);
+    index.nMint = nMint;
+    index.nMoneySupply = nMoneySupplyPrev + nMint - nFees;
+    statsDelta.AddBlock(nMint, nFees);
+    CAmount nExpectedMint = GetBlockValue(pindexPrev) + nFees;
+    if (!block.IsPoABlockByVersion()) {
+        LOCK(cs_main);
+        if (!IsBlockValueValid(block, nExpectedMint, nMint))
+            return state.DoS(100, error("%s : reward pays too much (actual=%s vs limit=%s)", __func__, FormatMoney(nMint), FormatMoney(nExpectedMint)),
+                REJECT_INVALID, "bad-cb-amount");
+    }
+
+    view.AddStatsDelta(statsDelta);
+    view.SetBestBlock(hash);
+    return true;
+}
+
+/** Connect the block at nHeight of the active chain to view, and compare the supply fields of its index record */
+bool ReplaySnapshotBlock(int nHeight, CCoinsViewCache& view)
+{
+    CBlockIndex index;
+    {
+        LOCK(cs_main);
+        CBlockIndex* pindex = chainActive[nHeight];
+        if (!pindex)
+            return error("%s : no block at height %d", __func__, nHeight);
+        index = *pindex;
+    }
+
+    CBlock block;
+    CValidationState state;
+    if (!ReadBlockFromDisk(block, &index))
+        return error("%s : failed to read block %s", __func__, index.GetBlockHash().ToString());
+    CAmount nMint = index.nMint, nMoneySupply = index.nMoneySupply;
+    if (!ConnectSnapshotBlock(block, index, view, state))
+        return error("%s : block %s does not connect: %s", __func__, index.GetBlockHash().ToString(), state.GetRejectReason());
+    if (index.nMint != nMint || index.nMoneySupply != nMoneySupply)
+        return error("%s : block %s mints %s with supply %s, the snapshot says %s with supply %s", __func__,
+            index.GetBlockHash().ToString(), FormatMoney(index.nMint), FormatMoney(index.nMoneySupply),
+            FormatMoney(nMint), FormatMoney(nMoneySupply));
+    return true;
+}
+}
+
+void ThreadVerifySnapshot()
+{
+    RenameThread("dapscoin-snapcheck");
+    int nSnapshotHeight = 0, nVerified = 0;
+    if (!pblocktree->ReadInt("snapshotheight", nSnapshotHeight) || !pblocktree->ReadInt("snapshotverified", nVerified) ||
+        nVerified >= nSnapshotHeight)
+        return;
+    CUtxoStats statsSnapshot;
+    if (!pblocktree->ReadSnapshotStats(statsSnapshot)) {
+        AbortNode("The statistics of the loaded UTXO snapshot are missing",
+            _("The loaded UTXO snapshot cannot be checked. Remove the blocks and chainstate directories and load it again."));
+        return;
+    }
+
+    // Ring signatures are only checked once the node has caught up
+    while (IsInitialBlockDownload()) {
+        boost::this_thread::interruption_point();
+        MilliSleep(1000);
+    }
+
+    // The blocks are connected from the genesis block into a chainstate of
+    // their own, which keeps its progress across restarts
+    CCoinsViewDB* pcheckdb = new CCoinsViewDB(SNAPSHOT_CHECK_DB_CACHE, false, false, SNAPSHOT_CHECK_DIR);
+    int nHeightStart = 0;
+    {
+        LOCK(cs_main);
+        uint256 hashResume = pcheckdb->GetBestBlock();
+        BlockMap::iterator mi = mapBlockIndex.find(hashResume);
+        if (mi != mapBlockIndex.end() && chainActive.Contains(mi->second) && mi->second->nHeight <= nSnapshotHeight) {
+            nHeightStart = mi->second->nHeight;
+        } else {
+            delete pcheckdb;
+            pcheckdb = new CCoinsViewDB(SNAPSHOT_CHECK_DB_CACHE, false, true, SNAPSHOT_CHECK_DIR);
+        }
+    }
+    CCoinsViewCache* pcheckview = new CCoinsViewCache(pcheckdb);
+    if (nHeightStart == 0) {
+        LOCK(cs_main);
+        pcheckview->SetBestBlock(chainActive.Genesis()->GetBlockHash());
+    }
+
+    LogPrintf("Replaying the blocks of the UTXO snapshot from height %d to %d\n", nHeightStart + 1, nSnapshotHeight);
+    int64_t nStart = GetTimeMillis();
+    bool fValid = true;
+    try {
+        for (int nHeight = nHeightStart + 1; nHeight <= nSnapshotHeight && fValid; nHeight++) {
+            boost::this_thread::interruption_point();
+            fValid = ReplaySnapshotBlock(nHeight, *pcheckview);
+            if (fValid && (nHeight % SNAPSHOT_VERIFY_INTERVAL == 0 || pcheckview->GetCacheSize() > nCoinCacheSize / 4) &&
+                !pcheckview->Flush())
+                throw std::runtime_error("Failed to write to the snapshot check database");
+        }
+
+        if (fValid) {
+            // The coins the replay ends with must be the ones the snapshot was loaded with
+            CCoinsStats stats;
+            fValid = pcheckview->GetStats(stats) &&
+                     stats.utxo.muhash.Finalize() == statsSnapshot.muhash.Finalize() &&
+                     stats.utxo.nTransactions == statsSnapshot.nTransactions &&
+                     stats.utxo.nTransactionOutputs == statsSnapshot.nTransactionOutputs &&
+                     stats.utxo.nSerializedSize == statsSnapshot.nSerializedSize &&
+                     stats.utxo.nPublicAmount == statsSnapshot.nPublicAmount &&
+                     stats.utxo.nMinted == statsSnapshot.nMinted &&
+                     stats.utxo.nFeesBurned == statsSnapshot.nFeesBurned;
+            if (!fValid)
+                LogPrintf("ThreadVerifySnapshot : the replayed UTXO set %s does not match the snapshot's %s\n",
+                    stats.utxo.muhash.Finalize().ToString(), statsSnapshot.muhash.Finalize().ToString());
+        }
+    } catch (const boost::thread_interrupted&) {
+        pcheckview->Flush();
+        delete pcheckview;
+        delete pcheckdb;
+        throw;
+    } catch (const std::exception& e) {
+        LogPrintf("ThreadVerifySnapshot : %s\n", e.what());
+        fValid = false;
+    }
+    if (fValid)
+        pcheckview->Flush();
+    delete pcheckview;
+    delete pcheckdb;
+
+    if (!fValid) {
+        AbortNode("The UTXO snapshot does not match its blocks",
+            _("The loaded UTXO snapshot does not match the blocks it was made from. Remove the blocks and chainstate directories and synchronize without -loadtxoutset."));
+        return;
+    }
+    pblocktree->WriteInt("snapshotverified", nSnapshotHeight);
+    boost::filesystem::remove_all(GetDataDir() / SNAPSHOT_CHECK_DIR);
+    LogPrintf("Replayed the blocks of the UTXO snapshot in %ds\n", (GetTimeMillis() - nStart) / 1000);
+}
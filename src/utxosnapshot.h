@@ -0,0 +1,83 @@
+// Copyright (c) 2018-2019 The DAPS Project developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#ifndef BITCOIN_UTXOSNAPSHOT_H
+#define BITCOIN_UTXOSNAPSHOT_H
+
+#include "serialize.h"
+#include "uint256.h"
+
+#include <string>
+
+#include <boost/filesystem/path.hpp>
+
+/** Format version of the files written by dumptxoutset */
+static const int SNAPSHOT_VERSION = 1;
+/** Blocks at the top of a snapshot that carry their undo data, so they can be disconnected and checked by VerifyDB */
+static const int SNAPSHOT_UNDO_DEPTH = 1000;
+
+/**
+ * Start of a UTXO snapshot file. It is followed by the coins, each record
+ * prefixed with true and the list ended by false, then by the block index
+ * record, block and optional undo data of every block from the genesis block
+ * to hashBlock, and by the double SHA-256 of everything before it.
+ */
+class CSnapshotHeader
+{
+public:
+    unsigned char pchMessageStart[4];
+    int nVersion;
+    uint256 hashBlock;
+    int nHeight;
+
+    CSnapshotHeader() : nVersion(0), nHeight(0)
+    {
+        memset(pchMessageStart, 0, sizeof(pchMessageStart));
+    }
+
+    ADD_SERIALIZE_METHODS;
+
+    template <typename Stream, typename Operation>
+    inline void SerializationOp(Stream& s, Operation ser_action, int nType, int nVersion)
+    {
+        READWRITE(FLATDATA(pchMessageStart));
+        READWRITE(this->nVersion);
+        READWRITE(hashBlock);
+        READWRITE(nHeight);
+    }
+};
+
+/**
+ * UTXO snapshots let a node start from the state of a chain instead of
+ * connecting every block since genesis.
+ *
+ * Validating a block needs more than the coins: ring members and staked
+ * outputs are read through the transaction index from the block files, the
+ * key image index detects double spends and the block index carries the
+ * stake modifiers and proof-of-audit headers. A snapshot therefore holds the
+ * coins and every block of the chain with its index record, and the loader
+ * rebuilds the transaction and key image indexes from the blocks. Only the
+ * top SNAPSHOT_UNDO_DEPTH blocks keep their undo data, deeper blocks cannot
+ * be disconnected.
+ *
+ * -loadtxoutset writes a snapshot into an empty data directory at startup,
+ * before the block index is loaded, and only accepts it if its hash is listed
+ * in CChainParams::Snapshots. No hashes are listed for the main and test
+ * networks yet, so only regtest loads snapshots. The node then follows the
+ * chain from the snapshot's tip while ThreadVerifySnapshot connects the blocks
+ * below it into a separate chainstate, on copies of their index records and
+ * holding cs_main only for lookups. Every block's supply and stake fields
+ * are compared with the snapshot's index records, and the final coins with the
+ * statistics of the snapshot's coins; a mismatch shuts the node down, and the
+ * snapshot is only marked verified once the replay reaches its tip.
+ */
+
+/** Write the active chain and its coins to path, returns the snapshot's header and hash */
+bool DumpTxOutSnapshot(const boost::filesystem::path& path, CSnapshotHeader& header, uint256& hashSnapshot, std::string& strError);
+/** Store the snapshot at path in empty block tree and coins databases */
+bool LoadTxOutSnapshot(const boost::filesystem::path& path, std::string& strError);
+/** Replay the blocks below a loaded snapshot and check they produce its coins and index fields */
+void ThreadVerifySnapshot();
+
+#endif // BITCOIN_UTXOSNAPSHOT_H
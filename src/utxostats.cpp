@@ -0,0 +1,97 @@
+// Copyright (c) 2018-2019 The DAPS Project developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include "utxostats.h"
+
+#include "clientversion.h"
+#include "crypto/sha256.h"
+#include "crypto/sha512.h"
+#include "hash.h"
+#include "primitives/transaction.h"
+#include "streams.h"
+
+namespace
+{
+/** 2^3072 - 1103717, the largest 3072 bit safe prime */
+const CBigNum& MuHashModulus()
+{
+    static const CBigNum bnModulus = (CBigNum(1) << 3072) - CBigNum(1103717);
+    return bnModulus;
+}
+
+/** Map vch to a number below the modulus */
+CBigNum MuHashElement(const std::vector<unsigned char>& vch)
+{
+    unsigned char seed[CSHA256::OUTPUT_SIZE];
+    CSHA256().Write(vch.empty() ? NULL : &vch[0], vch.size()).Finalize(seed);
+
+    // 384 bytes, little endian, and a zero byte that keeps the number positive
+    std::vector<unsigned char> vchNum(384 + 1, 0);
+    for (unsigned char i = 0; i < 6; i++)
+        CSHA512().Write(seed, sizeof(seed)).Write(&i, 1).Finalize(&vchNum[i * CSHA512::OUTPUT_SIZE]);
+    return CBigNum(vchNum) % MuHashModulus();
+}
+
+void SerializeOutput(const COutPoint& outpoint, const CTxOut& out, std::vector<unsigned char>& vch)
+{
+    CDataStream ss(SER_DISK, CLIENT_VERSION);
+    ss << outpoint << out;
+    vch.assign(ss.begin(), ss.end());
+}
+}
+
+void CMuHash3072::Insert(const std::vector<unsigned char>& vch)
+{
+    numerator = numerator.mul_mod(MuHashElement(vch), MuHashModulus());
+}
+
+void CMuHash3072::Remove(const std::vector<unsigned char>& vch)
+{
+    denominator = denominator.mul_mod(MuHashElement(vch), MuHashModulus());
+}
+
+CMuHash3072& CMuHash3072::operator*=(const CMuHash3072& other)
+{
+    numerator = numerator.mul_mod(other.numerator, MuHashModulus());
+    denominator = denominator.mul_mod(other.denominator, MuHashModulus());
+    return *this;
+}
+
+uint256 CMuHash3072::Finalize() const
+{
+    std::vector<unsigned char> vch = numerator.mul_mod(denominator.inverse(MuHashModulus()), MuHashModulus()).getvch();
+    return Hash(vch.begin(), vch.end());
+}
+
+void CUtxoStats::AddOutput(const COutPoint& outpoint, const CTxOut& out)
+{
+    std::vector<unsigned char> vch;
+    SerializeOutput(outpoint, out, vch);
+    nTransactionOutputs++;
+    nSerializedSize += vch.size();
+    nPublicAmount += out.nValue;
+    muhash.Insert(vch);
+}
+
+void CUtxoStats::RemoveOutput(const COutPoint& outpoint, const CTxOut& out)
+{
+    std::vector<unsigned char> vch;
+    SerializeOutput(outpoint, out, vch);
+    nTransactionOutputs--;
+    nSerializedSize -= vch.size();
+    nPublicAmount -= out.nValue;
+    muhash.Remove(vch);
+}
+
+CUtxoStats& CUtxoStats::operator+=(const CUtxoStats& delta)
+{
+    nTransactions += delta.nTransactions;
+    nTransactionOutputs += delta.nTransactionOutputs;
+    nSerializedSize += delta.nSerializedSize;
+    nPublicAmount += delta.nPublicAmount;
+    nMinted += delta.nMinted;
+    nFeesBurned += delta.nFeesBurned;
+    muhash *= delta.muhash;
+    return *this;
+}
@@ -0,0 +1,120 @@
+// Copyright (c) 2018-2019 The DAPS Project developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#ifndef BITCOIN_UTXOSTATS_H
+#define BITCOIN_UTXOSTATS_H
+
+#include "amount.h"
+#include "bignum.h"
+#include "serialize.h"
+#include "uint256.h"
+
+#include <stdint.h>
+#include <vector>
+
+class COutPoint;
+class CTxOut;
+
+/**
+ * Multiplicative hash of a set of byte strings modulo the prime 2^3072 - 1103717.
+ * Elements are expanded to 3072 bits with SHA-512 and multiplied into the
+ * numerator when inserted and into the denominator when removed, so the hash
+ * does not depend on the order of the changes and two hashes can be combined
+ * by multiplying them. The quotient is only computed by Finalize.
+ */
+class CMuHash3072
+{
+private:
+    CBigNum numerator;
+    CBigNum denominator;
+
+public:
+    CMuHash3072() : numerator(1), denominator(1) {}
+
+    void Insert(const std::vector<unsigned char>& vch);
+    void Remove(const std::vector<unsigned char>& vch);
+
+    //! Combine with the changes made to other
+    CMuHash3072& operator*=(const CMuHash3072& other);
+
+    //! Hash of the set
+    uint256 Finalize() const;
+
+    ADD_SERIALIZE_METHODS;
+
+    template <typename Stream, typename Operation>
+    inline void SerializationOp(Stream& s, Operation ser_action, int nType, int nVersion)
+    {
+        READWRITE(numerator);
+        READWRITE(denominator);
+    }
+};
+
+/**
+ * Statistics of the unspent outputs and supply totals of the chain, kept up
+ * to date by ConnectBlock and DisconnectBlock. The supply totals are summed
+ * from the transactions of the blocks, separately from the money supply the
+ * block index records for each block. A coins cache collects the
+ * changes of the blocks connected to it and hands them to its base on Flush;
+ * CCoinsViewDB adds them to the statistics of the whole set, stored in the
+ * same batch as the coins.
+ */
+class CUtxoStats
+{
+public:
+    //! Transactions with unspent outputs
+    int64_t nTransactions;
+    int64_t nTransactionOutputs;
+    //! Serialized size of the outputs and their outpoints
+    int64_t nSerializedSize;
+    //! Sum of the amounts of the outputs, hidden amounts count as 0
+    CAmount nPublicAmount;
+    //! Public value of the outputs of the blocks less their public inputs, fees included
+    CAmount nMinted;
+    //! Fees destroyed by the blocks
+    CAmount nFeesBurned;
+    //! Set hash of the outputs and their outpoints
+    CMuHash3072 muhash;
+
+    CUtxoStats() { SetNull(); }
+
+    void SetNull()
+    {
+        nTransactions = 0;
+        nTransactionOutputs = 0;
+        nSerializedSize = 0;
+        nPublicAmount = 0;
+        nMinted = 0;
+        nFeesBurned = 0;
+        muhash = CMuHash3072();
+    }
+
+    void AddOutput(const COutPoint& outpoint, const CTxOut& out);
+    void RemoveOutput(const COutPoint& outpoint, const CTxOut& out);
+
+    //! Record a block that created nMint coins and destroyed nFees
+    void AddBlock(CAmount nMint, CAmount nFees)
+    {
+        nMinted += nMint;
+        nFeesBurned += nFees;
+    }
+
+    CUtxoStats& operator+=(const CUtxoStats& delta);
+
+    ADD_SERIALIZE_METHODS;
+
+    template <typename Stream, typename Operation>
+    inline void SerializationOp(Stream& s, Operation ser_action, int nType, int nVersion)
+    {
+        READWRITE(nTransactions);
+        READWRITE(nTransactionOutputs);
+        READWRITE(nSerializedSize);
+        READWRITE(nPublicAmount);
+        READWRITE(nMinted);
+        READWRITE(nFeesBurned);
+        READWRITE(muhash);
+    }
+};
+
+#endif // BITCOIN_UTXOSTATS_H
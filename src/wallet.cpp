@@ -11,6 +11,7 @@
 #include "base58.h"
 #include "checkpoints.h"
 #include "coincontrol.h"
+#include "decoyprovider.h"
 #include "kernel.h"
 #include "masternode-budget.h"
 #include "net.h"
@@ -22,7 +23,7 @@
 #include "util.h"
 #include "utilmoneystr.h"
 
-#include "secp256k1.h"
+#include "ecutil.h"
 #include <assert.h>
 #include <boost/algorithm/string.hpp>
 
@@ -34,6 +35,8 @@
 #include "txdb.h"
 #include <boost/algorithm/string/replace.hpp>
 #include <boost/filesystem/operations.hpp>
+#include <boost/bind.hpp>
+#include <boost/scoped_ptr.hpp>
 #include <boost/thread.hpp>
 #include "masternodeconfig.h"
 
@@ -101,7 +104,7 @@ void ECDHInfo::ComputeSharedSec(const CKey& priv, const CPubKey& pubKey, CPubKey
     sharedSec.Set(pubKey.begin(), pubKey.end());
     unsigned char temp[65];
     memcpy(temp, sharedSec.begin(), sharedSec.size());
-    if (!secp256k1_ec_pubkey_tweak_mul(temp, sharedSec.size(), priv.begin()))
+    if (!ECPubKeyTweakMul(temp, sharedSec.size(), priv.begin()))
         throw runtime_error("Cannot compute EC multiplication: secp256k1_ec_pubkey_tweak_mul");
     sharedSec.Set(temp, temp + 33);
 }
@@ -164,6 +167,69 @@ const CWalletTx* CWallet::GetWalletTx(const uint256& hash) const
     return &(it->second);
 }
 
+const CWalletTx* CWallet::GetWalletTxBody(const uint256& hash) const
+{
+    LOCK(cs_wallet);
+    std::map<uint256, CWalletTx>::const_iterator it = mapWallet.find(hash);
+    if (it != mapWallet.end())
+        return &(it->second);
+    if (!mapWalletArchive.count(hash))
+        return NULL;
+
+    std::map<uint256, std::list<std::pair<uint256, CWalletTx> >::iterator>::iterator ci = mapArchivedTxCache.find(hash);
+    if (ci != mapArchivedTxCache.end()) {
+        lruArchivedTx.splice(lruArchivedTx.begin(), lruArchivedTx, ci->second);
+        return &(ci->second->second);
+    }
+
+    CWalletTx wtx;
+    if (!ReadArchivedTx(hash, wtx))
+        return NULL;
+    lruArchivedTx.push_front(std::make_pair(hash, wtx));
+    mapArchivedTxCache[hash] = lruArchivedTx.begin();
+    if (lruArchivedTx.size() > ARCHIVED_TX_CACHE_SIZE) {
+        mapArchivedTxCache.erase(lruArchivedTx.back().first);
+        lruArchivedTx.pop_back();
+    }
+    return &(lruArchivedTx.front().second);
+}
+
+bool CWallet::ReadArchivedTx(const uint256& hash, CWalletTx& wtx) const
+{
+    if (!fFileBacked || !CWalletDB(strWalletFile).ReadArchivedTx(hash, wtx))
+        return error("%s : archived transaction %s missing from the wallet file", __func__, hash.ToString());
+    wtx.BindWallet(const_cast<CWallet*>(this));
+    return true;
+}
+
+CAmount CWallet::GetArchivedOutValue(const uint256& hash, unsigned int n) const
+{
+    AssertLockHeld(cs_wallet);
+    std::map<uint256, CWalletTxMeta>::const_iterator ai = mapWalletArchive.find(hash);
+    if (ai == mapWalletArchive.end() || n >= ai->second.vIsMine.size() || IsLocked())
+        return 0;
+    const CWalletTxMeta& meta = ai->second;
+    if (meta.vAmounts.empty()) {
+        const CWalletTx* pwtx = GetWalletTxBody(hash);
+        if (!pwtx)
+            return 0;
+        meta.vAmounts.resize(pwtx->vout.size(), 0);
+        for (size_t i = 0; i < pwtx->vout.size(); i++)
+            if (meta.vIsMine[i] != ISMINE_NO)
+                meta.vAmounts[i] = getCTxOutValue(*pwtx, pwtx->vout[i]);
+    }
+    return meta.vAmounts[n];
+}
+
+int CWallet::GetArchivedDepth(const CWalletTxMeta& meta) const
+{
+    AssertLockHeld(cs_main);
+    BlockMap::const_iterator mi = mapBlockIndex.find(meta.hashBlock);
+    if (mi == mapBlockIndex.end() || !mi->second || !chainActive.Contains(mi->second))
+        return 0;
+    return chainActive.Height() - mi->second->nHeight + 1;
+}
+
 bool CWallet::checkPassPhraseRule(const char* pass)
 {
     bool upper = false;
@@ -634,6 +700,9 @@ void CWallet::SetBestChain(const CBlockLocator& loc)
 {
     CWalletDB walletdb(strWalletFile);
     walletdb.WriteBestBlock(loc);
+
+    LOCK2(cs_main, cs_wallet);
+    ArchiveSettledTransactions();
 }
 
 bool CWallet::SetMinVersion(enum WalletFeature nVersion, CWalletDB* pwalletdbIn, bool fExplicit)
@@ -718,6 +787,7 @@ void CWallet::SyncMetaData(pair<TxSpends::iterator, TxSpends::iterator> range)
         const uint256& hash = it->second;
         CWalletTx* copyTo = &mapWallet[hash];
         if (copyFrom == copyTo) continue;
+        RemoveFromHistory(hash);
         copyTo->mapValue = copyFrom->mapValue;
         copyTo->vOrderForm = copyFrom->vOrderForm;
         // fTimeReceivedIsTxTime not copied on purpose
@@ -727,9 +797,24 @@ void CWallet::SyncMetaData(pair<TxSpends::iterator, TxSpends::iterator> range)
         copyTo->strFromAccount = copyFrom->strFromAccount;
         // nOrderPos not copied on purpose
         // cached members not copied on purpose
+        AddToHistory(hash);
     }
 }
 
+void CWallet::AddToHistory(const uint256& hash)
+{
+    std::map<uint256, CWalletTx>::const_iterator mi = mapWallet.find(hash);
+    if (mi != mapWallet.end())
+        setTxHistory.insert(std::make_pair(mi->second.GetTxTime(), hash));
+}
+
+void CWallet::RemoveFromHistory(const uint256& hash)
+{
+    std::map<uint256, CWalletTx>::const_iterator mi = mapWallet.find(hash);
+    if (mi != mapWallet.end())
+        setTxHistory.erase(std::make_pair(mi->second.GetTxTime(), hash));
+}
+
 /**
  * Outpoint is spent if any non-conflicted transaction
  * spends it:
@@ -748,6 +833,9 @@ bool CWallet::IsSpent(const uint256& hash, unsigned int n)
             keyImagesSpends[keyImageHex] = true;
             return true; // Spent
         }
+        std::map<uint256, CWalletTxMeta>::const_iterator ait = mapWalletArchive.find(wtxid);
+        if (ait != mapWalletArchive.end() && GetArchivedDepth(ait->second) > 0)
+            return true; // Spent by a settled transaction
     }
 
     std::string outString = outpoint.hash.GetHex() + std::to_string(outpoint.n);
@@ -1037,7 +1125,33 @@ void CWallet::MarkDirty()
     }
 }
 
-bool CWallet::AddToWallet(const CWalletTx& wtxIn, bool fFromLoadWallet)
+bool CWallet::LoadToWallet(const CWalletTx& wtxIn)
+{
+    // Spends and key images are set up by ScanWalletKeyImages once all records are read
+    uint256 hash = wtxIn.GetHash();
+    RemoveFromHistory(hash);
+    mapWallet[hash] = wtxIn;
+    mapWallet[hash].BindWallet(this);
+    AddToHistory(hash);
+    return true;
+}
+
+bool CWallet::LoadArchivedTx(const uint256& hash, const CWalletTxMeta& meta)
+{
+    mapWalletArchive[hash] = meta;
+    setTxHistory.insert(std::make_pair(meta.GetTxTime(), hash));
+    return true;
+}
+
+bool CWallet::LoadKeyImage(const std::string& outpoint, const CKeyImage& ki)
+{
+    if (!ki.IsFullyValid())
+        return false;
+    outpointToKeyImages[outpoint] = ki;
+    return true;
+}
+
+bool CWallet::AddToWallet(const CWalletTx& wtxIn, bool fFromLoadWallet, CWalletDB* pwalletdb)
 {
     uint256 hash = wtxIn.GetHash();
     const uint256& hashBlock = wtxIn.hashBlock;
@@ -1048,13 +1162,17 @@ bool CWallet::AddToWallet(const CWalletTx& wtxIn, bool fFromLoadWallet)
         }
     }
 
-    CWalletDB db(strWalletFile);
+    boost::scoped_ptr<CWalletDB> pwalletdbLocal;
+    if (!pwalletdb) {
+        pwalletdbLocal.reset(new CWalletDB(strWalletFile));
+        pwalletdb = pwalletdbLocal.get();
+    }
     for (size_t i = 0; i < wtxIn.vout.size(); i++) {
         std::string outpoint = hash.GetHex() + std::to_string(i);
         if (outpointToKeyImages.count(outpoint) == 1 && outpointToKeyImages[outpoint].IsValid()) continue;
         CKeyImage ki;
         //reading key image
-        if (db.ReadKeyImage(outpoint, ki)) {
+        if (pwalletdb->ReadKeyImage(outpoint, ki)) {
             if (ki.IsFullyValid()) {
                 outpointToKeyImages[outpoint] = ki;
                 continue;
@@ -1063,17 +1181,22 @@ bool CWallet::AddToWallet(const CWalletTx& wtxIn, bool fFromLoadWallet)
         if (IsMine(wtxIn.vout[i])) {
             if (generateKeyImage(wtxIn.vout[i].scriptPubKey, ki)) {
                 outpointToKeyImages[outpoint] = ki;
-                db.WriteKeyImage(outpoint, ki);
+                pwalletdb->WriteKeyImage(outpoint, ki);
             }
         }
     }
 
     if (fFromLoadWallet) {
+        RemoveFromHistory(hash);
         mapWallet[hash] = wtxIn;
         mapWallet[hash].BindWallet(this);
+        AddToHistory(hash);
         AddToSpends(hash);
     } else {
         LOCK(cs_wallet);
+        // A settled transaction seen again, e.g. after its block was disconnected, is merged into its old entry
+        if (mapWalletArchive.count(hash))
+            RestoreArchivedTx(hash);
         // Inserts only if not already there, returns tx inserted or tx found
         pair<map<uint256, CWalletTx>::iterator, bool> ret = mapWallet.insert(make_pair(hash, wtxIn));
         CWalletTx& wtx = (*ret.first).second;
@@ -1081,7 +1204,7 @@ bool CWallet::AddToWallet(const CWalletTx& wtxIn, bool fFromLoadWallet)
         bool fInsertedNew = ret.second;
         if (fInsertedNew) {
             wtx.nTimeReceived = GetAdjustedTime();
-            wtx.nOrderPos = IncOrderPosNext();
+            wtx.nOrderPos = IncOrderPosNext(pwalletdbLocal ? NULL : pwalletdb);
 
             wtx.nTimeSmart = wtx.nTimeReceived;
             if (wtxIn.hashBlock != 0) {
@@ -1121,6 +1244,7 @@ bool CWallet::AddToWallet(const CWalletTx& wtxIn, bool fFromLoadWallet)
                         wtxIn.GetHash().ToString(),
                         wtxIn.hashBlock.ToString());
             }
+            AddToHistory(hash);
             AddToSpends(hash);
         }
 
@@ -1147,7 +1271,7 @@ bool CWallet::AddToWallet(const CWalletTx& wtxIn, bool fFromLoadWallet)
 
         // Write to disk
         if (fInsertedNew || fUpdated)
-            if (!wtx.WriteToDisk())
+            if (!wtx.WriteToDisk(pwalletdbLocal ? NULL : pwalletdb))
                 return false;
 
         // Break debit/credit balance caches:
@@ -1177,7 +1301,15 @@ bool CWallet::AddToWalletIfInvolvingMe(const CTransaction& tx, const CBlock* pbl
 {
     {
         AssertLockHeld(cs_wallet);
-        bool fExisted = mapWallet.count(tx.GetHash()) != 0;
+        uint256 hash = tx.GetHash();
+        bool fExisted = mapWallet.count(hash) != 0;
+        // Rescans find archived transactions in the block they were archived with, nothing to update then
+        std::map<uint256, CWalletTxMeta>::const_iterator ai = mapWalletArchive.find(hash);
+        if (ai != mapWalletArchive.end()) {
+            if (!fUpdate || (pblock && pblock->GetHash() == ai->second.hashBlock))
+                return false;
+            fExisted = true;
+        }
         if (fExisted && !fUpdate) return false;
         IsTransactionForMe(tx);
         if (pblock && mapBlockIndex.count(pblock->GetHash()) == 1) {
@@ -1223,6 +1355,7 @@ void CWallet::EraseFromWallet(const uint256& hash)
         return;
     {
         LOCK(cs_wallet);
+        RemoveFromHistory(hash);
         if (mapWallet.erase(hash))
             CWalletDB(strWalletFile).EraseTx(hash);
     }
@@ -1241,6 +1374,9 @@ isminetype CWallet::IsMine(const CTxIn& txin) const
             if (prevout.n < prev.vout.size())
                 return IsMine(prev.vout[prevout.n]);
         }
+        std::map<uint256, CWalletTxMeta>::const_iterator ai = mapWalletArchive.find(prevout.hash);
+        if (ai != mapWalletArchive.end() && prevout.n < ai->second.vIsMine.size())
+            return (isminetype)ai->second.vIsMine[prevout.n];
     }
     return ISMINE_NO;
 }
@@ -1255,48 +1391,29 @@ COutPoint CWallet::findMyOutPoint(const CTxIn& txin) const
         if (outpointToKeyImages.count(out) == 1 && outpointToKeyImages[out] == txin.keyImage) return txin.decoys[i];
     }
 
-    COutPoint outpoint;
-    {
-        //AssertLockHeld(cs_wallet); // mapWallet
-        bool ret = false;
-        CWalletTx prev;
-        if (mapWallet.count(txin.prevout.hash))
-            prev = mapWallet[txin.prevout.hash];
-        if (txin.prevout.n < prev.vout.size())
-            ret = IsMine(prev.vout[txin.prevout.n]);
-        if (ret) {
-            CKeyImage ki;
-            if (generateKeyImage(prev.vout[txin.prevout.n].scriptPubKey, ki)) {
-                if (ki == txin.keyImage) {
-                    outpoint = txin.prevout;
-                    prevout = txin.prevout.hash.GetHex() + std::to_string(txin.prevout.n);
-                    outpointToKeyImages[prevout] = ki;
-                    return outpoint;
-                }
-            }
-        }
-
-        for (size_t i = 0; i < txin.decoys.size(); i++) {
-            if (mapWallet.count(txin.decoys[i].hash))
-                prev = mapWallet[txin.decoys[i].hash];
-            else
-                continue;
-            if (txin.decoys[i].n < prev.vout.size())
-                ret = IsMine(prev.vout[txin.decoys[i].n]);
-            if (ret) {
-                CKeyImage ki;
-                if (generateKeyImage(prev.vout[txin.decoys[i].n].scriptPubKey, ki)) {
-                    if (ki == txin.keyImage) {
-                        outpoint = txin.decoys[i];
-                        std::string out = txin.decoys[i].hash.GetHex() + std::to_string(txin.decoys[i].n);
-                        outpointToKeyImages[out] = ki;
-                        return outpoint;
-                    }
-                }
-            }
+    // Only ring members whose key image was never derived are left, deriving one
+    // walks every key of the wallet so members with a known key image are skipped
+    std::vector<COutPoint> vMembers;
+    vMembers.push_back(txin.prevout);
+    vMembers.insert(vMembers.end(), txin.decoys.begin(), txin.decoys.end());
+    for (size_t i = 0; i < vMembers.size(); i++) {
+        const COutPoint& member = vMembers[i];
+        std::string out = member.hash.GetHex() + std::to_string(member.n);
+        std::map<std::string, CKeyImage>::const_iterator kit = outpointToKeyImages.find(out);
+        if (kit != outpointToKeyImages.end() && kit->second.IsValid())
+            continue;
+        std::map<uint256, CWalletTx>::const_iterator mi = mapWallet.find(member.hash);
+        if (mi == mapWallet.end() || member.n >= mi->second.vout.size())
+            continue;
+        const CTxOut& txout = mi->second.vout[member.n];
+        CKeyImage ki;
+        if (IsMine(txout) && generateKeyImage(txout.scriptPubKey, ki)) {
+            outpointToKeyImages[out] = ki;
+            if (ki == txin.keyImage)
+                return member;
         }
     }
-    return outpoint;
+    return COutPoint();
 }
 
 CAmount CWallet::GetDebit(const CTxIn& txin, const isminefilter& filter) const
@@ -1312,6 +1429,10 @@ CAmount CWallet::GetDebit(const CTxIn& txin, const isminefilter& filter) const
                 if (IsMine(prev.vout[prevout.n]) & filter)
                     return getCTxOutValue(prev, prev.vout[prevout.n]);
         }
+        std::map<uint256, CWalletTxMeta>::const_iterator ai = mapWalletArchive.find(prevout.hash);
+        if (ai != mapWalletArchive.end() && prevout.n < ai->second.vIsMine.size())
+            if (ai->second.vIsMine[prevout.n] & filter)
+                return GetArchivedOutValue(prevout.hash, prevout.n);
     }
     return 0;
 }
@@ -1580,8 +1701,10 @@ void CWalletTx::GetAccountAmounts(const string& strAccount, CAmount& nReceived,
 }
 
 
-bool CWalletTx::WriteToDisk()
+bool CWalletTx::WriteToDisk(CWalletDB* pwalletdb)
 {
+    if (pwalletdb)
+        return pwalletdb->WriteTx(GetHash(), *this);
     return CWalletDB(pwallet->strWalletFile).WriteTx(GetHash(), *this);
 }
 
@@ -2534,10 +2657,8 @@ void CWallet::resetPendingOutPoints()
     }
 }
 
-bool CWallet::SelectCoins(bool needFee, CAmount& estimatedFee, int ringSize, int numOut, const CAmount& nTargetValue, set<pair<const CWalletTx*, unsigned int> >& setCoinsRet, CAmount& nValueRet, const CCoinControl* coinControl, AvailableCoinsType coin_type, bool useIX)
+void CWallet::AvailableSpendableCoins(vector<COutput>& vCoins)
 {
-    // Note: this function should never be used for "always free" tx types like dstx
-    vector<COutput> vCoins;
     vCoins.clear();
 
     {
@@ -2590,6 +2711,16 @@ bool CWallet::SelectCoins(bool needFee, CAmount& estimatedFee, int ringSize, int
             }
         }
     }
+}
+
+bool CWallet::SelectCoins(bool needFee, CAmount& estimatedFee, int ringSize, int numOut, const CAmount& nTargetValue, set<pair<const CWalletTx*, unsigned int> >& setCoinsRet, CAmount& nValueRet, const CCoinControl* coinControl, AvailableCoinsType coin_type, bool useIX, const std::vector<COutput>* pvCoins)
+{
+    // Note: this function should never be used for "always free" tx types like dstx
+    vector<COutput> vCoins;
+    if (pvCoins)
+        vCoins = *pvCoins;
+    else
+        AvailableSpendableCoins(vCoins);
 
     // coin control -> return all selected outputs (we want all selected to go into the transaction for sure)
     if (coinControl && coinControl->HasSelected()) {
@@ -3034,15 +3165,16 @@ bool CWallet::IsAutoConsolidateOn()
     return ReadAutoConsolidateSettingTime() == 0;
 }
 
-bool CWallet::CreateTransactionBulletProof(const CKey& txPrivDes, const CPubKey& recipientViewKey, const std::vector<std::pair<CScript, CAmount> >& vecSend, CWalletTx& wtxNew, CReserveKey& reservekey, CAmount& nFeeRet, std::string& strFailReason, const CCoinControl* coinControl, AvailableCoinsType coin_type, bool useIX, CAmount nFeePay, int ringSize, bool tomyself)
+bool CWallet::buildTransactionBulletProof(const CKey& txPrivDes, const CPubKey& recipientViewKey, const std::vector<std::pair<CScript, CAmount> >& vecSend, CWalletTx& wtxNew, CAmount& nFeeRet, std::string& strFailReason, const CCoinControl* coinControl, AvailableCoinsType coin_type, bool useIX, CAmount nFeePay, bool tomyself, std::vector<COutput>* pvCoins, CRingCTInputs& inputs, std::vector<CKey>& vTxPrivKeys)
 {
-    if (useIX && nFeePay < CENT) nFeePay = CENT;
+    AssertLockHeld(cs_main);
+    AssertLockHeld(cs_wallet);
 
     //randomize ring size
     unsigned char rand_seed[16];
     memcpy(rand_seed, txPrivDes.begin(), 16);
     secp256k1_rand_seed(rand_seed);
-    ringSize = MIN_RING_SIZE + secp256k1_rand32() % (MAX_RING_SIZE - MIN_RING_SIZE + 1);
+    int ringSize = MIN_RING_SIZE + secp256k1_rand32() % (MAX_RING_SIZE - MIN_RING_SIZE + 1);
 
     //Currently we only allow transaction with one or two recipients
     //If two, the second recipient is a change output
@@ -3070,128 +3202,151 @@ bool CWallet::CreateTransactionBulletProof(const CKey& txPrivDes, const CPubKey&
     CMutableTransaction txNew;
     txNew.hasPaymentID = wtxNew.hasPaymentID;
     txNew.paymentID = wtxNew.paymentID;
-    CAmount nSpendableBalance = GetSpendableBalance();
-    bool ret = true;
-    {
-        LOCK2(cs_main, cs_wallet);
-        {
-            nFeeRet = 0;
-            if (nFeePay > 0) nFeeRet = nFeePay;
-            unsigned int nBytes = 0;
-            int iterations = 0;
-            while (true && iterations < 10) {
-                iterations++;
-                txNew.vin.clear();
-                txNew.vout.clear();
-                wtxNew.fFromMe = true;
-
-                CAmount nTotalValue = nValue + nFeeRet;
-                double dPriority = 0;
-
-                // vouts to the payees
-                BOOST_FOREACH (const PAIRTYPE(CScript, CAmount) & s, vecSend) {
-                    CTxOut txout(s.second, s.first);
-                    CPubKey txPub = txPrivDes.GetPubKey();
-                    txPrivKeys.push_back(txPrivDes);
-                    std::copy(txPub.begin(), txPub.end(), std::back_inserter(txout.txPub));
-                    if (txout.IsDust(::minRelayTxFee)) {
-                        strFailReason = _("Transaction amount too small");
-                        ret = false;
-                        break;
-                    }
-                    CPubKey sharedSec;
-                    ECDHInfo::ComputeSharedSec(txPrivDes, recipientViewKey, sharedSec);
-                    EncodeTxOutAmount(txout, txout.nValue, sharedSec.begin());
-                    txNew.vout.push_back(txout);
-                    nBytes += ::GetSerializeSize(*(CTxOut*)&txout, SER_NETWORK, PROTOCOL_VERSION);
+    // Payouts of a batch select from what the earlier ones left over and never retry
+    CAmount nSpendableBalance = pvCoins ? 0 : GetSpendableBalance();
+    nFeeRet = 0;
+    if (nFeePay > 0) nFeeRet = nFeePay;
+    bool fBuilt = false;
+    for (int iterations = 0; !fBuilt && iterations < 10; iterations++) {
+        txNew.vin.clear();
+        txNew.vout.clear();
+        vTxPrivKeys.clear();
+        wtxNew.fFromMe = true;
+
+        CAmount nTotalValue = nValue + nFeeRet;
+
+        // vouts to the payees
+        BOOST_FOREACH (const PAIRTYPE(CScript, CAmount) & s, vecSend) {
+            CTxOut txout(s.second, s.first);
+            CPubKey txPub = txPrivDes.GetPubKey();
+            vTxPrivKeys.push_back(txPrivDes);
+            std::copy(txPub.begin(), txPub.end(), std::back_inserter(txout.txPub));
+            if (txout.IsDust(::minRelayTxFee)) {
+                strFailReason = _("Transaction amount too small");
+                return false;
+            }
+            CPubKey sharedSec;
+            ECDHInfo::ComputeSharedSec(txPrivDes, recipientViewKey, sharedSec);
+            EncodeTxOutAmount(txout, txout.nValue, sharedSec.begin());
+            txNew.vout.push_back(txout);
+        }
+
+        // Choose coins to use
+        set<pair<const CWalletTx*, unsigned int> > setCoins;
+        CAmount nValueIn = 0;
+        CAmount estimateFee = 0;
+        if (!SelectCoins(true, estimateFee, ringSize, 2, nTotalValue, setCoins, nValueIn, coinControl, coin_type, useIX, pvCoins)) {
+            strFailReason = "Insufficient funds. Transaction requires a fee of " + ValueFromAmountToString(estimateFee);
+            if (pvCoins) {
+                // Only the coins the earlier payouts left over were available
+            } else if (coin_type == ALL_COINS) {
+                if (nSpendableBalance >= nTotalValue + estimateFee && (setCoins.size() > MAX_TX_INPUTS || nValueIn == 0)) {
+                    strFailReason = _("You have attempted to send more than 50 UTXOs in a single transaction. This is a rare occurrence, and to work around this limitation, please either lower the total amount of the transaction, or send two separate transactions with 50% of your total desired amount.");
                 }
+            } else if (coin_type == ONLY_NOT1000000IFMN) {
+                strFailReason = _("Unable to locate enough funds for this transaction that are not equal 10000 DAPS.");
+            } else if (coin_type == ONLY_NONDENOMINATED_NOT1000000IFMN) {
+                strFailReason = _("Unable to locate enough Obfuscation non-denominated funds for this transaction that are not equal 1000000 DAPS.");
+            } else {
+                strFailReason = _("Unable to locate enough Obfuscation denominated funds for this transaction.");
+                strFailReason += " " + _("Obfuscation uses exact denominated amounts to send funds, you might simply need to anonymize some more coins.");
+            }
 
-                if (!ret) break;
-
-                // Choose coins to use
-                set<pair<const CWalletTx*, unsigned int> > setCoins;
-                CAmount nValueIn = 0;
-                CAmount estimateFee;
-                if (!SelectCoins(true, estimateFee, ringSize, 2, nTotalValue, setCoins, nValueIn, coinControl, coin_type, useIX)) {
-                    if (coin_type == ALL_COINS) {
-                        if (nSpendableBalance < nTotalValue + estimateFee) {
-                            strFailReason = "Insufficient funds. Transaction requires a fee of " + ValueFromAmountToString(estimateFee);
-                        } else if (setCoins.size() > MAX_TX_INPUTS) {
-                            strFailReason = _("You have attempted to send more than 50 UTXOs in a single transaction. This is a rare occurrence, and to work around this limitation, please either lower the total amount of the transaction, or send two separate transactions with 50% of your total desired amount.");
-                        } else if (nValueIn == 0) {
-                            strFailReason = _("You have attempted to send more than 50 UTXOs in a single transaction. This is a rare occurrence, and to work around this limitation, please either lower the total amount of the transaction, or send two separate transactions with 50% of your total desired amount.");
-                        } 
-                    } else if (coin_type == ONLY_NOT1000000IFMN) {
-                        strFailReason = _("Unable to locate enough funds for this transaction that are not equal 10000 DAPS.");
-                    } else if (coin_type == ONLY_NONDENOMINATED_NOT1000000IFMN) {
-                        strFailReason = _("Unable to locate enough Obfuscation non-denominated funds for this transaction that are not equal 1000000 DAPS.");
-                    } else {
-                        strFailReason = _("Unable to locate enough Obfuscation denominated funds for this transaction.");
-                        strFailReason += " " + _("Obfuscation uses exact denominated amounts to send funds, you might simply need to anonymize some more coins.");
-                    }
-
-                    if (useIX) {
-                        strFailReason += " " + _("SwiftX requires inputs with at least 6 confirmations, you might need to wait a few minutes and try again.");
-                    }
+            if (useIX) {
+                strFailReason += " " + _("SwiftX requires inputs with at least 6 confirmations, you might need to wait a few minutes and try again.");
+            }
+            return false;
+        }
 
-                    ret = false;
-                    break;
-                }
+        CAmount nChange = nValueIn - nValue - nFeeRet;
+        if (nChange < 0) {
+            if (!pvCoins && nSpendableBalance > nValueIn) {
+                continue;
+            }
+            strFailReason = _("Insufficient funds.");
+            return false;
+        }
 
-                CAmount nChange = nValueIn - nValue - nFeeRet;
+        // Fill a vout to ourself
+        CScript scriptChange;
+        scriptChange = GetScriptForDestination(coinControl->receiver);
+
+        CTxOut newTxOut(nChange, scriptChange);
+        vTxPrivKeys.push_back(coinControl->txPriv);
+        CPubKey txPubChange = coinControl->txPriv.GetPubKey();
+        std::copy(txPubChange.begin(), txPubChange.end(), std::back_inserter(newTxOut.txPub));
+        //formulae for ring signature size
+        int rsSize = ComputeTxSize(setCoins.size(), 2, ringSize);
+        CAmount nFeeNeeded = max(nFeePay, GetMinimumFee(rsSize, nTxConfirmTarget, mempool));
+        nFeeNeeded += BASE_FEE;
+        LogPrintf("%s: nFeeNeeded=%d, rsSize=%d\n", __func__, nFeeNeeded, rsSize);
+        if (nFeeNeeded < COIN) nFeeNeeded = COIN;
+        newTxOut.nValue -= nFeeNeeded;
+        txNew.nTxFee = nFeeNeeded;
+        if (newTxOut.nValue < 0) {
+            if (!pvCoins && nSpendableBalance > nValueIn) {
+                continue;
+            }
+            strFailReason = "Insufficient funds. Transaction requires a fee of " + ValueFromAmountToString(nFeeNeeded);
+            return false;
+        }
+        CPubKey shared;
+        computeSharedSec(txNew, newTxOut, shared);
+        EncodeTxOutAmount(newTxOut, newTxOut.nValue, shared.begin());
+        if (tomyself)
+            txNew.vout.push_back(newTxOut);
+        else {
+            vector<CTxOut>::iterator position = txNew.vout.begin() + GetRandInt(txNew.vout.size() + 1);
+            txNew.vout.insert(position, newTxOut);
+        }
 
-                if (nChange >= 0) {
-                    // Fill a vout to ourself
-                    CScript scriptChange;
-                    scriptChange = GetScriptForDestination(coinControl->receiver);
+        // Fill vin
+        BOOST_FOREACH (const PAIRTYPE(const CWalletTx*, unsigned int) & coin, setCoins)
+            txNew.vin.push_back(CTxIn(coin.first->GetHash(), coin.second));
 
-                    CTxOut newTxOut(nChange, scriptChange);
-                    txPrivKeys.push_back(coinControl->txPriv);
-                    CPubKey txPubChange = coinControl->txPriv.GetPubKey();
-                    std::copy(txPubChange.begin(), txPubChange.end(), std::back_inserter(newTxOut.txPub));
-                    nBytes += ::GetSerializeSize(*(CTxOut*)&newTxOut, SER_NETWORK, PROTOCOL_VERSION);
-                    //formulae for ring signature size
-                    int rsSize = ComputeTxSize(setCoins.size(), 2, ringSize);
-                    nBytes = rsSize;
-                    CAmount nFeeNeeded = max(nFeePay, GetMinimumFee(nBytes, nTxConfirmTarget, mempool));
-                    nFeeNeeded += BASE_FEE;
-                    LogPrintf("%s: nFeeNeeded=%d, rsSize=%d\n", __func__, nFeeNeeded, rsSize);
-                    if (nFeeNeeded < COIN) nFeeNeeded = COIN;
-                    newTxOut.nValue -= nFeeNeeded;
-                    txNew.nTxFee = nFeeNeeded;
-                    if (newTxOut.nValue < 0) {
-                        if (nSpendableBalance > nValueIn) {
-                            continue;
-                        }
-                        ret = false;
-                        break;
-                    }
-                    CPubKey shared;
-                    computeSharedSec(txNew, newTxOut, shared);
-                    EncodeTxOutAmount(newTxOut, newTxOut.nValue, shared.begin());
-                    if (tomyself)
-                        txNew.vout.push_back(newTxOut);
-                    else {
-                        vector<CTxOut>::iterator position = txNew.vout.begin() + GetRandInt(txNew.vout.size() + 1);
-                        txNew.vout.insert(position, newTxOut);
-                    }
+        // The next payouts of a batch cannot use these inputs again
+        if (pvCoins) {
+            std::vector<COutput>& vCoins = *pvCoins;
+            for (size_t i = 0; i < vCoins.size();) {
+                if (setCoins.count(make_pair(vCoins[i].tx, (unsigned int)vCoins[i].i))) {
+                    vCoins[i] = vCoins.back();
+                    vCoins.pop_back();
                 } else {
-                    if (nSpendableBalance > nValueIn) {
-                        continue;
-                    }
-                    ret = false;
-                    break;
+                    i++;
                 }
+            }
+        }
 
-                // Fill vin
-                BOOST_FOREACH (const PAIRTYPE(const CWalletTx*, unsigned int) & coin, setCoins)
-                    txNew.vin.push_back(CTxIn(coin.first->GetHash(), coin.second));
+        // Embed the constructed transaction data in wtxNew.
+        *static_cast<CTransaction*>(&wtxNew) = CTransaction(txNew);
+        fBuilt = true;
+    }
+    if (!fBuilt) {
+        strFailReason = _("Insufficient funds.");
+        return false;
+    }
 
-                // Embed the constructed transaction data in wtxNew.
-                *static_cast<CTransaction*>(&wtxNew) = CTransaction(txNew);
-                break;
+    if (!selectDecoysAndRealIndex(wtxNew, inputs.myIndex, ringSize)) {
+        strFailReason = _("Not enough decoys for the ring signature, please wait for around 10 minutes and re-try");
+        return false;
+    }
+    return resolveRingCTInputs(wtxNew, inputs, strFailReason);
+}
+
+bool CWallet::CreateTransactionBulletProof(const CKey& txPrivDes, const CPubKey& recipientViewKey, const std::vector<std::pair<CScript, CAmount> >& vecSend, CWalletTx& wtxNew, CReserveKey& reservekey, CAmount& nFeeRet, std::string& strFailReason, const CCoinControl* coinControl, AvailableCoinsType coin_type, bool useIX, CAmount nFeePay, int ringSize, bool tomyself)
+{
+    if (useIX && nFeePay < CENT) nFeePay = CENT;
+
+    bool ret = true;
+    {
+        LOCK2(cs_main, cs_wallet);
+        {
+            CRingCTInputs inputs;
+            if (!buildTransactionBulletProof(txPrivDes, recipientViewKey, vecSend, wtxNew, nFeeRet, strFailReason, coinControl, coin_type, useIX, nFeePay, tomyself, NULL, inputs, txPrivKeys)) {
+                ret = false;
             }
-            if (ret && !makeRingCT(wtxNew, ringSize, strFailReason)) {
+
+            if (ret && !signRingCT(wtxNew, inputs, strFailReason)) {
                 ret = false;
             }
 
@@ -3222,8 +3377,8 @@ bool CWallet::CreateTransactionBulletProof(const CKey& txPrivDes, const CPubKey&
                     std::string key = hash.GetHex() + std::to_string(i);
                     CWalletDB(strWalletFile).WriteTxPrivateKey(key, CBitcoinSecret(txPrivKeys[i]).ToString());
                 }
-                txPrivKeys.clear();
             }
+            txPrivKeys.clear();
         }
     }
 
@@ -3444,6 +3599,11 @@ bool CWallet::CreateTransaction(const vector<pair<CScript, CAmount> >& vecSend,
 }
 
 bool CWallet::generateBulletProofAggregate(CTransaction& tx)
+{
+    return generateBulletProofAggregate(tx, GetScratch());
+}
+
+bool CWallet::generateBulletProofAggregate(CTransaction& tx, secp256k1_scratch_space2* scratch) const
 {
     unsigned char proof[2000];
     size_t len = 2000;
@@ -3461,17 +3621,71 @@ bool CWallet::generateBulletProofAggregate(CTransaction& tx)
         blind_ptr[i] = blinds[i];
         values[i] = tx.vout[i].nValue;
     }
-    int ret = secp256k1_bulletproof_rangeproof_prove(GetContext(), GetScratch(), GetGenerator(), proof, &len, values, NULL, blind_ptr, tx.vout.size(), &secp256k1_generator_const_h, 64, nonce, NULL, 0);
+    int ret = secp256k1_bulletproof_rangeproof_prove(GetContext(), scratch, GetGenerator(), proof, &len, values, NULL, blind_ptr, tx.vout.size(), &secp256k1_generator_const_h, 64, nonce, NULL, 0);
     std::copy(proof, proof + len, std::back_inserter(tx.bulletproofs));
     return ret;
 }
 
 bool CWallet::makeRingCT(CTransaction& wtxNew, int ringSize, std::string& strFailReason)
 {
-    int myIndex;
-    if (!selectDecoysAndRealIndex(wtxNew, myIndex, ringSize)) {
+    CRingCTInputs inputs;
+    if (!selectDecoysAndRealIndex(wtxNew, inputs.myIndex, ringSize)) {
+        strFailReason = _("Not enough decoys for the ring signature, please wait for around 10 minutes and re-try");
+        return false;
+    }
+    if (!resolveRingCTInputs(wtxNew, inputs, strFailReason)) {
         return false;
     }
+    return signRingCT(wtxNew, inputs, strFailReason);
+}
+
+bool CWallet::resolveRingCTInputs(const CTransaction& tx, CRingCTInputs& inputs, std::string& strFailReason) const
+{
+    AssertLockHeld(cs_main);
+    AssertLockHeld(cs_wallet);
+    //position of the real input in each ring, the prevout comes first
+    const int PI = inputs.myIndex + 1;
+    inputs.vSpendKeys.assign(tx.vin.size(), CKey());
+    inputs.vBlinds.assign(tx.vin.size(), CKey());
+    inputs.vAmounts.assign(tx.vin.size(), 0);
+    inputs.vRing.assign(tx.vin.size(), std::vector<CTxOut>());
+    for (size_t i = 0; i < tx.vin.size(); i++) {
+        std::vector<COutPoint> members;
+        members.push_back(tx.vin[i].prevout);
+        members.insert(members.end(), tx.vin[i].decoys.begin(), tx.vin[i].decoys.end());
+        if (PI >= (int)members.size()) {
+            strFailReason = _("All inputs should have the same number of decoys");
+            return false;
+        }
+        std::vector<CTxOut>& ring = inputs.vRing[i];
+        ring.resize(members.size());
+        for (int j = 0; j < (int)members.size(); j++) {
+            if (j == PI) {
+                std::map<uint256, CWalletTx>::const_iterator mi = mapWallet.find(members[j].hash);
+                if (mi == mapWallet.end() || members[j].n >= mi->second.vout.size() ||
+                    !findCorrespondingPrivateKey(mi->second.vout[members[j].n], inputs.vSpendKeys[i])) {
+                    strFailReason = _("Cannot find corresponding private key");
+                    return false;
+                }
+                ring[j] = mi->second.vout[members[j].n];
+                RevealTxOutAmount(mi->second, ring[j], inputs.vAmounts[i], inputs.vBlinds[i]);
+            } else {
+                CTransaction txPrev;
+                uint256 hashBlock;
+                if (!GetTransaction(members[j].hash, txPrev, hashBlock) || members[j].n >= txPrev.vout.size()) {
+                    strFailReason = _("Cannot find the decoys of the ring signature");
+                    return false;
+                }
+                ring[j] = txPrev.vout[members[j].n];
+            }
+        }
+    }
+    return true;
+}
+
+bool CWallet::signRingCT(CTransaction& wtxNew, const CRingCTInputs& inputs, std::string& strFailReason) const
+{
+    const int myIndex = inputs.myIndex;
     secp256k1_context2* both = GetContext();
 
     for (CTxOut& out : wtxNew.vout) {
@@ -3525,46 +3739,27 @@ bool CWallet::makeRingCT(CTransaction& wtxNew, int ringSize, std::string& strFai
     int myBlindsIdx = 0;
     //additional member in the ring = Sum of All input public keys + sum of all input commitments - sum of all output commitments
     for (size_t j = 0; j < wtxNew.vin.size(); j++) {
-        COutPoint myOutpoint;
-        if (myIndex == -1) {
-            myOutpoint = wtxNew.vin[j].prevout;
-        } else {
-            myOutpoint = wtxNew.vin[j].decoys[myIndex];
-        }
-        CTransaction& inTx = mapWallet[myOutpoint.hash];
-        CKey tmp;
-        if (!findCorrespondingPrivateKey(inTx.vout[myOutpoint.n], tmp))
-            throw runtime_error("Cannot find private key corresponding to the input");
-        memcpy(&myBlinds[myBlindsIdx][0], tmp.begin(), 32);
+        memcpy(&myBlinds[myBlindsIdx][0], inputs.vSpendKeys[j].begin(), 32);
         bptr[myBlindsIdx] = &myBlinds[myBlindsIdx][0];
         myBlindsIdx++;
     }
 
     //Collecting input commitments blinding factors
-    for (CTxIn& in : wtxNew.vin) {
-        COutPoint myOutpoint;
-        if (myIndex == -1) {
-            myOutpoint = in.prevout;
-        } else {
-            myOutpoint = in.decoys[myIndex];
-        }
-        CTransaction& inTx = mapWallet[myOutpoint.hash];
+    for (size_t j = 0; j < wtxNew.vin.size(); j++) {
+        const CTxOut& inOut = inputs.vRing[j][myIndex + 1];
         secp256k1_pedersen_commitment inCommitment;
-        if (!secp256k1_pedersen_commitment_parse(both, &inCommitment, &(inTx.vout[myOutpoint.n].commitment[0]))) {
+        if (!secp256k1_pedersen_commitment_parse(both, &inCommitment, &(inOut.commitment[0]))) {
             strFailReason = _("Cannot parse the commitment for inputs");
             return false;
         }
 
         myInputCommiments.push_back(inCommitment);
-        CAmount tempAmount;
-        CKey tmp;
-        RevealTxOutAmount(inTx, inTx.vout[myOutpoint.n], tempAmount, tmp);
-        if (tmp.IsValid()) memcpy(&myBlinds[myBlindsIdx][0], tmp.begin(), 32);
+        if (inputs.vBlinds[j].IsValid()) memcpy(&myBlinds[myBlindsIdx][0], inputs.vBlinds[j].begin(), 32);
         //verify input commitments
         std::vector<unsigned char> recomputedCommitment;
-        if (!CreateCommitment(&myBlinds[myBlindsIdx][0], tempAmount, recomputedCommitment))
+        if (!CreateCommitment(&myBlinds[myBlindsIdx][0], inputs.vAmounts[j], recomputedCommitment))
             throw runtime_error("Cannot create pedersen commitment");
-        if (recomputedCommitment != inTx.vout[myOutpoint.n].commitment) {
+        if (recomputedCommitment != inOut.commitment) {
             strFailReason = _("Input commitments are not correct");
             return false;
         }
@@ -3602,19 +3797,8 @@ bool CWallet::makeRingCT(CTransaction& wtxNew, int ringSize, std::string& strFai
 
     //generating LIJ and RIJ at PI: LIJ[j][PI], RIJ[j][PI], j=0..wtxNew.vin.size()
     for (size_t j = 0; j < wtxNew.vin.size(); j++) {
-        COutPoint myOutpoint;
-        if (myIndex == -1) {
-            myOutpoint = wtxNew.vin[j].prevout;
-        } else {
-            myOutpoint = wtxNew.vin[j].decoys[myIndex];
-        }
-        CTransaction& inTx = mapWallet[myOutpoint.hash];
-        CKey tempPk;
-        //looking for private keys corresponding to my real inputs
-        if (!findCorrespondingPrivateKey(inTx.vout[myOutpoint.n], tempPk)) {
-            strFailReason = _("Cannot find corresponding private key");
-            return false;
-        }
+        //private keys corresponding to my real inputs
+        const CKey& tempPk = inputs.vSpendKeys[j];
         memcpy(AllPrivKeys[j], tempPk.begin(), 32);
         //copying corresponding key images
         memcpy(allKeyImages[j], wtxNew.vin[j].keyImage.begin(), 33);
@@ -3622,7 +3806,7 @@ bool CWallet::makeRingCT(CTransaction& wtxNew, int ringSize, std::string& strFai
         CPubKey tempPubKey = tempPk.GetPubKey();
         memcpy(allInPubKeys[j][PI], tempPubKey.begin(), 33);
 
-        memcpy(allInCommitments[j][PI], &(inTx.vout[myOutpoint.n].commitment[0]), 33);
+        memcpy(allInCommitments[j][PI], &(inputs.vRing[j][PI].commitment[0]), 33);
         CKey alpha;
         alpha.MakeNewKey(true);
         memcpy(ALPHA[j], alpha.begin(), 32);
@@ -3667,25 +3851,16 @@ bool CWallet::makeRingCT(CTransaction& wtxNew, int ringSize, std::string& strFai
 
     //extract all public keys
     for (int i = 0; i < (int)wtxNew.vin.size(); i++) {
-        std::vector<COutPoint> decoysForIn;
-        decoysForIn.push_back(wtxNew.vin[i].prevout);
-        for (int j = 0; j < (int)wtxNew.vin[i].decoys.size(); j++) {
-            decoysForIn.push_back(wtxNew.vin[i].decoys[j]);
-        }
         for (int j = 0; j < (int)wtxNew.vin[0].decoys.size() + 1; j++) {
             if (j != PI) {
-                CTransaction txPrev;
-                uint256 hashBlock;
-                if (!GetTransaction(decoysForIn[j].hash, txPrev, hashBlock)) {
-                    return false;
-                }
+                const CTxOut& member = inputs.vRing[i][j];
                 CPubKey extractedPub;
-                if (!ExtractPubKey(txPrev.vout[decoysForIn[j].n].scriptPubKey, extractedPub)) {
+                if (!ExtractPubKey(member.scriptPubKey, extractedPub)) {
                     strFailReason = _("Cannot extract public key from script pubkey");
                     return false;
                 }
                 memcpy(allInPubKeys[i][j], extractedPub.begin(), 33);
-                memcpy(allInCommitments[i][j], &(txPrev.vout[decoysForIn[j].n].commitment[0]), 33);
+                memcpy(allInCommitments[i][j], &(member.commitment[0]), 33);
             }
         }
     }
@@ -3775,11 +3950,11 @@ bool CWallet::makeRingCT(CTransaction& wtxNew, int ringSize, std::string& strFai
             //compute LIJ
             unsigned char CP[33];
             memcpy(CP, allInPubKeys[j][PI_interator], 33);
-            if (!secp256k1_ec_pubkey_tweak_mul(CP, 33, CI[PI_interator])) {
+            if (!ECPubKeyTweakMul(CP, 33, CI[PI_interator])) {
                 strFailReason = _("Cannot compute LIJ for ring signature in secp256k1_ec_pubkey_tweak_mul");
                 return false;
             }
-            if (!secp256k1_ec_pubkey_tweak_add(CP, 33, SIJ[j][PI_interator])) {
+            if (!ECPubKeyTweakAdd(CP, 33, SIJ[j][PI_interator])) {
                 strFailReason = _("Cannot compute LIJ for ring signature in secp256k1_ec_pubkey_tweak_add");
                 return false;
             }
@@ -3788,7 +3963,7 @@ bool CWallet::makeRingCT(CTransaction& wtxNew, int ringSize, std::string& strFai
             //compute RIJ
             //first compute CI * I
             memcpy(RIJ[j][PI_interator], allKeyImages[j], 33);
-            if (!secp256k1_ec_pubkey_tweak_mul(RIJ[j][PI_interator], 33, CI[PI_interator])) {
+            if (!ECPubKeyTweakMul(RIJ[j][PI_interator], 33, CI[PI_interator])) {
                 strFailReason = _("Cannot compute RIJ for ring signature in secp256k1_ec_pubkey_tweak_mul");
                 return false;
             }
@@ -3847,7 +4022,7 @@ bool CWallet::makeRingCT(CTransaction& wtxNew, int ringSize, std::string& strFai
     for (size_t j = 0; j < wtxNew.vin.size() + 1; j++) {
         unsigned char cx[32];
         memcpy(cx, CI[PI], 32);
-        if (!secp256k1_ec_privkey_tweak_mul(cx, AllPrivKeys[j]))
+        if (!ECPrivKeyTweakMul(cx, AllPrivKeys[j]))
             throw runtime_error("Cannot compute EC mul");
         const unsigned char* sumArray[2];
         sumArray[0] = ALPHA[j];
@@ -3908,8 +4083,8 @@ bool CWallet::MakeShnorrSignatureTxIn(CTxIn& txin, uint256 cts)
 
     unsigned char ex[32];
     memcpy(ex, e.begin(), 32);
-    if (!secp256k1_ec_privkey_tweak_mul(ex, pk.begin())) return false;
-    if (!secp256k1_ec_privkey_tweak_add(ex, r.begin())) return false;
+    if (!ECPrivKeyTweakMul(ex, pk.begin())) return false;
+    if (!ECPrivKeyTweakAdd(ex, r.begin())) return false;
     std::copy(ex, ex + 32, std::back_inserter(txin.s));
     //copy R to masternodeStealthAddress
     std::copy(R, R + 33, std::back_inserter(txin.R));
@@ -3918,7 +4093,7 @@ bool CWallet::MakeShnorrSignatureTxIn(CTxIn& txin, uint256 cts)
 
 bool CWallet::selectDecoysAndRealIndex(CTransaction& tx, int& myIndex, int ringSize)
 {
-    if (coinbaseDecoysPool.size() <= 100) {
+    if (!decoyProvider.IsReady() && coinbaseDecoysPool.size() <= 100) {
         for (int i = chainActive.Height() - Params().COINBASE_MATURITY(); i > 0; i--) {
             if (coinbaseDecoysPool.size() > 100) break;
             CBlockIndex* p = chainActive[i];
@@ -3987,7 +4162,12 @@ bool CWallet::selectDecoysAndRealIndex(CTransaction& tx, int& myIndex, int ringS
 
         pendingKeyImages.push_back(ki.GetHex());
         int numDecoys = 0;
-        if (txPrev.IsCoinAudit() || txPrev.IsCoinBase() || txPrev.IsCoinStake()) {
+        bool fCoinbaseClass = txPrev.IsCoinAudit() || txPrev.IsCoinBase() || txPrev.IsCoinStake();
+        if (decoyProvider.SelectDecoys(tx.vin[i].prevout, fCoinbaseClass, ringSize, DecoyConfirmationMinimum, tx.vin[i].decoys))
+            continue;
+        // Index not loaded yet or too sparse, fall back to the wallet's own pools
+        tx.vin[i].decoys.clear();
+        if (fCoinbaseClass) {
             if ((int)coinbaseDecoysPool.size() >= ringSize * 5) {
                 while (numDecoys < ringSize) {
                     bool duplicated = false;
@@ -4117,7 +4297,7 @@ void CWallet::AddComputedPrivateKey(const CTxOut& out)
         CPubKey txPub = out.txPub;
         //copy R into a
         memcpy(aR, txPub.begin(), txPub.size());
-        if (!secp256k1_ec_pubkey_tweak_mul(aR, txPub.size(), view.begin())) {
+        if (!ECPubKeyTweakMul(aR, txPub.size(), view.begin())) {
             throw runtime_error("Failed to do secp256k1_ec_privkey_tweak_mul");
         }
         uint256 HS = Hash(aR, aR + txPub.size());
@@ -4127,7 +4307,7 @@ void CWallet::AddComputedPrivateKey(const CTxOut& out)
         unsigned char HStemp[32];
         unsigned char spendTemp[32];
         memcpy(HStemp, HS.begin(), 32);
-        if (!secp256k1_ec_privkey_tweak_add(HStemp, spend.begin()))
+        if (!ECPrivKeyTweakAdd(HStemp, spend.begin()))
             throw runtime_error("Failed to do secp256k1_ec_privkey_tweak_add");
         CKey privKey;
         privKey.Set(HStemp, HStemp + 32, true);
@@ -4664,6 +4844,85 @@ bool CWallet::CommitTransaction(CWalletTx& wtxNew, CReserveKey& reservekey, std:
     return true;
 }
 
+bool CWallet::CommitTransactions(std::vector<CWalletTx>& vwtxNew, const std::vector<std::vector<CKey> >& vTxPrivKeys, std::string strCommand, std::vector<char>* pvAccepted, std::vector<CValidationState>* pvState)
+{
+    LOCK2(cs_main, cs_wallet);
+    if (pvAccepted)
+        pvAccepted->assign(vwtxNew.size(), 0);
+    std::vector<CValidationState> vState(vwtxNew.size());
+
+    // Only payouts the mempool took are recorded, a rejected one never reaches the wallet
+    std::vector<size_t> vAccepted;
+    for (size_t n = 0; n < vwtxNew.size(); n++) {
+        if (!vwtxNew[n].AcceptToMemoryPool(vState[n], false)) {
+            LogPrintf("CommitTransactions() : Error: Transaction %s not valid\n", vwtxNew[n].GetHash().GetHex());
+            continue;
+        }
+        vAccepted.push_back(n);
+        if (pvAccepted)
+            (*pvAccepted)[n] = 1;
+    }
+
+    {
+        // Everything goes through one handle so it can share a single database transaction
+        CWalletDB walletdb(strWalletFile);
+        bool fTxn = fFileBacked && walletdb.TxnBegin();
+        BOOST_FOREACH (size_t n, vAccepted) {
+            CWalletTx& wtxNew = vwtxNew[n];
+            LogPrintf("CommitTransactions: %s\n", wtxNew.GetHash().GetHex());
+            AddToWallet(wtxNew, false, &walletdb);
+
+            uint256 hash = wtxNew.GetHash();
+            size_t maxTxPrivKeys = n < vTxPrivKeys.size() ? std::min(vTxPrivKeys[n].size(), wtxNew.vout.size()) : 0;
+            for (size_t i = 0; i < maxTxPrivKeys; i++) {
+                std::string key = hash.GetHex() + std::to_string(i);
+                walletdb.WriteTxPrivateKey(key, CBitcoinSecret(vTxPrivKeys[n][i]).ToString());
+            }
+        }
+        if (fTxn && !walletdb.TxnCommit()) {
+            // Nothing was stored, so take the payouts back out before anything relays them
+            std::list<CTransaction> removed;
+            BOOST_FOREACH (size_t n, vAccepted) {
+                uint256 hash = vwtxNew[n].GetHash();
+                mempool.remove(vwtxNew[n], removed, true);
+                RemoveFromHistory(hash);
+                mapWallet.erase(hash);
+                NotifyTransactionChanged(this, hash, CT_DELETED);
+                if (pvAccepted)
+                    (*pvAccepted)[n] = 0;
+                vState[n].Error("wallet write failed");
+            }
+            if (pvState)
+                pvState->swap(vState);
+            return error("CommitTransactions() : failed to write %u transactions to the wallet", vAccepted.size());
+        }
+
+        // Notify that old coins are spent
+        set<uint256> updated_hahes;
+        BOOST_FOREACH (size_t n, vAccepted) {
+            BOOST_FOREACH (const CTxIn& txin, vwtxNew[n].vin) {
+                // notify only once
+                COutPoint prevout = findMyOutPoint(txin);
+                if (updated_hahes.find(prevout.hash) != updated_hahes.end()) continue;
+
+                CWalletTx& coin = mapWallet[prevout.hash];
+                coin.BindWallet(this);
+                NotifyTransactionChanged(this, prevout.hash, CT_UPDATED);
+                updated_hahes.insert(prevout.hash);
+            }
+        }
+    }
+
+    // Broadcast
+    BOOST_FOREACH (size_t n, vAccepted) {
+        mapRequestCount[vwtxNew[n].GetHash()] = 0;
+        vwtxNew[n].RelayWalletTransaction(strCommand);
+    }
+    if (pvState)
+        pvState->swap(vState);
+    return vAccepted.size() == vwtxNew.size();
+}
+
 CAmount CWallet::GetMinimumFee(unsigned int nTxBytes, unsigned int nConfirmTarget, const CTxMemPool& pool)
 {
     CAmount nFeeNeeded = payTxFee.GetFee(nTxBytes);
@@ -4821,13 +5080,155 @@ string CWallet::PrepareObfuscationDenominate(int minRounds, int maxRounds)
 
 void CWallet::ScanWalletKeyImages()
 {
-    if (IsLocked()) return;
-    CWalletDB db(strWalletFile);
+    LOCK(cs_wallet);
+    int64_t nStart = GetTimeMillis();
+
+    // Key images of owned outputs come from the "outpointkeyimage" records read
+    // together with the transactions. Outputs without one (wallets written by older
+    // versions) are derived once here and stored, so the next start reads them too.
+    boost::scoped_ptr<CWalletDB> pwalletdb;
+    int nDerived = 0;
+    if (!IsLocked()) {
+        for (map<uint256, CWalletTx>::const_iterator it = mapWallet.begin(); it != mapWallet.end(); ++it) {
+            const CWalletTx& wtx = it->second;
+            for (size_t i = 0; i < wtx.vout.size(); i++) {
+                std::string outpoint = it->first.GetHex() + std::to_string(i);
+                std::map<std::string, CKeyImage>::const_iterator kit = outpointToKeyImages.find(outpoint);
+                if (kit != outpointToKeyImages.end() && kit->second.IsValid())
+                    continue;
+                CKeyImage ki;
+                if (IsMine(wtx.vout[i]) && generateKeyImage(wtx.vout[i].scriptPubKey, ki)) {
+                    outpointToKeyImages[outpoint] = ki;
+                    if (!pwalletdb)
+                        pwalletdb.reset(new CWalletDB(strWalletFile));
+                    pwalletdb->WriteKeyImage(outpoint, ki);
+                    nDerived++;
+                }
+            }
+        }
+    }
+
+    // Every transaction is in mapWallet now, so spends resolve whatever order they were read in
+    for (map<uint256, CWalletTx>::const_iterator it = mapWallet.begin(); it != mapWallet.end(); ++it)
+        AddToSpends(it->first);
+
+    LogPrintf("ScanWalletKeyImages(): %u transactions, %u key images derived  %dms\n", mapWallet.size(), nDerived, GetTimeMillis() - nStart);
+}
+
+//! Settled transactions moved per wallet.dat transaction, so the first pass over an old wallet stays bounded
+static const size_t WALLET_ARCHIVE_BATCH_SIZE = 1000;
+
+int CWallet::ArchiveSettledTransactions()
+{
+    AssertLockHeld(cs_main);
+    AssertLockHeld(cs_wallet);
+    int nArchiveDepth = GetArg("-walletarchivedepth", DEFAULT_WALLET_ARCHIVE_DEPTH);
+    if (!fFileBacked || nArchiveDepth <= 0 || fImporting || fReindex)
+        return 0;
+    nArchiveDepth = std::max(nArchiveDepth, COINBASE_MATURITY + 1);
+    int64_t nStart = GetTimeMillis();
+
+    // A transaction is settled when every output of ours has a stored key image and a spend
+    // buried as deep as the transaction itself. It can no longer change the balance and the
+    // spends of its outputs are still found from the key images.
+    std::vector<uint256> vSettled;
     for (map<uint256, CWalletTx>::const_iterator it = mapWallet.begin(); it != mapWallet.end(); ++it) {
-        const CWalletTx wtxIn = it->second;
-        uint256 hash = wtxIn.GetHash();
-        AddToSpends(hash);
+        const CWalletTx& wtx = it->second;
+        if (wtx.GetBlocksToMaturity() > 0 || wtx.GetDepthInMainChain() < nArchiveDepth)
+            continue;
+        bool fSettled = true;
+        for (size_t i = 0; i < wtx.vout.size() && fSettled; i++) {
+            if (IsMine(wtx.vout[i]) == ISMINE_NO)
+                continue;
+            std::map<std::string, CKeyImage>::const_iterator kit = outpointToKeyImages.find(it->first.GetHex() + std::to_string(i));
+            if (kit == outpointToKeyImages.end() || !kit->second.IsValid()) {
+                fSettled = false;
+                break;
+            }
+            bool fSpentDeep = false;
+            std::pair<TxSpends::const_iterator, TxSpends::const_iterator> range = mapTxSpends.equal_range(COutPoint(it->first, i));
+            for (TxSpends::const_iterator sit = range.first; sit != range.second && !fSpentDeep; ++sit) {
+                std::map<uint256, CWalletTx>::const_iterator mit = mapWallet.find(sit->second);
+                std::map<uint256, CWalletTxMeta>::const_iterator ait = mapWalletArchive.find(sit->second);
+                if (mit != mapWallet.end())
+                    fSpentDeep = mit->second.GetDepthInMainChain() >= nArchiveDepth;
+                else if (ait != mapWalletArchive.end())
+                    fSpentDeep = GetArchivedDepth(ait->second) >= nArchiveDepth;
+            }
+            fSettled = fSpentDeep;
+        }
+        if (fSettled)
+            vSettled.push_back(it->first);
     }
+    if (vSettled.empty())
+        return 0;
+
+    CWalletDB walletdb(strWalletFile);
+    // Clients that do not know the archive would load the wallet without its archived history
+    SetMinVersion(FEATURE_WALLETARCHIVE, &walletdb);
+    size_t nArchived = 0;
+    for (size_t nBegin = 0; nBegin < vSettled.size(); nBegin += WALLET_ARCHIVE_BATCH_SIZE) {
+        size_t nEnd = std::min(nBegin + WALLET_ARCHIVE_BATCH_SIZE, vSettled.size());
+        std::vector<CWalletTxMeta> vMeta(nEnd - nBegin);
+        if (!walletdb.TxnBegin())
+            break;
+        bool fWritten = true;
+        for (size_t n = nBegin; n < nEnd && fWritten; n++) {
+            const CWalletTx& wtx = mapWallet[vSettled[n]];
+            CWalletTxMeta& meta = vMeta[n - nBegin];
+            meta.hashBlock = wtx.hashBlock;
+            meta.nIndex = wtx.nIndex;
+            meta.nTimeReceived = wtx.nTimeReceived;
+            meta.nTimeSmart = wtx.nTimeSmart;
+            meta.nOrderPos = wtx.nOrderPos;
+            meta.nTxFee = wtx.nTxFee;
+            for (size_t i = 0; i < wtx.vout.size(); i++)
+                meta.vIsMine.push_back((unsigned char)IsMine(wtx.vout[i]));
+            if (!IsLocked()) {
+                meta.vAmounts.resize(wtx.vout.size(), 0);
+                for (size_t i = 0; i < wtx.vout.size(); i++)
+                    if (meta.vIsMine[i] != ISMINE_NO)
+                        meta.vAmounts[i] = getCTxOutValue(wtx, wtx.vout[i]);
+            }
+            fWritten = walletdb.WriteArchivedTx(vSettled[n], wtx, meta);
+        }
+        if (!fWritten || !walletdb.TxnCommit()) {
+            walletdb.TxnAbort();
+            LogPrintf("ArchiveSettledTransactions() : failed to write archived transactions to the wallet\n");
+            break;
+        }
+        // setTxHistory is unchanged, the metadata keeps the times it is keyed by
+        for (size_t n = nBegin; n < nEnd; n++) {
+            mapWallet.erase(vSettled[n]);
+            mapWalletArchive[vSettled[n]] = vMeta[n - nBegin];
+        }
+        nArchived += nEnd - nBegin;
+    }
+
+    LogPrintf("ArchiveSettledTransactions(): %u archived, %u resident, %u archived in total  %dms\n", nArchived, mapWallet.size(), mapWalletArchive.size(), GetTimeMillis() - nStart);
+    return nArchived;
+}
+
+bool CWallet::RestoreArchivedTx(const uint256& hash)
+{
+    AssertLockHeld(cs_wallet);
+    CWalletTx wtx;
+    if (!ReadArchivedTx(hash, wtx))
+        return false;
+    CWalletDB walletdb(strWalletFile);
+    if (!walletdb.WriteTx(hash, wtx) || !walletdb.EraseArchivedTx(hash))
+        return error("%s : failed to restore archived transaction %s", __func__, hash.ToString());
+
+    std::map<uint256, std::list<std::pair<uint256, CWalletTx> >::iterator>::iterator ci = mapArchivedTxCache.find(hash);
+    if (ci != mapArchivedTxCache.end()) {
+        lruArchivedTx.erase(ci->second);
+        mapArchivedTxCache.erase(ci);
+    }
+    mapWalletArchive.erase(hash);
+    mapWallet[hash] = wtx;
+    mapWallet[hash].BindWallet(this);
+    AddToSpends(hash);
+    return true;
 }
 
 DBErrors CWallet::LoadWallet(bool& fFirstRunRet)
@@ -5096,6 +5497,7 @@ void CWallet::CreatePrivacyAccount(bool forceNew)
             walletdb.AppendStealthAccountList("masteraccount");
             break;
         }
+        ResetAccountKeyCache();
     }
 }
 
@@ -6286,6 +6688,11 @@ int CMerkleTx::GetBlocksToMaturity() const
 bool CMerkleTx::AcceptToMemoryPool(bool fLimitFree, bool fRejectInsaneFee, bool ignoreFees)
 {
     CValidationState state;
+    return AcceptToMemoryPool(state, fLimitFree, fRejectInsaneFee, ignoreFees);
+}
+
+bool CMerkleTx::AcceptToMemoryPool(CValidationState& state, bool fLimitFree, bool fRejectInsaneFee, bool ignoreFees)
+{
     bool fAccepted = ::AcceptToMemoryPool(mempool, state, *this, fLimitFree, NULL, fRejectInsaneFee, ignoreFees);
     if (!fAccepted)
         LogPrintf("%s : %s\n", __func__, state.GetRejectReason());
@@ -6555,14 +6962,14 @@ bool computeStealthDestination(const CKey& secret, const CPubKey& pubViewKey, co
     unsigned char rA[65];
     unsigned char B[65];
     memcpy(rA, pubViewKey.begin(), pubViewKey.size());
-    if (!secp256k1_ec_pubkey_tweak_mul(rA, pubViewKey.size(), secret.begin())) {
+    if (!ECPubKeyTweakMul(rA, pubViewKey.size(), secret.begin())) {
         return false;
     }
     uint256 HS = Hash(rA, rA + pubViewKey.size());
 
     memcpy(B, pubSpendKey.begin(), pubSpendKey.size());
 
-    if (!secp256k1_ec_pubkey_tweak_add(B, pubSpendKey.size(), HS.begin()))
+    if (!ECPubKeyTweakAdd(B, pubSpendKey.size(), HS.begin()))
         throw runtime_error("Cannot compute stealth destination");
     des.Set(B, B + pubSpendKey.size());
     return true;
@@ -6657,6 +7064,173 @@ bool CWallet::SendToStealthAddress(const std::string& stealthAddr, const CAmount
     return true;
 }
 
+bool CWallet::createStealthPayout(const std::string& stealthAddr, const CAmount nValue, bool tomyself, std::vector<COutput>& vCoins, CWalletTx& wtxNew, CRingCTInputs& inputs, std::vector<CKey>& vTxPrivKeys, std::string& strFailReason)
+{
+    AssertLockHeld(cs_main);
+    AssertLockHeld(cs_wallet);
+    if (nValue <= 0) {
+        strFailReason = _("Transaction amounts must be positive");
+        return false;
+    }
+    CPubKey pubViewKey, pubSpendKey;
+    bool hasPaymentID;
+    uint64_t paymentID;
+    if (!CWallet::DecodeStealthAddress(stealthAddr, pubViewKey, pubSpendKey, hasPaymentID, paymentID)) {
+        strFailReason = "Stealth address mal-formatted";
+        return false;
+    }
+
+    // Generate transaction public key
+    CKey secret;
+    secret.MakeNewKey(true);
+    wtxNew.txPrivM.Set(secret.begin(), secret.end(), true);
+    wtxNew.hasPaymentID = 0;
+    if (hasPaymentID) {
+        wtxNew.hasPaymentID = 1;
+        wtxNew.paymentID = paymentID;
+    }
+    CPubKey stealthDes;
+    computeStealthDestination(secret, pubViewKey, pubSpendKey, stealthDes);
+
+    CKey spend, view;
+    mySpendPrivateKey(spend);
+    myViewPrivateKey(view);
+    CKey secretChange;
+    secretChange.MakeNewKey(true);
+    CPubKey changeDes;
+    computeStealthDestination(secretChange, view.GetPubKey(), spend.GetPubKey(), changeDes);
+    CCoinControl control;
+    control.destChange = CBitcoinAddress(changeDes.GetID()).Get();
+    control.receiver = changeDes;
+    control.txPriv = secretChange;
+
+    vector<pair<CScript, CAmount> > vecSend;
+    vecSend.push_back(make_pair(GetScriptForDestination(stealthDes), nValue));
+    CAmount nFeeRet;
+    return buildTransactionBulletProof(secret, pubViewKey, vecSend, wtxNew, nFeeRet, strFailReason, &control, ALL_COINS, false, 0, tomyself, &vCoins, inputs, vTxPrivKeys);
+}
+
+void CWallet::signStealthPayouts(std::vector<CWalletTx>* pvwtx, const std::vector<CRingCTInputs>* pvInputs, std::vector<char>* pvSigned, std::vector<std::string>* pvFailReason, size_t nBegin, size_t nEnd) const
+{
+    // The scratch space behind GetScratch() is not thread safe, each worker proves with its own
+    secp256k1_scratch_space2* scratch = secp256k1_scratch_space_create(GetContext(), 1024 * 1024 * 512);
+    for (size_t i = nBegin; i < nEnd; i++) {
+        CWalletTx& wtx = (*pvwtx)[i];
+        std::string& strFailReason = (*pvFailReason)[i];
+        try {
+            if (!signRingCT(wtx, (*pvInputs)[i], strFailReason))
+                continue;
+            if (!generateBulletProofAggregate(wtx, scratch)) {
+                strFailReason = _("Failed to generate bulletproof");
+                continue;
+            }
+        } catch (const std::exception& e) {
+            strFailReason = e.what();
+            continue;
+        }
+        //set transaction output amounts as 0
+        for (size_t j = 0; j < wtx.vout.size(); j++)
+            wtx.vout[j].nValue = 0;
+        (*pvSigned)[i] = 1;
+    }
+    secp256k1_scratch_space_destroy(scratch);
+}
+
+bool CWallet::SendToStealthAddresses(const std::vector<std::pair<std::string, CAmount> >& vecSend, std::vector<CWalletTx>& vwtxNew, std::vector<char>& vSent, std::vector<std::string>& vRejectReason, std::string& strFailReason, bool fUseIX)
+{
+    vwtxNew.clear();
+    vSent.clear();
+    vRejectReason.clear();
+    if (vecSend.empty() || vecSend.size() > MAX_STEALTH_PAYOUTS) {
+        strFailReason = strprintf("Number of payouts must be between 1 and %u", MAX_STEALTH_PAYOUTS);
+        return false;
+    }
+    if (IsLocked()) {
+        strFailReason = "Error: Wallet locked, unable to create transaction!";
+        return false;
+    }
+
+    std::string myAddress;
+    ComputeStealthPublicAddress("masteraccount", myAddress);
+    SetMinVersion(FEATURE_COMPRPUBKEY);
+
+    LOCK2(cs_main, cs_wallet);
+    int64_t nTimeStart = GetTimeMicros();
+
+    // One pass over the wallet, payouts take their inputs out of vCoins in turn
+    std::vector<COutput> vCoins;
+    AvailableSpendableCoins(vCoins);
+
+    vwtxNew.resize(vecSend.size());
+    std::vector<CRingCTInputs> vInputs(vecSend.size());
+    std::vector<std::vector<CKey> > vTxPrivKeys(vecSend.size());
+    for (size_t n = 0; n < vecSend.size(); n++) {
+        if (!createStealthPayout(vecSend[n].first, vecSend[n].second, vecSend[n].first == myAddress, vCoins, vwtxNew[n], vInputs[n], vTxPrivKeys[n], strFailReason)) {
+            strFailReason = strprintf("Payout %u to %s: %s", n, vecSend[n].first, strFailReason);
+            LogPrintf("SendToStealthAddresses() : %s\n", strFailReason);
+            inSpendQueueOutpointsPerSession.clear();
+            vwtxNew.clear();
+            return false;
+        }
+    }
+    int64_t nTimeBuild = GetTimeMicros();
+
+    // MLSAGs and bulletproofs only need what was resolved above, sign them on all cores
+    GetGenerator();
+    int nThreads = std::max((int)boost::thread::hardware_concurrency(), 1);
+    size_t nPerThread = (vwtxNew.size() + nThreads - 1) / nThreads;
+    std::vector<char> vSigned(vwtxNew.size(), 0);
+    std::vector<std::string> vFailReason(vwtxNew.size());
+    boost::thread_group signers;
+    for (size_t nBegin = nPerThread; nBegin < vwtxNew.size(); nBegin += nPerThread)
+        signers.create_thread(boost::bind(&CWallet::signStealthPayouts, this, &vwtxNew, &vInputs, &vSigned, &vFailReason, nBegin, std::min(nBegin + nPerThread, vwtxNew.size())));
+    signStealthPayouts(&vwtxNew, &vInputs, &vSigned, &vFailReason, 0, std::min(nPerThread, vwtxNew.size()));
+    signers.join_all();
+    int64_t nTimeSign = GetTimeMicros();
+
+    for (size_t n = 0; n < vwtxNew.size(); n++) {
+        if (!vSigned[n]) {
+            strFailReason = strprintf("Payout %u to %s: %s", n, vecSend[n].first, vFailReason[n].empty() ? _("Failed to create ring signature") : vFailReason[n]);
+            LogPrintf("SendToStealthAddresses() : %s\n", strFailReason);
+            inSpendQueueOutpointsPerSession.clear();
+            vwtxNew.clear();
+            return false;
+        }
+    }
+
+    std::vector<CValidationState> vState;
+    bool fAll = CommitTransactions(vwtxNew, vTxPrivKeys, (!fUseIX ? "tx" : "ix"), &vSent, &vState);
+    size_t nSent = std::count(vSent.begin(), vSent.end(), 1);
+    vRejectReason.resize(vwtxNew.size());
+    for (size_t n = 0; n < vwtxNew.size(); n++)
+        if (!vSent[n])
+            vRejectReason[n] = vState[n].GetRejectReason().empty() ? "rejected by the mempool" : vState[n].GetRejectReason();
+    if (fAll) {
+        for (size_t i = 0; i < inSpendQueueOutpointsPerSession.size(); i++) {
+            inSpendQueueOutpoints[inSpendQueueOutpointsPerSession[i]] = true;
+        }
+    } else {
+        // Payouts the mempool took are already in the wallet and broadcast, only their inputs are queued
+        for (size_t n = 0; n < vwtxNew.size(); n++) {
+            if (!vSent[n])
+                continue;
+            BOOST_FOREACH (const CTxIn& txin, vwtxNew[n].vin) {
+                COutPoint prevout = findMyOutPoint(txin);
+                if (!prevout.hash.IsNull())
+                    inSpendQueueOutpoints[prevout] = true;
+            }
+        }
+        size_t nFirst = std::find(vSent.begin(), vSent.end(), 0) - vSent.begin();
+        strFailReason = strprintf("Payout %u to %s: %s", nFirst, vecSend[nFirst].first, vRejectReason[nFirst]);
+        LogPrintf("SendToStealthAddresses() : %u of %u payouts rejected, first %s\n", vwtxNew.size() - nSent, vwtxNew.size(), strFailReason);
+    }
+    inSpendQueueOutpointsPerSession.clear();
+
+    LogPrint("bench", "SendToStealthAddresses: %u payouts, build %.2fms, sign %.2fms (%d threads), commit %.2fms\n", vwtxNew.size(),
+        0.001 * (nTimeBuild - nTimeStart), 0.001 * (nTimeSign - nTimeBuild), nThreads, 0.001 * (GetTimeMicros() - nTimeSign));
+    return nSent > 0;
+}
+
 bool CWallet::IsTransactionForMe(const CTransaction& tx)
 {
     LOCK(cs_wallet);
@@ -6689,14 +7263,14 @@ bool CWallet::IsTransactionForMe(const CTransaction& tx)
                 unsigned char aR[65];
                 //copy R into a
                 memcpy(aR, txPub.begin(), txPub.size());
-                if (!secp256k1_ec_pubkey_tweak_mul(aR, txPub.size(), view.begin())) {
+                if (!ECPubKeyTweakMul(aR, txPub.size(), view.begin())) {
                     return false;
                 }
                 uint256 HS = Hash(aR, aR + txPub.size());
                 unsigned char* pHS = HS.begin();
                 unsigned char expectedDestination[65];
                 memcpy(expectedDestination, pubSpendKey.begin(), pubSpendKey.size());
-                if (!secp256k1_ec_pubkey_tweak_add(expectedDestination, pubSpendKey.size(), pHS)) {
+                if (!ECPubKeyTweakAdd(expectedDestination, pubSpendKey.size(), pHS)) {
                     continue;
                 }
                 CPubKey expectedDes(expectedDestination, expectedDestination + 33);
@@ -6714,7 +7288,7 @@ bool CWallet::IsTransactionForMe(const CTransaction& tx)
                     unsigned char spendTemp[32];
                     memcpy(HStemp, HS.begin(), 32);
                     memcpy(spendTemp, spend.begin(), 32);
-                    if (!secp256k1_ec_privkey_tweak_add(HStemp, spendTemp))
+                    if (!ECPrivKeyTweakAdd(HStemp, spendTemp))
                         throw runtime_error("Failed to do secp256k1_ec_privkey_tweak_add");
                     CKey privKey;
                     privKey.Set(HStemp, HStemp + 32, true);
@@ -6767,32 +7341,48 @@ bool CWallet::allMyPrivateKeys(std::vector<CKey>& spends, std::vector<CKey>& vie
     if (IsLocked()) {
         return false;
     }
-    std::string labelList;
     CKey spend, view;
     mySpendPrivateKey(spend);
     myViewPrivateKey(view);
     spends.push_back(spend);
     views.push_back(view);
 
-    if (!ReadAccountList(labelList)) {
-        return false;
-    }
-    std::vector<std::string> results;
-    boost::split(results, labelList, [](char c) { return c == ','; });
-    for (size_t i = 0; i < results.size(); i++) {
-        std::string& accountName = results[i];
-        CStealthAccount stealthAcc;
-        if (ReadStealthAccount(accountName, stealthAcc)) {
-            CKey accSpend, accView;
-            GetKey(stealthAcc.spendAccount.vchPubKey.GetID(), accSpend);
-            GetKey(stealthAcc.viewAccount.vchPubKey.GetID(), accView);
-            spends.push_back(accSpend);
-            views.push_back(accView);
+    LOCK(cs_wallet);
+    if (!fAccountKeyIDsLoaded) {
+        std::string labelList;
+        if (!ReadAccountList(labelList)) {
+            return false;
+        }
+        std::vector<std::string> results;
+        boost::split(results, labelList, [](char c) { return c == ','; });
+        vAccountKeyIDs.clear();
+        for (size_t i = 0; i < results.size(); i++) {
+            std::string& accountName = results[i];
+            CStealthAccount stealthAcc;
+            if (ReadStealthAccount(accountName, stealthAcc))
+                vAccountKeyIDs.push_back(std::make_pair(stealthAcc.spendAccount.vchPubKey.GetID(), stealthAcc.viewAccount.vchPubKey.GetID()));
         }
+        fAccountKeyIDsLoaded = true;
+    }
+    for (size_t i = 0; i < vAccountKeyIDs.size(); i++) {
+        CKey accSpend, accView;
+        GetKey(vAccountKeyIDs[i].first, accSpend);
+        GetKey(vAccountKeyIDs[i].second, accView);
+        spends.push_back(accSpend);
+        views.push_back(accView);
     }
     return true;
 }
 
+void CWallet::ResetAccountKeyCache()
+{
+    LOCK(cs_wallet);
+    spendKeyID = CKeyID();
+    viewKeyID = CKeyID();
+    vAccountKeyIDs.clear();
+    fAccountKeyIDsLoaded = false;
+}
+
 CBitcoinAddress GetAccountAddress(uint32_t nAccountIndex, string strAccount, CWallet* pwalletMain)
 {
     CWalletDB walletdb(pwalletMain->strWalletFile);
@@ -6965,16 +7555,18 @@ bool CWallet::mySpendPrivateKey(CKey& spend) const
             LogPrintf("%s:Wallet is locked\n", __func__);
             return false;
         }
-        std::string spendAccountLabel = "spendaccount";
-        CAccount spendAccount;
-        CWalletDB pDB(strWalletFile);
-        if (!pDB.ReadAccount(spendAccountLabel, spendAccount)) {
-            LogPrintf("Cannot Load Spend private key, now create the master keys");
-            createMasterKey();
-            pDB.ReadAccount(spendAccountLabel, spendAccount);
+        if (spendKeyID.IsNull()) {
+            std::string spendAccountLabel = "spendaccount";
+            CAccount spendAccount;
+            CWalletDB pDB(strWalletFile);
+            if (!pDB.ReadAccount(spendAccountLabel, spendAccount)) {
+                LogPrintf("Cannot Load Spend private key, now create the master keys");
+                createMasterKey();
+                pDB.ReadAccount(spendAccountLabel, spendAccount);
+            }
+            spendKeyID = spendAccount.vchPubKey.GetID();
         }
-        const CKeyID& keyID = spendAccount.vchPubKey.GetID();
-        GetKey(keyID, spend);
+        GetKey(spendKeyID, spend);
     }
     return true;
 }
@@ -6986,16 +7578,18 @@ bool CWallet::myViewPrivateKey(CKey& view) const
             LogPrintf("%s:Wallet is locked\n", __func__);
             return false;
         }
-        std::string viewAccountLabel = "viewaccount";
-        CAccount viewAccount;
-        CWalletDB pDB(strWalletFile);
-        if (!pDB.ReadAccount(viewAccountLabel, viewAccount)) {
-            LogPrintf("Cannot Load view private key, now create the master keys");
-            createMasterKey();
-            pDB.ReadAccount(viewAccountLabel, viewAccount);
+        if (viewKeyID.IsNull()) {
+            std::string viewAccountLabel = "viewaccount";
+            CAccount viewAccount;
+            CWalletDB pDB(strWalletFile);
+            if (!pDB.ReadAccount(viewAccountLabel, viewAccount)) {
+                LogPrintf("Cannot Load view private key, now create the master keys");
+                createMasterKey();
+                pDB.ReadAccount(viewAccountLabel, viewAccount);
+            }
+            viewKeyID = viewAccount.vchPubKey.GetID();
         }
-        const CKeyID& keyID = viewAccount.vchPubKey.GetID();
-        GetKey(keyID, view);
+        GetKey(viewKeyID, view);
     }
     return true;
 }
@@ -7024,27 +7618,21 @@ bool CWallet::RevealTxOutAmount(const CTransaction& tx, const CTxOut& out, CAmou
         return true;
     }
 
-    std::set<CKeyID> keyIDs;
-    GetKeys(keyIDs);
+    // Outputs pay to a one-time pubkey, look its key up instead of trying every key of the wallet
     CPubKey sharedSec;
-    BOOST_FOREACH (const CKeyID& keyID, keyIDs) {
-        CKey privKey;
-        GetKey(keyID, privKey);
-        CScript scriptPubKey = GetScriptForDestination(privKey.GetPubKey());
-        if (scriptPubKey == out.scriptPubKey) {
-            CPubKey txPub(&(out.txPub[0]), &(out.txPub[0]) + 33);
-            CKey view;
-            if (myViewPrivateKey(view)) {
-                computeSharedSec(tx, out, sharedSec);
-                uint256 val = out.maskValue.amount;
-                uint256 mask = out.maskValue.mask;
-                CKey decodedMask;
-                ECDHInfo::Decode(mask.begin(), val.begin(), sharedSec, decodedMask, amount);
-                amountMap[out.scriptPubKey] = amount;
-                blindMap[out.scriptPubKey] = decodedMask;
-                blind.Set(blindMap[out.scriptPubKey].begin(), blindMap[out.scriptPubKey].end(), true);
-                return true;
-            }
+    CPubKey pub;
+    if (ExtractPubKey(out.scriptPubKey, pub) && HaveKey(pub.GetID())) {
+        CKey view;
+        if (myViewPrivateKey(view)) {
+            computeSharedSec(tx, out, sharedSec);
+            uint256 val = out.maskValue.amount;
+            uint256 mask = out.maskValue.mask;
+            CKey decodedMask;
+            ECDHInfo::Decode(mask.begin(), val.begin(), sharedSec, decodedMask, amount);
+            amountMap[out.scriptPubKey] = amount;
+            blindMap[out.scriptPubKey] = decodedMask;
+            blind.Set(blindMap[out.scriptPubKey].begin(), blindMap[out.scriptPubKey].end(), true);
+            return true;
         }
     }
     amount = 0;
@@ -7053,51 +7641,36 @@ bool CWallet::RevealTxOutAmount(const CTransaction& tx, const CTxOut& out, CAmou
 
 bool CWallet::findCorrespondingPrivateKey(const CTxOut& txout, CKey& key) const
 {
-    std::set<CKeyID> keyIDs;
-    GetKeys(keyIDs);
-    BOOST_FOREACH (const CKeyID& keyID, keyIDs) {
-        CBitcoinAddress address(keyID);
-        GetKey(keyID, key);
-        CPubKey pub = key.GetPubKey();
-        CScript script = GetScriptForDestination(pub);
-        if (script == txout.scriptPubKey) {
-            return true;
-        }
-    }
-    return false;
+    CPubKey pub;
+    if (!ExtractPubKey(txout.scriptPubKey, pub))
+        return false;
+    return GetKey(pub.GetID(), key);
 }
 
 bool CWallet::generateKeyImage(const CScript& scriptPubKey, CKeyImage& img) const
 {
-    std::set<CKeyID> keyIDs;
-    GetKeys(keyIDs);
     CKey key;
     unsigned char pubData[65];
-    BOOST_FOREACH (const CKeyID& keyID, keyIDs) {
-        CBitcoinAddress address(keyID);
-        GetKey(keyID, key);
-        CPubKey pub = key.GetPubKey();
-        CScript script = GetScriptForDestination(pub);
-        if (script == scriptPubKey) {
-            uint256 hash = pub.GetHash();
-            pubData[0] = *(pub.begin());
+    CPubKey pub;
+    if (ExtractPubKey(scriptPubKey, pub) && GetKey(pub.GetID(), key)) {
+        uint256 hash = pub.GetHash();
+        pubData[0] = *(pub.begin());
+        memcpy(pubData + 1, hash.begin(), 32);
+        CPubKey newPubKey(pubData, pubData + 33);
+        //P' = Hs(aR)G+B, a = view private, B = spend pub, R = tx public key
+        unsigned char ki[65];
+        //copy newPubKey into ki
+        memcpy(ki, newPubKey.begin(), newPubKey.size());
+        while (!ECPubKeyTweakMul(ki, newPubKey.size(), key.begin())) {
+            hash = newPubKey.GetHash();
+            pubData[0] = *(newPubKey.begin());
             memcpy(pubData + 1, hash.begin(), 32);
-            CPubKey newPubKey(pubData, pubData + 33);
-            //P' = Hs(aR)G+B, a = view private, B = spend pub, R = tx public key
-            unsigned char ki[65];
-            //copy newPubKey into ki
+            newPubKey.Set(pubData, pubData + 33);
             memcpy(ki, newPubKey.begin(), newPubKey.size());
-            while (!secp256k1_ec_pubkey_tweak_mul(ki, newPubKey.size(), key.begin())) {
-                hash = newPubKey.GetHash();
-                pubData[0] = *(newPubKey.begin());
-                memcpy(pubData + 1, hash.begin(), 32);
-                newPubKey.Set(pubData, pubData + 33);
-                memcpy(ki, newPubKey.begin(), newPubKey.size());
-            }
-
-            img = CKeyImage(ki, ki + 33);
-            return true;
         }
+
+        img = CKeyImage(ki, ki + 33);
+        return true;
     }
     return false;
 }
@@ -25,6 +25,7 @@
 #include "walletdb.h"
 
 #include <algorithm>
+#include <list>
 #include <map>
 #include <set>
 #include <stdexcept>
@@ -66,6 +67,12 @@ static const CAmount DEFAULT_TRANSACTION_MAXFEE = 1 * COIN;
 static const CAmount nHighTransactionMaxFeeWarning = 100 * nHighTransactionFeeWarning;
 //! Largest (in bytes) free transaction we're willing to create
 static const unsigned int MAX_FREE_TRANSACTION_CREATE_SIZE = 1000;
+//! Most payouts SendToStealthAddresses builds in one call
+static const unsigned int MAX_STEALTH_PAYOUTS = 5000;
+//! -walletarchivedepth default
+static const int DEFAULT_WALLET_ARCHIVE_DEPTH = 1000;
+//! Archived transaction bodies kept in memory after they were read back
+static const size_t ARCHIVED_TX_CACHE_SIZE = 200;
 
 // 6666 = 1*5000 + 1*1000 + 1*500 + 1*100 + 1*50 + 1*10 + 1*5 + 1
 static const int ZQ_6666 = 6666;
@@ -83,6 +90,7 @@ enum WalletFeature {
 
     FEATURE_WALLETCRYPT = 40000, // wallet encryption
     FEATURE_COMPRPUBKEY = 60000, // compressed public keys
+    FEATURE_WALLETARCHIVE = 1000305, // settled transactions kept as "atx"/"txmeta" records, set once the first one is archived
 
     FEATURE_LATEST = 61000
 };
@@ -106,6 +114,65 @@ struct CompactTallyItem {
     }
 };
 
+/**
+ * Everything a RingCT signature needs from the wallet and the chain, looked up
+ * under cs_main and cs_wallet so the signing itself can run on any thread.
+ */
+struct CRingCTInputs {
+    //! Ring position of the real inputs minus one, -1 when they are the prevouts
+    int myIndex;
+    //! Per input: spend key, commitment blind and amount of the real output
+    std::vector<CKey> vSpendKeys;
+    std::vector<CKey> vBlinds;
+    std::vector<CAmount> vAmounts;
+    //! Per input: the outputs of all ring members, prevout first, then the decoys
+    std::vector<std::vector<CTxOut> > vRing;
+
+    CRingCTInputs() : myIndex(-1) {}
+};
+
+/**
+ * What stays in memory of a settled wallet transaction once its body has been
+ * moved out of mapWallet (see CWallet::ArchiveSettledTransactions). The body
+ * stays in wallet.dat and is read back through CWallet::GetWalletTxBody.
+ */
+class CWalletTxMeta
+{
+public:
+    uint256 hashBlock;
+    int nIndex;
+    unsigned int nTimeReceived;
+    unsigned int nTimeSmart;
+    int64_t nOrderPos;
+    CAmount nTxFee;
+    //! isminetype of every output
+    std::vector<unsigned char> vIsMine;
+    //! Decoded value of every output, filled while the wallet is unlocked and never written to disk
+    mutable std::vector<CAmount> vAmounts;
+
+    CWalletTxMeta() : nIndex(-1), nTimeReceived(0), nTimeSmart(0), nOrderPos(-1), nTxFee(0) {}
+
+    ADD_SERIALIZE_METHODS;
+
+    template <typename Stream, typename Operation>
+    inline void SerializationOp(Stream& s, Operation ser_action, int nType, int nVersion)
+    {
+        READWRITE(hashBlock);
+        READWRITE(nIndex);
+        READWRITE(nTimeReceived);
+        READWRITE(nTimeSmart);
+        READWRITE(nOrderPos);
+        READWRITE(nTxFee);
+        READWRITE(vIsMine);
+    }
+
+    int64_t GetTxTime() const
+    {
+        int64_t n = nTimeSmart;
+        return n ? n : nTimeReceived;
+    }
+};
+
 /** A key pool entry */
 class CKeyPool
 {
@@ -229,7 +296,7 @@ enum StakingMode {
 class CWallet : public CCryptoKeyStore, public CValidationInterface
 {
 private:
-    bool SelectCoins(bool needFee, CAmount& estimatedFee, int ringSize, int numOut, const CAmount& nTargetValue, std::set<std::pair<const CWalletTx*, unsigned int> >& setCoinsRet, CAmount& nValueRet, const CCoinControl* coinControl = NULL, AvailableCoinsType coin_type = ALL_COINS, bool useIX = true) ;
+    bool SelectCoins(bool needFee, CAmount& estimatedFee, int ringSize, int numOut, const CAmount& nTargetValue, std::set<std::pair<const CWalletTx*, unsigned int> >& setCoinsRet, CAmount& nValueRet, const CCoinControl* coinControl = NULL, AvailableCoinsType coin_type = ALL_COINS, bool useIX = true, const std::vector<COutput>* pvCoins = NULL);
     //it was public bool SelectCoins(int64_t nTargetValue, std::set<std::pair<const CWalletTx*,unsigned int> >& setCoinsRet, int64_t& nValueRet, const CCoinControl *coinControl = NULL, AvailableCoinsType coin_type=ALL_COINS, bool useIX = true) const;
 
     CWalletDB* pwalletdbEncryption;
@@ -256,6 +323,10 @@ private:
     void SyncMetaData(std::pair<TxSpends::iterator, TxSpends::iterator>);
 
 public:
+    //! Keep setTxHistory in step with mapWallet: remove an entry before erasing it or changing its times, add it back after
+    void AddToHistory(const uint256& hash);
+    void RemoveFromHistory(const uint256& hash);
+
     static const CAmount MINIMUM_STAKE_AMOUNT = 400000 * COIN;
     static const int32_t MAX_DECOY_POOL = 500;
     static const int32_t PROBABILITY_NEW_COIN_SELECTED = 70;
@@ -354,6 +425,7 @@ public:
         nTimeFirstKey = 0;
         fWalletUnlockAnonymizeOnly = false;
         walletStakingInProgress = false;
+        fAccountKeyIDsLoaded = false;
         fBackupMints = false;
 
         // Stake Settings
@@ -387,7 +459,13 @@ public:
         fMultiSendStake = false;
     }
 
+    //! Wallet transactions that can still change the balance. Settled ones are moved to mapWalletArchive.
     mutable std::map<uint256, CWalletTx> mapWallet;
+    //! Settled transactions: every owned output is spent and they and their spends are buried
+    //! -walletarchivedepth blocks deep. Only the metadata is kept, read bodies with GetWalletTxBody.
+    std::map<uint256, CWalletTxMeta> mapWalletArchive;
+    //! (GetTxTime(), hash) of every wallet transaction, archived ones included, so the history can be read newest first
+    std::set<std::pair<int64_t, uint256> > setTxHistory;
 
     int64_t nOrderPosNext;
     std::map<uint256, int> mapRequestCount;
@@ -421,6 +499,18 @@ public:
     CAmount dirtyCachedBalance = 0;
 
     const CWalletTx* GetWalletTx(const uint256& hash) const;
+    /**
+     * Like GetWalletTx, but archived transactions are read back from wallet.dat
+     * and kept in a small LRU. Hold cs_wallet while using the result: an archived
+     * body is dropped again once ARCHIVED_TX_CACHE_SIZE other bodies were read.
+     */
+    const CWalletTx* GetWalletTxBody(const uint256& hash) const;
+    //! Reads an archived body without putting it in the LRU, for passes over the whole history
+    bool ReadArchivedTx(const uint256& hash, CWalletTx& wtx) const;
+    //! Decoded value of an output of an archived transaction, 0 while the wallet is locked
+    CAmount GetArchivedOutValue(const uint256& hash, unsigned int n) const;
+    //! Depth of an archived transaction in the active chain, 0 if its block was disconnected
+    int GetArchivedDepth(const CWalletTxMeta& meta) const;
 
     //! check whether we are allowed to upgrade (or already support) to the named feature
     bool CanSupportFeature(enum WalletFeature wf)
@@ -537,7 +627,17 @@ public:
     TxItems OrderedTxItems(std::list<CAccountingEntry>& acentries, std::string strAccount = "");
 
     void MarkDirty();
-    bool AddToWallet(const CWalletTx& wtxIn, bool fFromLoadWallet = false);
+    bool AddToWallet(const CWalletTx& wtxIn, bool fFromLoadWallet = false, CWalletDB* pwalletdb = NULL);
+    //! Adds a transaction read from the wallet file, spends are linked by ScanWalletKeyImages afterwards
+    bool LoadToWallet(const CWalletTx& wtxIn);
+    //! Adds a key image stored for an owned outpoint without writing it back
+    bool LoadKeyImage(const std::string& outpoint, const CKeyImage& ki);
+    //! Adds the metadata of an archived transaction read from the wallet file, its body is left on disk
+    bool LoadArchivedTx(const uint256& hash, const CWalletTxMeta& meta);
+    //! Moves settled transactions out of mapWallet, cs_main and cs_wallet must be held
+    int ArchiveSettledTransactions();
+    //! Moves an archived transaction back into mapWallet, e.g. when its block is disconnected
+    bool RestoreArchivedTx(const uint256& hash);
     void SyncTransaction(const CTransaction& tx, const CBlock* pblock);
     bool AddToWalletIfInvolvingMe(const CTransaction& tx, const CBlock* pblock, bool fUpdate);
     void EraseFromWallet(const uint256& hash);
@@ -592,6 +692,12 @@ public:
                            CAmount &nFeeRet, std::string &strFailReason, const CCoinControl *coinControl = NULL,
                            AvailableCoinsType coin_type = ALL_COINS, bool useIX = false, CAmount nFeePay = 0);
     bool CommitTransaction(CWalletTx& wtxNew, CReserveKey& reservekey, std::string strCommand = "tx");
+    /**
+     * Submit several transactions to the mempool, add the accepted ones to the wallet in one database
+     * transaction and broadcast them. pvState gets the verdict on each transaction. If the wallet
+     * write fails the accepted ones are taken back out of the mempool and the wallet and none is sent.
+     */
+    bool CommitTransactions(std::vector<CWalletTx>& vwtxNew, const std::vector<std::vector<CKey> >& vTxPrivKeys, std::string strCommand = "tx", std::vector<char>* pvAccepted = NULL, std::vector<CValidationState>* pvState = NULL);
     std::string PrepareObfuscationDenominate(int minRounds, int maxRounds);
     int GenerateObfuscationOutputs(int nTotalValue, std::vector<CTxOut>& vout);
     bool CreateCollateralTransaction(CMutableTransaction& txCollateral, std::string& strReason);
@@ -755,6 +861,17 @@ public:
     static bool DecodeStealthAddress(const std::string& stealth, CPubKey& pubViewKey, CPubKey& pubSpendKey, bool& hasPaymentID, uint64_t& paymentID);
     static bool ComputeStealthDestination(const CKey& secret, const CPubKey& pubViewKey, const CPubKey& pubSpendKey, CPubKey& des);
     bool SendToStealthAddress(const std::string& stealthAddr, CAmount nValue, CWalletTx& wtxNew, bool fUseIX = false, int ringSize = 5);
+    /**
+     * Pay each (stealth address, amount) in vecSend with its own transaction.
+     * The wallet's coins are scanned once and shared out between the payouts,
+     * the ring signatures and bulletproofs are computed on all cores and the
+     * transactions are written to the wallet in a single database transaction.
+     * Nothing is committed unless every payout could be built. A payout the
+     * mempool rejects is left out while the others are still sent; vSent flags
+     * the payouts that went out, vRejectReason says why each other one did not
+     * and false is returned only if none went out.
+     */
+    bool SendToStealthAddresses(const std::vector<std::pair<std::string, CAmount> >& vecSend, std::vector<CWalletTx>& vwtxNew, std::vector<char>& vSent, std::vector<std::string>& vRejectReason, std::string& strFailReason, bool fUseIX = false);
     bool GenerateAddress(CPubKey& pub, CPubKey& txPub, CKey& txPriv) const;
     bool IsTransactionForMe(const CTransaction& tx);
     bool ReadAccountList(std::string& accountList);
@@ -775,6 +892,8 @@ public:
     void CreatePrivacyAccount(bool force = false);
     bool mySpendPrivateKey(CKey& spend) const;
     bool myViewPrivateKey(CKey& view) const;
+    //! Read the account key IDs again on next use, after an account was added or replaced
+    void ResetAccountKeyCache();
     static bool CreateCommitment(const CAmount val, CKey& blind, std::vector<unsigned char>& commitment);
     static bool CreateCommitment(const unsigned char* blind, CAmount val, std::vector<unsigned char>& commitment);
     static bool CreateCommitmentWithZeroBlind(const CAmount val, unsigned char* pBlind, std::vector<unsigned char>& commitment);
@@ -797,12 +916,37 @@ private:
     bool encodeStealthBase58(const std::vector<unsigned char>& raw, std::string& stealth);
     bool allMyPrivateKeys(std::vector<CKey>& spends, std::vector<CKey>& views);
     void createMasterKey() const;
+
+    //! Key IDs of the master spend/view keys and of the stealth accounts' (spend, view) keys,
+    //! read from the database once. The keys themselves come from the keystore.
+    mutable CKeyID spendKeyID;
+    mutable CKeyID viewKeyID;
+    mutable std::vector<std::pair<CKeyID, CKeyID> > vAccountKeyIDs;
+    mutable bool fAccountKeyIDsLoaded;
     bool generateBulletProofAggregate(CTransaction& tx);
+    bool generateBulletProofAggregate(CTransaction& tx, secp256k1_scratch_space2* scratch) const;
     bool selectDecoysAndRealIndex(CTransaction& tx, int& myIndex, int ringSize);
     bool makeRingCT(CTransaction& wtxNew, int ringSize, std::string& strFailReason);
+    bool resolveRingCTInputs(const CTransaction& tx, CRingCTInputs& inputs, std::string& strFailReason) const;
+    bool signRingCT(CTransaction& wtxNew, const CRingCTInputs& inputs, std::string& strFailReason) const;
+    //! Spendable outputs as SelectCoins sees them, before coin control and selection
+    void AvailableSpendableCoins(std::vector<COutput>& vCoins);
+    /**
+     * Build the outputs, inputs and rings of a RingCT transaction, ready for signRingCT. With
+     * pvCoins the inputs are selected from that pool and removed from it instead of from the
+     * whole wallet, which is how the payouts of a batch share one wallet scan.
+     */
+    bool buildTransactionBulletProof(const CKey& txPrivDes, const CPubKey& recipientViewKey, const std::vector<std::pair<CScript, CAmount> >& vecSend, CWalletTx& wtxNew, CAmount& nFeeRet, std::string& strFailReason, const CCoinControl* coinControl, AvailableCoinsType coin_type, bool useIX, CAmount nFeePay, bool tomyself, std::vector<COutput>* pvCoins, CRingCTInputs& inputs, std::vector<CKey>& vTxPrivKeys);
+    bool createStealthPayout(const std::string& stealthAddr, CAmount nValue, bool tomyself, std::vector<COutput>& vCoins, CWalletTx& wtxNew, CRingCTInputs& inputs, std::vector<CKey>& vTxPrivKeys, std::string& strFailReason);
+    void signStealthPayouts(std::vector<CWalletTx>* pvwtx, const std::vector<CRingCTInputs>* pvInputs, std::vector<char>* pvSigned, std::vector<std::string>* pvFailReason, size_t nBegin, size_t nEnd) const;
     int walletIdxCache = 0;
     bool isMatchMyKeyImage(const CKeyImage& ki, const COutPoint& out);
     void ScanWalletKeyImages();
+
+private:
+    //! Archived bodies read by GetWalletTxBody, most recently used first
+    mutable std::list<std::pair<uint256, CWalletTx> > lruArchivedTx;
+    mutable std::map<uint256, std::list<std::pair<uint256, CWalletTx> >::iterator> mapArchivedTxCache;
 };
 
 
@@ -924,6 +1068,7 @@ public:
     }
     int GetBlocksToMaturity() const;
     bool AcceptToMemoryPool(bool fLimitFree = true, bool fRejectInsaneFee = true, bool ignoreFees = false);
+    bool AcceptToMemoryPool(CValidationState& state, bool fLimitFree = true, bool fRejectInsaneFee = true, bool ignoreFees = false);
     int GetTransactionLockSignatures() const;
     bool IsTransactionLockTimedOut() const;
 };
@@ -1462,7 +1607,7 @@ public:
         }
     }
 
-    bool WriteToDisk();
+    bool WriteToDisk(CWalletDB* pwalletdb = NULL);
 
     int64_t GetTxTime() const;
     int64_t GetComputedTxTime() const;
@@ -86,6 +86,29 @@ bool CWalletDB::EraseTx(uint256 hash)
     return Erase(std::make_pair(std::string("tx"), hash));
 }
 
+bool CWalletDB::WriteArchivedTx(uint256 hash, const CWalletTx& wtx, const CWalletTxMeta& meta)
+{
+    nWalletDBUpdated++;
+    if (!Write(std::make_pair(std::string("atx"), hash), wtx))
+        return false;
+    if (!Write(std::make_pair(std::string("txmeta"), hash), meta))
+        return false;
+    return Erase(std::make_pair(std::string("tx"), hash));
+}
+
+bool CWalletDB::ReadArchivedTx(uint256 hash, CWalletTx& wtx)
+{
+    return Read(std::make_pair(std::string("atx"), hash), wtx);
+}
+
+bool CWalletDB::EraseArchivedTx(uint256 hash)
+{
+    nWalletDBUpdated++;
+    if (!Erase(std::make_pair(std::string("txmeta"), hash)))
+        return false;
+    return Erase(std::make_pair(std::string("atx"), hash));
+}
+
 bool CWalletDB::WriteKey(const CPubKey& vchPubKey, const CPrivKey& vchPrivKey, const CKeyMetadata& keyMeta)
 {
     nWalletDBUpdated++;
@@ -572,7 +595,20 @@ bool ReadKeyValue(CWallet* pwallet, CDataStream& ssKey, CDataStream& ssValue, CW
             if (wtx.nOrderPos == -1)
                 wss.fAnyUnordered = true;
 
-            pwallet->AddToWallet(wtx, true);
+            pwallet->LoadToWallet(wtx);
+        } else if (strType == "txmeta") {
+            // The "atx" body of an archived transaction is skipped, it is only read when asked for
+            uint256 hash;
+            ssKey >> hash;
+            CWalletTxMeta meta;
+            ssValue >> meta;
+            pwallet->LoadArchivedTx(hash, meta);
+        } else if (strType == "outpointkeyimage") {
+            string outpoint;
+            ssKey >> outpoint;
+            CKeyImage ki;
+            ssValue >> ki;
+            pwallet->LoadKeyImage(outpoint, ki);
         } else if (strType == "acentry") {
             string strAccount;
             ssKey >> strAccount;
@@ -948,7 +984,7 @@ DBErrors CWalletDB::FindWalletTx(CWallet* pwallet, vector<uint256>& vTxHash, vec
 
             string strType;
             ssKey >> strType;
-            if (strType == "tx") {
+            if (strType == "tx" || strType == "atx") {
                 uint256 hash;
                 ssKey >> hash;
 
@@ -982,7 +1018,7 @@ DBErrors CWalletDB::ZapWalletTx(CWallet* pwallet, vector<CWalletTx>& vWtx)
 
     // erase each wallet TX
     BOOST_FOREACH (uint256& hash, vTxHash) {
-        if (!EraseTx(hash))
+        if (!EraseTx(hash) || !EraseArchivedTx(hash))
             return DB_CORRUPT;
     }
 
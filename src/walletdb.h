@@ -29,6 +29,7 @@ class CMasterKey;
 class CScript;
 class CWallet;
 class CWalletTx;
+class CWalletTxMeta;
 class uint160;
 class uint256;
 
@@ -93,6 +94,11 @@ public:
     bool WriteTx(uint256 hash, const CWalletTx& wtx);
     bool EraseTx(uint256 hash);
 
+    //! Archived transactions keep their body under "atx" and their resident metadata under "txmeta"
+    bool WriteArchivedTx(uint256 hash, const CWalletTx& wtx, const CWalletTxMeta& meta);
+    bool ReadArchivedTx(uint256 hash, CWalletTx& wtx);
+    bool EraseArchivedTx(uint256 hash);
+
     bool WriteStakingStatus(bool status);
     bool ReadStakingStatus();
 
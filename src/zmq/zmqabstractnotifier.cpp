@@ -25,3 +25,13 @@ bool CZMQAbstractNotifier::NotifyTransactionLock(const CTransaction &/*transacti
 {
     return true;
 }
+
+bool CZMQAbstractNotifier::NotifyBlockTransaction(const CTransaction &/*transaction*/, const CBlockIndex * /*pindex*/)
+{
+    return true;
+}
+
+bool CZMQAbstractNotifier::NotifyWalletTransaction(const CWallet * /*wallet*/, const CWalletTx &/*wtx*/)
+{
+    return true;
+}
@@ -8,6 +8,8 @@
 #include "zmqconfig.h"
 
 class CBlockIndex;
+class CWallet;
+class CWalletTx;
 class CZMQAbstractNotifier;
 
 typedef CZMQAbstractNotifier* (*CZMQNotifierFactory)();
@@ -35,6 +37,10 @@ public:
     virtual bool NotifyBlock(const CBlockIndex *pindex);
     virtual bool NotifyTransaction(const CTransaction &transaction);
     virtual bool NotifyTransactionLock(const CTransaction &transaction);
+    // transaction connected in the block of pindex, cs_main is held
+    virtual bool NotifyBlockTransaction(const CTransaction &transaction, const CBlockIndex *pindex);
+    // transaction added to or updated in the wallet, cs_wallet is held
+    virtual bool NotifyWalletTransaction(const CWallet *wallet, const CWalletTx &wtx);
 
 protected:
     void *psocket;
@@ -8,7 +8,13 @@
 #include "version.h"
 #include "main.h"
 #include "streams.h"
+#include "ui_interface.h"
 #include "util.h"
+#ifdef ENABLE_WALLET
+#include "wallet.h"
+#endif
+
+#include <boost/bind.hpp>
 
 void zmqError(const char *str)
 {
@@ -41,6 +47,10 @@ CZMQNotificationInterface* CZMQNotificationInterface::CreateWithArguments(const
     factories["pubrawblock"] = CZMQAbstractNotifier::Create<CZMQPublishRawBlockNotifier>;
     factories["pubrawtx"] = CZMQAbstractNotifier::Create<CZMQPublishRawTransactionNotifier>;
     factories["pubrawtxlock"] = CZMQAbstractNotifier::Create<CZMQPublishRawTransactionLockNotifier>;
+    factories["pubkeyimage"] = CZMQAbstractNotifier::Create<CZMQPublishKeyImageNotifier>;
+#ifdef ENABLE_WALLET
+    factories["pubwalletoutput"] = CZMQAbstractNotifier::Create<CZMQPublishWalletOutputNotifier>;
+#endif
 
     for (std::map<std::string, CZMQNotifierFactory>::const_iterator i=factories.begin(); i!=factories.end(); ++i)
     {
@@ -112,6 +122,7 @@ bool CZMQNotificationInterface::Initialize()
 void CZMQNotificationInterface::Shutdown()
 {
     LogPrint("zmq", "zmq: Shutdown notification interface\n");
+    walletConnection.disconnect();
     if (pcontext)
     {
         for (std::list<CZMQAbstractNotifier*>::iterator i=notifiers.begin(); i!=notifiers.end(); ++i)
@@ -145,10 +156,53 @@ void CZMQNotificationInterface::UpdatedBlockTip(const CBlockIndex *pindex)
 
 void CZMQNotificationInterface::SyncTransaction(const CTransaction &tx, const CBlock *pblock)
 {
+    // Transactions connected with a block come with it, the ones disconnected or from the mempool don't
+    const CBlockIndex *pindex = NULL;
+    if (pblock)
+    {
+        LOCK(cs_main);
+        BlockMap::const_iterator mi = mapBlockIndex.find(pblock->GetHash());
+        if (mi != mapBlockIndex.end())
+            pindex = mi->second;
+    }
+
+    for (std::list<CZMQAbstractNotifier*>::iterator i = notifiers.begin(); i!=notifiers.end(); )
+    {
+        CZMQAbstractNotifier *notifier = *i;
+        if (notifier->NotifyTransaction(tx) && (!pindex || notifier->NotifyBlockTransaction(tx, pindex)))
+        {
+            i++;
+        }
+        else
+        {
+            notifier->Shutdown();
+            i = notifiers.erase(i);
+        }
+    }
+}
+
+void CZMQNotificationInterface::RegisterWallet(CWallet *pwalletIn)
+{
+#ifdef ENABLE_WALLET
+    walletConnection.disconnect();
+    walletConnection = pwalletIn->NotifyTransactionChanged.connect(boost::bind(&CZMQNotificationInterface::NotifyWalletTransaction, this, _1, _2, _3));
+#endif
+}
+
+// Called by the wallet with cs_wallet held, after it took in the transaction
+void CZMQNotificationInterface::NotifyWalletTransaction(CWallet *wallet, const uint256 &hash, int status)
+{
+#ifdef ENABLE_WALLET
+    if (status == CT_DELETED)
+        return;
+    std::map<uint256, CWalletTx>::const_iterator mi = wallet->mapWallet.find(hash);
+    if (mi == wallet->mapWallet.end())
+        return;
+
     for (std::list<CZMQAbstractNotifier*>::iterator i = notifiers.begin(); i!=notifiers.end(); )
     {
         CZMQAbstractNotifier *notifier = *i;
-        if (notifier->NotifyTransaction(tx))
+        if (notifier->NotifyWalletTransaction(wallet, mi->second))
         {
             i++;
         }
@@ -158,6 +212,7 @@ void CZMQNotificationInterface::SyncTransaction(const CTransaction &tx, const CB
             i = notifiers.erase(i);
         }
     }
+#endif
 }
 
 void CZMQNotificationInterface::NotifyTransactionLock(const CTransaction &tx)
@@ -9,8 +9,12 @@
 #include <string>
 #include <map>
 
+#include <boost/signals2/connection.hpp>
+
 class CBlockIndex;
+class CWallet;
 class CZMQAbstractNotifier;
+class uint256;
 
 class CZMQNotificationInterface : public CValidationInterface
 {
@@ -19,6 +23,9 @@ public:
 
     static CZMQNotificationInterface* CreateWithArguments(const std::map<std::string, std::string> &args);
 
+    // Publish the outputs wallet receives, the wallet must outlive this interface
+    void RegisterWallet(CWallet *pwalletIn);
+
 protected:
     bool Initialize();
     void Shutdown();
@@ -31,8 +38,11 @@ protected:
 private:
     CZMQNotificationInterface();
 
+    void NotifyWalletTransaction(CWallet *wallet, const uint256 &hash, int status);
+
     void *pcontext;
     std::list<CZMQAbstractNotifier*> notifiers;
+    boost::signals2::connection walletConnection;
 };
 
 #endif // BITCOIN_ZMQ_ZMQNOTIFICATIONINTERFACE_H
@@ -7,6 +7,9 @@
 #include "main.h"
 #include "util.h"
 #include "crypto/common.h"
+#ifdef ENABLE_WALLET
+#include "wallet.h"
+#endif
 
 static std::multimap<std::string, CZMQAbstractPublishNotifier*> mapPublishNotifiers;
 
@@ -16,6 +19,8 @@ static const char *MSG_HASHTXLOCK = "hashtxlock";
 static const char *MSG_RAWBLOCK   = "rawblock";
 static const char *MSG_RAWTX      = "rawtx";
 static const char *MSG_RAWTXLOCK = "rawtxlock";
+static const char *MSG_KEYIMAGE   = "keyimage";
+static const char *MSG_WALLETOUTPUT = "walletoutput";
 
 // Internal function to send multipart message
 static int zmq_send_multipart(void *sock, const void* data, size_t size, ...)
@@ -57,6 +62,12 @@ static int zmq_send_multipart(void *sock, const void* data, size_t size, ...)
     return 0;
 }
 
+// Frees a payload handed over with zmq_msg_init_data
+static void zmq_free_vector(void * /*data*/, void *hint)
+{
+    delete static_cast<std::vector<unsigned char>*>(hint);
+}
+
 bool CZMQAbstractPublishNotifier::Initialize(void *pcontext)
 {
     assert(!psocket);
@@ -143,6 +154,37 @@ bool CZMQAbstractPublishNotifier::SendMessage(const char *command, const void* d
     return true;
 }
 
+bool CZMQAbstractPublishNotifier::SendMessage(const char *command, std::vector<unsigned char> *pdata)
+{
+    assert(psocket);
+
+    /* same three parts, the data part is sent from pdata itself */
+    unsigned char msgseq[sizeof(uint32_t)];
+    WriteLE32(&msgseq[0], nSequence);
+
+    zmq_msg_t msg;
+    if (zmq_msg_init_data(&msg, pdata->empty() ? NULL : &(*pdata)[0], pdata->size(), zmq_free_vector, pdata) != 0)
+    {
+        zmqError("Unable to initialize ZMQ msg");
+        delete pdata;
+        return false;
+    }
+    if (zmq_send(psocket, command, strlen(command), ZMQ_SNDMORE) == -1 ||
+        zmq_msg_send(&msg, psocket, ZMQ_SNDMORE) == -1 ||
+        zmq_send(psocket, msgseq, sizeof(msgseq), 0) == -1)
+    {
+        zmqError("Unable to send ZMQ msg");
+        zmq_msg_close(&msg);
+        return false;
+    }
+    zmq_msg_close(&msg);
+
+    /* increment memory only sequence number after sending */
+    nSequence++;
+
+    return true;
+}
+
 bool CZMQPublishHashBlockNotifier::NotifyBlock(const CBlockIndex *pindex)
 {
     uint256 hash = pindex->GetBlockHash();
@@ -177,22 +219,22 @@ bool CZMQPublishRawBlockNotifier::NotifyBlock(const CBlockIndex *pindex)
 {
     LogPrint("zmq", "zmq: Publish rawblock %s\n", pindex->GetBlockHash().GetHex());
 
-// XX42    const Consensus::Params& consensusParams = Params().GetConsensus();
-    CDataStream ss(SER_NETWORK, PROTOCOL_VERSION);
+    CDiskBlockPos pos;
     {
         LOCK(cs_main);
-        CBlock block;
-// XX42        if(!ReadBlockFromDisk(block, pindex, consensusParams))
-        if(!ReadBlockFromDisk(block, pindex))
-        {
-            zmqError("Can't read block from disk");
-            return false;
-        }
+        pos = pindex->GetBlockPos();
+    }
 
-        ss << block;
+    // The bytes as stored on disk are the network serialization, publish them as they are
+    std::vector<unsigned char> *pdata = new std::vector<unsigned char>();
+    if (!ReadRawBlockFromDisk(*pdata, pos))
+    {
+        delete pdata;
+        zmqError("Can't read block from disk");
+        return false;
     }
 
-    return SendMessage(MSG_RAWBLOCK, &(*ss.begin()), ss.size());
+    return SendMessage(MSG_RAWBLOCK, pdata);
 }
 
 bool CZMQPublishRawTransactionNotifier::NotifyTransaction(const CTransaction &transaction)
@@ -212,3 +254,66 @@ bool CZMQPublishRawTransactionLockNotifier::NotifyTransactionLock(const CTransac
     ss << transaction;
     return SendMessage(MSG_RAWTXLOCK, &(*ss.begin()), ss.size());
 }
+
+bool CZMQPublishKeyImageNotifier::NotifyBlockTransaction(const CTransaction &transaction, const CBlockIndex *pindex)
+{
+    if (transaction.IsCoinBase())
+        return true;
+
+    /* key image (33 bytes) | block hash (32 bytes) | LE 4byte height */
+    uint256 hashBlock = pindex->GetBlockHash();
+    unsigned char data[33 + 32 + 4];
+    for (unsigned int i = 0; i < 32; i++)
+        data[33 + 31 - i] = hashBlock.begin()[i];
+    WriteLE32(&data[33 + 32], pindex->nHeight);
+
+    for (unsigned int i = 0; i < transaction.vin.size(); i++)
+    {
+        const CKeyImage& keyImage = transaction.vin[i].keyImage;
+        if (!keyImage.IsValid() || keyImage.size() != 33)
+            continue;
+        LogPrint("zmq", "zmq: Publish keyimage %s\n", keyImage.GetHex());
+        memcpy(data, keyImage.begin(), 33);
+        if (!SendMessage(MSG_KEYIMAGE, data, sizeof(data)))
+            return false;
+    }
+    return true;
+}
+
+bool CZMQPublishWalletOutputNotifier::NotifyWalletTransaction(const CWallet *wallet, const CWalletTx &wtx)
+{
+#ifdef ENABLE_WALLET
+    /* tx hash (32 bytes) | LE 4byte output index | LE 8byte amount, -1 if it can't be decoded | account */
+    uint256 hash = wtx.GetHash();
+    for (unsigned int n = 0; n < wtx.vout.size(); n++)
+    {
+        const CTxOut& txout = wtx.vout[n];
+        if (!wallet->IsMine(txout))
+            continue;
+
+        CAmount nAmount;
+        CKey blind;
+        if (!wallet->RevealTxOutAmount(wtx, txout, nAmount, blind))
+            nAmount = -1;
+        std::string strAccount;
+        CTxDestination dest;
+        if (ExtractDestination(txout.scriptPubKey, dest))
+        {
+            std::map<CTxDestination, CAddressBookData>::const_iterator mi = wallet->mapAddressBook.find(dest);
+            if (mi != wallet->mapAddressBook.end())
+                strAccount = mi->second.name;
+        }
+
+        LogPrint("zmq", "zmq: Publish walletoutput %s:%u\n", hash.GetHex(), n);
+        std::vector<unsigned char> data(32 + 4 + 8);
+        for (unsigned int i = 0; i < 32; i++)
+            data[31 - i] = hash.begin()[i];
+        WriteLE32(&data[32], n);
+        WriteLE64(&data[36], (uint64_t)nAmount);
+        data.insert(data.end(), strAccount.begin(), strAccount.end());
+        if (!SendMessage(MSG_WALLETOUTPUT, &data[0], data.size()))
+            return false;
+    }
+#endif
+    return true;
+}
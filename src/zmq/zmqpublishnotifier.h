@@ -7,6 +7,8 @@
 
 #include "zmqabstractnotifier.h"
 
+#include <vector>
+
 class CBlockIndex;
 
 class CZMQAbstractPublishNotifier : public CZMQAbstractNotifier
@@ -23,6 +25,8 @@ public:
           * message sequence number
     */
     bool SendMessage(const char *command, const void* data, size_t size);
+    /* same, but the data part is handed to zmq without a copy and freed by it */
+    bool SendMessage(const char *command, std::vector<unsigned char> *pdata);
 
     bool Initialize(void *pcontext);
     void Shutdown();
@@ -64,4 +68,16 @@ public:
     bool NotifyTransactionLock(const CTransaction &transaction);
 };
 
+class CZMQPublishKeyImageNotifier : public CZMQAbstractPublishNotifier
+{
+public:
+    bool NotifyBlockTransaction(const CTransaction &transaction, const CBlockIndex *pindex);
+};
+
+class CZMQPublishWalletOutputNotifier : public CZMQAbstractPublishNotifier
+{
+public:
+    bool NotifyWalletTransaction(const CWallet *wallet, const CWalletTx &wtx);
+};
+
 #endif // BITCOIN_ZMQ_ZMQPUBLISHNOTIFIER_H